@@ -53,23 +53,34 @@ void BufferPoolManager::unpin_page(const page_id_t &page_id, const bool dirty) {
         return;
     }
 
+    /**
+     * the pin count is protected by latch_ like get_page() does. The page's latch isn't taken,
+     * or it deadlocks with a thread holding the page's latch and waiting for latch_ in get_page().
+     */
     frame_id_t frame_id = iter->second;
-    pages_[frame_id].w_lock();
     if (dirty) {
         pages_[frame_id].set_is_dirty(dirty);
     }
     pages_[frame_id].decrease_pin_count();
     if (pages_[frame_id].get_pin_count() > 0) {
-        pages_[frame_id].w_unlock();
         latch_.w_unlock();
         return;
     }
 
+    // the page was deleted while it's in use, it isn't in the replacer because it's pinned
+    if (!deferred_deletes_.empty() && deferred_deletes_.erase(page_id) > 0) {
+        pages_[frame_id].set_page_id(INVALID_PAGE_ID);
+        free_list_.push_back(frame_id);
+        mapping_.erase(iter);
+        latch_.w_unlock();
+        disk_manager_->free_page(page_id);
+        return;
+    }
+
     // no one need it, put him into replacer
     if (pages_[frame_id].get_pin_count() == 0)  {
         replacer_->unpin(frame_id);
     }
-    pages_[frame_id].w_unlock();
     latch_.w_unlock();
 }
 
@@ -109,29 +120,31 @@ bool BufferPoolManager::flush_all() {
     return ok;
 }
 
-void BufferPoolManager::evict_page(const page_id_t &page_id, const frame_id_t &frame_id) {
-    pages_[frame_id].w_lock();
+void BufferPoolManager::evict_page(const page_id_t &page_id, const frame_id_t &frame_id, bool force) {
+    /**
+     * the victim was picked without latch_, someone may get it again or it may be reloaded in another frame,
+     * so check it before evicting. A page isn't pinned can't be gotten while latch_ is held.
+     */
     latch_.w_lock();
     auto iter = mapping_.find(page_id);
-    if (iter == mapping_.end()) {
-        pages_[frame_id].w_unlock();
+    if (iter == mapping_.end() || iter->second != frame_id || (!force && pages_[frame_id].get_pin_count() > 0)) {
         latch_.w_unlock();
-        PRINT("evict fail");
         return;
     }
+    pages_[frame_id].w_lock();
 
+    // if the page is dirty, flush it before the frame is reused or the page is read from disk again
+    if (pages_[frame_id].is_dirty()) {
+        disk_manager_->write_page(page_id, pages_[frame_id].get_data());
+        pages_[frame_id].set_is_dirty(false);
+    }
     pages_[frame_id].set_page_id(INVALID_PAGE_ID);
+    pages_[frame_id].w_unlock();
 
     // update meta data
     mapping_.erase(iter);
     free_list_.push_back(frame_id);
-
-    // if the page is dirty, flush it first
     latch_.w_unlock();
-    if (pages_[frame_id].is_dirty()) {
-        disk_manager_->write_page(page_id, pages_[frame_id].get_data());
-    }
-    pages_[frame_id].w_unlock();
 }
 
 /**
@@ -146,6 +159,20 @@ Page* BufferPoolManager::get_page(const page_id_t &page_id) {
     // firstly, judge we are in which situation
     latch_.w_lock();
     auto iter = mapping_.find(page_id);
+
+    /**
+     * ensure free frame id is available for situation 2. latch_ is released while evicting,
+     * others may load the same page in the meantime, so judge again after that.
+     */
+    frame_id_t frame_id;
+    while (iter == mapping_.end() && free_list_.empty()) {
+        latch_.w_unlock();
+        replacer_->victim(&frame_id);
+        evict_page(pages_[frame_id].get_page_id(), frame_id);
+        latch_.w_lock();
+        iter = mapping_.find(page_id);
+    }
+
     if (iter != mapping_.end()) {
         // situation 1
         pages_[iter->second].add_pin_count();
@@ -153,20 +180,12 @@ Page* BufferPoolManager::get_page(const page_id_t &page_id) {
         latch_.w_unlock();
         return &(pages_[iter->second]);
     } else {
-        // situation 2, ensure free frame id is available
-        frame_id_t frame_id;
-        while (free_list_.empty()) {
-            latch_.w_unlock();
-            replacer_->victim(&frame_id);
-            evict_page(pages_[frame_id].get_page_id(), frame_id);
-            latch_.w_lock();
-        }
-        
-        // get a free frame id
+        // situation 2, get a free frame id
         frame_id = free_list_.front();
 
         // read page from disk
         if (!disk_manager_->read_page(page_id, pages_[frame_id].get_data())) {
+            latch_.w_unlock();
             LOG("read page fail");
             return nullptr;
         }
@@ -200,7 +219,7 @@ Page* BufferPoolManager::get_page(const page_id_t &page_id) {
 /**
  * if someone is using the page, return false.
  */
-bool BufferPoolManager::delete_page(const page_id_t &page_id) {
+bool BufferPoolManager::delete_page(const page_id_t &page_id, bool defer) {
     // find if this page exists in the buffer pool
     latch_.w_lock();
     auto iter = mapping_.find(page_id);
@@ -214,6 +233,8 @@ bool BufferPoolManager::delete_page(const page_id_t &page_id) {
     // page is in the buffer pool, check if someone else is using it
     if (pages_[iter->second].get_pin_count() != 0) {
         // someone else is using it
+        if (defer)
+            deferred_deletes_.insert(page_id);
         latch_.w_unlock();
         return false;
     }
@@ -222,7 +243,8 @@ bool BufferPoolManager::delete_page(const page_id_t &page_id) {
     pages_[iter->second].set_page_id(INVALID_PAGE_ID);
     pages_[iter->second].w_unlock();
 
-    // update meta data
+    // update meta data, the frame is in the free list now and shouldn't be evicted by the replacer
+    replacer_->pin(iter->second);
     free_list_.push_back(iter->second);
     mapping_.erase(iter);
     latch_.w_unlock();
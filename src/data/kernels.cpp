@@ -0,0 +1,96 @@
+#include "data/kernels.h"
+
+namespace dawn {
+
+cmp_kernel_t get_cmp_kernel(TypeId left_type, TypeId right_type, ComparisonType cmp_type) {
+    // the Value of a VARCHAR column is kChar
+    if (left_type == TypeId::kVarchar)
+        left_type = TypeId::kChar;
+    if (right_type == TypeId::kVarchar)
+        right_type = TypeId::kChar;
+
+    if (left_type == TypeId::kInteger) {
+        if (right_type == TypeId::kInteger)
+            return select_cmp_kernel<TypeId::kInteger, TypeId::kInteger>(cmp_type);
+        if (right_type == TypeId::kDecimal)
+            return select_cmp_kernel<TypeId::kInteger, TypeId::kDecimal>(cmp_type);
+    } else if (left_type == TypeId::kDecimal) {
+        if (right_type == TypeId::kDecimal)
+            return select_cmp_kernel<TypeId::kDecimal, TypeId::kDecimal>(cmp_type);
+        if (right_type == TypeId::kInteger)
+            return select_cmp_kernel<TypeId::kDecimal, TypeId::kInteger>(cmp_type);
+    } else if (left_type == TypeId::kBoolean && right_type == TypeId::kBoolean) {
+        return select_cmp_kernel<TypeId::kBoolean, TypeId::kBoolean>(cmp_type);
+    } else if (left_type == TypeId::kChar && right_type == TypeId::kChar) {
+        return select_cmp_kernel<TypeId::kChar, TypeId::kChar>(cmp_type);
+    }
+
+    switch (cmp_type) {
+        case ComparisonType::kEqual:
+            return &virtual_cmp_kernel<ComparisonType::kEqual>;
+        case ComparisonType::kNotEqual:
+            return &virtual_cmp_kernel<ComparisonType::kNotEqual>;
+        case ComparisonType::kLessThan:
+            return &virtual_cmp_kernel<ComparisonType::kLessThan>;
+        case ComparisonType::kLessThanOrEqual:
+            return &virtual_cmp_kernel<ComparisonType::kLessThanOrEqual>;
+        case ComparisonType::kGreaterThan:
+            return &virtual_cmp_kernel<ComparisonType::kGreaterThan>;
+        default:
+            return &virtual_cmp_kernel<ComparisonType::kGreaterThanOrEqual>;
+    }
+}
+
+arith_kernel_t get_arith_kernel(TypeId left_type, TypeId right_type, ArithmeticType arith_type) {
+    if (left_type == TypeId::kInteger) {
+        if (right_type == TypeId::kInteger)
+            return select_arith_kernel<TypeId::kInteger, TypeId::kInteger>(arith_type);
+        if (right_type == TypeId::kDecimal)
+            return select_arith_kernel<TypeId::kInteger, TypeId::kDecimal>(arith_type);
+    } else if (left_type == TypeId::kDecimal) {
+        if (right_type == TypeId::kDecimal)
+            return select_arith_kernel<TypeId::kDecimal, TypeId::kDecimal>(arith_type);
+        if (right_type == TypeId::kInteger)
+            return select_arith_kernel<TypeId::kDecimal, TypeId::kInteger>(arith_type);
+    }
+
+    switch (arith_type) {
+        case ArithmeticType::kAdd:
+            return &virtual_arith_kernel<ArithmeticType::kAdd>;
+        case ArithmeticType::kMinus:
+            return &virtual_arith_kernel<ArithmeticType::kMinus>;
+        case ArithmeticType::kMultiply:
+            return &virtual_arith_kernel<ArithmeticType::kMultiply>;
+        case ArithmeticType::kDivide:
+            return &virtual_arith_kernel<ArithmeticType::kDivide>;
+        case ArithmeticType::kMin:
+            return &virtual_arith_kernel<ArithmeticType::kMin>;
+        default:
+            return &virtual_arith_kernel<ArithmeticType::kMax>;
+    }
+}
+
+sel_kernel_t get_sel_kernel(TypeId left_type, TypeId right_type, ComparisonType cmp_type) {
+    if (left_type == right_type) {
+        sel_kernel_t kernel = get_simd_sel_kernel(left_type, cmp_type);
+        if (kernel != nullptr)
+            return kernel;
+    }
+
+    if (left_type == TypeId::kInteger) {
+        if (right_type == TypeId::kInteger)
+            return select_sel_kernel<TypeId::kInteger, TypeId::kInteger>(cmp_type);
+        if (right_type == TypeId::kDecimal)
+            return select_sel_kernel<TypeId::kInteger, TypeId::kDecimal>(cmp_type);
+    } else if (left_type == TypeId::kDecimal) {
+        if (right_type == TypeId::kDecimal)
+            return select_sel_kernel<TypeId::kDecimal, TypeId::kDecimal>(cmp_type);
+        if (right_type == TypeId::kInteger)
+            return select_sel_kernel<TypeId::kDecimal, TypeId::kInteger>(cmp_type);
+    } else if (left_type == TypeId::kBoolean && right_type == TypeId::kBoolean) {
+        return select_sel_kernel<TypeId::kBoolean, TypeId::kBoolean>(cmp_type);
+    }
+    return nullptr;
+}
+
+} // namespace dawn
@@ -0,0 +1,192 @@
+#include "data/kernels.h"
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+namespace dawn {
+
+#ifdef __AVX2__
+
+/** rows whose bitmap is built at a time, a batch fits in a chunk */
+constexpr size_t_ SIMD_CHUNK_ROWS = 1024;
+
+/** `constant op column` is evaluated as `column flipped-op constant` */
+constexpr ComparisonType flip_cmp(ComparisonType cmp_type) {
+    switch (cmp_type) {
+        case ComparisonType::kLessThan:
+            return ComparisonType::kGreaterThan;
+        case ComparisonType::kLessThanOrEqual:
+            return ComparisonType::kGreaterThanOrEqual;
+        case ComparisonType::kGreaterThan:
+            return ComparisonType::kLessThan;
+        case ComparisonType::kGreaterThanOrEqual:
+            return ComparisonType::kLessThanOrEqual;
+        default:
+            return cmp_type;
+    }
+}
+
+template<typename T>
+struct SimdOps {};
+
+/** 8 integers in a register */
+template<>
+struct SimdOps<integer_t> {
+    static constexpr size_t_ LANES = 8;
+
+    template<ComparisonType cmp_type>
+    static inline uint32_t cmp_mask(const integer_t *col, __m256i val) {
+        __m256i data = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(col));
+        __m256i res;
+        bool negated = false;
+        if constexpr (cmp_type == ComparisonType::kEqual) {
+            res = _mm256_cmpeq_epi32(data, val);
+        } else if constexpr (cmp_type == ComparisonType::kNotEqual) {
+            res = _mm256_cmpeq_epi32(data, val);
+            negated = true;
+        } else if constexpr (cmp_type == ComparisonType::kLessThan) {
+            res = _mm256_cmpgt_epi32(val, data);
+        } else if constexpr (cmp_type == ComparisonType::kLessThanOrEqual) {
+            res = _mm256_cmpgt_epi32(data, val);
+            negated = true;
+        } else if constexpr (cmp_type == ComparisonType::kGreaterThan) {
+            res = _mm256_cmpgt_epi32(data, val);
+        } else {
+            res = _mm256_cmpgt_epi32(val, data);
+            negated = true;
+        }
+        uint32_t mask = _mm256_movemask_ps(_mm256_castsi256_ps(res));
+        return negated ? mask ^ 0xff : mask;
+    }
+
+    static inline __m256i broadcast(integer_t val) { return _mm256_set1_epi32(val); }
+};
+
+/** 4 decimals in a register, the comparisons are ordered just like the scalar ones */
+template<>
+struct SimdOps<decimal_t> {
+    static constexpr size_t_ LANES = 4;
+
+    template<ComparisonType cmp_type>
+    static inline uint32_t cmp_mask(const decimal_t *col, __m256d val) {
+        __m256d data = _mm256_loadu_pd(col);
+        __m256d res;
+        if constexpr (cmp_type == ComparisonType::kEqual)
+            res = _mm256_cmp_pd(data, val, _CMP_EQ_OQ);
+        else if constexpr (cmp_type == ComparisonType::kNotEqual)
+            res = _mm256_cmp_pd(data, val, _CMP_NEQ_UQ);
+        else if constexpr (cmp_type == ComparisonType::kLessThan)
+            res = _mm256_cmp_pd(data, val, _CMP_LT_OQ);
+        else if constexpr (cmp_type == ComparisonType::kLessThanOrEqual)
+            res = _mm256_cmp_pd(data, val, _CMP_LE_OQ);
+        else if constexpr (cmp_type == ComparisonType::kGreaterThan)
+            res = _mm256_cmp_pd(data, val, _CMP_GT_OQ);
+        else
+            res = _mm256_cmp_pd(data, val, _CMP_GE_OQ);
+        return _mm256_movemask_pd(res);
+    }
+
+    static inline __m256d broadcast(decimal_t val) { return _mm256_set1_pd(val); }
+};
+
+/** set bit i of the bitmap if col[i] op val, for the first rows */
+template<typename T, ComparisonType cmp_type>
+inline void build_bitmap(const T *col, T val, size_t_ rows, uint64_t *bitmap) {
+    using Ops = SimdOps<T>;
+    auto val_reg = Ops::broadcast(val);
+    size_t_ word_num = (rows + 63) / 64;
+    memset(bitmap, 0, word_num * sizeof(uint64_t));
+
+    size_t_ i = 0;
+    for (; i + Ops::LANES <= rows; i += Ops::LANES) {
+        uint64_t mask = Ops::template cmp_mask<cmp_type>(col + i, val_reg);
+        bitmap[i / 64] |= mask << (i % 64);
+    }
+    for (; i < rows; i++)
+        bitmap[i / 64] |= static_cast<uint64_t>(apply_cmp<cmp_type, T>(col[i], val)) << (i % 64);
+}
+
+/** compare the column with the constant, the result bitmap is turned into the selection */
+template<typename T, ComparisonType cmp_type>
+size_t_ simd_select(const T *col, T val, const int *sel, size_t_ num, int *sel_out) {
+    uint64_t bitmap[SIMD_CHUNK_ROWS / 64];
+    size_t_ rows = sel == nullptr ? num : (num == 0 ? 0 : sel[num - 1] + 1);
+    size_t_ cnt = 0;
+    size_t_ sel_idx = 0;
+    for (size_t_ base = 0; base < rows; base += SIMD_CHUNK_ROWS) {
+        size_t_ chunk_rows = std::min(SIMD_CHUNK_ROWS, rows - base);
+        build_bitmap<T, cmp_type>(col + base, val, chunk_rows, bitmap);
+
+        if (sel == nullptr) {
+            size_t_ word_num = (chunk_rows + 63) / 64;
+            for (size_t_ w = 0; w < word_num; w++) {
+                uint64_t word = bitmap[w];
+                while (word != 0) {
+                    sel_out[cnt++] = base + w * 64 + __builtin_ctzll(word);
+                    word &= word - 1;
+                }
+            }
+            continue;
+        }
+
+        // the selection is ascending, so its rows in this chunk are continuous
+        for (; sel_idx < num && sel[sel_idx] < base + chunk_rows; sel_idx++) {
+            int row = sel[sel_idx];
+            size_t_ bit = row - base;
+            sel_out[cnt] = row;
+            cnt += (bitmap[bit / 64] >> (bit % 64)) & 1;
+        }
+    }
+    return cnt;
+}
+
+template<TypeId type_id, ComparisonType cmp_type>
+size_t_ simd_sel_kernel(const char *left, bool left_const, const char *right, bool right_const,
+    const int *sel, size_t_ num, int *sel_out) {
+    using T = typename NativeType<type_id>::type;
+    if (!left_const && right_const)
+        return simd_select<T, cmp_type>(reinterpret_cast<const T*>(left), *reinterpret_cast<const T*>(right),
+            sel, num, sel_out);
+    if (left_const && !right_const)
+        return simd_select<T, flip_cmp(cmp_type)>(reinterpret_cast<const T*>(right), *reinterpret_cast<const T*>(left),
+            sel, num, sel_out);
+    // column vs column
+    return sel_kernel<type_id, type_id, cmp_type>(left, left_const, right, right_const, sel, num, sel_out);
+}
+
+template<TypeId type_id>
+sel_kernel_t select_simd_sel_kernel(ComparisonType cmp_type) {
+    switch (cmp_type) {
+        case ComparisonType::kEqual:
+            return &simd_sel_kernel<type_id, ComparisonType::kEqual>;
+        case ComparisonType::kNotEqual:
+            return &simd_sel_kernel<type_id, ComparisonType::kNotEqual>;
+        case ComparisonType::kLessThan:
+            return &simd_sel_kernel<type_id, ComparisonType::kLessThan>;
+        case ComparisonType::kLessThanOrEqual:
+            return &simd_sel_kernel<type_id, ComparisonType::kLessThanOrEqual>;
+        case ComparisonType::kGreaterThan:
+            return &simd_sel_kernel<type_id, ComparisonType::kGreaterThan>;
+        default:
+            return &simd_sel_kernel<type_id, ComparisonType::kGreaterThanOrEqual>;
+    }
+}
+
+sel_kernel_t get_simd_sel_kernel(TypeId type_id, ComparisonType cmp_type) {
+    if (type_id == TypeId::kInteger)
+        return select_simd_sel_kernel<TypeId::kInteger>(cmp_type);
+    if (type_id == TypeId::kDecimal)
+        return select_simd_sel_kernel<TypeId::kDecimal>(cmp_type);
+    return nullptr;
+}
+
+#else
+
+sel_kernel_t get_simd_sel_kernel(TypeId type_id, ComparisonType cmp_type) {
+    return nullptr;
+}
+
+#endif
+
+} // namespace dawn
@@ -14,6 +14,8 @@ string_t type_to_string(TypeId type_id) {
             return "kDecimal";
         case TypeId::kChar:
             return "kChar";
+        case TypeId::kVarchar:
+            return "kVarchar";
     }
     return "ILLEGAL";
 }
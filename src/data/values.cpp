@@ -4,10 +4,11 @@
 #include "data/integer.h"
 #include "data/decimal.h"
 #include "data/char.h"
+#include "data/varchar.h"
 
 namespace dawn {
 
-Type *singleton[4] = { new Boolean(), new Integer(), new Decimal(), new Char()};
+Type *singleton[TYPE_NUM] = { new Boolean(), new Integer(), new Decimal(), new Char(), new Varchar()};
 
 Value::Value() {
     type_id_ = TypeId::kInvalid;
@@ -29,30 +30,25 @@ Value::Value(decimal_t val) {
     construct(val);
 }
 
-Value::Value(const char* val) : str_len_(strlen(val)) {
-    construct(val, str_len_);
+Value::Value(const char* val) {
+    construct(val, strlen(val));
 }
 
-Value::Value(const string_t &val) : str_len_(val.length()) {
-    type_id_ = TypeId::kChar;
-    value_.char_ = new char[str_len_+1];
-    memset(value_.char_, 0, str_len_ + 1);
-    for (int i = 0; i < str_len_; i++)
-        value_.char_[i] = val[i];
-    value_.char_[str_len_] = '\0'; // remind us that there needs a string end
+Value::Value(const string_t &val) {
+    construct(val.data(), val.length());
 }
 
 Value::Value(char *value, TypeId type_id, size_t_ str_size) : type_id_(type_id), str_len_(str_size) {
     if (type_id_ == TypeId::kChar) {
-        value_.char_ = new char[str_len_+1];
+        // the string may be shorter than str_size, the rest is left 0
+        alloc_str(str_len_);
         memset(value_.char_, 0, str_len_ + 1);
     }
     deserialize_from(value);
 }
 
 Value::~Value() {
-    if (type_id_ == TypeId::kChar)
-        delete[] value_.char_;
+    free_str();
 }
 
 } // namespace dawn
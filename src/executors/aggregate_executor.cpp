@@ -0,0 +1,68 @@
+#include "executors/aggregate_executor.h"
+#include "table/toast.h"
+
+namespace dawn {
+
+void AggregateExecutor::open() {
+    states_.assign(aggs_.size(), AggregateState());
+    input_num_ = 0;
+    output_ = false;
+
+    // the states are read by the position in kFinal
+    ref_cols_.clear();
+    if (phase_ == AggregationPhase::kFinal) {
+        for (size_t_ i = 0; i < static_cast<size_t_>(aggs_.size()); i++)
+            ref_cols_.push_back(i);
+    } else {
+        for (auto agg : aggs_)
+            agg->get_col_idxs(&ref_cols_);
+    }
+    child_->set_required_cols(ref_cols_);
+    child_->open();
+    consume();
+}
+
+void AggregateExecutor::consume() {
+    BufferPoolManager *bpm = get_context()->get_buffer_pool_manager();
+    AggregateState other;
+    other.empty = false;
+    while (child_->get_next_view(&child_view_)) {
+        input_num_++;
+        toast_fetch(child_view_.get_tuple(), *input_schema_, ref_cols_, bpm);
+        for (size_t_ i = 0; i < static_cast<size_t_>(aggs_.size()); i++) {
+            if (phase_ == AggregationPhase::kFinal) {
+                other.value = child_view_->get_value(*input_schema_, i);
+                aggs_[i]->combine(&states_[i], other);
+            } else {
+                aggs_[i]->accumulate(&states_[i], &(*child_view_), input_schema_);
+            }
+        }
+    }
+    child_view_.release();
+}
+
+bool AggregateExecutor::get_next(Tuple *tuple) {
+    // the worker having no tuples outputs nothing, so the final phase doesn't combine the empty states
+    if (output_ || (phase_ == AggregationPhase::kPartial && input_num_ == 0))
+        return false;
+
+    // the empty states are 0 of the output types
+    char zero[DECIMAL_T_SIZE] = {0};
+    values_.clear();
+    for (size_t_ i = 0; i < static_cast<size_t_>(aggs_.size()); i++) {
+        if (states_[i].empty)
+            values_.push_back(Value(zero, output_schema_->get_column_type(i)));
+        else
+            values_.push_back(aggs_[i]->finalize(states_[i]));
+    }
+    tuple->reconstruct(&values_, *output_schema_);
+    output_ = true;
+    return true;
+}
+
+void AggregateExecutor::close() {
+    child_view_.release();
+    child_->close();
+}
+
+} // namespace dawn
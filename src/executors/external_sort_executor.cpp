@@ -0,0 +1,197 @@
+#include <algorithm>
+
+#include "executors/external_sort_executor.h"
+#include "table/toast.h"
+
+namespace dawn {
+
+void ExternalSortExecutor::open() {
+    BufferPoolManager *bpm = get_context()->get_buffer_pool_manager();
+    threshold_pages_ = bpm->get_threshold_page(3);
+
+    out_idx_ = 0;
+    run_num_ = 0;
+    merge_pass_num_ = 0;
+    child_->open();
+
+    // run generation
+    TupleView view;
+    while (child_->get_next_view(&view)) {
+        if (chunk_insert(*view))
+            continue;
+        spill_chunk();
+        if (!chunk_insert(*view))
+            FATAL("ExternalSortExecutor Error: the tuple is larger than a page");
+    }
+    view.release();
+
+    if (runs_.empty()) {
+        sort_chunk();
+        return;
+    }
+    if (!entries_.empty())
+        spill_chunk();
+    run_num_ = runs_.size();
+
+    // each run pins a page when it's merged, and the merged run pins another one.
+    // Each pass merges every group of the consecutive runs, so that every tuple is merged once
+    // in a pass and the runs are still in the order of the input
+    size_t_ merge_num = threshold_pages_ - 1;
+    while (static_cast<size_t_>(runs_.size()) > threshold_pages_) {
+        std::deque<TmpPageChain> merged_runs;
+        for (size_t_ begin = 0; begin < static_cast<size_t_>(runs_.size()); begin += merge_num) {
+            size_t_ num = std::min(merge_num, static_cast<size_t_>(runs_.size()) - begin);
+            if (num == 1) {
+                merged_runs.push_back(runs_[begin]);
+                continue;
+            }
+
+            TmpPageChain merged;
+            Tuple tuple;
+            start_merge(begin, num);
+            while (next_merged(&tuple))
+                merged.append(tuple, bpm);
+            merged.finish(bpm);
+
+            sources_.clear();
+            for (size_t_ i = begin; i < begin + num; i++)
+                runs_[i].destroy(bpm);
+            merged_runs.push_back(merged);
+        }
+        runs_.swap(merged_runs);
+        merge_pass_num_++;
+    }
+    start_merge(0, runs_.size());
+}
+
+bool ExternalSortExecutor::get_next(Tuple *tuple) {
+    if (!runs_.empty())
+        return next_merged(tuple);
+
+    if (out_idx_ >= static_cast<size_t_>(entries_.size()))
+        return false;
+    const SortEntry &entry = entries_[out_idx_++];
+    if (!entry.page->get_tuple(tuple, entry.rid))
+        FATAL("ExternalSortExecutor Error: fail to get the tuple");
+    return true;
+}
+
+void ExternalSortExecutor::close() {
+    BufferPoolManager *bpm = get_context()->get_buffer_pool_manager();
+    clear_chunk();
+
+    // the readers unpin their pages before the runs are deleted
+    sources_.clear();
+    for (auto &run : runs_)
+        run.destroy(bpm);
+    runs_.clear();
+
+    bpm->return_threshold_page(threshold_pages_);
+    threshold_pages_ = 0;
+    child_->close();
+}
+
+int ExternalSortExecutor::compare_keys(const std::vector<Value> &lhs, const std::vector<Value> &rhs,
+    const std::vector<bool> &descs) {
+    for (size_t i = 0; i < lhs.size(); i++) {
+        int res = 0;
+        if (lhs[i] < rhs[i])
+            res = -1;
+        else if (rhs[i] < lhs[i])
+            res = 1;
+        if (res != 0)
+            return descs[i] ? -res : res;
+    }
+    return 0;
+}
+
+void ExternalSortExecutor::fetch_keys(const Tuple &tuple, std::vector<Value> *keys) const {
+    BufferPoolManager *bpm = get_context()->get_buffer_pool_manager();
+    keys->clear();
+    for (auto idx : key_idxs_)
+        keys->push_back(toast_fetch_value(tuple, *schema_, idx, bpm));
+}
+
+bool ExternalSortExecutor::chunk_insert(const Tuple &tuple) {
+    RID rid;
+    if (chunk_pages_.empty() || !chunk_pages_.back()->insert_tuple(tuple, &rid)) {
+        // a page is left for writing the run
+        if (static_cast<size_t_>(chunk_pages_.size()) >= threshold_pages_ - 1)
+            return false;
+
+        TablePage *page = reinterpret_cast<TablePage*>(get_context()->get_buffer_pool_manager()->new_tmp_page());
+        if (page == nullptr)
+            FATAL("ExternalSortExecutor Error: fail to get a temporary page");
+        page->init(INVALID_PAGE_ID, INVALID_PAGE_ID);
+        chunk_pages_.push_back(page);
+        if (!page->insert_tuple(tuple, &rid))
+            return false;
+    }
+
+    entries_.push_back(SortEntry{std::vector<Value>{}, chunk_pages_.back(), rid});
+    fetch_keys(tuple, &entries_.back().keys);
+    return true;
+}
+
+void ExternalSortExecutor::sort_chunk() {
+    std::stable_sort(entries_.begin(), entries_.end(), [this](const SortEntry &lhs, const SortEntry &rhs) {
+        return compare_keys(lhs.keys, rhs.keys, descs_) < 0;
+    });
+}
+
+void ExternalSortExecutor::spill_chunk() {
+    BufferPoolManager *bpm = get_context()->get_buffer_pool_manager();
+    sort_chunk();
+    TmpPageChain run;
+    Tuple tuple;
+    for (auto &entry : entries_) {
+        if (!entry.page->get_tuple_ref(&tuple, entry.rid))
+            FATAL("ExternalSortExecutor Error: fail to get the tuple");
+        run.append(tuple, bpm);
+    }
+    run.finish(bpm);
+    runs_.push_back(run);
+    clear_chunk();
+}
+
+void ExternalSortExecutor::clear_chunk() {
+    BufferPoolManager *bpm = get_context()->get_buffer_pool_manager();
+    for (auto page : chunk_pages_) {
+        page_id_t page_id = page->get_page_id();
+        bpm->unpin_page(page_id, false);
+        bpm->delete_page(page_id);
+    }
+    chunk_pages_.clear();
+    entries_.clear();
+}
+
+void ExternalSortExecutor::start_merge(size_t_ begin, size_t_ num) {
+    BufferPoolManager *bpm = get_context()->get_buffer_pool_manager();
+    sources_ = std::vector<MergeSource>(num);
+    for (size_t_ i = 0; i < num; i++) {
+        sources_[i].reader.open(runs_[begin + i].get_first_page_id(), bpm);
+        advance_source(i);
+    }
+    tree_.init(num);
+}
+
+void ExternalSortExecutor::advance_source(size_t_ idx) {
+    MergeSource &source = sources_[idx];
+    source.valid = source.reader.next(&source.tuple);
+    if (source.valid)
+        fetch_keys(source.tuple, &source.keys);
+}
+
+bool ExternalSortExecutor::next_merged(Tuple *tuple) {
+    size_t_ winner = tree_.get_winner();
+    if (!sources_[winner].valid)
+        return false;
+
+    // copy it before the reader moves on and unpins the page
+    *tuple = sources_[winner].tuple;
+    advance_source(winner);
+    tree_.replay();
+    return true;
+}
+
+} // namespace dawn
@@ -0,0 +1,96 @@
+#include "executors/gather_executor.h"
+
+namespace dawn {
+
+void GatherExecutor::open() {
+    queue_.reset();
+    chunk_.clear();
+    chunk_idx_ = 0;
+    if (workers_.empty()) {
+        queue_.close();
+        return;
+    }
+
+    opened_.assign(workers_.size(), false);
+    bool own_thread = false;
+    for (auto worker : workers_)
+        own_thread = own_thread || worker->need_own_thread();
+    size_t_ worker_num = workers_.size();
+    thread_num_ = exec_ctx_->acquire_threads(worker_num, own_thread ? worker_num : 1);
+    running_num_ = thread_num_;
+    for (size_t_ i = 0; i < thread_num_; i++)
+        threads_.emplace_back(&GatherExecutor::run_thread, this, i);
+}
+
+bool GatherExecutor::get_next(Tuple *tuple) {
+    while (chunk_idx_ >= chunk_.size()) {
+        if (!queue_.pop(&chunk_))
+            return false;
+        chunk_idx_ = 0;
+    }
+    *tuple = chunk_[chunk_idx_++];
+    return true;
+}
+
+void GatherExecutor::close() {
+    stop_workers();
+    // the workers not started before the consumer stops aren't opened
+    for (size_t_ i = 0; i < static_cast<size_t_>(opened_.size()); i++) {
+        if (opened_[i])
+            workers_[i]->close();
+    }
+    opened_.clear();
+    chunk_.clear();
+    chunk_idx_ = 0;
+}
+
+void GatherExecutor::run_thread(size_t_ idx) {
+    for (size_t_ i = idx; i < static_cast<size_t_>(workers_.size()); i += thread_num_) {
+        if (!run_worker(i))
+            break;
+    }
+
+    if (--running_num_ == 0)
+        queue_.close();
+}
+
+bool GatherExecutor::run_worker(size_t_ idx) {
+    ExecutorAbstract *worker = workers_[idx];
+    opened_[idx] = true;
+    worker->open();
+
+    bool more = true;
+    while (more) {
+        std::vector<Tuple> chunk;
+        chunk.reserve(EXCHANGE_CHUNK_SZ);
+        while (chunk.size() < EXCHANGE_CHUNK_SZ) {
+            chunk.emplace_back();
+            if (!worker->get_next(&chunk.back())) {
+                chunk.pop_back();
+                more = false;
+                break;
+            }
+        }
+
+        // the consumer has stopped, the worker is closed here in case some others are waiting for it,
+        // e.g. the other consumers of a RepartitionExchange
+        if (!chunk.empty() && !queue_.push(std::move(chunk))) {
+            worker->close();
+            opened_[idx] = false;
+            return false;
+        }
+    }
+    return true;
+}
+
+void GatherExecutor::stop_workers() {
+    if (threads_.empty())
+        return;
+    queue_.cancel();
+    for (auto &thd : threads_)
+        thd.join();
+    threads_.clear();
+    exec_ctx_->release_threads(thread_num_);
+}
+
+} // namespace dawn
@@ -0,0 +1,234 @@
+#include <algorithm>
+
+#include "executors/hash_aggregate_executor.h"
+#include "table/toast.h"
+
+namespace dawn {
+
+/** the partition bits of the deepest level are the highest bits of the hash */
+constexpr int MAX_SPILL_LEVEL = 5;
+
+/** initial number of the slots, it's always a power of 2 */
+constexpr size_t_ INIT_SLOT_NUM = 64;
+
+void HashAggregateExecutor::open() {
+    BufferPoolManager *bpm = get_context()->get_buffer_pool_manager();
+    threshold_pages_ = bpm->get_threshold_page(4);
+
+    // the partitions being written and the one being read pin a page each, the table uses the rest
+    spill_fanout_ = std::max(2, std::min(16, threshold_pages_ / 4));
+    size_t_ group_size = sizeof(GroupState) + sizeof(Value) * (group_exprs_.size() + agg_types_.size()) + 2 * sizeof(int);
+    group_limit_ = std::max(1, static_cast<int>((threshold_pages_ - spill_fanout_ - 1) * PAGE_SIZE / group_size));
+
+    ref_cols_.clear();
+    for (auto expr : group_exprs_)
+        expr->get_col_idxs(&ref_cols_);
+    for (auto expr : agg_exprs_)
+        if (expr != nullptr)
+            expr->get_col_idxs(&ref_cols_);
+    kernels_.assign(agg_types_.size(), nullptr);
+    arg_types_.assign(agg_types_.size(), TypeId::kInvalid);
+    level_ = 0;
+    spilled_part_num_ = 0;
+    clear_table();
+
+    // aggregate all the tuples in one pass
+    child_->set_required_cols(ref_cols_);
+    child_->open();
+    while (child_->get_next_view(&child_view_))
+        consume(*child_view_);
+    child_view_.release();
+    finish_spill();
+
+    if (group_exprs_.empty() && groups_.empty()) {
+        char zero[DECIMAL_T_SIZE] = {0};
+        GroupState group{0, std::vector<Value>{}, std::vector<Value>{}};
+        for (size_t_ i = 0; i < static_cast<size_t_>(agg_types_.size()); i++)
+            group.aggs.push_back(Value(zero, output_schema_->get_column_type(i)));
+        groups_.push_back(group);
+    }
+}
+
+bool HashAggregateExecutor::get_next(Tuple *tuple) {
+    while (out_idx_ >= static_cast<size_t_>(groups_.size())) {
+        if (!load_partition())
+            return false;
+    }
+
+    const GroupState &group = groups_[out_idx_++];
+    values_ = group.keys;
+    values_.insert(values_.end(), group.aggs.begin(), group.aggs.end());
+    tuple->reconstruct(&values_, *output_schema_);
+    return true;
+}
+
+void HashAggregateExecutor::close() {
+    BufferPoolManager *bpm = get_context()->get_buffer_pool_manager();
+    child_view_.release();
+    clear_table();
+    for (auto &part : spilling_parts_)
+        part.destroy(bpm);
+    spilling_parts_.clear();
+    for (auto &part : parts_)
+        part.chain.destroy(bpm);
+    parts_.clear();
+
+    bpm->return_threshold_page(threshold_pages_);
+    threshold_pages_ = 0;
+    child_->close();
+}
+
+void HashAggregateExecutor::consume(const Tuple &raw) {
+    BufferPoolManager *bpm = get_context()->get_buffer_pool_manager();
+
+    // the raw tuple is spilled, so the toasted values are fetched into a copy
+    const Tuple *tuple = &raw;
+    for (auto idx : ref_cols_) {
+        if (!raw.is_toasted(*input_schema_, idx))
+            continue;
+        fetched_tuple_ = raw;
+        toast_fetch(&fetched_tuple_, *input_schema_, ref_cols_, bpm);
+        tuple = &fetched_tuple_;
+        break;
+    }
+
+    keys_.clear();
+    hash_t hash = 0;
+    for (auto expr : group_exprs_) {
+        keys_.push_back(expr->evaluate(tuple, input_schema_));
+        hash ^= keys_.back().get_hash_value() + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+    }
+    args_.clear();
+    for (auto expr : agg_exprs_)
+        args_.push_back(expr == nullptr ? Value() : expr->evaluate(tuple, input_schema_));
+
+    size_t_ slot;
+    int idx = find_group(hash, keys_, &slot);
+    if (idx >= 0) {
+        update_group(&groups_[idx]);
+        return;
+    }
+
+    // the deepest partitions are aggregated in the memory anyway
+    if (static_cast<size_t_>(groups_.size()) >= group_limit_ && level_ < MAX_SPILL_LEVEL) {
+        if (spilling_parts_.empty())
+            spilling_parts_.resize(spill_fanout_);
+        spilling_parts_[get_partition(hash)].append(raw, bpm);
+        return;
+    }
+    insert_group(slot, hash);
+}
+
+int HashAggregateExecutor::find_group(hash_t hash, const std::vector<Value> &keys, size_t_ *slot) const {
+    size_t_ mask = slots_.size() - 1;
+    size_t_ pos = hash & mask;
+    while (slots_[pos] != -1) {
+        const GroupState &group = groups_[slots_[pos]];
+        if (group.hash == hash && group.keys == keys)
+            return slots_[pos];
+        pos = (pos + 1) & mask;
+    }
+    *slot = pos;
+    return -1;
+}
+
+void HashAggregateExecutor::insert_group(size_t_ slot, hash_t hash) {
+    GroupState group{hash, keys_, std::vector<Value>{}};
+    char zero[DECIMAL_T_SIZE] = {0};
+    size_t_ key_num = group_exprs_.size();
+    for (size_t_ i = 0; i < static_cast<size_t_>(agg_types_.size()); i++) {
+        switch (agg_types_[i]) {
+            case AggregationType::kCountAggregate:
+                group.aggs.push_back(Value(static_cast<integer_t>(1)));
+                break;
+            case AggregationType::kSumAggregate: {
+                TypeId type_id = output_schema_->get_column_type(key_num + i);
+                group.aggs.push_back(get_kernel(i, type_id)(Value(zero, type_id), args_[i]));
+                break;
+            }
+            default:
+                group.aggs.push_back(args_[i]);
+        }
+    }
+
+    slots_[slot] = groups_.size();
+    groups_.push_back(std::move(group));
+    // keep the load factor under 1/2
+    if (groups_.size() * 2 > slots_.size())
+        grow_slots();
+}
+
+void HashAggregateExecutor::grow_slots() {
+    slots_.assign(slots_.size() * 2, -1);
+    size_t_ mask = slots_.size() - 1;
+    for (size_t_ i = 0; i < static_cast<size_t_>(groups_.size()); i++) {
+        size_t_ pos = groups_[i].hash & mask;
+        while (slots_[pos] != -1)
+            pos = (pos + 1) & mask;
+        slots_[pos] = i;
+    }
+}
+
+void HashAggregateExecutor::update_group(GroupState *group) {
+    for (size_t_ i = 0; i < static_cast<size_t_>(agg_types_.size()); i++) {
+        if (agg_types_[i] == AggregationType::kCountAggregate)
+            ++group->aggs[i];
+        else
+            group->aggs[i] = get_kernel(i, group->aggs[i].get_type_id())(group->aggs[i], args_[i]);
+    }
+}
+
+arith_kernel_t HashAggregateExecutor::get_kernel(size_t_ i, TypeId state_type) {
+    TypeId arg_type = args_[i].get_type_id();
+    if (kernels_[i] != nullptr && arg_types_[i] == arg_type)
+        return kernels_[i];
+
+    ArithmeticType arith_type = ArithmeticType::kAdd;
+    if (agg_types_[i] == AggregationType::kMinAggregate)
+        arith_type = ArithmeticType::kMin;
+    else if (agg_types_[i] == AggregationType::kMaxAggregate)
+        arith_type = ArithmeticType::kMax;
+    arg_types_[i] = arg_type;
+    kernels_[i] = get_arith_kernel(state_type, arg_type, arith_type);
+    return kernels_[i];
+}
+
+void HashAggregateExecutor::clear_table() {
+    slots_.assign(INIT_SLOT_NUM, -1);
+    groups_.clear();
+    out_idx_ = 0;
+}
+
+void HashAggregateExecutor::finish_spill() {
+    BufferPoolManager *bpm = get_context()->get_buffer_pool_manager();
+    for (auto &part : spilling_parts_) {
+        part.finish(bpm);
+        if (part.is_empty())
+            continue;
+        parts_.push_back(SpillPartition{part, level_ + 1});
+        spilled_part_num_++;
+    }
+    spilling_parts_.clear();
+}
+
+bool HashAggregateExecutor::load_partition() {
+    if (parts_.empty())
+        return false;
+
+    BufferPoolManager *bpm = get_context()->get_buffer_pool_manager();
+    SpillPartition part = parts_.back();
+    parts_.pop_back();
+    clear_table();
+    level_ = part.level;
+
+    TmpChainReader reader;
+    reader.open(part.chain.get_first_page_id(), bpm);
+    while (reader.next(&part_tuple_))
+        consume(part_tuple_);
+    reader.close();
+    part.chain.destroy(bpm);
+    finish_spill();
+    return true;
+}
+
+} // namespace dawn
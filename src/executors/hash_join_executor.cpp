@@ -0,0 +1,224 @@
+#include "executors/hash_join_executor.h"
+#include "table/toast.h"
+
+namespace dawn {
+
+void HashJoinExecutor::open() {
+    BufferPoolManager *bpm = get_context()->get_buffer_pool_manager();
+    threshold_pages_ = bpm->get_threshold_page(4);
+
+    cur_part_ = -1;
+    build_part_done_ = true;
+    has_pending_ = false;
+    probe_tuple_ = nullptr;
+    match_iter_ = match_end_ = hash_table_.end();
+    left_child_->open();
+    right_child_->open();
+
+    // half of the pages are left for the partitions in case the build side can't fit in the memory
+    TupleView view;
+    while (left_child_->get_next_view(&view)) {
+        hash_t hash = hash_keys(*view, *left_schema_, left_key_idxs_, &build_keys_);
+        if (build_insert(*view, hash, threshold_pages_ / 2))
+            continue;
+
+        // switch to the grace hash join
+        build_parts_.resize(threshold_pages_ / 2);
+        probe_parts_.resize(threshold_pages_ / 2);
+        partition_build();
+        partition_insert(&build_parts_, *view, hash);
+        while (left_child_->get_next_view(&view))
+            partition_insert(&build_parts_, *view, hash_keys(*view, *left_schema_, left_key_idxs_, &build_keys_));
+        view.release();
+        finish_partitions(&build_parts_);
+        partition_probe();
+        break;
+    }
+}
+
+bool HashJoinExecutor::get_next(Tuple *tuple) {
+    BufferPoolManager *bpm = get_context()->get_buffer_pool_manager();
+    while (true) {
+        while (match_iter_ != match_end_) {
+            TablePage *page = match_iter_->second.first;
+            if (!page->get_tuple_ref(&build_tuple_, match_iter_->second.second))
+                FATAL("HashJoinExecutor Error: fail to get the build tuple");
+            ++match_iter_;
+
+            // tuples with the same hash value may have different keys
+            bool matched = true;
+            for (size_t i = 0; i < left_key_idxs_.size() && matched; i++)
+                matched = toast_fetch_value(build_tuple_, *left_schema_, left_key_idxs_[i], bpm) == probe_keys_[i];
+            if (!matched)
+                continue;
+
+            // concatenate them, the toasted values are fetched here
+            values_.clear();
+            for (int i = 0; i < left_schema_->get_column_num(); i++)
+                values_.push_back(toast_fetch_value(build_tuple_, *left_schema_, i, bpm));
+            for (int i = 0; i < right_schema_->get_column_num(); i++)
+                values_.push_back(toast_fetch_value(*probe_tuple_, *right_schema_, i, bpm));
+            tuple->reconstruct(&values_, *output_schema_);
+            return true;
+        }
+
+        if (next_probe_tuple())
+            continue;
+
+        // the probe side is consumed for the build tuples in the memory
+        if (build_parts_.empty() || !load_build_chunk())
+            return false;
+    }
+}
+
+void HashJoinExecutor::close() {
+    BufferPoolManager *bpm = get_context()->get_buffer_pool_manager();
+    probe_view_.release();
+    clear_build();
+
+    build_reader_.close();
+    probe_reader_.close();
+
+    // partitions before the current one have been deleted
+    for (size_t_ i = std::max(cur_part_, 0); i < static_cast<size_t_>(build_parts_.size()); i++) {
+        build_parts_[i].destroy(bpm);
+        probe_parts_[i].destroy(bpm);
+    }
+    build_parts_.clear();
+    probe_parts_.clear();
+
+    bpm->return_threshold_page(threshold_pages_);
+    threshold_pages_ = 0;
+    left_child_->close();
+    right_child_->close();
+}
+
+hash_t HashJoinExecutor::hash_keys(const Tuple &tuple, const Schema &schema, const std::vector<offset_t> &key_idxs,
+    std::vector<Value> *keys) const {
+    BufferPoolManager *bpm = get_context()->get_buffer_pool_manager();
+    keys->clear();
+    hash_t hash = 0;
+    for (auto idx : key_idxs) {
+        keys->push_back(toast_fetch_value(tuple, schema, idx, bpm));
+        hash ^= keys->back().get_hash_value() + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+    }
+    return hash;
+}
+
+bool HashJoinExecutor::build_insert(const Tuple &tuple, hash_t hash, size_t_ page_limit) {
+    RID rid;
+    if (build_pages_.empty() || !build_pages_.back()->insert_tuple(tuple, &rid)) {
+        if (static_cast<size_t_>(build_pages_.size()) >= page_limit)
+            return false;
+
+        TablePage *page = reinterpret_cast<TablePage*>(get_context()->get_buffer_pool_manager()->new_tmp_page());
+        if (page == nullptr)
+            FATAL("HashJoinExecutor Error: fail to get a temporary page");
+        page->init(INVALID_PAGE_ID, INVALID_PAGE_ID);
+        build_pages_.push_back(page);
+        if (!page->insert_tuple(tuple, &rid))
+            FATAL("HashJoinExecutor Error: the tuple is larger than a page");
+    }
+
+    hash_table_.emplace(hash, std::make_pair(build_pages_.back(), rid));
+    return true;
+}
+
+void HashJoinExecutor::clear_build() {
+    BufferPoolManager *bpm = get_context()->get_buffer_pool_manager();
+    for (auto page : build_pages_) {
+        page_id_t page_id = page->get_page_id();
+        bpm->unpin_page(page_id, false);
+        bpm->delete_page(page_id);
+    }
+    build_pages_.clear();
+    hash_table_.clear();
+    match_iter_ = match_end_ = hash_table_.end();
+}
+
+void HashJoinExecutor::partition_build() {
+    Tuple tuple;
+    for (auto &entry : hash_table_) {
+        if (!entry.second.first->get_tuple_ref(&tuple, entry.second.second))
+            FATAL("HashJoinExecutor Error: fail to get the build tuple");
+        partition_insert(&build_parts_, tuple, entry.first);
+    }
+    clear_build();
+}
+
+void HashJoinExecutor::partition_probe() {
+    TupleView view;
+    while (right_child_->get_next_view(&view))
+        partition_insert(&probe_parts_, *view, hash_keys(*view, *right_schema_, right_key_idxs_, &probe_keys_));
+    view.release();
+    finish_partitions(&probe_parts_);
+}
+
+void HashJoinExecutor::finish_partitions(std::vector<TmpPageChain> *parts) {
+    BufferPoolManager *bpm = get_context()->get_buffer_pool_manager();
+    for (auto &part : *parts)
+        part.finish(bpm);
+}
+
+bool HashJoinExecutor::load_build_chunk() {
+    BufferPoolManager *bpm = get_context()->get_buffer_pool_manager();
+    clear_build();
+    while (true) {
+        if (build_part_done_) {
+            // the current pair of partitions is joined
+            if (cur_part_ >= 0) {
+                build_parts_[cur_part_].destroy(bpm);
+                probe_parts_[cur_part_].destroy(bpm);
+            }
+            if (++cur_part_ >= static_cast<size_t_>(build_parts_.size()))
+                return false;
+
+            build_reader_.open(build_parts_[cur_part_].get_first_page_id(), bpm);
+            build_part_done_ = false;
+        }
+
+        // the page reading the build partition and the one reading the probe partition are also pinned
+        size_t_ page_limit = threshold_pages_ - 2;
+        if (has_pending_) {
+            build_insert(pending_tuple_, pending_hash_, page_limit);
+            has_pending_ = false;
+        }
+        while (build_reader_.next(&chain_tuple_)) {
+            hash_t hash = hash_keys(chain_tuple_, *left_schema_, left_key_idxs_, &build_keys_);
+            if (build_insert(chain_tuple_, hash, page_limit))
+                continue;
+            // this tuple starts the next chunk
+            pending_tuple_ = chain_tuple_;
+            pending_hash_ = hash;
+            has_pending_ = true;
+            break;
+        }
+        build_part_done_ = !has_pending_;
+        if (hash_table_.empty())
+            continue;
+
+        // scan the probe partition from the beginning for each chunk
+        probe_reader_.open(probe_parts_[cur_part_].get_first_page_id(), bpm);
+        return true;
+    }
+}
+
+bool HashJoinExecutor::next_probe_tuple() {
+    if (build_parts_.empty()) {
+        if (!right_child_->get_next_view(&probe_view_))
+            return false;
+        probe_tuple_ = probe_view_.get_tuple();
+    } else {
+        if (!probe_reader_.next(&probe_chain_tuple_))
+            return false;
+        probe_tuple_ = &probe_chain_tuple_;
+    }
+
+    probe_hash_ = hash_keys(*probe_tuple_, *right_schema_, right_key_idxs_, &probe_keys_);
+    auto range = hash_table_.equal_range(probe_hash_);
+    match_iter_ = range.first;
+    match_end_ = range.second;
+    return true;
+}
+
+} // namespace dawn
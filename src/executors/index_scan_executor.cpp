@@ -0,0 +1,24 @@
+#include "executors/index_scan_executor.h"
+
+namespace dawn {
+
+void IndexScanExecutor::open() {
+    rids_.clear();
+    cursor_ = 0;
+    index_->scan_key(key_, &rids_);
+}
+
+bool IndexScanExecutor::get_next(Tuple *tuple) {
+    while (cursor_ < rids_.size()) {
+        if (table_->get_tuple(tuple, rids_[cursor_++]))
+            return true;
+    }
+    return false;
+}
+
+void IndexScanExecutor::close() {
+    rids_.clear();
+    cursor_ = 0;
+}
+
+} // namespace dawn
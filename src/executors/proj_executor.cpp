@@ -3,7 +3,15 @@
 namespace dawn {
 
 void ProjectionExecutor::open() {
+    ref_cols_.clear();
+    for (auto expr : exprs_)
+        expr->get_col_idxs(&ref_cols_);
+    for (auto expr : agg_exprs_)
+        expr->get_col_idxs(&ref_cols_);
+    child_->set_required_cols(ref_cols_);
     child_->open();
+    child_batch_.init(input_schema_, ref_cols_);
+    BufferPoolManager *bpm = get_context()->get_buffer_pool_manager();
 
     /**
      * do aggregation at the beginning
@@ -13,22 +21,25 @@ void ProjectionExecutor::open() {
      * will union the whole two table for twice, it's very inefficient!
      */
     if (is_aggregate_) {
-        while (child_->get_next(&next_tuple_)) {
+        while (child_->get_next_view(&child_view_)) {
+            toast_fetch(child_view_.get_tuple(), *input_schema_, ref_cols_, bpm);
             for (int i = 0; i < agg_num_; i++)
-                agg_vals_[i] = agg_exprs_[i]->evaluate(&next_tuple_, input_schema_);
+                agg_vals_[i] = agg_exprs_[i]->evaluate(&(*child_view_), input_schema_);
         }
+        child_view_.release();
         child_->close();
         child_->open();
     }
 }
 
 bool ProjectionExecutor::get_next(Tuple *tuple) {
-    if(!child_->get_next(&next_tuple_))
+    if(!child_->get_next_view(&child_view_))
         return false;
+    toast_fetch(child_view_.get_tuple(), *input_schema_, ref_cols_, get_context()->get_buffer_pool_manager());
 
     std::vector<Value> vals;
     for (auto expr : exprs_)
-        vals.push_back(expr->evaluate(&next_tuple_, input_schema_));
+        vals.push_back(expr->evaluate(&(*child_view_), input_schema_));
 
     if (is_aggregate_) {
         for (int i = 0; i < agg_num_; i++)
@@ -38,7 +49,29 @@ bool ProjectionExecutor::get_next(Tuple *tuple) {
     return true;
 }
 
+bool ProjectionExecutor::get_next_batch(TupleBatch *batch) {
+    if (!child_->get_next_batch(&child_batch_))
+        return false;
+
+    // the selected rows are compacted into the output batch
+    size_t_ count = child_batch_.get_count();
+    size_t_ proj_col_num = exprs_.size();
+    for (size_t_ i = 0; i < proj_col_num; i++)
+        exprs_[i]->evaluate_batch(child_batch_, batch->get_column(i));
+
+    if (is_aggregate_) {
+        for (int i = 0; i < agg_num_; i++) {
+            ColumnVector *col = batch->get_column(proj_col_num + i);
+            for (size_t_ j = 0; j < count; j++)
+                col->set_value(j, agg_vals_[i]);
+        }
+    }
+    batch->set_size(count);
+    return true;
+}
+
 void ProjectionExecutor::close() {
+    child_view_.release();
     child_->close();
 }
 
@@ -0,0 +1,144 @@
+#include "executors/repartition_executor.h"
+#include "table/toast.h"
+
+namespace dawn {
+
+RepartitionExchange::RepartitionExchange(ExecutorContext *exec_ctx, std::vector<ExecutorAbstract*> producers,
+    Schema *schema, std::vector<offset_t> key_idxs, size_t_ partition_num)
+    : exec_ctx_(exec_ctx), producers_(producers), schema_(schema), key_idxs_(key_idxs) {
+    if (partition_num <= 0)
+        FATAL("RepartitionExchange Error: invalid partition number");
+
+    // each partition could hold the chunks from all the producers
+    for (size_t_ i = 0; i < partition_num; i++)
+        queues_.emplace_back(new BoundedQueue<std::vector<Tuple>>(producers_.size() * EXCHANGE_QUEUE_CHUNKS));
+}
+
+void RepartitionExchange::attach() {
+    std::lock_guard<std::mutex> lg(mt_);
+    if (consumer_num_++ > 0)
+        return;
+
+    for (auto &queue : queues_)
+        queue->reset();
+    if (producers_.empty()) {
+        for (auto &queue : queues_)
+            queue->close();
+        return;
+    }
+
+    opened_.assign(producers_.size(), false);
+    thread_num_ = exec_ctx_->acquire_threads(producers_.size());
+    running_num_ = thread_num_;
+    for (size_t_ i = 0; i < thread_num_; i++)
+        threads_.emplace_back(&RepartitionExchange::run_thread, this, i);
+}
+
+void RepartitionExchange::detach(size_t_ partition) {
+    std::lock_guard<std::mutex> lg(mt_);
+    // the producers waiting for the partition's queue go on with the others
+    queues_[partition]->cancel();
+    if (--consumer_num_ > 0)
+        return;
+
+    stop_producers();
+    for (size_t_ i = 0; i < static_cast<size_t_>(opened_.size()); i++) {
+        if (opened_[i])
+            producers_[i]->close();
+    }
+    opened_.clear();
+}
+
+void RepartitionExchange::run_thread(size_t_ idx) {
+    for (size_t_ i = idx; i < static_cast<size_t_>(producers_.size()); i += thread_num_) {
+        if (!run_producer(i))
+            break;
+    }
+
+    if (--running_num_ == 0) {
+        for (auto &queue : queues_)
+            queue->close();
+    }
+}
+
+bool RepartitionExchange::run_producer(size_t_ idx) {
+    ExecutorAbstract *producer = producers_[idx];
+    opened_[idx] = true;
+    producer->open();
+
+    // the tuples are pushed to the partition when its chunk is full
+    size_t_ partition_num = queues_.size();
+    std::vector<std::vector<Tuple>> chunks(partition_num);
+    std::vector<char> dropped(partition_num, false); // the partition's consumer has stopped
+    size_t_ dropped_num = 0;
+    Tuple tuple;
+    while (producer->get_next(&tuple)) {
+        size_t_ partition = get_partition(tuple);
+        if (dropped[partition])
+            continue;
+
+        std::vector<Tuple> &chunk = chunks[partition];
+        if (chunk.empty())
+            chunk.reserve(EXCHANGE_CHUNK_SZ);
+        chunk.push_back(tuple);
+        if (static_cast<size_t_>(chunk.size()) < EXCHANGE_CHUNK_SZ)
+            continue;
+        if (!queues_[partition]->push(std::move(chunk))) {
+            dropped[partition] = true;
+            if (++dropped_num == partition_num)
+                return false;
+        }
+        chunk.clear();
+    }
+
+    for (size_t_ i = 0; i < partition_num; i++) {
+        if (!dropped[i] && !chunks[i].empty())
+            queues_[i]->push(std::move(chunks[i]));
+    }
+    return true;
+}
+
+size_t_ RepartitionExchange::get_partition(const Tuple &tuple) const {
+    BufferPoolManager *bpm = exec_ctx_->get_buffer_pool_manager();
+    hash_t hash = 0;
+    for (auto idx : key_idxs_) {
+        Value key = toast_fetch_value(tuple, *schema_, idx, bpm);
+        hash ^= key.get_hash_value() + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+    }
+    return hash % queues_.size();
+}
+
+void RepartitionExchange::stop_producers() {
+    if (threads_.empty())
+        return;
+    for (auto &queue : queues_)
+        queue->cancel();
+    for (auto &thd : threads_)
+        thd.join();
+    threads_.clear();
+    exec_ctx_->release_threads(thread_num_);
+}
+
+void RepartitionExecutor::open() {
+    chunk_.clear();
+    chunk_idx_ = 0;
+    exchange_->attach();
+}
+
+bool RepartitionExecutor::get_next(Tuple *tuple) {
+    while (chunk_idx_ >= chunk_.size()) {
+        if (!exchange_->pop(partition_, &chunk_))
+            return false;
+        chunk_idx_ = 0;
+    }
+    *tuple = chunk_[chunk_idx_++];
+    return true;
+}
+
+void RepartitionExecutor::close() {
+    chunk_.clear();
+    chunk_idx_ = 0;
+    exchange_->detach(partition_);
+}
+
+} // namespace dawn
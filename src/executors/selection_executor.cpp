@@ -3,13 +3,28 @@
 namespace dawn {
 
 void SelectionExecutor::open() {
+    pred_cols_.clear();
+    predicate_->get_col_idxs(&pred_cols_);
+    if (!required_cols_.empty()) {
+        std::vector<offset_t> child_cols(required_cols_);
+        child_cols.insert(child_cols.end(), pred_cols_.begin(), pred_cols_.end());
+        child_->set_required_cols(child_cols);
+    }
     child_->open();
 }
 
 // TODO implement the value vs value (values are in the same tuple)
 bool SelectionExecutor::get_next(Tuple *tuple) {
-    while (child_->get_next(tuple)) {
-        if (predicate_->evaluate(tuple, schema_) == cmp_) {
+    if (!get_next_view(&view_))
+        return false;
+    view_.materialize(tuple);
+    return true;
+}
+
+bool SelectionExecutor::get_next_view(TupleView *view) {
+    while (child_->get_next_view(view)) {
+        toast_fetch(view->get_tuple(), *schema_, pred_cols_, get_context()->get_buffer_pool_manager());
+        if (predicate_->evaluate(&(**view), schema_) == cmp_) {
             return true;
         }
     }
@@ -17,7 +32,22 @@ bool SelectionExecutor::get_next(Tuple *tuple) {
     return false;
 }
 
+bool SelectionExecutor::get_next_batch(TupleBatch *batch) {
+    batch->require_cols(pred_cols_);
+    sel_buf_.resize(TUPLE_BATCH_SZ);
+    while (child_->get_next_batch(batch)) {
+        size_t_ num = predicate_->select_batch(*batch, sel_buf_.data());
+        if (num == 0)
+            continue;
+        batch->set_selection(sel_buf_.data(), num);
+        return true;
+    }
+
+    return false;
+}
+
 void SelectionExecutor::close() {
+    view_.release();
     child_->close();
 }
 
@@ -3,11 +3,33 @@
 namespace dawn {
 
 void SeqScanExecutor::open() {
-    tb_iter_ = new LinkHashTableIter(table_->get_first_table_page_id(), get_context()->get_buffer_pool_manager());
+    viewed_ = false;
+    if (morsels_ == nullptr) {
+        tb_iter_ = new LinkHashTableIter(table_->get_first_table_page_id(), get_context()->get_buffer_pool_manager(), col_idxs_);
+        return;
+    }
+
+    // the iter is empty, the first morsel is taken when the first tuple is read
+    morsels_->attach();
+    tb_iter_ = new LinkHashTableIter(table_->get_first_table_page_id(), get_context()->get_buffer_pool_manager(),
+        col_idxs_, 0, 0);
+}
+
+bool SeqScanExecutor::reach_end() {
+    offset_t begin, end;
+    while ((*tb_iter_)->get_rid().get_page_id() == INVALID_PAGE_ID) {
+        if (morsels_ == nullptr || !morsels_->next_morsel(&begin, &end))
+            return true;
+        delete tb_iter_;
+        tb_iter_ = new LinkHashTableIter(table_->get_first_table_page_id(), get_context()->get_buffer_pool_manager(),
+            col_idxs_, begin, end);
+    }
+    return false;
 }
 
 bool SeqScanExecutor::get_next(Tuple *tuple) {
-    if ((*tb_iter_)->get_rid().get_page_id() == INVALID_PAGE_ID)
+    skip_viewed();
+    if (reach_end())
         return false;
     
     *tuple = *(*tb_iter_);
@@ -15,7 +37,32 @@ bool SeqScanExecutor::get_next(Tuple *tuple) {
     return true;
 }
 
+bool SeqScanExecutor::get_next_view(TupleView *view) {
+    skip_viewed();
+    if (reach_end())
+        return false;
+
+    // the view refers to the iter's copy, so the iter moves on in the next call
+    view->refer(tb_iter_->get_view());
+    viewed_ = true;
+    return true;
+}
+
+bool SeqScanExecutor::get_next_batch(TupleBatch *batch) {
+    skip_viewed();
+    batch->reset();
+    BufferPoolManager *bpm = get_context()->get_buffer_pool_manager();
+    // the columns are copied from the page directly
+    while (!batch->is_full() && !reach_end()) {
+        batch->append(**tb_iter_, bpm);
+        ++(*tb_iter_);
+    }
+    return batch->get_size() > 0;
+}
+
 void SeqScanExecutor::close() {
+    if (tb_iter_ != nullptr && morsels_ != nullptr)
+        morsels_->detach();
     delete tb_iter_;
     tb_iter_ = nullptr;
 }
@@ -0,0 +1,81 @@
+#include "executors/sort_merge_join_executor.h"
+#include "table/toast.h"
+
+namespace dawn {
+
+void SortMergeJoinExecutor::open() {
+    left_input_->open();
+    right_input_->open();
+    group_.clear();
+    group_idx_ = 0;
+    left_valid_ = next_left();
+    right_valid_ = next_right();
+}
+
+bool SortMergeJoinExecutor::get_next(Tuple *tuple) {
+    BufferPoolManager *bpm = get_context()->get_buffer_pool_manager();
+    while (true) {
+        if (group_idx_ < group_.size()) {
+            // concatenate them, the toasted values are fetched here
+            const Tuple &right_tuple = group_[group_idx_++];
+            values_.clear();
+            for (int i = 0; i < left_schema_->get_column_num(); i++)
+                values_.push_back(toast_fetch_value(left_tuple_, *left_schema_, i, bpm));
+            for (int i = 0; i < right_schema_->get_column_num(); i++)
+                values_.push_back(toast_fetch_value(right_tuple, *right_schema_, i, bpm));
+            tuple->reconstruct(&values_, *output_schema_);
+            return true;
+        }
+
+        if (!group_.empty()) {
+            // the next left tuple having the same keys is joined with the group again
+            left_valid_ = next_left();
+            if (left_valid_ && ExternalSortExecutor::compare_keys(left_keys_, group_keys_, descs_) == 0) {
+                group_idx_ = 0;
+                continue;
+            }
+            group_.clear();
+        }
+
+        if (!left_valid_ || !right_valid_)
+            return false;
+
+        int res = ExternalSortExecutor::compare_keys(left_keys_, right_keys_, descs_);
+        if (res < 0) {
+            left_valid_ = next_left();
+            continue;
+        }
+        if (res > 0) {
+            right_valid_ = next_right();
+            continue;
+        }
+
+        // collect the right tuples having the same keys
+        group_keys_ = right_keys_;
+        do {
+            group_.push_back(right_tuple_);
+            right_valid_ = next_right();
+        } while (right_valid_ && ExternalSortExecutor::compare_keys(right_keys_, group_keys_, descs_) == 0);
+        group_idx_ = 0;
+    }
+}
+
+void SortMergeJoinExecutor::close() {
+    group_.clear();
+    left_input_->close();
+    right_input_->close();
+}
+
+bool SortMergeJoinExecutor::next_input(ExecutorAbstract *input, const Schema &schema,
+    const std::vector<offset_t> &key_idxs, Tuple *tuple, std::vector<Value> *keys) {
+    if (!input->get_next(tuple))
+        return false;
+
+    BufferPoolManager *bpm = get_context()->get_buffer_pool_manager();
+    keys->clear();
+    for (auto idx : key_idxs)
+        keys->push_back(toast_fetch_value(*tuple, schema, idx, bpm));
+    return true;
+}
+
+} // namespace dawn
@@ -1,22 +1,21 @@
+#include <algorithm>
+
 #include "executors/union_executor.h"
 #include "storage/page/table_page.h"
+#include "table/toast.h"
 
 namespace dawn {
 
 void UnionExecutor::open() {
-    // initialize the threshold_pages_
-    threshold_pages_ = get_context()->get_buffer_pool_manager()->get_threshold_page();
-
-    // construct the output schema according to the child_schema
-    std::vector<Column> left_child_col = child_schema_[0]->get_columns();
-    std::vector<Column> right_child_col = child_schema_[1]->get_columns();
-
-    // concatenate the left and right columns
-    for (auto &col : right_child_col)
-        left_child_col.push_back(col);
-
-    output_schema_ = new Schema(left_child_col);
+    // initialize the threshold_pages_, half of them hold the batch being joined
+    threshold_pages_ = get_context()->get_buffer_pool_manager()->get_threshold_page(2);
+    batch_pages_ = threshold_pages_ / 2;
+    in_mem_idx_ = 0;
+    inner_next_ = true;
+    pos_.set(INVALID_PAGE_ID, INVALID_SLOT_NUM);
 
+    children_[0]->open();
+    children_[1]->open();
     initialize();
 }
 
@@ -27,16 +26,15 @@ get_next_tuple:
         while (!children_[1]->get_next(right_child_tuple_)) {
             /**
              * we have consumed all the tuples in the outer table.
-             * Close the child executor, reopen it and load the next
-             * batch of the inner table for another round of concatenating.
+             * Load the next batch of the inner table, reopen the child
+             * executor for another round of concatenating.
              */
-            children_[1]->close();
-            children_[1]->open();
-
             if (!load_another_batch()) {
                 // we have consumed all the inner and outer tables' tuples
                 return false;
             }
+            children_[1]->close();
+            children_[1]->open();
         }
         inner_next_ = false;
     }
@@ -56,20 +54,25 @@ get_next_tuple:
         }
     }        
 
-    if (!in_mem_pages_[in_mem_idx_]->get_tuple(left_child_tuple_, next_pos_)) {
+    pos_ = next_pos_;
+
+    // the in-memory pages are pinned, so their tuples needn't be copied
+    TablePage *in_mem_page = in_mem_pages_[in_mem_idx_];
+    if (!in_mem_page->get_tuple_ref(left_child_tuple_, next_pos_) && !in_mem_page->get_tuple(left_child_tuple_, next_pos_)) {
         FATAL("UnionExecutor Error!");
     }
 
-    // Now, we have got inner and outer tuples. Concatenate them!
+    // Now, we have got inner and outer tuples. Concatenate them! Toasted values are fetched here
+    BufferPoolManager *bpm = get_context()->get_buffer_pool_manager();
     std::vector<Value> values;
     int left_col_num = child_schema_[0]->get_column_num();
     int right_col_num = child_schema_[1]->get_column_num();
     for (int i = 0; i < left_col_num; i++) {
-        values.push_back(left_child_tuple_->get_value(*(child_schema_[0]), i));
+        values.push_back(toast_fetch_value(*left_child_tuple_, *(child_schema_[0]), i, bpm));
     }
 
     for (int i = 0; i < right_col_num; i++) {
-        values.push_back(right_child_tuple_->get_value(*(child_schema_[1]), i));
+        values.push_back(toast_fetch_value(*right_child_tuple_, *(child_schema_[1]), i, bpm));
     }
 
     tuple->reconstruct(&values, *output_schema_);
@@ -80,88 +83,116 @@ get_next_tuple:
 /** delete temporary pages and return memory to buffer pool manager */
 void UnionExecutor::close() {
     BufferPoolManager *bpm = get_context()->get_buffer_pool_manager();
-    bpm->return_threshold_page(threshold_pages_);
-    threshold_pages_ = 0;
+    if (prefetch_.valid())
+        prefetch_.wait();
+    delete_pages(&in_mem_pages_);
+    delete_pages(&prefetched_pages_);
 
-    spill_to_disk(false); // put all pages into avail_tmp_page_ to gather them together
+    // the batches haven't been loaded
+    for (size_t_ i = next_batch_ * batch_pages_; i < static_cast<size_t_>(spilled_pages_.size()); i++)
+        bpm->delete_page(spilled_pages_[i]);
+    spilled_pages_.clear();
+    next_batch_ = 0;
 
-    while (!avail_tmp_page_.empty()) {
-        bpm->delete_page(avail_tmp_page_.front());
-        avail_tmp_page_.pop_front();
-    }
+    bpm->return_threshold_page(threshold_pages_);
+    threshold_pages_ = 0;
 
     pos_.set(INVALID_PAGE_ID, INVALID_SLOT_NUM);
 
     children_[0]->close();
     children_[1]->close();
-    delete output_schema_;
 }
 
 void UnionExecutor::initialize() {
-    TablePage *left_tb_page = reinterpret_cast<TablePage*>(get_context()->get_buffer_pool_manager()->new_tmp_page());
-    if (left_tb_page == nullptr) {
-        FATAL("UnionExecutor Error: left_tb_page == nullptr");
-    }
-
-    in_mem_pages_.push_back(left_tb_page);
+    TablePage *left_tb_page = new_left_page();
     RID rid;
-    
-    BufferPoolManager *bpm = get_context()->get_buffer_pool_manager();
 
-    /**
-     * FIXME Very inefficient!!!
-     * Spill to the disk operation will copy all of the outer table's data
-     */
     while (children_[0]->get_next(left_child_tuple_)) {
-        while (!left_tb_page->insert_tuple(*left_child_tuple_, &rid)) {
-            // enter here means the TablePage has no more space to insert a tuple
-            if (in_mem_pages_.size() + 1 > (1/2) * threshold_pages_) {
-                // trigger the spill to disk operation
-                spill_to_disk(true);
-            }
-
-            // get a new page to insert the tuple
-            left_tb_page = reinterpret_cast<TablePage*>(bpm->new_tmp_page());
-            if (left_tb_page == nullptr) {
-                FATAL("UnionExecutor Error: left_tb_page == nullptr");
-            }
+        if (left_tb_page->insert_tuple(*left_child_tuple_, &rid))
+            continue;
 
-            in_mem_pages_.push_back(left_tb_page);
+        // enter here means the TablePage has no more space to insert a tuple
+        if (!spilled_pages_.empty() || in_mem_pages_.size() + 1 > static_cast<size_t>(batch_pages_)) {
+            // trigger the spill to disk operation
+            spill_to_disk();
         }
+
+        // get a new page to insert the tuple
+        left_tb_page = new_left_page();
+        if (!left_tb_page->insert_tuple(*left_child_tuple_, &rid))
+            FATAL("UnionExecutor Error: the tuple is larger than a page");
     }
+
+    if (spilled_pages_.empty())
+        return;
+
+    // load the first batch, and the second one is prefetched at the same time
+    spill_to_disk();
+    next_batch_ = 0;
+    start_prefetch();
+    load_another_batch();
 }
 
-void UnionExecutor::spill_to_disk(bool is_dirty) {
-    BufferPoolManager *bpm = get_context()->get_buffer_pool_manager();
-    while (!in_mem_pages_.empty()) {
-        TablePage *page = in_mem_pages_.front();
-        bpm->unpin_page(page->get_page_id(), is_dirty);
-        in_mem_pages_.pop_front();
-        avail_tmp_page_.push_back(page->get_page_id());
+TablePage* UnionExecutor::new_left_page() {
+    TablePage *page = reinterpret_cast<TablePage*>(get_context()->get_buffer_pool_manager()->new_tmp_page());
+    if (page == nullptr) {
+        FATAL("UnionExecutor Error: left_tb_page == nullptr");
     }
+
+    // new_tmp_page() doesn't initialize the page
+    page->init(INVALID_PAGE_ID, INVALID_PAGE_ID);
+    in_mem_pages_.push_back(page);
+    return page;
 }
 
-bool UnionExecutor::load_another_batch() {
+void UnionExecutor::spill_to_disk() {
     BufferPoolManager *bpm = get_context()->get_buffer_pool_manager();
-    
-    while (!in_mem_pages_.empty()) {
-        TablePage *page = in_mem_pages_.front();
-        bpm->delete_page(page->get_page_id());
-        in_mem_pages_.pop_front();
+    for (auto page : in_mem_pages_) {
+        bpm->unpin_page(page->get_page_id(), true);
+        spilled_pages_.push_back(page->get_page_id());
     }
+    in_mem_pages_.clear();
+}
 
-    while (in_mem_pages_.size() < (1/2) * threshold_pages_) {
-        TablePage *page = reinterpret_cast<TablePage*>(bpm->get_page(avail_tmp_page_.front()));
-        avail_tmp_page_.pop_front();
-        in_mem_pages_.push_back(page);
-    }
+void UnionExecutor::start_prefetch() {
+    size_t_ begin = next_batch_ * batch_pages_;
+    size_t_ end = std::min(begin + batch_pages_, static_cast<size_t_>(spilled_pages_.size()));
+    if (begin >= end)
+        return;
+    next_batch_++;
+
+    BufferPoolManager *bpm = get_context()->get_buffer_pool_manager();
+    prefetch_ = std::async(std::launch::async, [this, bpm, begin, end] {
+        for (size_t_ i = begin; i < end; i++) {
+            TablePage *page = reinterpret_cast<TablePage*>(bpm->get_page(spilled_pages_[i]));
+            if (page == nullptr)
+                FATAL("UnionExecutor Error: fail to load the spilled page");
+            prefetched_pages_.push_back(page);
+        }
+    });
+}
 
-    if (in_mem_pages_.size() > 0) {
-        in_mem_idx_ = 0;
-        return true;
+void UnionExecutor::delete_pages(std::vector<TablePage*> *pages) {
+    BufferPoolManager *bpm = get_context()->get_buffer_pool_manager();
+    for (auto page : *pages) {
+        page_id_t page_id = page->get_page_id();
+        bpm->unpin_page(page_id, false);
+        bpm->delete_page(page_id);
     }
+    pages->clear();
+}
 
-    return false;
+bool UnionExecutor::load_another_batch() {
+    // the current batch is joined with all the inner tuples
+    delete_pages(&in_mem_pages_);
+    in_mem_idx_ = 0;
+    if (!prefetch_.valid())
+        return false;
+
+    prefetch_.get();
+    in_mem_pages_.swap(prefetched_pages_);
+    start_prefetch();
+    return true;
 }
 
 } // namespace dawn
@@ -59,7 +59,7 @@ public:
     // FIXME I think it's bad to call get_data_type_node() recursively.
     size_t_ get_char_len() const {
         DataTypeNode* data_node = get_data_type_node();
-        if (data_node->get_data_type() != TypeId::kChar) {
+        if (!is_string_type(data_node->get_data_type())) {
             return -1;
         }
 
@@ -196,7 +196,7 @@ private:
             col_types_.push_back(node->get_col_type());
 
             // get char length
-            if (node->get_col_type() == TypeId::kChar) {
+            if (is_string_type(node->get_col_type())) {
                 char_lens_.push_back(node->get_char_len());
             }
         }
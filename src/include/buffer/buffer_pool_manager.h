@@ -1,6 +1,8 @@
 #pragma once
 
 #include <unordered_map>
+#include <unordered_set>
+#include <algorithm>
 #include <deque>
 
 #include "util/util.h"
@@ -38,35 +40,37 @@ public:
     bool flush_all();
 
     /**
+     * @param defer if someone is using the page, it's deleted by the last unpin_page() instead, so the
+     * caller needn't wait with the latches held. The page should have been unreachable for the others.
      * @return false if someone is using it and it's caller's duty to decide what to do next
      */
-    bool delete_page(const page_id_t &page_id);
+    bool delete_page(const page_id_t &page_id, bool defer = false);
 
     /**
      * The buffer pool manager is responsible for the allocation of the threshold_page.
      * Only 4/5 of the pool_size_ will be allow to allocated for the threshold_page, because
      * if we allocate all the pages for executors the buffer pool may be totally consumed
      * and every executor will wait for others to unpin the pages, so the dead lock will happen.
-     * 
-     * Allocate half of the available_threshold_page_ each time.
-     * 
-     * If there is no enough pages to be allocated, wait, until we can allocate.
+     *
+     * Allocate half of the pages that are still not allocated each time, so the executors
+     * running at the same time share the threshold pages.
+     *
+     * It never waits for others to return their pages, the executor that opens while the
+     * threshold pages are used up still gets min_num pages, or it would hang forever when its
+     * ancestor holds the rest of them. These pages are overcommitted beyond the 4/5 without a
+     * limit, each such executor takes another min_num pages from the 1/5 left for the others,
+     * so that 1/5 is only kept when few executors holding threshold pages are open at the same
+     * time, e.g. the blocking executors of a few plans. Nothing refuses the rest, and the
+     * executors have no way to fail in open(), so it's up to the plans to keep them few.
+     *
+     * @param min_num the fewest pages the caller can work with
      */
-    size_t_ get_threshold_page() {
-        size_t_ alloc_num = available_threshold_page_ / 2;
-        while (true) {
-            latch_.w_lock();
-            if (alloc_num + allocated_threshold_pages_ > available_threshold_page_) {
-                latch_.w_unlock();
-
-                // wait, until we can allocate
-                std::this_thread::sleep_for(std::chrono::milliseconds(10));
-            } else {
-                latch_.w_unlock();
-                return alloc_num;
-            }
-        }
-
+    size_t_ get_threshold_page(size_t_ min_num = 1) {
+        latch_.w_lock();
+        size_t_ alloc_num = std::max(min_num, (available_threshold_page_ - allocated_threshold_pages_) / 2);
+        allocated_threshold_pages_ += alloc_num;
+        latch_.w_unlock();
+        return alloc_num;
     }
 
     /** @param ret_threpage show how many pages are returned by the executor */
@@ -80,8 +84,8 @@ protected:
     // ATTENTION no lock protects it
     inline frame_id_t get_frame_id(const page_id_t &page_id) const;
 
-    // we assume this function will always success.
-    void evict_page(const page_id_t &page_id, const frame_id_t &frame_id);
+    // the victim is kept if someone gets it again before it's evicted, unless it's forced.
+    void evict_page(const page_id_t &page_id, const frame_id_t &frame_id, bool force = false);
 
     ReaderWriterLatch latch_;
 private:
@@ -101,6 +105,9 @@ private:
     // map the page id to frame id
     std::unordered_map<page_id_t, frame_id_t> mapping_;
 
+    // pages deleted while they were pinned, the last unpin_page() deletes them
+    std::unordered_set<page_id_t> deferred_deletes_;
+
     DiskManager *disk_manager_;
 
     ReplacerAbstract *replacer_;
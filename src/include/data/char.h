@@ -1,3 +1,5 @@
+#pragma once
+
 #include "data/types.h"
 
 namespace dawn {
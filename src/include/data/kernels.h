@@ -0,0 +1,236 @@
+#pragma once
+
+#include <string.h>
+#include <algorithm>
+#include <type_traits>
+
+#include "data/types.h"
+#include "data/values.h"
+
+namespace dawn {
+
+/**
+ * The kernels are specialized for each pair of TypeId and each operation. The expression
+ * selects the kernel once, so that evaluating it for each row is a direct call that reads
+ * the values and compares them inline, instead of finding the Type singleton and calling
+ * its virtual functions.
+ *
+ * Integer and decimal can be mixed, the integer is converted to decimal. Strings are only
+ * compared with strings. Other pairs fall back to the Type of the left value.
+ */
+using cmp_kernel_t = CmpResult (*)(const Value &left, const Value &right);
+using arith_kernel_t = Value (*)(const Value &left, const Value &right);
+
+/**
+ * The selection kernel compares the arrays of the batch (see table/tuple_batch.h), the constant
+ * operand is a single value. Rows satisfying the comparison are written to sel_out, which may
+ * be the same array as sel.
+ * @param sel the selected rows, all of the num rows are selected if it's nullptr
+ * @return number of the rows written to sel_out
+ */
+using sel_kernel_t = size_t_ (*)(const char *left, bool left_const, const char *right, bool right_const,
+    const int *sel, size_t_ num, int *sel_out);
+
+/** C++ type held by the Value of the TypeId */
+template<TypeId type>
+struct NativeType {};
+
+template<> struct NativeType<TypeId::kBoolean> { using type = boolean_t; };
+template<> struct NativeType<TypeId::kInteger> { using type = integer_t; };
+template<> struct NativeType<TypeId::kDecimal> { using type = decimal_t; };
+template<> struct NativeType<TypeId::kChar> { using type = const char*; };
+
+template<ComparisonType cmp_type, typename T>
+inline bool apply_cmp(T left, T right) {
+    if constexpr (cmp_type == ComparisonType::kEqual)
+        return left == right;
+    else if constexpr (cmp_type == ComparisonType::kNotEqual)
+        return left != right;
+    else if constexpr (cmp_type == ComparisonType::kLessThan)
+        return left < right;
+    else if constexpr (cmp_type == ComparisonType::kLessThanOrEqual)
+        return left <= right;
+    else if constexpr (cmp_type == ComparisonType::kGreaterThan)
+        return left > right;
+    else
+        return left >= right;
+}
+
+template<ArithmeticType arith_type, typename T>
+inline T apply_arith(T left, T right) {
+    if constexpr (arith_type == ArithmeticType::kAdd)
+        return left + right;
+    else if constexpr (arith_type == ArithmeticType::kMinus)
+        return left - right;
+    else if constexpr (arith_type == ArithmeticType::kMultiply)
+        return left * right;
+    else if constexpr (arith_type == ArithmeticType::kDivide)
+        return left / right;
+    else if constexpr (arith_type == ArithmeticType::kMin)
+        return std::min(left, right);
+    else
+        return std::max(left, right);
+}
+
+template<TypeId left_type, TypeId right_type, ComparisonType cmp_type>
+CmpResult cmp_kernel(const Value &left, const Value &right) {
+    using L = typename NativeType<left_type>::type;
+    using R = typename NativeType<right_type>::type;
+    bool ok;
+    if constexpr (left_type == TypeId::kChar) {
+        ok = apply_cmp<cmp_type>(strcmp(left.get_value<L>(), right.get_value<R>()), 0);
+    } else {
+        using C = std::common_type_t<L, R>;
+        ok = apply_cmp<cmp_type, C>(left.get_value<L>(), right.get_value<R>());
+    }
+    return ok ? CmpResult::kTrue : CmpResult::kFalse;
+}
+
+template<TypeId left_type, TypeId right_type, ArithmeticType arith_type>
+Value arith_kernel(const Value &left, const Value &right) {
+    using L = typename NativeType<left_type>::type;
+    using R = typename NativeType<right_type>::type;
+    using C = std::common_type_t<L, R>;
+    return Value(apply_arith<arith_type, C>(left.get_value<L>(), right.get_value<R>()));
+}
+
+template<TypeId left_type, TypeId right_type, ComparisonType cmp_type>
+size_t_ sel_kernel(const char *left, bool left_const, const char *right, bool right_const,
+    const int *sel, size_t_ num, int *sel_out) {
+    using L = typename NativeType<left_type>::type;
+    using R = typename NativeType<right_type>::type;
+    using C = std::common_type_t<L, R>;
+    const L *lhs = reinterpret_cast<const L*>(left);
+    const R *rhs = reinterpret_cast<const R*>(right);
+    size_t_ lhs_step = left_const ? 0 : 1;
+    size_t_ rhs_step = right_const ? 0 : 1;
+
+    // the row is always written and only kept if it's selected, so that there is no branch
+    size_t_ cnt = 0;
+    if (sel == nullptr) {
+        for (size_t_ i = 0; i < num; i++) {
+            sel_out[cnt] = i;
+            cnt += apply_cmp<cmp_type, C>(lhs[i * lhs_step], rhs[i * rhs_step]);
+        }
+        return cnt;
+    }
+    for (size_t_ i = 0; i < num; i++) {
+        int row = sel[i];
+        sel_out[cnt] = row;
+        cnt += apply_cmp<cmp_type, C>(lhs[row * lhs_step], rhs[row * rhs_step]);
+    }
+    return cnt;
+}
+
+/** the old path, used by the pairs without a specialized kernel */
+template<ComparisonType cmp_type>
+CmpResult virtual_cmp_kernel(const Value &left, const Value &right) {
+    switch (cmp_type) {
+        case ComparisonType::kEqual:
+            return CMP_EQ(left.get_type_id(), left, right);
+        case ComparisonType::kNotEqual:
+            return CMP_NOT_EQ(left.get_type_id(), left, right);
+        case ComparisonType::kLessThan:
+            return CMP_LESS(left.get_type_id(), left, right);
+        case ComparisonType::kLessThanOrEqual:
+            return CMP_LESS_EQ(left.get_type_id(), left, right);
+        case ComparisonType::kGreaterThan:
+            return CMP_GREATER(left.get_type_id(), left, right);
+        default:
+            return CMP_GREATER_EQ(left.get_type_id(), left, right);
+    }
+}
+
+template<ArithmeticType arith_type>
+Value virtual_arith_kernel(const Value &left, const Value &right) {
+    switch (arith_type) {
+        case ArithmeticType::kAdd:
+            return ADD(left.get_type_id(), left, right);
+        case ArithmeticType::kMinus:
+            return MINUS(left.get_type_id(), left, right);
+        case ArithmeticType::kMultiply:
+            return MULTIPLY(left.get_type_id(), left, right);
+        case ArithmeticType::kDivide:
+            return DIVIDE(left.get_type_id(), left, right);
+        case ArithmeticType::kMin:
+            return MIN(left.get_type_id(), left, right);
+        default:
+            return MAX(left.get_type_id(), left, right);
+    }
+}
+
+template<TypeId left_type, TypeId right_type>
+cmp_kernel_t select_cmp_kernel(ComparisonType cmp_type) {
+    switch (cmp_type) {
+        case ComparisonType::kEqual:
+            return &cmp_kernel<left_type, right_type, ComparisonType::kEqual>;
+        case ComparisonType::kNotEqual:
+            return &cmp_kernel<left_type, right_type, ComparisonType::kNotEqual>;
+        case ComparisonType::kLessThan:
+            return &cmp_kernel<left_type, right_type, ComparisonType::kLessThan>;
+        case ComparisonType::kLessThanOrEqual:
+            return &cmp_kernel<left_type, right_type, ComparisonType::kLessThanOrEqual>;
+        case ComparisonType::kGreaterThan:
+            return &cmp_kernel<left_type, right_type, ComparisonType::kGreaterThan>;
+        default:
+            return &cmp_kernel<left_type, right_type, ComparisonType::kGreaterThanOrEqual>;
+    }
+}
+
+template<TypeId left_type, TypeId right_type>
+arith_kernel_t select_arith_kernel(ArithmeticType arith_type) {
+    switch (arith_type) {
+        case ArithmeticType::kAdd:
+            return &arith_kernel<left_type, right_type, ArithmeticType::kAdd>;
+        case ArithmeticType::kMinus:
+            return &arith_kernel<left_type, right_type, ArithmeticType::kMinus>;
+        case ArithmeticType::kMultiply:
+            return &arith_kernel<left_type, right_type, ArithmeticType::kMultiply>;
+        case ArithmeticType::kDivide:
+            return &arith_kernel<left_type, right_type, ArithmeticType::kDivide>;
+        case ArithmeticType::kMin:
+            return &arith_kernel<left_type, right_type, ArithmeticType::kMin>;
+        default:
+            return &arith_kernel<left_type, right_type, ArithmeticType::kMax>;
+    }
+}
+
+template<TypeId left_type, TypeId right_type>
+sel_kernel_t select_sel_kernel(ComparisonType cmp_type) {
+    switch (cmp_type) {
+        case ComparisonType::kEqual:
+            return &sel_kernel<left_type, right_type, ComparisonType::kEqual>;
+        case ComparisonType::kNotEqual:
+            return &sel_kernel<left_type, right_type, ComparisonType::kNotEqual>;
+        case ComparisonType::kLessThan:
+            return &sel_kernel<left_type, right_type, ComparisonType::kLessThan>;
+        case ComparisonType::kLessThanOrEqual:
+            return &sel_kernel<left_type, right_type, ComparisonType::kLessThanOrEqual>;
+        case ComparisonType::kGreaterThan:
+            return &sel_kernel<left_type, right_type, ComparisonType::kGreaterThan>;
+        default:
+            return &sel_kernel<left_type, right_type, ComparisonType::kGreaterThanOrEqual>;
+    }
+}
+
+/** @return the kernel comparing the values of these types, it's never nullptr */
+cmp_kernel_t get_cmp_kernel(TypeId left_type, TypeId right_type, ComparisonType cmp_type);
+
+/** @return the kernel computing the values of these types, it's never nullptr */
+arith_kernel_t get_arith_kernel(TypeId left_type, TypeId right_type, ArithmeticType arith_type);
+
+/**
+ * @return the kernel comparing the arrays of these types, nullptr if only the values could be compared.
+ * The AVX2 kernel is returned for the integer and decimal columns if it's available.
+ */
+sel_kernel_t get_sel_kernel(TypeId left_type, TypeId right_type, ComparisonType cmp_type);
+
+/**
+ * The AVX2 kernel compares a column with a constant 8 integers or 4 decimals at a time, the
+ * results are collected into a bitmap and turned into the selection at last. Comparing two
+ * columns falls back to the scalar kernel.
+ * @return nullptr if the type is not supported or it's not built with AVX2 (see simd_kernels.cpp)
+ */
+sel_kernel_t get_simd_sel_kernel(TypeId type_id, ComparisonType cmp_type);
+
+} // namespace dawn
@@ -5,19 +5,31 @@
 namespace dawn {
 class Type;
 
-extern Type *singleton[4];
+extern Type *singleton[TYPE_NUM];
 
-// TODO VARCHAR
-enum class TypeId : enum_size_t { kInvalid = -1, kBoolean, kInteger, kDecimal, kChar };
+/**
+ * kVarchar only describes how the column is stored in the tuple,
+ * the Value of a VARCHAR column is kChar as well.
+ */
+enum class TypeId : enum_size_t { kInvalid = -1, kBoolean, kInteger, kDecimal, kChar, kVarchar };
 
 enum class CmpResult : enum_size_t { kTrue = 0, kFalse };
 
 /** ComparisonType represents the type of comparison that we want to perform. */
 enum class ComparisonType { kEqual, kNotEqual, kLessThan, kLessThanOrEqual, kGreaterThan, kGreaterThanOrEqual };
 
+/** ArithmeticType represents the binary arithmetic operation that we want to perform. */
+enum class ArithmeticType { kAdd, kMinus, kMultiply, kDivide, kMin, kMax };
+
 /** AggregationType enumerates all the possible aggregation functions in our system. */
 enum class AggregationType : enum_size_t { kCountAggregate, kSumAggregate, kMinAggregate, kMaxAggregate };
 
+/**
+ * AggregationPhase shows which part of a split aggregation an executor does. In the parallel plan,
+ * kPartial aggregates a worker's tuples into the states, kFinal combines the workers' states.
+ */
+enum class AggregationPhase : enum_size_t { kComplete, kPartial, kFinal };
+
 class Value;
 
 class Type {
@@ -56,6 +68,8 @@ public:
                 return INTEGER_T_SIZE;
             case TypeId::kDecimal:
                 return DECIMAL_T_SIZE;
+            case TypeId::kVarchar:
+                return VARCHAR_SLOT_SZ;
             default:
                 return -1;
         }
@@ -63,5 +77,10 @@ public:
 };
 
 string_t type_to_string(TypeId type_id);
+
+/** CHAR and VARCHAR columns hold strings */
+inline bool is_string_type(TypeId type_id) {
+    return type_id == TypeId::kChar || type_id == TypeId::kVarchar;
+}
     
 } // namespace dawn
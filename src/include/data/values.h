@@ -11,11 +11,15 @@ namespace dawn {
 enum class TypeId;
 class Type;
 
-extern Type *singleton[4];
+extern Type *singleton[TYPE_NUM];
 
 /**
  * WARNING: DO NOT IMPLEMENT THE SHALLOW COPY!
- * Deconstructor always deletes the pointer when TypeId is kChar.
+ * Deconstructor always deletes the pointer when TypeId is kChar and the string is not inline.
+ *
+ * Strings shorter than INLINE_STR_SZ are stored in the Value itself, so that evaluating the
+ * expressions on the short CHAR columns doesn't allocate for each value. value_.char_ always
+ * points to the string, wherever it's stored.
  */
 class Value {
 public:
@@ -32,11 +36,13 @@ public:
     // TODO: construct should not be accessed in outside of the Value, or check TypeId before in the function
 
     void construct(boolean_t val) {
+        free_str();
         type_id_ = TypeId::kBoolean;
         value_.boolean = val;
     }
 
     void construct(CmpResult val) {
+        free_str();
         type_id_ = TypeId::kBoolean;
         if (val == CmpResult::kTrue)
             value_.boolean = true;
@@ -45,24 +51,38 @@ public:
     }
 
     void construct(integer_t val) {
+        free_str();
         type_id_ = TypeId::kInteger;
         value_.integer = val;
     }
 
     void construct(decimal_t val) {
+        free_str();
         type_id_ = TypeId::kDecimal;
         value_.decimal = val;
     }
 
     void construct(const char* val, int size) {
+        free_str();
         type_id_ = TypeId::kChar;
-        str_len_ = size;
-        value_.char_ = new char[str_len_+1];
-        memset(value_.char_, 0, str_len_ + 1);
+        alloc_str(size);
         memcpy(value_.char_, val, str_len_);
         value_.char_[str_len_] = '\0'; // remind us that there needs a string end
     }
 
+    /**
+     * the string stored in the tuple doesn't end with '\0', and may be shorter than the size.
+     * Bytes after the end of the string are set to 0, so that the values are hashed in the same way.
+     */
+    void construct_padded(const char* val, int size) {
+        free_str();
+        type_id_ = TypeId::kChar;
+        alloc_str(size);
+        size_t len = strnlen(val, size);
+        memcpy(value_.char_, val, len);
+        memset(value_.char_ + len, 0, str_len_ + 1 - len);
+    }
+
     // deep copy
     Value(const Value &value) {
         this->type_id_ = value.type_id_;
@@ -71,32 +91,49 @@ public:
         if (value.type_id_ != TypeId::kChar) {
             this->value_ = value.value_;
         } else {
-            this->value_.char_ = new char[str_len_+1];
-            memset(this->value_.char_, 0, str_len_ + 1);
+            alloc_str(str_len_);
             memcpy(this->value_.char_, value.value_.char_, str_len_ + 1);
         }
     }
 
+    /** the string on the heap is taken over, and the moved value becomes kInvalid */
+    Value(Value &&value) noexcept {
+        move_from(&value);
+    }
+
     // deep copy
     Value& operator=(const Value &value) {
-        if (this->type_id_ == TypeId::kChar) {
-            delete[] value_.char_;
+        if (this == &value)
+            return *this;
+
+        // the string's space is reused if it has the same length
+        if (type_id_ == TypeId::kChar && value.type_id_ == TypeId::kChar && str_len_ == value.str_len_) {
+            memcpy(this->value_.char_, value.value_.char_, str_len_ + 1);
+            return *this;
         }
 
+        free_str();
         this->type_id_ = value.type_id_;
         this->str_len_ = value.str_len_;
 
         if (value.type_id_ != TypeId::kChar) {
             this->value_ = value.value_;
         } else {
-            this->value_.char_ = new char[str_len_+1];
-            memset(this->value_.char_, 0, str_len_ + 1);
+            alloc_str(str_len_);
             memcpy(this->value_.char_, value.value_.char_, str_len_ + 1);
         }
 
         return *this;
     }
 
+    Value& operator=(Value &&value) noexcept {
+        if (this == &value)
+            return *this;
+        free_str();
+        move_from(&value);
+        return *this;
+    }
+
     bool operator==(const Value &value) const {
         if (this->type_id_ != value.type_id_)
             return false;
@@ -116,7 +153,7 @@ public:
                     ok = false;
                 break;
             case TypeId::kChar:
-                if (string_t(this->value_.char_) != string_t(value.value_.char_)) 
+                if (strcmp(this->value_.char_, value.value_.char_) != 0)
                     ok = false;
                 break;
             default:
@@ -145,7 +182,7 @@ public:
                     ok = false;
                 break;
             case TypeId::kChar:
-                if (string_t(this->value_.char_) == string_t(value.value_.char_)) 
+                if (strcmp(this->value_.char_, value.value_.char_) == 0)
                     ok = false;
                 break;
             default:
@@ -171,11 +208,7 @@ public:
                 return this->value_.decimal < value.value_.decimal;
             }
             case TypeId::kChar: {
-                string_t s1(value_.char_);
-                string_t s2(value.value_.char_);
-                if (s1.compare(s2) < 0)
-                    return true;
-                return false;
+                return strcmp(value_.char_, value.value_.char_) < 0;
             }
             case TypeId::kInvalid: {
                 return false;
@@ -195,9 +228,10 @@ public:
     }
 
     void swap(Value &val) {
-        std::swap(val.type_id_, type_id_);
-        std::swap(val.value_, value_);
-        std::swap(val.str_len_, str_len_);
+        // the inline strings can't be swapped with the pointers
+        Value tmp(std::move(val));
+        val = std::move(*this);
+        *this = std::move(tmp);
     }
 
     TypeId get_type_id() const { return type_id_; }
@@ -210,7 +244,7 @@ public:
     int get_char_size() const { return str_len_; }
 
     // string should end with '\0'
-    inline void serialize_to(char *storage) {
+    inline void serialize_to(char *storage) const {
         if (type_id_ == TypeId::kChar) {
             singleton[static_cast<int>(type_id_)]->serialize_to(storage, value_.char_);
             return;
@@ -242,8 +276,9 @@ public:
                 return do_hash(static_cast<void*>(val), DECIMAL_T_SIZE);
             }
             case TypeId::kChar: {
+                // equality is strcmp, so the zero padding of a wider column must not change the hash
                 char *val = const_cast<char*>(value_.char_);
-                return do_hash(static_cast<void*>(val), str_len_);
+                return do_hash(static_cast<void*>(val), strnlen(val, str_len_));
             }
             case TypeId::kInvalid: {
                 return 0;
@@ -271,7 +306,38 @@ public:
                 return string_t("kInvalid VALUE");
         }
     }
+    /** @return true if the string is stored in the Value */
+    inline bool is_inline_str() const { return type_id_ == TypeId::kChar && value_.char_ == inline_str_; }
+
 private: // should private
+    /** get the space of a string with size len, '\0' is not included */
+    inline void alloc_str(int len) {
+        str_len_ = len;
+        value_.char_ = len < INLINE_STR_SZ ? inline_str_ : new char[len + 1];
+    }
+
+    inline void free_str() {
+        if (type_id_ == TypeId::kChar && value_.char_ != inline_str_)
+            delete[] value_.char_;
+    }
+
+    inline void move_from(Value *value) {
+        type_id_ = value->type_id_;
+        str_len_ = value->str_len_;
+        if (type_id_ != TypeId::kChar) {
+            value_ = value->value_;
+        } else if (value->is_inline_str()) {
+            value_.char_ = inline_str_;
+            memcpy(inline_str_, value->inline_str_, str_len_ + 1);
+        } else {
+            value_.char_ = value->value_.char_;
+        }
+        value->type_id_ = TypeId::kInvalid;
+        value->str_len_ = -1;
+    }
+
+    static constexpr int INLINE_STR_SZ = 24;
+
     union {
         boolean_t boolean;
         integer_t integer;
@@ -279,8 +345,9 @@ private: // should private
         char *char_; // string
     } value_;
     
-    TypeId type_id_;
+    TypeId type_id_ = TypeId::kInvalid;
     int str_len_ = -1;
+    char inline_str_[INLINE_STR_SZ];
 };
 
 } // namespace dawn
@@ -0,0 +1,17 @@
+#pragma once
+
+#include "data/char.h"
+
+namespace dawn {
+
+/**
+ * VARCHAR differs from CHAR only in the storage, and values of both are kChar strings,
+ * so the operations are the same as Char's.
+ */
+class Varchar : public Char {
+public:
+    Varchar() = default;
+    ~Varchar() override {}
+};
+
+} // namespace dawn
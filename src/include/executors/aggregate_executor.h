@@ -0,0 +1,64 @@
+#pragma once
+
+#include <vector>
+
+#include "executors/executor_abstr.h"
+#include "sql/expressions/aggregate_expr.h"
+#include "table/schema.h"
+
+namespace dawn {
+
+/**
+ * AggregateExecutor computes the aggregations over all the child's tuples (without GROUP BY) and
+ * outputs them as a tuple, the child is scanned only once.
+ *
+ * In the parallel plan, the pipeline of each worker ends with a kPartial one, it accumulates the
+ * worker's tuples into its own states and outputs the states as a tuple, or nothing if the worker
+ * gets no tuples. A kFinal one above the GatherExecutor combines the workers' states, e.g.
+ *
+ *   Final -> Gather -> { Partial -> Selection -> SeqScan (morsels), Partial -> ..., ... }
+ *
+ * The states are never shared by the workers. kComplete does both phases in one executor.
+ * The input of kFinal is the output of kPartial, whose schema is the same as the output schema.
+ */
+class AggregateExecutor : public ExecutorAbstract {
+public:
+    /** @param aggs the states are kept by the executor, so the workers could share the expressions */
+    AggregateExecutor(ExecutorContext *exec_ctx, ExecutorAbstract *child, std::vector<AggregateExpression*> aggs,
+        AggregationPhase phase, Schema *input_schema, Schema *output_schema)
+        : ExecutorAbstract(exec_ctx), child_(child), aggs_(aggs), phase_(phase), input_schema_(input_schema),
+        output_schema_(output_schema) {}
+
+    ~AggregateExecutor() override = default;
+
+    DISALLOW_COPY_AND_MOVE(AggregateExecutor);
+
+    void open() override;
+    bool get_next(Tuple *tuple) override;
+    void close() override;
+    bool need_own_thread() const override { return child_->need_own_thread(); }
+
+    inline AggregationPhase get_phase() const { return phase_; }
+
+private:
+    /** accumulate the child's tuples, or combine the states if it's kFinal */
+    void consume();
+
+    ExecutorAbstract *child_;
+    std::vector<AggregateExpression*> aggs_;
+    AggregationPhase phase_;
+    Schema *input_schema_;
+    Schema *output_schema_;
+
+    std::vector<AggregateState> states_;
+    std::vector<offset_t> ref_cols_;
+
+    /** number of the tuples got from the child */
+    size_t_ input_num_ = 0;
+    bool output_ = false;
+
+    TupleView child_view_;
+    std::vector<Value> values_;
+};
+
+} // namespace dawn
@@ -3,6 +3,8 @@
 #include <vector>
 #include "executors/executor_context.h"
 #include "table/tuple.h"
+#include "table/tuple_view.h"
+#include "table/tuple_batch.h"
 
 namespace dawn {
 
@@ -13,6 +15,42 @@ public:
     virtual void open() = 0;
     virtual bool get_next(Tuple *tuple) = 0;
     virtual void close() = 0;
+
+    /**
+     * the same as get_next(), but the tuple may refer to the page without being copied.
+     * It's valid until the next call, materialize it if it should be kept longer.
+     */
+    virtual bool get_next_view(TupleView *view) {
+        view->release();
+        return get_next(view->get_tuple());
+    }
+
+    /**
+     * fill the batch with the next rows, the batch should have been initialized with the executor's
+     * output schema. By default, the rows are got one by one with get_next_view(), the executors
+     * working on the batches override it.
+     * @return false if there are no more rows
+     */
+    virtual bool get_next_batch(TupleBatch *batch) {
+        batch->reset();
+        TupleView view;
+        while (!batch->is_full() && get_next_view(&view))
+            batch->append(*view, exec_ctx_->get_buffer_pool_manager());
+        return batch->get_size() > 0;
+    }
+
+    /**
+     * tell the executor that only these columns of its output are needed, so that the scan could
+     * skip the others in the PAX pages. It should be called before open(), empty means all columns.
+     */
+    virtual void set_required_cols(const std::vector<offset_t> &col_idxs) {}
+
+    /**
+     * @return true if the executor waits for the pipelines running beside it, e.g. it reads a partition
+     * of a RepartitionExchange, so the exchange running its pipeline should give it a thread of its own.
+     * The executors having children ask them.
+     */
+    virtual bool need_own_thread() const { return false; }
 protected:
     const ExecutorContext* get_context() const { return exec_ctx_; }
 protected:
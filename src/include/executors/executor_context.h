@@ -1,19 +1,49 @@
 #pragma once
 
+#include <algorithm>
+#include <mutex>
+#include <thread>
+
 #include "buffer/buffer_pool_manager.h"
 
 namespace dawn {
 
 class ExecutorContext {
 public:
-    ExecutorContext(BufferPoolManager *bpm) : bpm_(bpm) {}
+    /** @param thread_budget threads the exchanges of the query could start, all the cores by default */
+    ExecutorContext(BufferPoolManager *bpm, size_t_ thread_budget = std::max(1u, std::thread::hardware_concurrency()))
+        : bpm_(bpm), thread_budget_(thread_budget) {}
 
     ~ExecutorContext() = default;
 
     BufferPoolManager* get_buffer_pool_manager() const { return bpm_; }
+
+    /**
+     * The exchanges (e.g. GatherExecutor) take their threads from the query's budget when they're opened.
+     * At least min_num threads are granted even if the budget is used up, so that every exchange could
+     * make progress, e.g. the pipelines waiting for each other must run at the same time.
+     * @return number of the threads granted, it's no more than num
+     */
+    size_t_ acquire_threads(size_t_ num, size_t_ min_num = 1) {
+        std::lock_guard<std::mutex> lg(thread_mt_);
+        size_t_ granted = std::max(min_num, std::min(num, thread_budget_ - used_threads_));
+        used_threads_ += granted;
+        return granted;
+    }
+
+    void release_threads(size_t_ num) {
+        std::lock_guard<std::mutex> lg(thread_mt_);
+        used_threads_ -= num;
+    }
+
+    inline size_t_ get_thread_budget() const { return thread_budget_; }
 private:
     /** some more context will be added, such as transaction, catalog, etc. */
     BufferPoolManager *bpm_;
+
+    const size_t_ thread_budget_;
+    size_t_ used_threads_ = 0;
+    std::mutex thread_mt_;
 };
 
 } // namespace dawn
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <deque>
+#include <vector>
+
+#include "executors/executor_abstr.h"
+#include "table/schema.h"
+#include "table/tmp_page_chain.h"
+#include "storage/page/table_page.h"
+#include "util/loser_tree.h"
+
+namespace dawn {
+
+/**
+ * ExternalSortExecutor outputs the child's tuples ordered by the key columns, it's used by
+ * ORDER BY and the sort-merge join. The sort is stable.
+ *
+ * The tuples are copied into the temporary TablePages and sorted in the memory. The pages are
+ * limited by the threshold pages got from the buffer pool manager, when they are used up, the
+ * sorted chunk is written to a chain of temporary pages as a run. After all the tuples are
+ * consumed, the runs are merged with a loser tree, each run pins one page while it's merged.
+ * If there are more runs than the threshold pages, some of them are merged into a longer run first.
+ */
+class ExternalSortExecutor : public ExecutorAbstract {
+public:
+    /**
+     * @param descs whether each key column is in the descending order, all ascending if it's empty
+     */
+    ExternalSortExecutor(ExecutorContext *exec_ctx, ExecutorAbstract *child, Schema *schema,
+        std::vector<offset_t> key_idxs, std::vector<bool> descs = std::vector<bool>{})
+        : ExecutorAbstract(exec_ctx), child_(child), schema_(schema), key_idxs_(key_idxs), descs_(descs),
+        tree_(SourceLess{this}) {
+        descs_.resize(key_idxs_.size(), false);
+    }
+
+    ~ExternalSortExecutor() override = default;
+
+    DISALLOW_COPY_AND_MOVE(ExternalSortExecutor);
+
+    void open() override;
+    bool get_next(Tuple *tuple) override;
+    void close() override;
+    bool need_own_thread() const override { return child_->need_own_thread(); }
+
+    inline const Schema* get_output_schema() const { return schema_; }
+
+    /** @return number of the runs written to the temporary pages, 0 if the child's tuples fit in the memory */
+    inline size_t_ get_run_num() const { return run_num_; }
+
+    /** @return number of the passes merging the runs before the final merge */
+    inline size_t_ get_merge_pass_num() const { return merge_pass_num_; }
+
+    /**
+     * compare the keys column by column
+     * @return < 0 if lhs should be output before rhs, 0 if they're equal
+     */
+    static int compare_keys(const std::vector<Value> &lhs, const std::vector<Value> &rhs, const std::vector<bool> &descs);
+
+private:
+    /** a tuple in the memory, the keys are fetched once when it's inserted */
+    struct SortEntry {
+        std::vector<Value> keys;
+        TablePage *page;
+        RID rid;
+    };
+
+    /** a run being merged, its current tuple refers to the page pinned by the reader */
+    struct MergeSource {
+        TmpChainReader reader;
+        Tuple tuple;
+        std::vector<Value> keys;
+        bool valid = false;
+    };
+
+    struct SourceLess {
+        ExternalSortExecutor *sort;
+
+        /** the exhausted sources lose, and the earlier runs win the ties to keep the sort stable */
+        bool operator()(size_t_ lhs, size_t_ rhs) const {
+            const MergeSource &l = sort->sources_[lhs];
+            const MergeSource &r = sort->sources_[rhs];
+            if (!l.valid || !r.valid)
+                return l.valid;
+            int res = compare_keys(l.keys, r.keys, sort->descs_);
+            return res != 0 ? res < 0 : lhs < rhs;
+        }
+    };
+
+    /** the toasted key values are fetched */
+    void fetch_keys(const Tuple &tuple, std::vector<Value> *keys) const;
+
+    /** @return false if the chunk pages reach the limit */
+    bool chunk_insert(const Tuple &tuple);
+
+    /** sort the tuples in the memory */
+    void sort_chunk();
+
+    /** write the sorted chunk as a run and delete the chunk pages */
+    void spill_chunk();
+
+    /** delete the chunk pages */
+    void clear_chunk();
+
+    /** start merging runs_[begin, begin + num), each of them pins a page */
+    void start_merge(size_t_ begin, size_t_ num);
+
+    /** move the source to its next tuple */
+    void advance_source(size_t_ idx);
+
+    /** @return false if all the sources are consumed */
+    bool next_merged(Tuple *tuple);
+
+    ExecutorAbstract *child_;
+    Schema *schema_;
+    std::vector<offset_t> key_idxs_;
+    std::vector<bool> descs_;
+
+    /** pages the sort could hold at the same time */
+    size_t_ threshold_pages_ = 0;
+
+    /** the chunk being sorted in the memory */
+    std::vector<TablePage*> chunk_pages_;
+    std::vector<SortEntry> entries_;
+    size_t_ out_idx_ = 0;
+
+    std::deque<TmpPageChain> runs_;
+    size_t_ run_num_ = 0;
+    size_t_ merge_pass_num_ = 0;
+
+    std::vector<MergeSource> sources_;
+    LoserTree<SourceLess> tree_;
+};
+
+} // namespace dawn
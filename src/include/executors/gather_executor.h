@@ -0,0 +1,80 @@
+#pragma once
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "executors/executor_abstr.h"
+#include "util/bounded_queue.h"
+#include "util/config.h"
+
+namespace dawn {
+
+/**
+ * GatherExecutor is the exchange merging the pipelines of the workers. Each worker's pipeline
+ * (e.g. a ProjectionExecutor over a SelectionExecutor over a SeqScanExecutor taking the morsels
+ * from a shared MorselQueue) is opened and run on its own thread, the tuples are passed back in
+ * chunks through a bounded queue. The order of the tuples among the workers is not kept.
+ *
+ * The threads are taken from the query's thread budget (see ExecutorContext::acquire_threads()).
+ * If fewer threads are granted than the workers, each thread runs several pipelines one by one.
+ * But if any pipeline needs its own thread (see ExecutorAbstract::need_own_thread()), e.g. the
+ * pipelines reading the partitions of a RepartitionExchange wait for each other, every worker
+ * gets a thread even beyond the budget.
+ *
+ * The workers shouldn't share anything that isn't thread-safe, e.g. each pipeline has its own
+ * expressions because they bind the kernels lazily.
+ */
+class GatherExecutor : public ExecutorAbstract {
+public:
+    GatherExecutor(ExecutorContext *exec_ctx, std::vector<ExecutorAbstract*> workers)
+        : ExecutorAbstract(exec_ctx), workers_(workers), queue_(workers.size() * EXCHANGE_QUEUE_CHUNKS) {}
+
+    ~GatherExecutor() override { stop_workers(); }
+
+    DISALLOW_COPY_AND_MOVE(GatherExecutor);
+
+    void open() override;
+    bool get_next(Tuple *tuple) override;
+    void close() override;
+
+    void set_required_cols(const std::vector<offset_t> &col_idxs) override {
+        for (auto worker : workers_)
+            worker->set_required_cols(col_idxs);
+    }
+
+    inline size_t_ get_worker_num() const { return workers_.size(); }
+
+    /** @return number of the threads running the workers since open() */
+    inline size_t_ get_thread_num() const { return thread_num_; }
+
+private:
+    /** run the pipelines workers_[idx], workers_[idx + thread_num_], ... on the thread */
+    void run_thread(size_t_ idx);
+
+    /**
+     * open the worker's pipeline and put its tuples into the queue
+     * @return false if the consumer has stopped
+     */
+    bool run_worker(size_t_ idx);
+
+    /** stop the workers if they're still running and wait for them */
+    void stop_workers();
+
+    std::vector<ExecutorAbstract*> workers_;
+    std::vector<std::thread> threads_;
+    size_t_ thread_num_ = 0;
+
+    /** each one is only set by the thread running the worker, they're read after the threads exit */
+    std::vector<char> opened_;
+    BoundedQueue<std::vector<Tuple>> queue_;
+
+    /** the last finished thread closes the queue */
+    std::atomic<size_t_> running_num_{0};
+
+    /** the chunk being output */
+    std::vector<Tuple> chunk_;
+    size_t chunk_idx_ = 0;
+};
+
+} // namespace dawn
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <vector>
+
+#include "executors/executor_abstr.h"
+#include "sql/expressions/expr_abstr.h"
+#include "table/schema.h"
+#include "table/tmp_page_chain.h"
+#include "data/kernels.h"
+
+namespace dawn {
+
+/**
+ * HashAggregateExecutor groups the child's tuples by the GROUP BY expressions and computes the
+ * aggregations of each group, the child is scanned only once.
+ *
+ * The aggregation states are kept in an open-addressing hash table (linear probing), whose size
+ * is limited by the threshold pages got from the buffer pool manager. When the table is full,
+ * the tuples of the new groups are spilled to the partitions (chains of temporary pages) by the
+ * hash of their keys, while the groups in the table keep being aggregated. After the groups in
+ * the memory are output, the partitions are aggregated one by one in the same way, and a partition
+ * that is still too large is partitioned again with other bits of the hash.
+ *
+ * The output tuple is | group by columns | aggregation columns |. Without GROUP BY, a single
+ * tuple is output even if the child is empty (COUNT is 0, others are 0 of their types).
+ */
+class HashAggregateExecutor : public ExecutorAbstract {
+public:
+    /**
+     * @param group_exprs GROUP BY expressions
+     * @param agg_exprs arguments of the aggregations, nullptr means COUNT(*)
+     * @param output_schema types of the aggregation columns should be the same as the results',
+     *                      e.g. SUM of integers is integer
+     */
+    HashAggregateExecutor(ExecutorContext *exec_ctx, ExecutorAbstract *child, std::vector<ExpressionAbstract*> group_exprs,
+        std::vector<AggregationType> agg_types, std::vector<ExpressionAbstract*> agg_exprs, Schema *input_schema,
+        Schema *output_schema)
+        : ExecutorAbstract(exec_ctx), child_(child), group_exprs_(group_exprs), agg_types_(agg_types),
+        agg_exprs_(agg_exprs), input_schema_(input_schema), output_schema_(output_schema) {}
+
+    ~HashAggregateExecutor() override = default;
+
+    DISALLOW_COPY_AND_MOVE(HashAggregateExecutor);
+
+    void open() override;
+    bool get_next(Tuple *tuple) override;
+    void close() override;
+    bool need_own_thread() const override { return child_->need_own_thread(); }
+
+    /** @return number of the partitions spilled to the temporary pages since open() */
+    inline size_t_ get_spilled_partition_num() const { return spilled_part_num_; }
+
+private:
+    /** the aggregation states of a group */
+    struct GroupState {
+        hash_t hash;
+        std::vector<Value> keys;
+        std::vector<Value> aggs;
+    };
+
+    /** a partition waiting to be aggregated, level decides which bits of the hash partition it again */
+    struct SpillPartition {
+        TmpPageChain chain;
+        int level;
+    };
+
+    /** aggregate the tuple in the table, or spill it if its group isn't in the full table */
+    void consume(const Tuple &raw);
+
+    /** @return index of the group in groups_, -1 if it's not found */
+    int find_group(hash_t hash, const std::vector<Value> &keys, size_t_ *slot) const;
+
+    /** create the group with the first tuple's arguments */
+    void insert_group(size_t_ slot, hash_t hash);
+
+    /** double the slots and put the groups into them again */
+    void grow_slots();
+
+    void update_group(GroupState *group);
+
+    /** @return the kernel of the i-th aggregation, it's bound again if the argument's type changes */
+    arith_kernel_t get_kernel(size_t_ i, TypeId state_type);
+
+    /** the hash table and the groups are cleared */
+    void clear_table();
+
+    /** unpin the last pages of the partitions being written and push them to the stack */
+    void finish_spill();
+
+    /**
+     * aggregate the next partition in the stack
+     * @return false if there are no more partitions
+     */
+    bool load_partition();
+
+    inline size_t_ get_partition(hash_t hash) const {
+        return (hash >> (32 + level_ * 5)) % spill_fanout_;
+    }
+
+    ExecutorAbstract *child_;
+    std::vector<ExpressionAbstract*> group_exprs_;
+    std::vector<AggregationType> agg_types_;
+    std::vector<ExpressionAbstract*> agg_exprs_;
+    Schema *input_schema_;
+    Schema *output_schema_;
+
+    /** columns read by the expressions, the toasted ones are fetched */
+    std::vector<offset_t> ref_cols_;
+
+    /** pages the aggregation could hold at the same time */
+    size_t_ threshold_pages_ = 0;
+
+    /** number of the partitions the spilled tuples are split into, each one pins a page */
+    size_t_ spill_fanout_ = 0;
+
+    /** groups could be held by the table, estimated by the memory they use */
+    size_t_ group_limit_ = 0;
+
+    /** slots of the open-addressing table, they store the indexes of groups_ and -1 if it's empty */
+    std::vector<int> slots_;
+    std::vector<GroupState> groups_;
+    size_t_ out_idx_ = 0;
+
+    /** the partitions being written while the table is aggregating, and the ones waiting */
+    int level_ = 0;
+    std::vector<TmpPageChain> spilling_parts_;
+    std::vector<SpillPartition> parts_;
+    size_t_ spilled_part_num_ = 0;
+
+    /** the kernels of the SUM/MIN/MAX, they're bound with the types of the first arguments */
+    std::vector<arith_kernel_t> kernels_;
+    std::vector<TypeId> arg_types_;
+
+    /** containers reused for each tuple */
+    TupleView child_view_;
+    Tuple fetched_tuple_;
+    Tuple part_tuple_;
+    std::vector<Value> keys_;
+    std::vector<Value> args_;
+    std::vector<Value> values_;
+};
+
+} // namespace dawn
@@ -0,0 +1,142 @@
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+
+#include "executors/executor_abstr.h"
+#include "table/schema.h"
+#include "storage/page/table_page.h"
+#include "table/tmp_page_chain.h"
+
+namespace dawn {
+
+/**
+ * HashJoinExecutor joins the tuples of two children whose key columns are equal.
+ *
+ * The left child is the build side. Its tuples are copied into the temporary TablePages and
+ * indexed by the hash of their keys, then each tuple of the right child probes the hash table.
+ * Pages of the build side are limited by the threshold pages got from the buffer pool manager.
+ *
+ * When the build side exceeds the limit, both sides are partitioned by the hash of the keys
+ * into the chains of temporary pages (grace hash join), and the partitions are joined one pair
+ * at a time. A build partition that is still too large (e.g. most tuples have the same key)
+ * is loaded chunk by chunk, and its probe partition is scanned once for each chunk.
+ *
+ * The output tuple is | left child's columns | right child's columns |, see get_output_schema().
+ */
+class HashJoinExecutor : public ExecutorAbstract {
+public:
+    /**
+     * @param left_key_idxs compared with right_key_idxs one by one, the key columns should have the same types
+     */
+    HashJoinExecutor(ExecutorContext *exec_ctx, ExecutorAbstract *left_child, ExecutorAbstract *right_child,
+        Schema *left_schema, Schema *right_schema, std::vector<offset_t> left_key_idxs, std::vector<offset_t> right_key_idxs)
+        : ExecutorAbstract(exec_ctx), left_child_(left_child), right_child_(right_child), left_schema_(left_schema),
+        right_schema_(right_schema), left_key_idxs_(left_key_idxs), right_key_idxs_(right_key_idxs) {
+        output_schema_ = create_join_schema(*left_schema_, *right_schema_);
+    }
+
+    ~HashJoinExecutor() override {
+        delete output_schema_;
+    }
+
+    DISALLOW_COPY_AND_MOVE(HashJoinExecutor);
+
+    void open() override;
+    bool get_next(Tuple *tuple) override;
+    void close() override;
+
+    bool need_own_thread() const override {
+        return left_child_->need_own_thread() || right_child_->need_own_thread();
+    }
+
+    inline const Schema* get_output_schema() const { return output_schema_; }
+
+    /** @return number of the partitions, 0 if the build side fits in the memory */
+    inline size_t_ get_partition_num() const { return build_parts_.size(); }
+
+private:
+    /** @return hash value of the key columns, the toasted ones are fetched */
+    hash_t hash_keys(const Tuple &tuple, const Schema &schema, const std::vector<offset_t> &key_idxs,
+        std::vector<Value> *keys) const;
+
+    /** @return the partition of the hash value, other bits are used by the hash table */
+    inline size_t_ get_partition(hash_t hash) const { return (hash >> 40) % build_parts_.size(); }
+
+    /** @return false if the build pages reach the limit */
+    bool build_insert(const Tuple &tuple, hash_t hash, size_t_ page_limit);
+
+    /** delete the in-memory build pages and the hash table */
+    void clear_build();
+
+    /** move the in-memory build tuples into the partitions, and partition the rest of the left child */
+    void partition_build();
+
+    /** partition the right child */
+    void partition_probe();
+
+    inline void partition_insert(std::vector<TmpPageChain> *parts, const Tuple &tuple, hash_t hash) {
+        (*parts)[get_partition(hash)].append(tuple, get_context()->get_buffer_pool_manager());
+    }
+
+    /** unpin the last page of each partition */
+    void finish_partitions(std::vector<TmpPageChain> *parts);
+
+    /**
+     * load the next chunk of the current build partition into the hash table,
+     * the next partition is started if the current one is consumed.
+     * @return false if all the partitions are joined
+     */
+    bool load_build_chunk();
+
+    /** @return false if there are no more probe tuples for the build tuples in the memory */
+    bool next_probe_tuple();
+
+    ExecutorAbstract *left_child_;
+    ExecutorAbstract *right_child_;
+    Schema *left_schema_;
+    Schema *right_schema_;
+    Schema *output_schema_;
+    std::vector<offset_t> left_key_idxs_;
+    std::vector<offset_t> right_key_idxs_;
+
+    /** pages the join could hold at the same time */
+    size_t_ threshold_pages_ = 0;
+
+    /** build pages in the memory and the hash table indexing their tuples */
+    std::vector<TablePage*> build_pages_;
+    std::unordered_multimap<hash_t, std::pair<TablePage*, RID>> hash_table_;
+
+    std::vector<TmpPageChain> build_parts_;
+    std::vector<TmpPageChain> probe_parts_;
+    size_t_ cur_part_ = -1;
+
+    /** position in the current build partition where the next chunk starts */
+    TmpChainReader build_reader_;
+    bool build_part_done_ = true;
+
+    /** the tuple not fitting in the last chunk, it's copied since its page may be unpinned */
+    Tuple pending_tuple_;
+    hash_t pending_hash_ = 0;
+    bool has_pending_ = false;
+
+    /** position in the current probe partition */
+    TmpChainReader probe_reader_;
+
+    /** the probe tuple and its matches in the hash table */
+    TupleView probe_view_;
+    Tuple *probe_tuple_ = nullptr;
+    std::vector<Value> probe_keys_;
+    hash_t probe_hash_ = 0;
+    std::unordered_multimap<hash_t, std::pair<TablePage*, RID>>::iterator match_iter_;
+    std::unordered_multimap<hash_t, std::pair<TablePage*, RID>>::iterator match_end_;
+
+    /** containers reused for each tuple */
+    Tuple build_tuple_;
+    Tuple chain_tuple_;
+    Tuple probe_chain_tuple_;
+    std::vector<Value> build_keys_;
+    std::vector<Value> values_;
+};
+
+} // namespace dawn
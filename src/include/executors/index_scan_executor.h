@@ -0,0 +1,34 @@
+#pragma once
+
+#include "executors/executor_abstr.h"
+#include "table/table.h"
+#include "index/secondary_index.h"
+#include "util/config.h"
+
+namespace dawn {
+
+/**
+ * get the tuples whose indexed columns are equal to the key with the secondary index,
+ * so that the filter on the non-key column doesn't need to scan the whole table.
+ */
+class IndexScanExecutor : public ExecutorAbstract {
+public:
+    IndexScanExecutor(ExecutorContext *exec_ctx, Table *table, SecondaryIndex *index, const IndexKey &key)
+        : ExecutorAbstract(exec_ctx), table_(table), index_(index), key_(key), cursor_(0) {}
+
+    ~IndexScanExecutor() = default;
+
+    DISALLOW_COPY_AND_MOVE(IndexScanExecutor);
+
+    void open() override;
+    bool get_next(Tuple *tuple) override;
+    void close() override;
+private:
+    Table *table_;
+    SecondaryIndex *index_;
+    IndexKey key_;
+    std::vector<RID> rids_;
+    size_t cursor_;
+};
+
+} // namespace dawn
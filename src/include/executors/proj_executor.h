@@ -3,6 +3,7 @@
 #include "executors/executor_abstr.h"
 #include "sql/expressions/col_value_expr.h"
 #include "table/schema.h"
+#include "table/toast.h"
 #include "util/config.h"
 #include "data/types.h"
 
@@ -113,11 +114,14 @@ public:
 
     void open() override;
     bool get_next(Tuple *tuple) override;
+    bool get_next_batch(TupleBatch *batch) override;
     void close() override;
+    bool need_own_thread() const override { return child_->need_own_thread(); }
 private:
     ExecutorAbstract *child_;
     std::vector<ExpressionAbstract*> exprs_; // get the columns from input tuple
-    Tuple next_tuple_; // in avoid of the construction and deconstruction every time we call the get_next()
+    TupleView child_view_; // the child's tuple is only read, so it needn't be copied
+    TupleBatch child_batch_; // only the columns read by the expressions are loaded
     Schema *input_schema_;
     Schema *output_schema_;
 
@@ -125,6 +129,9 @@ private:
     bool is_aggregate_;
     std::vector<Value> agg_vals_; // store the aggregation result
     int agg_num_;
+
+    /** columns read by the expressions, only these columns are scanned or fetched if they are toasted */
+    std::vector<offset_t> ref_cols_;
 };
 
 } // namespace dawn
\ No newline at end of file
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "executors/executor_abstr.h"
+#include "table/schema.h"
+#include "util/bounded_queue.h"
+#include "util/config.h"
+
+namespace dawn {
+
+/**
+ * RepartitionExchange redistributes the tuples of N producer pipelines into M partitions by the
+ * hash of their key columns, so that the tuples having the same keys go to the same consumer,
+ * e.g. the workers of a parallel hash join or aggregation. Each consumer reads its partition
+ * with a RepartitionExecutor.
+ *
+ * The producers run on the threads taken from the query's thread budget when the first consumer
+ * is opened, and they're stopped and closed when the last consumer is closed. Each partition has
+ * a bounded queue, a producer waits when the queue of a partition is full, so all the consumers
+ * should run at the same time (e.g. a GatherExecutor giving each of them a thread).
+ */
+class RepartitionExchange {
+public:
+    /**
+     * @param schema the producers' output schema
+     * @param key_idxs the tuples are partitioned by these columns
+     */
+    RepartitionExchange(ExecutorContext *exec_ctx, std::vector<ExecutorAbstract*> producers, Schema *schema,
+        std::vector<offset_t> key_idxs, size_t_ partition_num);
+
+    ~RepartitionExchange() { stop_producers(); }
+
+    DISALLOW_COPY_AND_MOVE(RepartitionExchange);
+
+    /** called by the consumer's open(), the first one starts the producers */
+    void attach();
+
+    /**
+     * called by the consumer's close(), the tuples of its partition are dropped from now on.
+     * The last one stops and closes the producers.
+     */
+    void detach(size_t_ partition);
+
+    /** @return false if there are no more tuples in the partition */
+    inline bool pop(size_t_ partition, std::vector<Tuple> *chunk) { return queues_[partition]->pop(chunk); }
+
+    inline size_t_ get_partition_num() const { return queues_.size(); }
+
+    inline const Schema* get_output_schema() const { return schema_; }
+
+private:
+    /** run the producers producers_[idx], producers_[idx + thread_num_], ... on the thread */
+    void run_thread(size_t_ idx);
+
+    /**
+     * open the producer and put its tuples into the partitions
+     * @return false if all the consumers have stopped
+     */
+    bool run_producer(size_t_ idx);
+
+    size_t_ get_partition(const Tuple &tuple) const;
+
+    void stop_producers();
+
+    ExecutorContext *exec_ctx_;
+    std::vector<ExecutorAbstract*> producers_;
+    Schema *schema_;
+    std::vector<offset_t> key_idxs_;
+    std::vector<std::unique_ptr<BoundedQueue<std::vector<Tuple>>>> queues_;
+
+    /** protects the consumer_num_, the consumers may be opened on different threads */
+    std::mutex mt_;
+    int consumer_num_ = 0;
+
+    std::vector<std::thread> threads_;
+    size_t_ thread_num_ = 0;
+
+    /** the same as GatherExecutor::opened_ */
+    std::vector<char> opened_;
+
+    /** the last finished thread closes the queues */
+    std::atomic<size_t_> running_num_{0};
+};
+
+/**
+ * RepartitionExecutor outputs the tuples of a partition of the RepartitionExchange,
+ * it's the leaf of a consumer's pipeline.
+ */
+class RepartitionExecutor : public ExecutorAbstract {
+public:
+    RepartitionExecutor(ExecutorContext *exec_ctx, RepartitionExchange *exchange, size_t_ partition)
+        : ExecutorAbstract(exec_ctx), exchange_(exchange), partition_(partition) {}
+
+    ~RepartitionExecutor() override = default;
+
+    DISALLOW_COPY_AND_MOVE(RepartitionExecutor);
+
+    void open() override;
+    bool get_next(Tuple *tuple) override;
+    void close() override;
+
+    /** the producers wait when its partition is full, so it blocks the other consumers if it isn't running */
+    bool need_own_thread() const override { return true; }
+
+private:
+    RepartitionExchange *exchange_;
+    size_t_ partition_;
+
+    /** the chunk being output */
+    std::vector<Tuple> chunk_;
+    size_t chunk_idx_ = 0;
+};
+
+} // namespace dawn
@@ -4,6 +4,7 @@
 #include "sql/expressions/expr_abstr.h"
 #include "sql/expressions/comparison_expr.h"
 #include "table/schema.h"
+#include "table/toast.h"
 #include "util/config.h"
 
 namespace dawn {
@@ -18,12 +19,20 @@ public:
 
     void open() override;
     bool get_next(Tuple *tuple) override;
+    bool get_next_view(TupleView *view) override;
+    bool get_next_batch(TupleBatch *batch) override;
     void close() override;
+    bool need_own_thread() const override { return child_->need_own_thread(); }
+    void set_required_cols(const std::vector<offset_t> &col_idxs) override { required_cols_ = col_idxs; }
 private:
     ExpressionAbstract *predicate_;
     ExecutorAbstract *child_;
     Schema *schema_;
     Value cmp_; // in avoid of the repeated constructor and deconstructor
+    TupleView view_; // only the tuples satisfying the predicate are copied in get_next()
+    std::vector<offset_t> pred_cols_; // columns read by the predicate, fetched if they are toasted
+    std::vector<offset_t> required_cols_; // columns needed by the parent, all columns if it's empty
+    std::vector<int> sel_buf_; // rows of the batch satisfying the predicate
 };
     
 } // namespace dawn
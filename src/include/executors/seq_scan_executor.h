@@ -3,6 +3,7 @@
 #include "executors/executor_abstr.h"
 #include "table/table.h"
 #include "table/lk_ha_tb_iter.h"
+#include "table/morsel_queue.h"
 #include "util/config.h"
 
 namespace dawn {
@@ -10,7 +11,14 @@ namespace dawn {
 class SeqScanExecutor : public ExecutorAbstract {
 public:
     SeqScanExecutor(ExecutorContext *exec_ctx, Table *table) 
-        : ExecutorAbstract(exec_ctx), table_(table), tb_iter_(nullptr) {}
+        : ExecutorAbstract(exec_ctx), table_(table), tb_iter_(nullptr), morsels_(nullptr) {}
+
+    /**
+     * the scan of a worker in the parallel plan, it only scans the morsels taken from the queue,
+     * and the scans sharing the queue output each tuple once in total.
+     */
+    SeqScanExecutor(ExecutorContext *exec_ctx, Table *table, MorselQueue *morsels)
+        : ExecutorAbstract(exec_ctx), table_(table), tb_iter_(nullptr), morsels_(morsels) {}
 
     virtual ~SeqScanExecutor() {
         if (tb_iter_ != nullptr)
@@ -21,10 +29,26 @@ public:
 
     void open() override;
     bool get_next(Tuple *tuple) override;
+    bool get_next_view(TupleView *view) override;
+    bool get_next_batch(TupleBatch *batch) override;
     void close() override;
+    void set_required_cols(const std::vector<offset_t> &col_idxs) override { col_idxs_ = col_idxs; }
 private:
+    /** @return true if there are no more tuples, the next morsel is taken when the current one is done */
+    bool reach_end();
+
+    /** move the iter on if its tuple has been output by get_next_view() */
+    inline void skip_viewed() {
+        if (viewed_)
+            ++(*tb_iter_);
+        viewed_ = false;
+    }
+
     Table *table_;
     TableIterAbstract *tb_iter_;
+    MorselQueue *morsels_; // nullptr if the whole table is scanned
+    std::vector<offset_t> col_idxs_; // columns read from the PAX pages
+    bool viewed_ = false; // the view output last time refers to the iter's tuple
 };
 
 } // namespace dawn
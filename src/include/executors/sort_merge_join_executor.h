@@ -0,0 +1,104 @@
+#pragma once
+
+#include <vector>
+
+#include "executors/executor_abstr.h"
+#include "executors/external_sort_executor.h"
+#include "table/schema.h"
+
+namespace dawn {
+
+/**
+ * SortMergeJoinExecutor joins the tuples of two children whose key columns are equal.
+ *
+ * Both children are sorted by their keys with the ExternalSortExecutor, and then they're merged
+ * like the merge sort. The child whose tuples are already ordered by the keys (e.g. an index scan)
+ * could skip the sort, so the join reads each child only once.
+ *
+ * The right tuples having the same keys are kept in the memory while the left tuples with these
+ * keys are joined with them, so a huge group of duplicated keys on the right side costs the memory.
+ *
+ * The output tuple is | left child's columns | right child's columns |, see get_output_schema().
+ */
+class SortMergeJoinExecutor : public ExecutorAbstract {
+public:
+    /**
+     * @param left_key_idxs compared with right_key_idxs one by one, the key columns should have the same types
+     * @param left_sorted the left child's tuples are ordered by the keys (ascending), it's not sorted again
+     * @param right_sorted the same as left_sorted
+     */
+    SortMergeJoinExecutor(ExecutorContext *exec_ctx, ExecutorAbstract *left_child, ExecutorAbstract *right_child,
+        Schema *left_schema, Schema *right_schema, std::vector<offset_t> left_key_idxs, std::vector<offset_t> right_key_idxs,
+        bool left_sorted = false, bool right_sorted = false)
+        : ExecutorAbstract(exec_ctx), left_schema_(left_schema), right_schema_(right_schema),
+        left_key_idxs_(left_key_idxs), right_key_idxs_(right_key_idxs), descs_(left_key_idxs.size(), false) {
+        left_sort_ = left_sorted ? nullptr : new ExternalSortExecutor(exec_ctx, left_child, left_schema, left_key_idxs);
+        right_sort_ = right_sorted ? nullptr : new ExternalSortExecutor(exec_ctx, right_child, right_schema, right_key_idxs);
+        left_input_ = left_sorted ? left_child : left_sort_;
+        right_input_ = right_sorted ? right_child : right_sort_;
+        output_schema_ = create_join_schema(*left_schema_, *right_schema_);
+    }
+
+    ~SortMergeJoinExecutor() override {
+        delete left_sort_;
+        delete right_sort_;
+        delete output_schema_;
+    }
+
+    DISALLOW_COPY_AND_MOVE(SortMergeJoinExecutor);
+
+    void open() override;
+    bool get_next(Tuple *tuple) override;
+    void close() override;
+
+    bool need_own_thread() const override {
+        return left_input_->need_own_thread() || right_input_->need_own_thread();
+    }
+
+    inline const Schema* get_output_schema() const { return output_schema_; }
+
+private:
+    /** @return false if the input is consumed, the keys of the tuple are fetched */
+    bool next_input(ExecutorAbstract *input, const Schema &schema, const std::vector<offset_t> &key_idxs,
+        Tuple *tuple, std::vector<Value> *keys);
+
+    inline bool next_left() {
+        return next_input(left_input_, *left_schema_, left_key_idxs_, &left_tuple_, &left_keys_);
+    }
+
+    inline bool next_right() {
+        return next_input(right_input_, *right_schema_, right_key_idxs_, &right_tuple_, &right_keys_);
+    }
+
+    /** nullptr if the child is sorted */
+    ExternalSortExecutor *left_sort_;
+    ExternalSortExecutor *right_sort_;
+
+    /** the sorted inputs, either the sorts or the children */
+    ExecutorAbstract *left_input_;
+    ExecutorAbstract *right_input_;
+
+    Schema *left_schema_;
+    Schema *right_schema_;
+    Schema *output_schema_;
+    std::vector<offset_t> left_key_idxs_;
+    std::vector<offset_t> right_key_idxs_;
+    std::vector<bool> descs_;
+
+    /** the current tuples of the inputs */
+    Tuple left_tuple_;
+    Tuple right_tuple_;
+    std::vector<Value> left_keys_;
+    std::vector<Value> right_keys_;
+    bool left_valid_ = false;
+    bool right_valid_ = false;
+
+    /** the right tuples having the same keys, the left tuple is joined with group_[group_idx_] next */
+    std::vector<Tuple> group_;
+    std::vector<Value> group_keys_;
+    size_t group_idx_ = 0;
+
+    std::vector<Value> values_;
+};
+
+} // namespace dawn
@@ -1,23 +1,36 @@
 #pragma once
 
+#include <future>
+
 #include "executors/executor_abstr.h"
 #include "table/schema.h"
 #include "storage/page/table_page.h"
-#include <deque>
 
 namespace dawn {
 
+/**
+ * UnionExecutor concatenates each tuple of the left child with each tuple of the right child.
+ *
+ * The left child's tuples are copied into the temporary pages. If they exceed half of the threshold
+ * pages, they're spilled to the disk and loaded batch by batch, and the right child is scanned once
+ * for each batch. The other half of the threshold pages is used to prefetch the next batch in the
+ * background, so that the join isn't stopped by the I/O when it moves to the next batch.
+ *
+ * The output tuple is | left child's columns | right child's columns |.
+ */
 class UnionExecutor : public ExecutorAbstract {
 public:
     UnionExecutor(ExecutorContext *exec_ctx, std::vector<ExecutorAbstract*> children, std::vector<Schema*> child_schema)
     : ExecutorAbstract(exec_ctx), children_(children), child_schema_(child_schema), in_mem_idx_(0) {
         left_child_tuple_ = new Tuple();
         right_child_tuple_ = new Tuple();
+        output_schema_ = create_join_schema(*child_schema_[0], *child_schema_[1]);
     }
 
     ~UnionExecutor() override {
         delete left_child_tuple_;
         delete right_child_tuple_;
+        delete output_schema_;
     }
 
     DISALLOW_COPY_AND_MOVE(UnionExecutor);
@@ -26,38 +39,45 @@ public:
     bool get_next(Tuple *tuple) override;
     void close() override;
 
+    bool need_own_thread() const override {
+        return children_[0]->need_own_thread() || children_[1]->need_own_thread();
+    }
+
+    inline const Schema* get_output_schema() const { return output_schema_; }
+
+    /** @return number of the batches the left child's tuples are split into, 1 if they fit in the memory */
+    inline size_t_ get_batch_num() const {
+        return spilled_pages_.empty() ? 1 : (spilled_pages_.size() + batch_pages_ - 1) / batch_pages_;
+    }
+
 private:
 
     /**
      * load all the outer table's tuples into memory, and put them on the disk
-     * when the number ofallocated pages for outer table's tuples exceed the threshold
+     * when the number of allocated pages for outer table's tuples exceed the batch size
      */
     void initialize();
 
-    /**
-     * get next left child's tuple in the temporary pages
-     * @return true: successfully false: no more tuples
-     */
-    bool get_next_left_tuple();
+    /** get a new temporary page for the left child's tuples, it's pinned */
+    TablePage* new_left_page();
+
+    /** unpin the in-memory pages, they'll be loaded again batch by batch */
+    void spill_to_disk();
 
-    /** spill the outer table's data which stay in the memory to the disk */
-    void spill_to_disk(bool is_dirty);
+    /** pin the pages of the next batch in the background */
+    void start_prefetch();
+
+    /** unpin and delete the pages */
+    void delete_pages(std::vector<TablePage*> *pages);
 
     /**
-     * After traversing all the inner table's tuples, we should load another
-     * batch of outer table's tuples from disk and delete all the temporary pages
-     * that are current in the buffer pool manager.
-     * 
-     * FIXME Very inefficient!!!
-     * This function will stop the thread for a long time because of the I/O. 
-     * We may set two buffer. When one is used for concatenating with inner table's 
-     * tuples, the other could be under the I/O operation so that we can keep cpu running.
+     * After traversing all the inner table's tuples, the current batch of outer table's tuples
+     * is deleted and the prefetched batch takes its place. Then the batch after it starts
+     * being prefetched.
+     * @return false if there are no more batches
      */
     bool load_another_batch();
 
-    /** available temporary pages that store the left child's tuple */
-    std::deque<page_id_t> avail_tmp_page_;
-
     /** store left and right child, and see left child as inner table */
     std::vector<ExecutorAbstract*> children_;
 
@@ -66,16 +86,24 @@ private:
 
     Schema *output_schema_;
 
-    /**
-     * When the outer table is too large, we should spill some data to temporary pages on the disk.
-     * This field is used for checking if we should trigger the spill to disk function.
-     * 
-     * When the outer table exceeds 1/2 of the threshold_pages_, spill the rest of the data to the disk.
-     */
-    size_t_ threshold_pages_;
+    /** pages the union could hold at the same time */
+    size_t_ threshold_pages_ = 0;
+
+    /** half of the threshold_pages_, the other half is for the prefetched batch */
+    size_t_ batch_pages_ = 1;
 
     /** store outer table's pages in memory */
-    std::deque<TablePage*> in_mem_pages_;
+    std::vector<TablePage*> in_mem_pages_;
+
+    /** the left child's pages on the disk in order, empty if they fit in the memory */
+    std::vector<page_id_t> spilled_pages_;
+
+    /** the next batch to be prefetched, it starts from spilled_pages_[next_batch_ * batch_pages_] */
+    size_t_ next_batch_ = 0;
+
+    /** pages of the next batch, they're only touched by the prefetching task until it finishes */
+    std::vector<TablePage*> prefetched_pages_;
+    std::future<void> prefetch_;
 
     /**
      * help to locate which page in the memory last time we visited
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "util/util.h"
+#include "util/config.h"
+#include "data/values.h"
+#include "table/column.h"
+#include "table/schema.h"
+#include "table/tuple.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace dawn {
+
+/**
+ * IndexKey is the encoding of one or more key columns, and every index hashes and compares
+ * keys in this form, so that the composite key is hashed only once as a whole.
+ * 
+ * The encoding is memcmp-able, memcmp() on two encoded keys gets the same order as
+ * comparing the columns one by one. Each column has a fixed size, so the encoded key
+ * of a table always has the same size.
+ * 
+ * column encoding:
+ *   integer: big endian with the sign bit flipped (4)
+ *   decimal: big endian, flip the sign bit for positive numbers and all bits for negative numbers (8)
+ *   boolean: 0 or 1 (1)
+ *   char(n), varchar(n): the string padded with '\0', bytes after the first '\0' are cleared (n)
+ */
+class IndexKey {
+public:
+    IndexKey() = default;
+
+    /** @param key_values values of the key columns, in the same order as the key_cols */
+    IndexKey(const std::vector<Value> &key_values, const std::vector<Column> &key_cols);
+
+    /** encode the key of a single column */
+    IndexKey(const Value &key_value, const Column &key_col);
+
+    /** encode the key columns of the tuple */
+    IndexKey(const char *tuple_data, const std::vector<Column> &key_cols);
+
+    inline const char* get_data() const { return data_.data(); }
+    inline size_t_ get_size() const { return static_cast<size_t_>(data_.size()); }
+
+    inline hash_t get_hash_value() const {
+        return do_hash(const_cast<char*>(data_.data()), get_size());
+    }
+
+    /**
+     * compare the key with the tuple's key columns without encoding the whole tuple's key,
+     * it stops at the first column that is not equal.
+     */
+    bool is_equal_to_tuple(const char *tuple_data, const std::vector<Column> &key_cols) const;
+
+    bool operator==(const IndexKey &key) const { return data_ == key.data_; }
+    bool operator!=(const IndexKey &key) const { return data_ != key.data_; }
+    /** char may be signed, so compare the bytes as unsigned with memcmp */
+    bool operator<(const IndexKey &key) const {
+        size_t n = std::min(data_.size(), key.data_.size());
+        int cmp = memcmp(data_.data(), key.data_.data(), n);
+        return cmp < 0 || (cmp == 0 && data_.size() < key.data_.size());
+    }
+
+    /** @return size of the encoded key of these columns */
+    static size_t_ get_key_size(const std::vector<Column> &key_cols);
+
+    /** strings are encoded with their max length, so that all the keys have the same size */
+    inline static size_t_ get_encoded_size(const Column &col) {
+        return is_string_type(col.get_type_id()) ? col.get_max_length() : col.get_data_size();
+    }
+
+    /**
+     * encode a column stored in the form of the tuple, VARCHAR should be padded as CHAR
+     * @param dst should be able to contain get_encoded_size(col) bytes
+     */
+    static void encode_column(const char *raw, const Column &col, char *dst);
+
+    /**
+     * @param buf VARCHAR is copied to it and padded as CHAR, it should contain get_encoded_size(col) bytes
+     * @return the column's data that could be passed to encode_column()
+     */
+    static const char* get_raw_column(const char *tuple_data, const Column &col, char *buf);
+
+private:
+    std::vector<char> data_;
+};
+
+/** @return the key columns of the table in the order of the key */
+inline std::vector<Column> get_key_columns(const Schema &schema) {
+    std::vector<Column> key_cols;
+    for (offset_t idx : schema.get_key_idxs())
+        key_cols.push_back(schema.get_column(idx));
+    return key_cols;
+}
+
+} // namespace dawn
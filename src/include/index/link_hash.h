@@ -3,6 +3,11 @@
 #include "util/config.h"
 #include "table/tuple.h"
 #include "table/tb_common_op.h"
+#include "table/column.h"
+#include "index/index_key.h"
+
+#include <atomic>
+#include <mutex>
 
 /**
  * link hash needs pages divided into three levels.
@@ -14,6 +19,66 @@
 
 namespace dawn {
 
+class LinkHashPage;
+
+/**
+ * the returned value will be set in the second and third parameter
+ * @param hash_val the input hash value
+ * @param sec_pg_slot_num get the second level's page id with this
+ * @param tb_pg_slot_num get the third level's page id with this
+ */
+inline void hash_to_slot(hash_t hash_val, offset_t *sec_pg_slot_num, offset_t *tb_pg_slot_num) {
+    offset_t slot_num = static_cast<offset_t>(hash_val % static_cast<hash_t>(Lk_HA_TOTAL_SLOT_NUM));
+    *sec_pg_slot_num = slot_num / LK_HA_PG_SLOT_NUM;
+    *tb_pg_slot_num = slot_num % LK_HA_PG_SLOT_NUM;
+}
+
+/**
+ * Every operation on the link hash visits the first level page, so each Table keeps it
+ * pinned in the buffer pool while the Table is alive, and caches the page ids stored in
+ * it's slots so that looking up a second level page takes no latch of the buffer pool.
+ *
+ * A slot only changes from INVALID_PAGE_ID to a valid page id when a second level page is
+ * allocated, and this change is written through to both of the page and the cache.
+ */
+class LinkHashDirectory {
+public:
+    /** @param first_page_id first level page should have been initialized */
+    LinkHashDirectory(page_id_t first_page_id, BufferPoolManager *bpm);
+
+    ~LinkHashDirectory();
+
+    DISALLOW_COPY_AND_MOVE(LinkHashDirectory);
+
+    inline page_id_t get_first_page_id() const { return first_page_id_; }
+
+    /** @return INVALID_PAGE_ID if the second level page has not been allocated */
+    inline page_id_t get_sec_pgid(offset_t sec_pg_slot_num) const {
+        if (sec_pg_slot_num < 0 || sec_pg_slot_num >= LK_HA_PG_SLOT_NUM)
+            return INVALID_PAGE_ID;
+        return sec_pgids_[sec_pg_slot_num].load(std::memory_order_acquire);
+    }
+
+    /**
+     * get the second level page id, and allocate the page when it's nonexistent
+     * @return INVALID_PAGE_ID if we can't get a new page
+     */
+    page_id_t get_or_create_sec_pgid(offset_t sec_pg_slot_num);
+
+private:
+    page_id_t first_page_id_;
+    BufferPoolManager *bpm_;
+
+    /** always pinned until the LinkHashDirectory is destroyed */
+    LinkHashPage *first_level_page_;
+
+    /** copy of the first level page's slots */
+    std::atomic<page_id_t> sec_pgids_[LK_HA_PG_SLOT_NUM];
+
+    /** serialize the allocation of the second level pages */
+    std::mutex alloc_mutex_;
+};
+
 /**
  * Insert duplicated key is not allowd.
  * 
@@ -21,7 +86,7 @@ namespace dawn {
  * first level: only one LinkHashPage, his slots store the page ids that refer to the second level's LinkHashPage
  * second level: many LinkHashPage, their slots store the page ids that refer to the third level's TablePage
  * third level: the actual level that stores data and has many double linked list.
- * @param first_page_id refer to the first level's page id
+ * @param lk_ha_dir refer to the first level's page
  * @param tuple insert it's data into db and set it's RID to return the insert position
  * @param tb_schema describe the tuple to get the key index
  */
@@ -30,7 +95,10 @@ op_code_t lk_ha_insert_tuple(INSERT_TUPLE_FUNC_PARAMS);
 op_code_t lk_ha_mark_delete(MARK_DELETE_FUNC_PARAMS);
 
 /**
- * after deleting the last tuple in a TablePage, we should delete the TablePage
+ * after deleting the last tuple in a TablePage, or when a TablePage becomes sparse,
+ * the TablePage list of this slot is compacted: empty pages are deleted and sparse pages
+ * are merged into their previous pages.
+ * @param moved_rids (old rid, new rid) pairs of the tuples moved by the compaction, nullable
  */
 void lk_ha_apply_delete(APPLY_DELETE_FUNC_PARAMS);
 
@@ -39,10 +107,36 @@ void lk_ha_rollback_delete(ROLLBACK_DELETE_FUNC_PARAMS);
 
 op_code_t lk_ha_get_tuple(GET_TUPLE_FUNC_PARAMS);
 
+/**
+ * Search a batch of keys at once.
+ * Keys are sorted by the slots they hash to, so that every first level page, second level page
+ * and link list is visited only once no matter how many keys refer to it.
+ * @param tuples tuples are returned in the same order as the keys,
+ *               and the tuple's RID is invalid if it's key can't be found
+ * @return number of the tuples that have been found
+ */
+size_t_ lk_ha_get_tuples_batch(GET_TUPLES_FUNC_PARAMS);
+
+/**
+ * Load a batch of tuples at once, it's much cheaper than inserting them one by one.
+ * 
+ * Tuples are sorted by the slots they hash to, and the second level pages are visited in order.
+ * The TablePage list of an empty slot is built from scratch with full pages, no duplicate probe
+ * and no latch on the new pages are needed, because nobody can see them until the slot refers to them.
+ * Tuples whose slot already has a list are inserted with lk_ha_insert_tuple().
+ * 
+ * @param tuples RID of the loaded tuple is set, and it's invalid if the tuple hasn't been loaded
+ * @return DUP_KEY if the batch contains duplicated keys, nothing is loaded in this case.
+ *         Tuples whose keys exist in the table are skipped and DUP_KEY is returned at last.
+ *         Loading stops when we can't get new pages, and the loaded tuples are kept.
+ */
+op_code_t lk_ha_bulk_load(BULK_LOAD_FUNC_PARAMS);
+
 /**
  * Firstly, check if key will be modified. 
  * Yes, then reinsert the new_tuple, but may be fail because of the possible duplicate, and delete the old tuple.
- * No, modify the tuple in place.
+ * No, modify the tuple in place. If the new tuple is larger and can't be put into its page,
+ *     it's moved to another page of the list.
  * @param new_tuple new position will be set in the new tuple
  * @param old_rid old tuple's position
  */
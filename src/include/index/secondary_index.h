@@ -0,0 +1,84 @@
+#pragma once
+
+#include "util/config.h"
+#include "table/rid.h"
+#include "table/schema.h"
+#include "index/index_key.h"
+#include "data/values.h"
+#include "table/tuple.h"
+#include "buffer/buffer_pool_manager.h"
+#include "index/link_hash.h"
+
+#include <vector>
+
+namespace dawn {
+
+/**
+ * Secondary index maps the values of one or more columns to the RIDs of the tuples, and the key is not unique.
+ * 
+ * So far, only the link hash is supported. It has the same three levels as the table's link hash,
+ * but the third level's TablePages store entries instead of tuples.
+ * 
+ * entry layout:
+ * ---------------------------------------------------------------
+ * | encoded key (IndexKey's size) | page id (4) | slot num (4) |
+ * ---------------------------------------------------------------
+ * 
+ * ATTENTION the index doesn't check if the tuple that the RID refers to is still there,
+ * the Table is responsible for keeping the entries consistent with the tuples.
+ */
+class SecondaryIndex {
+public:
+    /**
+     * @param first_page_id the index's first level page
+     * @param col_idxs the indexed columns' indexes in the table's schema, in the order of the key
+     * @param tb_schema the table's schema
+     * @param from_scratch initialize the first level page if it's true
+     */
+    SecondaryIndex(BufferPoolManager *bpm, page_id_t first_page_id, const std::vector<offset_t> &col_idxs,
+        const Schema &tb_schema, index_code_t index_type = LINK_HASH, bool from_scratch = false);
+
+    ~SecondaryIndex();
+
+    DISALLOW_COPY_AND_MOVE(SecondaryIndex);
+
+    inline page_id_t get_first_page_id() const { return first_page_id_; }
+    inline const std::vector<offset_t>& get_col_idxs() const { return col_idxs_; }
+    inline index_code_t get_index_type() const { return index_type_; }
+
+    /** get the indexed columns' key from the table's tuple */
+    inline IndexKey get_key(const Tuple &tuple) const { return IndexKey(tuple.get_data(), key_cols_); }
+
+    /** make the key of a single column index */
+    inline IndexKey make_key(const Value &key_value) const { return IndexKey(key_value, key_cols_[0]); }
+
+    /** duplicate (key, rid) is not checked */
+    bool insert_entry(const IndexKey &key, const RID &rid);
+
+    /** @return false if the entry can't be found */
+    bool delete_entry(const IndexKey &key, const RID &rid);
+
+    /** @param rids RIDs of all the tuples whose key is equal to the key are appended */
+    void scan_key(const IndexKey &key, std::vector<RID> *rids);
+
+    /** delete all the pages of this index, it can't be used any more after it */
+    void delete_all_data();
+
+private:
+    inline size_t_ get_entry_size() const { return key_size_ + PGID_T_SIZE + OFFSET_T_SIZE; }
+
+    /** @return the head of the link list that the key is hashed to, INVALID_PAGE_ID if it's empty */
+    page_id_t get_list_head(hash_t hash_val);
+
+    BufferPoolManager *bpm_;
+    page_id_t first_page_id_;
+    std::vector<offset_t> col_idxs_;
+
+    /** the indexed columns in the table's tuple */
+    std::vector<Column> key_cols_;
+    size_t_ key_size_;
+    index_code_t index_type_;
+    LinkHashDirectory *lk_ha_dir_;
+};
+
+} // namespace dawn
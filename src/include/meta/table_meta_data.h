@@ -19,12 +19,25 @@ namespace dawn {
  * ------------------------------------------------------------------------
  * |                          common header (64)                          |
  * ------------------------------------------------------------------------
- * | first_table_page_id_ (4) | index_header_page_id_ (4) | Reserved (64) |
+ * | first_table_page_id_ (4) | index_header_page_id_ (4) |
+ * ------------------------------------------------------------------------
+ * | key col num (4) | key col idxs (4 * MAX_KEY_COL_NUM) | layout (4) | Reserved (24) |
  * ------------------------------------------------------------------------
  * | column num (4) | col name length 1 (4) | name 1 (x) | offset 1 (4) |
  * ------------------------------------------------------------------------
  * | type id 1 (4) | data size 1 (4) | ... |
  * ------------------------------------------------------------------------
+ * data size is the max length of CHAR and VARCHAR columns,
+ * and layout is the storage layout of the table's pages (ROW_LAYOUT or PAX_LAYOUT)
+ * 
+ * index header page layout:
+ * ------------------------------------------------------------------------
+ * |                          common header (64)                          |
+ * ------------------------------------------------------------------------
+ * | index num (4) | col num 1 (4) | col idxs 1 (4 * MAX_KEY_COL_NUM) |
+ * ------------------------------------------------------------------------
+ * | index type 1 (4) | first page id 1 (4) | col num 2 (4) | ... |
+ * ------------------------------------------------------------------------
  */
 class TableMetaData {
 public:
@@ -56,9 +69,37 @@ public:
     inline void set_table_name(const std::string& new_name){ table_name_ = new_name;};
     
     void delete_table_data();
+
+    /**
+     * create a secondary index on the columns, tuples that have been in the table are indexed at once.
+     * @param col_idxs the composite key's columns, in the order of the key
+     * @return false if the columns have been indexed, the index type is not supported,
+     *         or the table has had MAX_INDEX_NUM indexes
+     */
+    bool create_index(const std::vector<offset_t> &col_idxs, index_code_t index_type = LINK_HASH);
+
+    bool create_index(offset_t col_idx, index_code_t index_type = LINK_HASH) {
+        return create_index(std::vector<offset_t>{col_idx}, index_type);
+    }
+
+    /** the max number of columns in the primary key or the secondary index's key */
+    static constexpr size_t_ MAX_KEY_COL_NUM = 8;
+private:
+    static constexpr offset_t INDEX_NUM_OFFSET = COM_PG_HEADER_SZ;
+    static constexpr offset_t FIRST_INDEX_OFFSET = COM_PG_HEADER_SZ + SIZE_T_SIZE;
+    static constexpr size_t_ INDEX_INFO_SIZE = SIZE_T_SIZE + OFFSET_T_SIZE * MAX_KEY_COL_NUM + sizeof(index_code_t) + PGID_T_SIZE;
+public:
+    /** the max number of secondary indexes of a table, their info should fit in the index header page */
+    static constexpr size_t_ MAX_INDEX_NUM = (PAGE_SIZE - FIRST_INDEX_OFFSET) / INDEX_INFO_SIZE;
 private:
+    /** create the secondary indexes recorded in the index header page */
+    void load_indexes();
+
     static constexpr offset_t FIRST_TABLE_PGID_OFFSET = COM_PG_HEADER_SZ;
     static constexpr offset_t INDEX_HEADER_PGID_OFFSET = COM_PG_HEADER_SZ + sizeof(page_id_t);
+    static constexpr offset_t KEY_COL_NUM_OFFSET = COM_PG_HEADER_SZ + 2*sizeof(page_id_t);
+    static constexpr offset_t FIRST_KEY_COL_OFFSET = KEY_COL_NUM_OFFSET + SIZE_T_SIZE;
+    static constexpr offset_t LAYOUT_OFFSET = FIRST_KEY_COL_OFFSET + OFFSET_T_SIZE * MAX_KEY_COL_NUM;
     static constexpr offset_t COLUMN_NUM_OFFSET = COM_PG_HEADER_SZ + 2*sizeof(page_id_t) + 64; // 64 is reserved space
     static constexpr offset_t FIRST_COLUMN_OFFSET = COM_PG_HEADER_SZ + 2*sizeof(page_id_t) + 64 + sizeof(size_t_);
 
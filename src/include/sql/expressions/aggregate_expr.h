@@ -1,64 +1,98 @@
 #pragma once
 
-#include "plans/expressions/expr_abstr.h"
+#include "sql/expressions/expr_abstr.h"
 #include "data/types.h"
+#include "data/kernels.h"
 
 namespace dawn {
 
+/**
+ * the intermediate result of an aggregation. Each worker of a parallel plan keeps its own states,
+ * so the aggregation needn't any lock.
+ */
+struct AggregateState {
+    Value value;
+    bool empty = true;
+
+    /** the kernel is bound with the types of the last operands */
+    arith_kernel_t kernel = nullptr;
+    TypeId lhs_type = TypeId::kInvalid;
+    TypeId rhs_type = TypeId::kInvalid;
+};
+
+/**
+ * AggregateExpression computes COUNT/SUM/MIN/MAX of a column. The aggregation is split into two phases:
+ * accumulate() adds the tuples into a state (partial), and combine() merges the states (final), e.g.
+ * each worker accumulates its own tuples and the states of the workers are combined at last. The state
+ * is owned by the caller, so these methods could be called by several threads at the same time.
+ *
+ * evaluate() accumulates the tuple into the expression's own state and returns the result so far,
+ * it's not thread-safe.
+ */
 class AggregateExpression : public ExpressionAbstract {
 public:
-    AggregateExpression(AggregationType type, offset_t agg_idx) : type_(type), agg_idx_(agg_idx) {
-        switch (type_) {
-            case AggregationType::kCountAggregate: 
-            case AggregationType::kSumAggregate: 
-                val_ = Value(static_cast<integer_t>(0));
-                break;
-            case AggregationType::kMinAggregate:
-                val_ = Value(static_cast<integer_t>(INT32_MAX));
-                break;
-            case AggregationType::kMaxAggregate:
-                val_ = Value(static_cast<integer_t>(INT32_MIN));
-                break;
-            default:
-                LOG("should not reach here");
-                break;
-        }
-    }
+    AggregateExpression(AggregationType type, offset_t agg_idx) : type_(type), agg_idx_(agg_idx) {}
     ~AggregateExpression() = default;
     Value evaluate(const Tuple *tuple, const Schema *schema) override {
-        perform_aggregation(tuple, schema);
-        return val_;
+        accumulate(&state_, tuple, schema);
+        return finalize(state_);
     }
+    void get_col_idxs(std::vector<offset_t> *col_idxs) const override {
+        col_idxs->push_back(agg_idx_);
+    }
+
+    /** add the tuple into the state */
+    void accumulate(AggregateState *state, const Tuple *tuple, const Schema *schema) const {
+        if (type_ == AggregationType::kCountAggregate) {
+            if (state->empty)
+                state->value = Value(static_cast<integer_t>(0));
+            ++state->value;
+            state->empty = false;
+            return;
+        }
+        merge(state, tuple->get_value(*schema, agg_idx_));
+    }
+
+    /** merge the other state into the state, COUNT of the states are added */
+    void combine(AggregateState *state, const AggregateState &other) const {
+        if (!other.empty)
+            merge(state, other.value);
+    }
+
+    /** @return the result of the state, 0 if nothing is aggregated */
+    Value finalize(const AggregateState &state) const {
+        return state.empty ? Value(static_cast<integer_t>(0)) : state.value;
+    }
+
+    /** clear the state used by evaluate() */
+    inline void reset() { state_ = AggregateState(); }
+
+    inline AggregationType get_type() const { return type_; }
 private:
-    void perform_aggregation(const Tuple *tuple, const Schema *schema) {
-        switch (type_) {
-            case AggregationType::kCountAggregate:  {
-                ++val_;
-                break;
-            }
-            case AggregationType::kSumAggregate: {
-                val_ = ADD(val_.get_type_id(), val_, tuple->get_value(*schema, agg_idx_));
-                break;
-            }
-            case AggregationType::kMinAggregate: {
-                if (CMP_LESS(val_.get_type_id(), tuple->get_value(*schema, agg_idx_), val_) == CmpResult::kTrue)
-                    val_ = tuple->get_value(*schema, agg_idx_);
-                break;
-            }
-            case AggregationType::kMaxAggregate: {
-                if (CMP_GREATER(val_.get_type_id(), tuple->get_value(*schema, agg_idx_), val_) == CmpResult::kTrue)
-                    val_ = tuple->get_value(*schema, agg_idx_);
-                break;
-            }
-            default:
-                LOG("should not reach here");
-                break;
+    void merge(AggregateState *state, const Value &val) const {
+        if (state->empty) {
+            state->value = val;
+            state->empty = false;
+            return;
         }
+
+        if (state->kernel == nullptr || state->lhs_type != state->value.get_type_id() ||
+            state->rhs_type != val.get_type_id()) {
+            ArithmeticType arith_type = ArithmeticType::kAdd;
+            if (type_ == AggregationType::kMinAggregate)
+                arith_type = ArithmeticType::kMin;
+            else if (type_ == AggregationType::kMaxAggregate)
+                arith_type = ArithmeticType::kMax;
+            state->lhs_type = state->value.get_type_id();
+            state->rhs_type = val.get_type_id();
+            state->kernel = get_arith_kernel(state->lhs_type, state->rhs_type, arith_type);
+        }
+        state->value = state->kernel(state->value, val);
     }
 
-    Value val_;
-    offset_t agg_idx_;
     AggregationType type_;
+    offset_t agg_idx_;
+    AggregateState state_;
 };
 
 } // namespace dawn
@@ -12,6 +12,22 @@ public:
     Value evaluate(const Tuple *tuple, const Schema *schema) override {
         return tuple->get_value(*schema, col_idx_);
     }
+    void get_col_idxs(std::vector<offset_t> *col_idxs) const override {
+        col_idxs->push_back(col_idx_);
+    }
+    bool get_batch_operand(const TupleBatch &batch, const char **data, TypeId *type_id, bool *is_const) const override {
+        const ColumnVector *col = batch.get_column(col_idx_);
+        if (!col->is_valid() || is_string_type(col->get_type_id()))
+            return false;
+        *data = col->get_data<char>();
+        *type_id = col->get_type_id();
+        *is_const = false;
+        return true;
+    }
+    void evaluate_batch(const TupleBatch &batch, ColumnVector *result) override {
+        result->copy_rows(*batch.get_column(col_idx_), batch.get_selection(), batch.get_count());
+    }
+    inline offset_t get_col_idx() const { return col_idx_; }
 private:
     offset_t col_idx_;
 };
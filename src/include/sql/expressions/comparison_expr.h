@@ -4,43 +4,70 @@
 #include "sql/expressions/expr_abstr.h"
 #include "data/types.h"
 #include "data/boolean.h"
+#include "data/kernels.h"
 
 namespace dawn {
 
+/**
+ * The comparison kernel is selected by the types of the children. It's selected when the
+ * expression is built if the types are given, or else when the first row is evaluated.
+ */
 class ComparisonExpression : public ExpressionAbstract {
 public:
     ComparisonExpression(std::vector<ExpressionAbstract*> children, ComparisonType cmp_type)
         : children_(children), cmp_type_(cmp_type) {}
+    ComparisonExpression(std::vector<ExpressionAbstract*> children, ComparisonType cmp_type,
+        TypeId lhs_type, TypeId rhs_type)
+        : children_(children), cmp_type_(cmp_type) {
+        bind(lhs_type, rhs_type);
+    }
     ~ComparisonExpression() = default;
     Value evaluate(const Tuple *tuple, const Schema *schema) override {
         Value lhs = children_[0]->evaluate(tuple, schema);
         Value rhs = children_[1]->evaluate(tuple, schema);
-        return perform_cmp(lhs, rhs);
+        if (lhs.get_type_id() != lhs_type_ || rhs.get_type_id() != rhs_type_)
+            bind(lhs.get_type_id(), rhs.get_type_id());
+        return kernel_(lhs, rhs);
     }
-private:
-    CmpResult perform_cmp(const Value &lhs, const Value &rhs) const {
-        switch (cmp_type_) {
-            case ComparisonType::kEqual:
-                return CMP_EQ(lhs.get_type_id(), lhs, rhs);
-            case ComparisonType::kNotEqual:
-                return CMP_NOT_EQ(lhs.get_type_id(), lhs, rhs);
-            case ComparisonType::kLessThan:
-                return CMP_LESS(lhs.get_type_id(), lhs, rhs);
-            case ComparisonType::kLessThanOrEqual:
-                return CMP_LESS_EQ(lhs.get_type_id(), lhs, rhs);
-            case ComparisonType::kGreaterThan:
-                return CMP_GREATER(lhs.get_type_id(), lhs, rhs);
-            case ComparisonType::kGreaterThanOrEqual:
-                return CMP_GREATER_EQ(lhs.get_type_id(), lhs, rhs);
-            default: {
-                LOG("should not reach here");
-                exit(-1);
-            }
+    void get_col_idxs(std::vector<offset_t> *col_idxs) const override {
+        for (auto child : children_)
+            child->get_col_idxs(col_idxs);
+    }
+
+    /** the numeric columns and constants are compared as arrays, others are evaluated row by row */
+    size_t_ select_batch(const TupleBatch &batch, int *sel_out) override {
+        const char *lhs, *rhs;
+        TypeId lhs_type, rhs_type;
+        bool lhs_const, rhs_const;
+        if (!children_[0]->get_batch_operand(batch, &lhs, &lhs_type, &lhs_const) ||
+            !children_[1]->get_batch_operand(batch, &rhs, &rhs_type, &rhs_const))
+            return ExpressionAbstract::select_batch(batch, sel_out);
+
+        if (lhs_type != sel_lhs_type_ || rhs_type != sel_rhs_type_) {
+            sel_lhs_type_ = lhs_type;
+            sel_rhs_type_ = rhs_type;
+            sel_kernel_ = get_sel_kernel(lhs_type, rhs_type, cmp_type_);
         }
+        if (sel_kernel_ == nullptr)
+            return ExpressionAbstract::select_batch(batch, sel_out);
+        return sel_kernel_(lhs, lhs_const, rhs, rhs_const, batch.get_selection(), batch.get_count(), sel_out);
+    }
+private:
+    void bind(TypeId lhs_type, TypeId rhs_type) {
+        // the Value of a VARCHAR column is kChar
+        lhs_type_ = lhs_type == TypeId::kVarchar ? TypeId::kChar : lhs_type;
+        rhs_type_ = rhs_type == TypeId::kVarchar ? TypeId::kChar : rhs_type;
+        kernel_ = get_cmp_kernel(lhs_type_, rhs_type_, cmp_type_);
     }
 
     std::vector<ExpressionAbstract*> children_;
     ComparisonType cmp_type_;
+    TypeId lhs_type_ = TypeId::kInvalid;
+    TypeId rhs_type_ = TypeId::kInvalid;
+    cmp_kernel_t kernel_ = nullptr;
+    TypeId sel_lhs_type_ = TypeId::kInvalid;
+    TypeId sel_rhs_type_ = TypeId::kInvalid;
+    sel_kernel_t sel_kernel_ = nullptr;
 };
 
 } // namespace dawn
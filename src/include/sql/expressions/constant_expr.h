@@ -1,16 +1,28 @@
 #pragma once
 
-#include "plans/expressions/expr_abstr.h"
+#include "sql/expressions/expr_abstr.h"
 #include "data/values.h"
 
 namespace dawn {
 
 class ConstantExpression : public ExpressionAbstract {
 public:
-    ConstantExpression(const Value &val) : val_(val){}
+    ConstantExpression(const Value &val) : val_(val) {
+        if (!is_string_type(val_.get_type_id()) && val_.get_type_id() != TypeId::kInvalid)
+            val_.serialize_to(raw_);
+    }
     Value evaluate(const Tuple *tuple, const Schema *schema) override { return val_; }
+    bool get_batch_operand(const TupleBatch &batch, const char **data, TypeId *type_id, bool *is_const) const override {
+        if (is_string_type(val_.get_type_id()) || val_.get_type_id() == TypeId::kInvalid)
+            return false;
+        *data = raw_;
+        *type_id = val_.get_type_id();
+        *is_const = true;
+        return true;
+    }
 private:
     Value val_;
+    alignas(decimal_t) char raw_[DECIMAL_T_SIZE]; // the value read by the kernels
 };
 
 } // namespace dawn
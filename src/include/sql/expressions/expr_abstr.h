@@ -3,6 +3,7 @@
 #include "data/values.h"
 #include "table/schema.h"
 #include "table/tuple.h"
+#include "table/tuple_batch.h"
 
 namespace dawn {
 
@@ -11,6 +12,50 @@ public:
     ExpressionAbstract() = default;
     virtual ~ExpressionAbstract() = default;
     virtual Value evaluate(const Tuple *tuple, const Schema *schema) = 0;
+
+    /** collect the columns read by the expression, so that the toasted ones could be fetched before evaluating */
+    virtual void get_col_idxs(std::vector<offset_t> *col_idxs) const {}
+
+    /**
+     * describe the expression as an array of the batch, so that the kernels could read it directly
+     * @param is_const true if data points to a single value used by all rows
+     * @return false if the expression can't be read as an array of the native type
+     */
+    virtual bool get_batch_operand(const TupleBatch &batch, const char **data, TypeId *type_id, bool *is_const) const {
+        return false;
+    }
+
+    /**
+     * evaluate the selected rows of the batch, the result of the i-th selected row is stored in the i-th row.
+     * By default, the rows are built into tuples and evaluated one by one.
+     */
+    virtual void evaluate_batch(const TupleBatch &batch, ColumnVector *result) {
+        Tuple tuple;
+        size_t_ count = batch.get_count();
+        for (size_t_ i = 0; i < count; i++) {
+            batch.get_tuple(batch.get_row(i), &tuple);
+            result->set_value(i, evaluate(&tuple, batch.get_schema()));
+        }
+    }
+
+    /**
+     * keep the selected rows of the batch whose result is true
+     * @param sel_out the rows kept are written to it, it may be the batch's selection
+     * @return number of the rows kept
+     */
+    virtual size_t_ select_batch(const TupleBatch &batch, int *sel_out) {
+        Tuple tuple;
+        Value true_val(true);
+        size_t_ count = batch.get_count();
+        size_t_ cnt = 0;
+        for (size_t_ i = 0; i < count; i++) {
+            int row = batch.get_row(i);
+            batch.get_tuple(row, &tuple);
+            if (evaluate(&tuple, batch.get_schema()) == true_val)
+                sel_out[cnt++] = row;
+        }
+        return cnt;
+    }
 private:
 
 };
@@ -24,8 +24,11 @@ namespace dawn {
  * | db_name size (4) | db_name... | log_name size (4) | log_name ... |
  * --------------------------------------------------------------------
  * --------------------------------------------------------------------
- * | max_ava_pgid_ (4) |  Reserved (128)    |
- * --------------------------------------------------------------------
+ * -------------------------------------------------------------------------------------------
+ * | max_ava_pgid_ (4) | catalog page id (4) | page size (4) | format version (4) | Reserved (120) |
+ * -------------------------------------------------------------------------------------------
+ * page size is 0 in the files written before the format version 1, they are rejected.
+ * format version is 0 in the files written before it's recorded, they are of version 1 if the page size is recorded.
  */
 class DiskManager {
 friend class DiskManager_T;
@@ -88,6 +91,8 @@ private:
     offset_t log_name_offset;
     offset_t max_ava_pgid_offset;
     offset_t catalog_pgid_offset;
+    offset_t page_size_offset;
+    offset_t format_version_offset;
     offset_t reserved_offset;
 
     fstream_t db_io_;
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <algorithm>
+
+#include "storage/page/page.h"
+
+namespace dawn {
+
+/**
+ * WARNING DO NOT ADD ANY DATA MEMBER!
+ *
+ * This Page stores a part of a large value moved out of the tuple, see table/toast.h.
+ * Pages of a value are chained with the next page id, and the last one's is INVALID_PAGE_ID.
+ * OverflowPage layout:
+ * -----------------------------------------------------
+ * |              common page header (64)              |
+ * -----------------------------------------------------
+ * -----------------------------------------------------
+ * | next page id (4) | data size (4) |      data      |
+ * -----------------------------------------------------
+ */
+class OverflowPage : public Page {
+public:
+    void init(page_id_t next_pgid) {
+        set_next_page_id(next_pgid);
+        set_data_size(0);
+    }
+
+    inline page_id_t get_next_page_id() const {
+        return *reinterpret_cast<page_id_t*>(get_data() + NEXT_PGID_OFFSET);
+    }
+
+    inline void set_next_page_id(page_id_t page_id) {
+        memcpy(get_data() + NEXT_PGID_OFFSET, &page_id, PGID_T_SIZE);
+    }
+
+    inline size_t_ get_data_size() const {
+        return *reinterpret_cast<size_t_*>(get_data() + DATA_SIZE_OFFSET);
+    }
+
+    /** @param size should not be larger than get_capacity() */
+    inline void write_data(const char *src, size_t_ size) {
+        memcpy(get_data() + FIRST_DATA_OFFSET, src, size);
+        set_data_size(size);
+    }
+
+    /**
+     * @param max_size dst can't contain more bytes than it, the rest of the data is not copied
+     * @return number of bytes copied to dst, -1 if the data size is invalid
+     */
+    inline size_t_ read_data(char *dst, size_t_ max_size) const {
+        size_t_ size = get_data_size();
+        if (size < 0 || size > get_capacity())
+            return -1;
+        size = std::min(size, max_size);
+        memcpy(dst, get_data() + FIRST_DATA_OFFSET, size);
+        return size;
+    }
+
+    /** @return bytes of the value a page could contain */
+    inline static constexpr size_t_ get_capacity() { return PAGE_SIZE - FIRST_DATA_OFFSET; }
+
+private:
+    inline void set_data_size(size_t_ size) {
+        memcpy(get_data() + DATA_SIZE_OFFSET, &size, SIZE_T_SIZE);
+    }
+
+    static constexpr offset_t NEXT_PGID_OFFSET = COM_PG_HEADER_SZ;
+    static constexpr offset_t DATA_SIZE_OFFSET = NEXT_PGID_OFFSET + PGID_T_SIZE;
+    static constexpr offset_t FIRST_DATA_OFFSET = DATA_SIZE_OFFSET + SIZE_T_SIZE;
+};
+
+} // namespace dawn
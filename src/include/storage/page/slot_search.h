@@ -0,0 +1,42 @@
+#pragma once
+
+#include "util/config.h"
+
+namespace dawn {
+
+/**
+ * Kernels searching the tuple record array of a TablePage.
+ * 
+ * Every record is | tuple offset (4) | tuple size (4) |, and the slot is empty when the offset is 0.
+ * SIMD kernels check 8 records at a time, and the remaining records are checked one by one.
+ * The kernel is chosen once according to the CPU, call the slot_search_* functions instead of
+ * the kernels directly.
+ */
+enum class SlotSearchKernel { kScalar, kSSE4, kAVX2 };
+
+struct SlotSearchFuncs {
+    /** @return the first slot in [begin, end) that is empty (empty == true) or not, end if there is none */
+    offset_t (*find_slot)(const char *records, offset_t begin, offset_t end, bool empty);
+
+    /** @return number of the non-empty slots in [0, count) */
+    size_t_ (*count_live)(const char *records, size_t_ count);
+};
+
+/** @return the kernels chosen for this CPU */
+const SlotSearchFuncs& get_slot_search_funcs();
+
+/**
+ * used by tests and benchmarks to compare the kernels
+ * @return nullptr if the CPU doesn't support the kernel
+ */
+const SlotSearchFuncs* get_slot_search_funcs(SlotSearchKernel kernel);
+
+inline offset_t slot_search_find(const char *records, offset_t begin, offset_t end, bool empty) {
+    return get_slot_search_funcs().find_slot(records, begin, end, empty);
+}
+
+inline size_t_ slot_search_count_live(const char *records, size_t_ count) {
+    return get_slot_search_funcs().count_live(records, count);
+}
+
+} // namespace dawn
@@ -7,6 +7,9 @@
 #include "buffer/buffer_pool_manager.h"
 #include "table/tuple.h"
 #include "table/rid.h"
+#include "storage/page/slot_search.h"
+
+#include <algorithm>
 
 namespace dawn {
 
@@ -23,9 +26,9 @@ namespace dawn {
  * ------------------------------------------------------------------------
  * | previous page id (4) | next page id (4) |   free space pointer (4)   |
  * ------------------------------------------------------------------------
- * ------------------------------------------------------------------------
- * |                            reserved (64)                             |
- * ------------------------------------------------------------------------
+ * ------------------------------------------------------------------------------------------------
+ * | key filter (48) | free slot count (4) | free slot hint (4) | PAX capacity (4) | column num (4) |
+ * ------------------------------------------------------------------------------------------------
  * ------------------------------------------------------------------------
  * | tuple count (4) | tuple offset 1 (4) | tuple size 1 (4) |    .....   |
  * ------------------------------------------------------------------------
@@ -34,6 +37,29 @@ namespace dawn {
  * -----------------------------------------------
  *                 ^
  *                 free space pointer
+ *
+ * key filter is a tiny bloom filter over the hash values of the keys stored in this page.
+ * The index sets the bits when it inserts a tuple, and checks them before scanning the page.
+ * Bits are never cleared by deletion, so the filter may report false positives but never
+ * false negatives.
+ *
+ * free slot count is the number of empty slots in the tuple record array, and there is no
+ * empty slot before the free slot hint. insert_tuple() appends a new slot directly when there
+ * is no empty slot, or searches from the hint otherwise.
+ *
+ * Tables with the PAX_LAYOUT store the tuples column by column in each page, it's only for the
+ * tuples with fixed length. The page could contain at most PAX capacity tuples, and the values of
+ * a column are put together in a mini page, the value of slot i is at i * column size.
+ * The tuple records are the same as the row layout, but their offsets only show the slots are used.
+ * PAX capacity is 0 for the row layout.
+ * ---------------------------------------------------------------------------------------------
+ * | tuple count (4) | tuple records (8 * capacity) | ... | mini page 1 | mini page 2 | ... |
+ * ---------------------------------------------------------------------------------------------
+ * ------------------------------------------------------------------------
+ * | ... | mini page n | column size 1 (4) | column size 2 (4) | ... | column size n (4) |
+ * ------------------------------------------------------------------------
+ *       ^
+ *       free space pointer, it's fixed in the PAX layout
  */
 class TablePage : public Page {
 public:
@@ -43,6 +69,9 @@ public:
     
     void init(const page_id_t prev_pgid, const page_id_t next_pgid);
 
+    /** initialize the page with the table's layout */
+    void init(const page_id_t prev_pgid, const page_id_t next_pgid, const Schema &tb_schema);
+
     inline page_id_t get_next_page_id() {
         return *reinterpret_cast<page_id_t*>(get_data() + NEXT_PGID_OFFSET);
     }
@@ -78,11 +107,110 @@ public:
     void apply_delete(const RID &rid);
 
     /**
-     * we suppose that all the table's tuples have the same size
+     * tuples may have different sizes. The tuple is updated in place, and the tuples' data
+     * is moved to keep it contiguous when the size is changed.
+     * @return false if the page has no enough space for the larger tuple
      */
     bool update_tuple(const Tuple &new_tuple, const RID &rid);
 
     bool get_tuple(Tuple *tuple, const RID &rid) const;
+
+    /**
+     * attach the tuple to its data in the page without copying it,
+     * the tuple is valid only when the page is pinned and not modified.
+     * @return false if the slot is empty, or the page has the PAX layout
+     */
+    bool get_tuple_ref(Tuple *tuple, const RID &rid) const;
+
+    /**
+     * only these columns are copied from the PAX page, the others are left 0.
+     * The whole tuple is copied in the row layout.
+     */
+    bool get_tuple_columns(Tuple *tuple, const RID &rid, const std::vector<offset_t> &col_idxs) const;
+
+    /** @return true if the slot holds a tuple marked as deleted */
+    inline bool is_marked_delete(offset_t slot_num) const {
+        if (slot_num < 0 || slot_num >= get_tuple_count() || get_tuple_offset(slot_num) == 0)
+            return false;
+        return is_deleted(get_tuple_size(slot_num));
+    }
+
+    /**
+     * access the tuple's data in the page directly without copying it.
+     * Tuples marked as deleted are also visible, the same as get_tuple().
+     * @return nullptr if the slot is empty, or the page has the PAX layout
+     */
+    inline char* get_tuple_data(offset_t slot_num) const {
+        if (slot_num < 0 || slot_num >= get_tuple_count() || is_pax())
+            return nullptr;
+
+        offset_t offset = get_tuple_offset(slot_num);
+        if (offset == 0)
+            return nullptr;
+        return get_data() + offset;
+    }
+
+    /**
+     * the same as get_tuple_data(), but the PAX tuple is gathered into the buf
+     * @param buf should be able to contain get_pax_tuple_size() bytes for the PAX page
+     */
+    inline const char* get_tuple_row(offset_t slot_num, char *buf) const {
+        if (!is_pax())
+            return get_tuple_data(slot_num);
+        if (slot_num < 0 || slot_num >= get_tuple_count() || get_tuple_offset(slot_num) == 0)
+            return nullptr;
+        read_pax_tuple(slot_num, buf);
+        return buf;
+    }
+
+    inline bool is_pax() const { return get_pax_capacity() > 0; }
+
+    /** @return number of tuples the PAX page could contain, 0 for the row layout */
+    inline size_t_ get_pax_capacity() const {
+        return *reinterpret_cast<size_t_*>(get_data() + PAX_CAPACITY_OFFSET);
+    }
+
+    inline size_t_ get_pax_col_num() const {
+        return *reinterpret_cast<size_t_*>(get_data() + PAX_COL_NUM_OFFSET);
+    }
+
+    inline size_t_ get_pax_col_size(offset_t col_idx) const {
+        return *reinterpret_cast<size_t_*>(get_data() + get_pax_col_sizes_offset() + col_idx * SIZE_T_SIZE);
+    }
+
+    inline size_t_ get_pax_tuple_size() const {
+        return (get_pax_col_sizes_offset() - get_free_space_pointer()) / get_pax_capacity();
+    }
+
+    /**
+     * the column's values are contiguous, the value of slot i is at i * get_pax_col_size(col_idx).
+     * Check the slot with get_next_tuple_rid() before reading its value.
+     */
+    inline const char* get_pax_column(offset_t col_idx) const {
+        offset_t col_offset = 0;
+        for (offset_t i = 0; i < col_idx; i++)
+            col_offset += get_pax_col_size(i);
+        return get_data() + get_free_space_pointer() + get_pax_capacity() * col_offset;
+    }
+
+    /** record the key's hash value in the key filter */
+    inline void add_key_hash(hash_t hash_val) {
+        offset_t bit1;
+        offset_t bit2;
+        get_key_filter_bits(hash_val, &bit1, &bit2);
+        char *filter = get_data() + KEY_FILTER_OFFSET;
+        filter[bit1 / 8] |= static_cast<char>(1 << (bit1 % 8));
+        filter[bit2 / 8] |= static_cast<char>(1 << (bit2 % 8));
+    }
+
+    /** @return false: the key is absolutely not in this page, true: the key may be in this page */
+    inline bool may_contain_key(hash_t hash_val) const {
+        offset_t bit1;
+        offset_t bit2;
+        get_key_filter_bits(hash_val, &bit1, &bit2);
+        const char *filter = get_data() + KEY_FILTER_OFFSET;
+        return (filter[bit1 / 8] & (1 << (bit1 % 8))) && (filter[bit2 / 8] & (1 << (bit2 % 8)));
+    }
     
     /**
      * return the first tuple's rid when the cur_rid's page id is invalid
@@ -99,10 +227,26 @@ public:
      * @return number of the existing tuples
      */
     size_t_ get_stored_tuple_cnt() const;
+
+    /**
+     * @return bytes occupied by the existing tuples and their records,
+     *         empty slots are not counted.
+     */
+    size_t_ get_used_space() const;
+
+    /**
+     * @return bytes between the tuple records and the tuples' data.
+     *         It's the space of the slots that haven't been appended for the PAX page.
+     */
+    inline size_t_ get_free_space() const {
+        if (is_pax())
+            return (get_pax_capacity() - get_tuple_count()) * (get_pax_tuple_size() + TUPLE_RECORD_SZ);
+        return get_free_space_pointer() - (FIRST_TUPLE_OFFSET + get_tuple_count() * TUPLE_RECORD_SZ);
+    }
     
     inline static size_t_ get_tuple_record_sz() { return TUPLE_RECORD_SZ; }
 
-    inline static size_t_ get_tp_load_data_space() { return LOAD_DATA_SPACE; }
+    inline static constexpr size_t_ get_tp_load_data_space() { return LOAD_DATA_SPACE; }
 
     /** 
      * @param tp_size size of a tuple
@@ -116,6 +260,13 @@ private:
     static constexpr offset_t PREV_PGID_OFFSET = START_OFFSET;
     static constexpr offset_t NEXT_PGID_OFFSET = PREV_PGID_OFFSET + PGID_T_SIZE;
     static constexpr offset_t FREE_SPACE_PTR_OFFSET = NEXT_PGID_OFFSET + PGID_T_SIZE;
+    static constexpr offset_t KEY_FILTER_OFFSET = FREE_SPACE_PTR_OFFSET + PGID_T_SIZE;
+    static constexpr size_t_ KEY_FILTER_SZ = 48;
+    static constexpr offset_t KEY_FILTER_BITS = KEY_FILTER_SZ * 8;
+    static constexpr offset_t FREE_SLOT_CNT_OFFSET = KEY_FILTER_OFFSET + KEY_FILTER_SZ;
+    static constexpr offset_t FREE_SLOT_HINT_OFFSET = FREE_SLOT_CNT_OFFSET + SIZE_T_SIZE;
+    static constexpr offset_t PAX_CAPACITY_OFFSET = FREE_SLOT_HINT_OFFSET + OFFSET_T_SIZE;
+    static constexpr offset_t PAX_COL_NUM_OFFSET = PAX_CAPACITY_OFFSET + SIZE_T_SIZE;
     static constexpr offset_t TUPLE_CNT_OFFSET = FREE_SPACE_PTR_OFFSET + PGID_T_SIZE + TABLE_PAGE_RESERVED;
     static constexpr offset_t FIRST_TUPLE_OFFSET = TUPLE_CNT_OFFSET + SIZE_T_SIZE;
     static constexpr offset_t INVALID_FREE_SPACE_PTR = PAGE_SIZE;
@@ -139,6 +290,16 @@ private:
         return static_cast<size_t_>(tuple_size & (~DELETE_MASK));
     }
 
+    /**
+     * The lower bits of the hash value have been used for choosing the slot in the link hash,
+     * so the keys in the same link list are almost the same in them. Use the higher bits instead.
+     */
+    inline static void get_key_filter_bits(hash_t hash_val, offset_t *bit1, offset_t *bit2) {
+        uint32_t high = static_cast<uint32_t>(hash_val >> 32);
+        *bit1 = static_cast<offset_t>(high % KEY_FILTER_BITS);
+        *bit2 = static_cast<offset_t>((high / KEY_FILTER_BITS) % KEY_FILTER_BITS);
+    }
+
     /**
      * the returned value may be overestimated, because some slots may be empty
      */
@@ -163,16 +324,43 @@ private:
         return *reinterpret_cast<offset_t*>(get_data() + FIRST_TUPLE_OFFSET + slot_num * TUPLE_RECORD_SZ);
     }
 
+    /** tuple records are searched with the kernels in slot_search.h */
+    inline const char* get_tuple_records() const {
+        return get_data() + FIRST_TUPLE_OFFSET;
+    }
+
     inline void set_tuple_count(size_t_ tuple_count) {
         memcpy(get_data() + TUPLE_CNT_OFFSET, &tuple_count, SIZE_T_SIZE);
     }
 
-    inline offset_t get_free_space_pointer() const {
-        return *reinterpret_cast<offset_t*>(get_data() + FREE_SPACE_PTR_OFFSET);
+    inline size_t_ get_free_slot_count() const {
+        return *reinterpret_cast<size_t_*>(get_data() + FREE_SLOT_CNT_OFFSET);
     }
 
-    inline size_t_ get_free_space() {
-        return get_free_space_pointer() - (FIRST_TUPLE_OFFSET + get_tuple_count() * TUPLE_RECORD_SZ);
+    inline void set_free_slot_count(size_t_ free_slot_cnt) {
+        memcpy(get_data() + FREE_SLOT_CNT_OFFSET, &free_slot_cnt, SIZE_T_SIZE);
+    }
+
+    inline offset_t get_free_slot_hint() const {
+        return *reinterpret_cast<offset_t*>(get_data() + FREE_SLOT_HINT_OFFSET);
+    }
+
+    inline void set_free_slot_hint(offset_t slot_num) {
+        memcpy(get_data() + FREE_SLOT_HINT_OFFSET, &slot_num, OFFSET_T_SIZE);
+    }
+
+    inline offset_t get_pax_col_sizes_offset() const {
+        return PAGE_SIZE - get_pax_col_num() * SIZE_T_SIZE;
+    }
+
+    /** scatter the tuple's columns into the mini pages */
+    void write_pax_tuple(offset_t slot_num, const char *tuple_data);
+
+    /** gather the tuple from the mini pages */
+    void read_pax_tuple(offset_t slot_num, char *tuple_data) const;
+
+    inline offset_t get_free_space_pointer() const {
+        return *reinterpret_cast<offset_t*>(get_data() + FREE_SPACE_PTR_OFFSET);
     }
 
     inline void set_free_space_pointer(offset_t fsp_offset) {
@@ -190,7 +378,9 @@ private:
     }
 
     /**
-     * slot is empty when the tuple record's offset is 0
+     * slot is empty when the tuple record's offset is 0.
+     * Empty slots at the end of the record array are given back to the free space,
+     * so a page whose tuples are all deleted has the same free space as a new one.
      */
     inline void delete_tuple_record(offset_t slot_num) {
         size_t_ tuple_count = get_tuple_count();
@@ -199,9 +389,18 @@ private:
 
         offset_t tuple_record_offset = FIRST_TUPLE_OFFSET + slot_num * TUPLE_RECORD_SZ;
         memset(get_data() + tuple_record_offset, 0, TUPLE_RECORD_SZ);
-    }
+        size_t_ free_slot_cnt = get_free_slot_count() + 1;
 
-    offset_t get_empty_slot();
+        while (tuple_count > 0 && get_tuple_offset(tuple_count - 1) == 0) {
+            tuple_count--;
+            free_slot_cnt--;
+        }
+        set_tuple_count(tuple_count);
+
+        // pages written before the count was kept may have less free slots recorded than they have
+        set_free_slot_count(std::max(free_slot_cnt, 0));
+        set_free_slot_hint(std::min(get_free_slot_hint(), std::min(slot_num, tuple_count)));
+    }
 };
     
 } // namespace dawn
\ No newline at end of file
@@ -19,12 +19,25 @@ public:
     explicit Column(const string_t &column_name, offset_t offset, size_t_ char_length)
         : column_name_(column_name), offset_(offset), char_length_(char_length), fixed_length_(PTR_SIZE), column_type_(TypeId::kChar) {}
 
+    /**
+     * for the varchar initialization, the string is stored at the end of the tuple
+     * and only the slot referring to it is stored at the offset.
+     * @param column_type only tells it from the char initialization, it should be kVarchar
+     */
+    explicit Column(const string_t &column_name, offset_t offset, size_t_ max_length, TypeId column_type)
+        : column_name_(column_name), offset_(offset), char_length_(max_length), fixed_length_(VARCHAR_SLOT_SZ), column_type_(TypeId::kVarchar) {
+        if (column_type != TypeId::kVarchar) {
+            FATAL("the column with the max length should be varchar");
+        }
+    }
+
     ~Column() = default;
 
     inline offset_t get_offset() const { return offset_; }
     inline TypeId get_type_id() const { return column_type_; }
     inline string_t get_column_name() const { return column_name_; }
 
+    /** @return size of the column in the fixed part of the tuple */
     inline size_t_ get_data_size() const {
         if (column_type_ != TypeId::kChar)
             return fixed_length_;
@@ -34,6 +47,13 @@ public:
         return -1;
     }
 
+    /** @return max length of the string column, or the data size of other columns */
+    inline size_t_ get_max_length() const {
+        if (is_string_type(column_type_))
+            return char_length_;
+        return fixed_length_;
+    }
+
     // FIXME I think it's a bad method
     string_t to_string() const {
         std::ostringstream os;
@@ -41,7 +61,7 @@ public:
         os << "Column[" << column_name_ << ", " << type_to_string(column_type_) << ", "
             << "offset:" << offset_ << ", ";
 
-        if (column_type_ != TypeId::kChar) {
+        if (!is_string_type(column_type_)) {
             os << "fixed length:" << fixed_length_;
         } else {
             os << "char length:" << char_length_;
@@ -67,7 +87,7 @@ public:
             PRINT(col1.offset_, col2.offset_);
             return false;
         }
-        if (col1.get_data_size() != col2.get_data_size()) {
+        if (col1.get_data_size() != col2.get_data_size() || col1.get_max_length() != col2.get_max_length()) {
             return false;
         }
         return true;
@@ -86,6 +106,8 @@ private:
                 return char_length_;
             case TypeId::kDecimal:
                 return Type::get_decimal_size();
+            case TypeId::kVarchar:
+                return VARCHAR_SLOT_SZ;
         }
 
         PRINT("WARNING: Invalid TypeId");
@@ -4,27 +4,80 @@
 #include "buffer/buffer_pool_manager.h"
 #include "storage/page/link_hash_page.h"
 #include "storage/page/table_page.h"
+#include "table/tuple_view.h"
 
 namespace dawn {
 
 class LinkHashTableIter : public TableIterAbstract {
 public:
-    /** initialize the iter from the beginning */
-    LinkHashTableIter(page_id_t first_page_id, BufferPoolManager *bpm);
+    /**
+     * initialize the iter from the beginning
+     * @param col_idxs only these columns are read from the PAX pages, all of them are read if it's empty
+     * @param slot1_begin only the first level slots [slot1_begin, slot1_end) are traversed, e.g. a morsel
+     */
+    LinkHashTableIter(page_id_t first_page_id, BufferPoolManager *bpm,
+        const std::vector<offset_t> &col_idxs = std::vector<offset_t>{},
+        offset_t slot1_begin = 0, offset_t slot1_end = LK_HA_PG_SLOT_NUM);
 
-    ~LinkHashTableIter() override { delete tuple_; }
+    ~LinkHashTableIter() override {
+        unpin();
+        delete view_;
+    }
 
     DISALLOW_COPY(LinkHashTableIter);
 
-    const Tuple& operator*() const override { return *tuple_; }
+    const Tuple& operator*() const override { return **view_; }
 
-    Tuple* operator->() const override { return tuple_; }
+    Tuple* operator->() const override { return view_->get_tuple(); }
 
     TableIterAbstract &operator++() override;
+
+    /** the tuple is copied while the page is latched, and its buffer is reused by the next tuple */
+    const TupleView& get_view() const override { return *view_; }
 private:
+    /** the page should have been pinned and latched by the caller, it's pinned by the iter after that */
+    inline bool read_tuple(TablePage *tb_page, const RID &rid) {
+        if (!view_->refer(tb_page, rid, col_idxs_))
+            return false;
+        if (tb_page->get_page_id() != pinned_pgid_) {
+            unpin();
+            bpm_->get_page(tb_page->get_page_id());
+            pinned_pgid_ = tb_page->get_page_id();
+        }
+        return true;
+    }
+
+    inline void unpin() {
+        if (pinned_pgid_ != INVALID_PAGE_ID)
+            bpm_->unpin_page(pinned_pgid_, false);
+        pinned_pgid_ = INVALID_PAGE_ID;
+    }
+
+    /** the iter reaches to the end */
+    inline void set_end() {
+        unpin();
+        view_->release();
+        view_->get_tuple()->set_rid(RID(INVALID_PAGE_ID, INVALID_SLOT_NUM));
+    }
+
+    inline bool read_first_tuple(TablePage *tb_page) {
+        RID rid;
+        return tb_page->get_next_tuple_rid(RID(), &rid) && read_tuple(tb_page, rid);
+    }
+
     page_id_t first_page_id_;
     BufferPoolManager *bpm_;
-    Tuple *tuple_; // store the tuple referred by the iter
+    TupleView *view_; // the copy of the tuple in the page
+
+    /**
+     * the page of the current tuple is kept pinned, so that the compaction keeps it in the list
+     * and operator++() could go on from it
+     */
+    page_id_t pinned_pgid_ = INVALID_PAGE_ID;
+    std::vector<offset_t> col_idxs_;
+
+    /** the iter reaches to the end after the first level slot (slot1_end_ - 1) */
+    offset_t slot1_end_;
 
     /** 
      * refer to the first level page's slot,
@@ -37,13 +90,6 @@ private:
      * help the iter to know it accesses which link list
      */
     offset_t slot2_num_;
-
-    /**
-     * Refer to the TablePage which the tuple stays on.
-     * Always holds the write lock and pins the page.
-     * nullptr, if the iter reaches to the end
-     */
-    TablePage *cur_tb_page_;
 };
 
 } // namespace dawn
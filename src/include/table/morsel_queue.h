@@ -0,0 +1,54 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+
+#include "util/config.h"
+#include "util/util.h"
+
+namespace dawn {
+
+/**
+ * MorselQueue hands out the first level slots of a LinkHashTable to the scans of a parallel plan.
+ * Each morsel is MORSEL_SLOT_NUM consecutive slots (MORSEL_SLOT_NUM * LK_HA_PG_SLOT_NUM bucket
+ * chains), a worker takes the next morsel when it finishes the current one, so the fast workers
+ * take more morsels and the work is balanced.
+ *
+ * The scans sharing the queue attach to it in open() and detach in close(), the queue starts
+ * over when the last scan detaches, so that the plan could be opened again.
+ */
+class MorselQueue {
+public:
+    explicit MorselQueue(offset_t morsel_slots = MORSEL_SLOT_NUM) : morsel_slots_(morsel_slots) {}
+
+    ~MorselQueue() = default;
+
+    DISALLOW_COPY_AND_MOVE(MorselQueue);
+
+    /**
+     * take the first level slots [*begin, *end)
+     * @return false if all the slots have been handed out
+     */
+    inline bool next_morsel(offset_t *begin, offset_t *end) {
+        offset_t first = next_slot_.fetch_add(morsel_slots_);
+        if (first >= LK_HA_PG_SLOT_NUM)
+            return false;
+        *begin = first;
+        *end = std::min(first + morsel_slots_, LK_HA_PG_SLOT_NUM);
+        return true;
+    }
+
+    inline void attach() { scan_num_++; }
+
+    inline void detach() {
+        if (--scan_num_ == 0)
+            next_slot_ = 0;
+    }
+
+private:
+    const offset_t morsel_slots_;
+    std::atomic<offset_t> next_slot_{0};
+    std::atomic<int> scan_num_{0};
+};
+
+} // namespace dawn
@@ -18,13 +18,21 @@ namespace dawn {
 class Schema {
 public:
     explicit Schema(const std::vector<Column> &columns) : columns_(columns), length_(0) {
-        for (auto &col : columns_)
+        for (auto &col : columns_) {
             length_ += col.get_data_size();
+            if (col.get_type_id() == TypeId::kVarchar)
+                fixed_length_ = false;
+        }
     }
 
     ~Schema() = default;
 
+    /**
+     * @return size of the tuple's fixed part, it's the whole tuple's size when there is no VARCHAR column.
+     *         VARCHAR strings are appended after the fixed part.
+     */
     inline size_t_ get_tuple_size() const { return length_; }
+    inline bool is_fixed_length() const { return fixed_length_; }
     inline int get_column_num() const { return columns_.size(); }
 
     // QUESTION who should ensure the index is valid?
@@ -43,12 +51,35 @@ public:
         return -1;
     }
 
+    /** @return the first key column's index, it's the only one when the key is not composite */
     inline offset_t get_key_idx() const {
-        return key_idx_;
+        return key_idxs_[0];
     }
 
     inline void set_key_idx(offset_t key_idx) {
-        key_idx_ = key_idx;
+        key_idxs_ = std::vector<offset_t>{key_idx};
+    }
+
+    /** columns of the composite key, in the order that they are encoded in the key */
+    inline const std::vector<offset_t>& get_key_idxs() const {
+        return key_idxs_;
+    }
+
+    inline void set_key_idxs(const std::vector<offset_t> &key_idxs) {
+        if (!key_idxs.empty())
+            key_idxs_ = key_idxs;
+    }
+
+    /** ROW_LAYOUT or PAX_LAYOUT, see TablePage */
+    inline layout_code_t get_layout() const { return layout_; }
+    inline bool is_pax() const { return layout_ == PAX_LAYOUT; }
+
+    /** @return false if the layout is not supported, PAX_LAYOUT needs the tuples to have the fixed length */
+    inline bool set_layout(layout_code_t layout) {
+        if (layout != ROW_LAYOUT && (layout != PAX_LAYOUT || !fixed_length_))
+            return false;
+        layout_ = layout;
+        return true;
     }
 
     // FIXME I think it's a bad method
@@ -77,9 +108,11 @@ public:
 private:
     std::vector<Column> columns_;
     size_t_ length_; // the tuple's size
+    bool fixed_length_ = true;
 
-    // TODO the default key index is 0, change it!
-    offset_t key_idx_ = 0; // key index, and we do not support the jointly index
+    // the default key is the first column
+    std::vector<offset_t> key_idxs_{0};
+    layout_code_t layout_ = ROW_LAYOUT;
 };
 
 Schema* create_table_schema(const std::vector<TypeId> &types, 
@@ -87,4 +120,7 @@ Schema* create_table_schema(const std::vector<TypeId> &types,
 
 bool is_table_schemas_equal(const Schema &ts1, const Schema &ts2);
 
+/** @return schema of | left's columns | right's columns |, the offsets are laid out again */
+Schema* create_join_schema(const Schema &left, const Schema &right);
+
 } // namespace dawn
\ No newline at end of file
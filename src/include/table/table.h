@@ -9,6 +9,8 @@
 #include "table/rid.h"
 #include "table/tuple.h"
 #include "index/link_hash.h"
+#include "index/secondary_index.h"
+#include "table/toast.h"
 #include "mutex"
 
 namespace dawn {
@@ -24,17 +26,45 @@ class Table {
 public:
     // if from_scratch == true, it means that the Table should initialize the page in the disk
     Table(BufferPoolManager *bpm, const page_id_t first_table_page_id, bool from_scratch = false);
-    ~Table() = default;
-    void delete_all_data();
+    ~Table() {
+        for (auto index : indexes_)
+            delete index;
+        delete lk_ha_dir_;
+    }
+    /** the schema is used to find the overflow pages of the toasted values */
+    void delete_all_data(const Schema &tb_schema);
     page_id_t get_first_table_page_id() const { return first_table_page_id_; }
     // bool get_the_first_tuple(Tuple *tuple) const;
 
+    /**
+     * functions with the key_value can only be used when the key has a single column,
+     * encode the composite key with IndexKey and use the functions with the IndexKey instead.
+     */
+    static IndexKey make_key(const Value &key_value, const Schema &tb_schema) {
+        return IndexKey(key_value, tb_schema.get_column(tb_schema.get_key_idx()));
+    }
+
+    /**
+     * large values are moved to the overflow pages if the tuple is too large (see table/toast.h),
+     * the tuple stored in the page only has the pointers to them.
+     */
     bool insert_tuple(Tuple *tuple, const Schema &tb_schema);
-    bool mark_delete(const Value &key_value, const Schema &tb_schema);
+
+    /**
+     * load a batch of tuples, it's used for loading a lot of tuples into a new table
+     * @param tuples RID of the loaded tuple is set, and it's invalid if the tuple hasn't been loaded.
+     *               The tuples are kept as they are, as insert_tuple() does.
+     * @return false if any tuple can't be loaded, e.g. duplicated key
+     */
+    bool bulk_load(std::vector<Tuple> *tuples, const Schema &tb_schema);
+    bool mark_delete(const IndexKey &key, const Schema &tb_schema);
+    bool mark_delete(const Value &key_value, const Schema &tb_schema) { return mark_delete(make_key(key_value, tb_schema), tb_schema); }
     bool mark_delete(const RID &rid);
-    void apply_delete(const Value &key_value, const Schema &tb_schema);
-    void apply_delete(const RID &rid);
-    void rollback_delete(const Value &key_value, const Schema &tb_schema);
+    void apply_delete(const IndexKey &key, const Schema &tb_schema);
+    void apply_delete(const Value &key_value, const Schema &tb_schema) { apply_delete(make_key(key_value, tb_schema), tb_schema); }
+    void apply_delete(const RID &rid, const Schema &tb_schema);
+    void rollback_delete(const IndexKey &key, const Schema &tb_schema);
+    void rollback_delete(const Value &key_value, const Schema &tb_schema) { rollback_delete(make_key(key_value, tb_schema), tb_schema); }
     void rollback_delete(const RID &rid);
 
     /**
@@ -43,19 +73,68 @@ public:
     bool update_tuple(Tuple *new_tuple, const RID &old_rid, const Schema &tb_schema);
 
     /**
-     * search tuple with index, the rid will be set in the parameter *tuple
+     * search tuple with index, the rid will be set in the parameter *tuple.
+     * Toasted values are not fetched, use toast_fetch() if they are needed.
      */
-    bool get_tuple(const Value &key_value, Tuple *tuple, const Schema &tb_schema);
+    bool get_tuple(const IndexKey &key, Tuple *tuple, const Schema &tb_schema);
+    bool get_tuple(const Value &key_value, Tuple *tuple, const Schema &tb_schema) {
+        return get_tuple(make_key(key_value, tb_schema), tuple, tb_schema);
+    }
 
     /** get tuple directly */
     bool get_tuple(Tuple *tuple, const RID &rid);
 
+    /**
+     * search a batch of tuples with index, it's much cheaper than calling get_tuple() one by one
+     * @param tuples tuples are returned in the same order as the keys,
+     *               RID of the tuple whose key can't be found is invalid
+     * @return number of the tuples that have been found
+     */
+    size_t_ get_tuples(const std::vector<IndexKey> &keys, std::vector<Tuple> *tuples, const Schema &tb_schema);
+    size_t_ get_tuples(const std::vector<Value> &key_values, std::vector<Tuple> *tuples, const Schema &tb_schema);
+
     index_code_t get_index_type() const { return index_type_; }
+
+    /**
+     * secondary indexes are maintained in insert_tuple(), update_tuple() and apply_delete()
+     * @param index the Table takes the ownership of it, and it should be empty or consistent with the table
+     */
+    void add_index(SecondaryIndex *index) { indexes_.push_back(index); }
+
+    /**
+     * the writers maintaining the indexes share the latch, creating an index holds it exclusively while
+     * the existing tuples are indexed, so that no tuple written in the meantime is missed by the new index
+     */
+    void block_writers() { latch_.w_lock(); }
+    void unblock_writers() { latch_.w_unlock(); }
+
+    /** @return nullptr if these columns have no secondary index */
+    SecondaryIndex* get_index(const std::vector<offset_t> &col_idxs) const {
+        for (auto index : indexes_)
+            if (index->get_col_idxs() == col_idxs)
+                return index;
+        return nullptr;
+    }
+
+    SecondaryIndex* get_index(offset_t col_idx) const { return get_index(std::vector<offset_t>{col_idx}); }
+
+    const std::vector<SecondaryIndex*>& get_indexes() const { return indexes_; }
 private:
+    /** pin the index's directory, it's released in delete_all_data() or the destructor */
+    void init_directory();
+
+    /** key columns and indexed columns are never toasted, so that the keys are got from the tuple directly */
+    std::vector<offset_t> get_inline_cols(const Schema &tb_schema) const;
+
+    /** the index may be created after the tuple's values are toasted, fetch them first */
+    IndexKey get_index_key(SecondaryIndex *index, const Tuple &tuple, const Schema &tb_schema) const;
+
     BufferPoolManager *bpm_;
     const page_id_t first_table_page_id_; // TODO initialize it at first
     ReaderWriterLatch latch_;
     index_code_t index_type_ = LINK_HASH;
+    LinkHashDirectory *lk_ha_dir_ = nullptr;
+    std::vector<SecondaryIndex*> indexes_;
 
     op_code_t (*insert_tuple_func)(INSERT_TUPLE_FUNC_PARAMS);
     op_code_t (*mark_delete_func)(MARK_DELETE_FUNC_PARAMS);
@@ -63,6 +142,8 @@ private:
     void (*rollback_delete_func)(ROLLBACK_DELETE_FUNC_PARAMS);
     op_code_t (*get_tuple_func)(GET_TUPLE_FUNC_PARAMS);
     op_code_t (*update_tuple_func)(UPDATE_TUPLE_FUNC_PARAMS);
+    size_t_ (*get_tuples_func)(GET_TUPLES_FUNC_PARAMS);
+    op_code_t (*bulk_load_func)(BULK_LOAD_FUNC_PARAMS);
 };
 
 } // namespace dawn
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "table/tuple.h"
+#include "table/tuple_view.h"
 
 namespace dawn {
 
@@ -10,6 +11,9 @@ public:
     virtual const Tuple& operator*() const = 0;
     virtual Tuple* operator->() const = 0;
     virtual TableIterAbstract &operator++() = 0;
+
+    /** the iter's copy of the current tuple, it's valid until the iter moves on */
+    virtual const TupleView& get_view() const = 0;
 };
 
 } // namespace dawn
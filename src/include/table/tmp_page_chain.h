@@ -0,0 +1,68 @@
+#pragma once
+
+#include "util/config.h"
+#include "util/util.h"
+#include "table/tuple.h"
+#include "buffer/buffer_pool_manager.h"
+#include "storage/page/table_page.h"
+
+namespace dawn {
+
+/**
+ * TmpPageChain is a list of temporary TablePages linked by their next page ids. The executors
+ * spill tuples to it when they run out of the threshold pages, e.g. the partitions of the hash
+ * join and the runs of the external sort.
+ *
+ * Only the last page is pinned while the chain is written, call finish() to unpin it.
+ */
+class TmpPageChain {
+public:
+    TmpPageChain() = default;
+
+    /** append the tuple to the last page, a new page is linked when it's full */
+    void append(const Tuple &tuple, BufferPoolManager *bpm);
+
+    /** unpin the last page, nothing could be appended after that */
+    void finish(BufferPoolManager *bpm);
+
+    /** delete all the pages, the chain should not be read by anyone */
+    void destroy(BufferPoolManager *bpm);
+
+    inline page_id_t get_first_page_id() const { return first_pgid_; }
+    inline size_t_ get_tuple_num() const { return tuple_num_; }
+    inline bool is_empty() const { return tuple_num_ == 0; }
+
+private:
+    page_id_t first_pgid_ = INVALID_PAGE_ID;
+    TablePage *last_page_ = nullptr;
+    size_t_ tuple_num_ = 0;
+};
+
+/**
+ * TmpChainReader reads the tuples of a chain in order, the page being read is kept pinned.
+ * The tuple refers to the page, so it's valid until the reader jumps to the next page.
+ */
+class TmpChainReader {
+public:
+    TmpChainReader() = default;
+
+    ~TmpChainReader() { close(); }
+
+    DISALLOW_COPY(TmpChainReader);
+
+    /** start reading from the first page, the previous page is unpinned */
+    void open(page_id_t first_pgid, BufferPoolManager *bpm);
+
+    /** @return false if the chain is consumed, the page is unpinned at that time */
+    bool next(Tuple *tuple);
+
+    /** unpin the page being read */
+    void close();
+
+private:
+    BufferPoolManager *bpm_ = nullptr;
+    TablePage *page_ = nullptr;
+    RID pos_;
+};
+
+} // namespace dawn
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "util/config.h"
+#include "table/tuple.h"
+#include "table/schema.h"
+#include "buffer/buffer_pool_manager.h"
+#include "storage/page/table_page.h"
+
+#include <vector>
+
+/**
+ * TOAST (The Oversized-Attribute Storage Technique) keeps the TablePage dense.
+ *
+ * When a tuple is larger than TOAST_TUPLE_THRESHOLD, its largest VARCHAR values are moved
+ * out of the tuple one by one until it's small enough. Each moved value is stored in a chain
+ * of OverflowPages, and the tuple keeps a pointer | first page id | length | instead.
+ *
+ * CHAR columns are not toasted, they have fixed offsets in the tuple and can't be replaced with
+ * pointers, so a tuple whose CHAR columns alone don't fit in a page still fails to be stored.
+ * Wide strings should be VARCHAR.
+ *
+ * Tuples read from the table still carry the pointers, so scans never touch the overflow
+ * pages. Whoever needs the value of a toasted column fetches it with toast_fetch().
+ *
+ * ATTENTION overflow pages are never modified after they are written, a new value always
+ * gets a new chain and the old one is deleted with the tuple. No latch is taken on them,
+ * so the caller should ensure the tuple is not deleted while fetching its values.
+ */
+
+namespace dawn {
+
+/** tuples larger than it are toasted, so that a TablePage could contain 4 tuples at least */
+constexpr size_t_ TOAST_TUPLE_THRESHOLD = TablePage::get_tp_load_data_space() / 4;
+
+inline bool toast_needed(const Tuple &tuple) {
+    return tuple.get_size() > TOAST_TUPLE_THRESHOLD;
+}
+
+/**
+ * @param toasted tuple whose large values are replaced with the pointers
+ * @param inline_cols these columns are never toasted, e.g. the key and the indexed columns
+ * @return NEW_PG_FAIL if the overflow pages can't be allocated, nothing is left on the disk then
+ */
+op_code_t toast_tuple(const Tuple &tuple, Tuple *toasted, const Schema &tb_schema,
+    const std::vector<offset_t> &inline_cols, BufferPoolManager *bpm);
+
+/** @return the column's value, it's read from the overflow pages if it's toasted */
+Value toast_fetch_value(const Tuple &tuple, const Schema &tb_schema, int idx, BufferPoolManager *bpm);
+
+/**
+ * replace the pointers of these columns with their values,
+ * the tuple may be larger than a TablePage after that.
+ */
+void toast_fetch(Tuple *tuple, const Schema &tb_schema, const std::vector<offset_t> &col_idxs, BufferPoolManager *bpm);
+
+/** fetch all of the toasted columns */
+void toast_fetch(Tuple *tuple, const Schema &tb_schema, BufferPoolManager *bpm);
+
+/**
+ * delete the overflow pages of the tuple's toasted values
+ * @param kept values also referred by this tuple are not deleted, e.g. the new version of an updated tuple
+ */
+void toast_delete(const Tuple &tuple, const Schema &tb_schema, BufferPoolManager *bpm, const Tuple *kept = nullptr);
+
+/** @return the first page of the chain, INVALID_PAGE_ID if it fails */
+page_id_t toast_write_value(const char *src, size_t_ size, BufferPoolManager *bpm);
+
+/**
+ * @param dst should be able to contain size bytes, no more bytes are copied even if the pages hold more
+ * @return false if the pages hold fewer bytes, or they are corrupted
+ */
+bool toast_read_value(page_id_t first_pgid, size_t_ size, char *dst, BufferPoolManager *bpm);
+
+void toast_delete_value(page_id_t first_pgid, BufferPoolManager *bpm);
+
+} // namespace dawn
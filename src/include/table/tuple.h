@@ -1,6 +1,7 @@
 #pragma once
 
 #include <vector>
+#include <algorithm>
 #include <assert.h>
    
 #include "util/util.h"
@@ -14,6 +15,10 @@ namespace dawn {
 
 /**
  * ATTENTION no lock!
+ *
+ * A tuple either owns its data, or is attached to the data stored somewhere else (e.g. a pinned
+ * in-memory page, or another TupleView's buffer, see table/tuple_view.h) without copying it. The attached data is copied before the tuple
+ * is modified, and copying an attached tuple always gets a tuple owning the data.
  */
 class Tuple {
 friend class TablePage;
@@ -37,16 +42,7 @@ public:
 
     // deep copy
     Tuple(const Tuple &tuple) {
-        if (allocated_) {
-            delete[] data_;
-        }
-        allocated_ = tuple.allocated_;
-        size_ = tuple.size_;
-        rid_ = tuple.rid_;
-        if (allocated_) {
-            data_ = new char[size_];
-            memcpy(data_, tuple.data_, size_);
-        }
+        copy_from(tuple);
     }
 
     ~Tuple() {
@@ -68,19 +64,71 @@ public:
     inline RID get_rid() const { return rid_; }
     inline void set_rid(const RID &rid) { rid_ = rid; }
 
+    /** the toasted VARCHAR column should be fetched with toast_fetch_value() instead */
     Value get_value(const Schema &schema, int idx) const;
+
+    /** it also replaces the pointer of a toasted VARCHAR column with the value */
     void set_value(const Schema &schema, Value *value, int idx);
 
+    /** @return true if the VARCHAR column's string is stored in the overflow pages (see table/toast.h) */
+    inline bool is_toasted(const Schema &schema, int idx) const {
+        Column col = schema.get_column(idx);
+        if (col.get_type_id() != TypeId::kVarchar)
+            return false;
+        size_t_ str_size;
+        memcpy(&str_size, data_ + col.get_offset() + OFFSET_T_SIZE, SIZE_T_SIZE);
+        return static_cast<bool>(str_size & TOAST_MASK);
+    }
+
+    /** @return size of the VARCHAR column's data stored in the tuple, it's TOAST_POINTER_SZ if it's toasted */
+    inline size_t_ get_varchar_stored_size(const Schema &schema, int idx) const {
+        offset_t str_offset;
+        size_t_ str_size;
+        get_varchar_slot(schema.get_column(idx), &str_offset, &str_size);
+        return str_size;
+    }
+
+    void get_toast_pointer(const Schema &schema, int idx, page_id_t *first_pgid, size_t_ *str_size) const;
+
+    /** replace the VARCHAR column's string with the pointer to the overflow pages */
+    void set_toast_pointer(const Schema &schema, int idx, page_id_t first_pgid, size_t_ str_size);
+
     inline bool is_allocated() const { return allocated_; }
+
+    /** @return true if the tuple refers to the data it doesn't own */
+    inline bool is_attached() const { return !allocated_ && data_ != nullptr; }
+
+    /**
+     * refer to the data without copying it, the tuple is valid as long as the data is.
+     * The data is copied when the tuple is going to be modified.
+     */
+    inline void attach(char *data, size_t_ size, const RID &rid) {
+        if (allocated_)
+            delete[] data_;
+        allocated_ = false;
+        data_ = data;
+        size_ = size;
+        rid_ = rid;
+    }
+
+    /** forget the attached data, the owned data is kept so that its space could be reused */
+    inline void detach() {
+        if (!is_attached())
+            return;
+        data_ = nullptr;
+        size_ = -1;
+    }
+
     string_t to_string(const Schema &schema) const;
 
     inline void serialize_to(char *dst) const {
-        if (allocated_) {
+        if (data_ != nullptr) {
             memcpy(dst, data_, size_);
         }
     }
 
     inline void deserialize_from(char *src) {
+        own_data();
         if (allocated_) {
             memcpy(data_, src, size_);
         } else {
@@ -97,16 +145,8 @@ public:
 
     // deep copy
     Tuple& operator=(const Tuple &tuple) {
-        if (allocated_) {
-            delete[] data_;
-        }
-        allocated_ = tuple.allocated_;
-        size_ = tuple.size_;
-        rid_ = tuple.rid_;
-        if (allocated_) {
-            data_ = new char[size_];
-            memcpy(data_, tuple.data_, size_);
-        }
+        if (this != &tuple)
+            copy_from(tuple);
         return *this;
     }
 
@@ -117,10 +157,67 @@ private:
      */
     void init(std::vector<Value> *values, const Schema &schema);
 
+    /** the space owned by this tuple is reused if it has the same size, so the scans needn't allocate for each tuple */
+    inline void copy_from(const Tuple &tuple) {
+        rid_ = tuple.rid_;
+        if (tuple.data_ == nullptr) {
+            if (allocated_)
+                delete[] data_;
+            allocated_ = false;
+            data_ = nullptr;
+            size_ = tuple.size_;
+            return;
+        }
+        reserve(tuple.size_);
+        memcpy(data_, tuple.data_, size_);
+    }
+
+    /** own a space of size bytes, the content is undefined */
+    inline void reserve(size_t_ size) {
+        if (!allocated_ || size_ != size) {
+            if (allocated_)
+                delete[] data_;
+            data_ = new char[size];
+            allocated_ = true;
+        }
+        size_ = size;
+    }
+
+    /** copy the attached data before modifying it */
+    inline void own_data() {
+        if (!is_attached())
+            return;
+        char *data = new char[size_];
+        memcpy(data, data_, size_);
+        data_ = data;
+        allocated_ = true;
+    }
+
+    /** the string longer than the column's max length is truncated */
+    inline static size_t_ get_varchar_size(const Value &value, const Column &col) {
+        return std::min(static_cast<size_t_>(strnlen(value.get_value<char*>(), value.get_char_size())), col.get_max_length());
+    }
+
+    /** @param str_size the toast flag is not included */
+    inline void get_varchar_slot(const Column &col, offset_t *str_offset, size_t_ *str_size) const {
+        memcpy(str_offset, data_ + col.get_offset(), OFFSET_T_SIZE);
+        memcpy(str_size, data_ + col.get_offset() + OFFSET_T_SIZE, SIZE_T_SIZE);
+        *str_size &= ~TOAST_MASK;
+    }
+
+    /**
+     * replace the data of a VARCHAR column and lay out the strings again,
+     * the other toasted columns are kept as they are.
+     */
+    void replace_varchar(const Schema &schema, int idx, const char *str, size_t_ str_size, bool toasted);
+
+    // the VARCHAR column is toasted if top bit of the length in its slot is set to 1
+    static const uint32_t TOAST_MASK = (1U << (8 * sizeof(uint32_t) - 1));
+
     bool allocated_ = false;
     RID rid_;
     size_t_ size_ = -1;
-    char *data_;
+    char *data_ = nullptr;
 };
 
 } // namespace dawn
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <vector>
+
+#include "util/config.h"
+#include "data/values.h"
+#include "table/schema.h"
+#include "table/tuple.h"
+#include "table/rid.h"
+#include "buffer/buffer_pool_manager.h"
+
+namespace dawn {
+
+/** rows of a batch, the virtual calls are paid once per batch instead of once per row */
+constexpr size_t_ TUPLE_BATCH_SZ = 1024;
+
+/**
+ * ColumnVector holds a column's values of the rows in a batch as an array.
+ *
+ * Boolean, integer and decimal values are stored as the arrays of the native types, so that
+ * the kernels read them directly. CHAR values are stored in the slots as wide as the column,
+ * the same as they are stored in the tuple. VARCHAR values are padded with 0 to the max
+ * length of the column, and their lengths are kept aside.
+ */
+class ColumnVector {
+public:
+    ColumnVector() = default;
+    ~ColumnVector() = default;
+
+    void init(TypeId type_id, size_t_ width);
+
+    inline TypeId get_type_id() const { return type_id_; }
+    inline size_t_ get_width() const { return width_; }
+    inline bool is_valid() const { return type_id_ != TypeId::kInvalid; }
+
+    template<typename T>
+    inline T* get_data() { return reinterpret_cast<T*>(data_.data()); }
+
+    template<typename T>
+    inline const T* get_data() const { return reinterpret_cast<const T*>(data_.data()); }
+
+    inline char* get_slot(int row) { return data_.data() + row * width_; }
+    inline const char* get_slot(int row) const { return data_.data() + row * width_; }
+
+    Value get_value(int row) const;
+    void set_value(int row, const Value &value);
+
+    /** store the string of the VARCHAR column, it's cut if it's longer than the column */
+    void set_str(int row, const char *str, size_t_ len);
+
+    /**
+     * copy the selected rows of the vector to the first num rows of this one
+     * @param sel all of the num rows are copied if it's nullptr
+     */
+    void copy_rows(const ColumnVector &src, const int *sel, size_t_ num);
+
+private:
+    TypeId type_id_ = TypeId::kInvalid;
+    size_t_ width_ = 0;
+    std::vector<char> data_;
+    std::vector<size_t_> lens_; // only for VARCHAR
+};
+
+/**
+ * TupleBatch holds up to TUPLE_BATCH_SZ rows of a schema column by column, and a selection
+ * vector marking the rows still alive, so that a filter only rewrites the selection instead
+ * of moving the values.
+ *
+ * Only the columns the operators need are loaded, the others are left invalid. A batch is
+ * initialized by whoever calls get_next_batch(), and the executors fill it with the rows.
+ */
+class TupleBatch {
+public:
+    TupleBatch() = default;
+    ~TupleBatch() = default;
+
+    DISALLOW_COPY_AND_MOVE(TupleBatch);
+
+    /** @param col_idxs columns loaded from the tuples, all columns if it's empty */
+    void init(const Schema *schema, const std::vector<offset_t> &col_idxs = std::vector<offset_t>{});
+
+    /** load these columns as well, the rows appended before are not changed */
+    void require_cols(const std::vector<offset_t> &col_idxs);
+
+    /** drop the rows and the selection */
+    inline void reset() {
+        size_ = 0;
+        has_sel_ = false;
+    }
+
+    inline const Schema* get_schema() const { return schema_; }
+
+    /** @return number of the rows in the batch, including the ones filtered out */
+    inline size_t_ get_size() const { return size_; }
+
+    /** set the number of rows after the columns are filled directly, the selection is dropped */
+    inline void set_size(size_t_ size) {
+        size_ = size;
+        has_sel_ = false;
+    }
+
+    inline bool is_full() const { return size_ == TUPLE_BATCH_SZ; }
+
+    /** @return number of the selected rows */
+    inline size_t_ get_count() const { return has_sel_ ? sel_num_ : size_; }
+
+    /** @return the i-th selected row */
+    inline int get_row(int i) const { return has_sel_ ? sel_[i] : i; }
+
+    /** @return the selected rows in ascending order, nullptr if all rows are selected */
+    inline const int* get_selection() const { return has_sel_ ? sel_.data() : nullptr; }
+
+    /** @param rows ascending, they may be written to the array returned by get_selection() */
+    inline void set_selection(const int *rows, size_t_ num) {
+        if (rows != sel_.data())
+            memcpy(sel_.data(), rows, num * sizeof(int));
+        sel_num_ = num;
+        has_sel_ = true;
+    }
+
+    inline bool is_loaded(int col_idx) const { return columns_[col_idx].is_valid(); }
+    inline ColumnVector* get_column(int col_idx) { return &columns_[col_idx]; }
+    inline const ColumnVector* get_column(int col_idx) const { return &columns_[col_idx]; }
+
+    inline RID get_rid(int row) const { return rids_[row]; }
+
+    /**
+     * copy the loaded columns of the tuple to the end of the batch
+     * @param bpm the toasted values are fetched with it
+     * @return false if the batch is full
+     */
+    bool append(const Tuple &tuple, BufferPoolManager *bpm);
+
+    /** build the row's tuple, the columns not loaded are set to 0 */
+    void get_tuple(int row, Tuple *tuple) const;
+
+private:
+    const Schema *schema_ = nullptr;
+    std::vector<ColumnVector> columns_; // indexed by the column index of the schema
+    std::vector<offset_t> loaded_cols_;
+    std::vector<offset_t> loaded_offsets_; // offsets of the loaded columns in the tuple
+    std::vector<RID> rids_;
+    std::vector<int> sel_;
+    size_t_ sel_num_ = 0;
+    bool has_sel_ = false;
+    size_t_ size_ = 0;
+};
+
+} // namespace dawn
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <vector>
+
+#include "util/config.h"
+#include "table/tuple.h"
+#include "buffer/buffer_pool_manager.h"
+#include "storage/page/table_page.h"
+
+namespace dawn {
+
+/**
+ * TupleView is a reusable copy of a tuple, it passes the tuples between the executors without
+ * allocating one for each row. It isn't zero-copy, the scan copies each row once.
+ *
+ * The tuple is copied out of the TablePage while the caller holds the page's latch, because
+ * others may move the data in the page (e.g. delete or update a tuple) as soon as the latch is
+ * released. It's copied into the buffer the view owns, and the buffer is reused by the next
+ * tuple of the same size, so a scan neither allocates per row nor keeps any page pinned.
+ *
+ * A view could refer to another view's tuple without copying it (see refer(const TupleView&)),
+ * it's valid until the other view changes. Modifying the tuple copies it first.
+ */
+class TupleView {
+public:
+    TupleView() = default;
+
+    ~TupleView() = default;
+
+    DISALLOW_COPY_AND_MOVE(TupleView);
+
+    /**
+     * copy the tuple in the page, the page should have been pinned and latched by the caller
+     * @param col_idxs only these columns are copied from the PAX page, all of them if it's empty
+     */
+    bool refer(TablePage *tb_page, const RID &rid, const std::vector<offset_t> &col_idxs = std::vector<offset_t>{});
+
+    /** refer to the same tuple as the other view, the tuple is copied if the other one refers to another view */
+    void refer(const TupleView &view);
+
+    /** stop referring to the other view's tuple, the tuple copied into the view is kept */
+    inline void release() { tuple_.detach(); }
+
+    /** copy the tuple, so that it's still valid after the view is released */
+    inline void materialize(Tuple *tuple) const { *tuple = tuple_; }
+
+    inline const Tuple& operator*() const { return tuple_; }
+    inline const Tuple* operator->() const { return &tuple_; }
+
+    /** the attached data is copied when the tuple is modified */
+    inline Tuple* get_tuple() { return &tuple_; }
+
+private:
+    Tuple tuple_;
+};
+
+} // namespace dawn
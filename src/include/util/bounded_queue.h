@@ -0,0 +1,89 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+#include "util/util.h"
+
+namespace dawn {
+
+/**
+ * BoundedQueue passes the items from the producers to the consumers running on other threads.
+ * push() waits when the queue is full, so that the fast producers can't use up the memory.
+ *
+ * The queue is closed after all the producers finish, and the consumers get the remaining items
+ * before pop() fails. cancel() stops both sides at once, e.g. the consumer doesn't need more items.
+ */
+template<typename T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(size_t capacity) : capacity_(capacity) {}
+
+    ~BoundedQueue() = default;
+
+    DISALLOW_COPY_AND_MOVE(BoundedQueue);
+
+    /** @return false if the queue is cancelled, the item is dropped */
+    bool push(T &&item) {
+        std::unique_lock<std::mutex> ul(mt_);
+        not_full_cv_.wait(ul, [&]{ return items_.size() < capacity_ || cancelled_; });
+        if (cancelled_)
+            return false;
+        items_.push_back(std::move(item));
+        ul.unlock();
+        not_empty_cv_.notify_one();
+        return true;
+    }
+
+    /** @return false if there are no more items */
+    bool pop(T *item) {
+        std::unique_lock<std::mutex> ul(mt_);
+        not_empty_cv_.wait(ul, [&]{ return !items_.empty() || closed_ || cancelled_; });
+        if (items_.empty() || cancelled_)
+            return false;
+        *item = std::move(items_.front());
+        items_.pop_front();
+        ul.unlock();
+        not_full_cv_.notify_one();
+        return true;
+    }
+
+    /** no more items will be pushed */
+    void close() {
+        {
+            std::unique_lock<std::mutex> ul(mt_);
+            closed_ = true;
+        }
+        not_empty_cv_.notify_all();
+    }
+
+    void cancel() {
+        {
+            std::unique_lock<std::mutex> ul(mt_);
+            cancelled_ = true;
+            items_.clear();
+        }
+        not_empty_cv_.notify_all();
+        not_full_cv_.notify_all();
+    }
+
+    /** drop the items and open the queue again, nobody should be using it */
+    void reset() {
+        std::unique_lock<std::mutex> ul(mt_);
+        items_.clear();
+        closed_ = false;
+        cancelled_ = false;
+    }
+
+private:
+    const size_t capacity_;
+    std::deque<T> items_;
+    bool closed_ = false;
+    bool cancelled_ = false;
+    std::mutex mt_;
+    std::condition_variable not_full_cv_;
+    std::condition_variable not_empty_cv_;
+};
+
+} // namespace dawn
@@ -5,9 +5,29 @@
 
 namespace dawn {
 
-constexpr int32_t PAGE_SIZE =   4096;
-constexpr long READ_DB_PG_NUM = 10240;
-constexpr long READ_DB_BUF_SZ = PAGE_SIZE * READ_DB_PG_NUM; // 10240 pages, approximate 40MB
+/**
+ * page size is chosen when building, e.g. cmake -DDAWN_PAGE_SIZE=32768
+ * larger pages suit the analytic workloads, scans need fewer IOs and the link hash is shallower.
+ * It's recorded in the .mtd file, a database can only be opened with the same page size.
+ */
+#ifndef DAWN_PAGE_SIZE
+#define DAWN_PAGE_SIZE 4096
+#endif
+constexpr int32_t PAGE_SIZE = DAWN_PAGE_SIZE;
+constexpr int32_t MIN_PAGE_SIZE = 4096;
+constexpr int32_t MAX_PAGE_SIZE = 65536;
+static_assert(PAGE_SIZE >= MIN_PAGE_SIZE && PAGE_SIZE <= MAX_PAGE_SIZE && (PAGE_SIZE & (PAGE_SIZE - 1)) == 0,
+    "page size should be a power of 2 between 4K and 64K");
+
+/**
+ * the version of the files' format, it's bumped when the files written before can't be read correctly.
+ * It's recorded in the .mtd file, a database can only be opened with the same version.
+ *   1: TablePages have the key filter, and the keys are hashed by their encoded columns
+ */
+constexpr int32_t DB_FORMAT_VERSION = 1;
+
+constexpr long READ_DB_BUF_SZ = 40 * 1024 * 1024; // approximate 40MB
+constexpr long READ_DB_PG_NUM = READ_DB_BUF_SZ / PAGE_SIZE;
 
 // page
 #define COM_PG_HEADER_SZ       64 // page's comman header size
@@ -30,8 +50,12 @@ constexpr long READ_DB_BUF_SZ = PAGE_SIZE * READ_DB_PG_NUM; // 10240 pages, appr
 #define LINK_HASH 1 // link hash
 #define BP_TREE   2 // B+ tree
 
+// storage layout of the table's pages
+#define ROW_LAYOUT 0 // tuples are stored row by row
+#define PAX_LAYOUT 1 // tuples are stored column by column in each page
+
 // type
-#define TYPE_NUM  4
+#define TYPE_NUM  5
 
 // op_code
 #define OP_SUCCESS            0
@@ -39,6 +63,7 @@ constexpr long READ_DB_BUF_SZ = PAGE_SIZE * READ_DB_PG_NUM; // 10240 pages, appr
 #define NEW_PG_FAIL          -2 // get new page fail
 #define TUPLE_NOT_FOUND      -3 // can't find tuple
 #define MARK_DELETE_FAIL     -4
+#define TUPLE_TOO_LARGE      -5 // tuple can't be contained by an empty page
 
 #define INVALID_T TypeId::kInvalid
 #define BOOLEAN_T TypeId::kBoolean
@@ -60,12 +85,14 @@ constexpr long READ_DB_BUF_SZ = PAGE_SIZE * READ_DB_PG_NUM; // 10240 pages, appr
 #define MIN(type, left, right) Type::get_instance(type)->min(left, right)
 #define MAX(type, left, right) Type::get_instance(type)->max(left, right)
 
-#define INSERT_TUPLE_FUNC_PARAMS     page_id_t first_page_id, Tuple *tuple, const Schema &tb_schema, BufferPoolManager *bpm
-#define MARK_DELETE_FUNC_PARAMS      page_id_t first_page_id, Value key_value, const Schema &tb_schema, BufferPoolManager *bpm
-#define APPLY_DELETE_FUNC_PARAMS     page_id_t first_page_id, Value key_value, const Schema &tb_schema, BufferPoolManager *bpm
-#define ROLLBACK_DELETE_FUNC_PARAMS  page_id_t first_page_id, Value key_value, const Schema &tb_schema, BufferPoolManager *bpm
-#define GET_TUPLE_FUNC_PARAMS        page_id_t first_page_id, Value key_value, Tuple *tuple, const Schema &tb_schema, BufferPoolManager *bpm
-#define UPDATE_TUPLE_FUNC_PARAMS     page_id_t first_page_id, Tuple *new_tuple, const RID &old_rid, const Schema &tb_schema, BufferPoolManager *bpm
+#define INSERT_TUPLE_FUNC_PARAMS     LinkHashDirectory *lk_ha_dir, Tuple *tuple, const Schema &tb_schema, BufferPoolManager *bpm
+#define MARK_DELETE_FUNC_PARAMS      LinkHashDirectory *lk_ha_dir, const IndexKey &key, const Schema &tb_schema, BufferPoolManager *bpm
+#define APPLY_DELETE_FUNC_PARAMS     LinkHashDirectory *lk_ha_dir, const IndexKey &key, const Schema &tb_schema, BufferPoolManager *bpm, std::vector<std::pair<RID, RID>> *moved_rids
+#define ROLLBACK_DELETE_FUNC_PARAMS  LinkHashDirectory *lk_ha_dir, const IndexKey &key, const Schema &tb_schema, BufferPoolManager *bpm
+#define GET_TUPLE_FUNC_PARAMS        LinkHashDirectory *lk_ha_dir, const IndexKey &key, Tuple *tuple, const Schema &tb_schema, BufferPoolManager *bpm
+#define UPDATE_TUPLE_FUNC_PARAMS     LinkHashDirectory *lk_ha_dir, Tuple *new_tuple, const RID &old_rid, const Schema &tb_schema, BufferPoolManager *bpm
+#define GET_TUPLES_FUNC_PARAMS       LinkHashDirectory *lk_ha_dir, const std::vector<IndexKey> &keys, std::vector<Tuple> *tuples, const Schema &tb_schema, BufferPoolManager *bpm
+#define BULK_LOAD_FUNC_PARAMS        LinkHashDirectory *lk_ha_dir, std::vector<Tuple> *tuples, const Schema &tb_schema, BufferPoolManager *bpm
 
 using page_id_t = int32_t;
 using offset_t = int32_t;
@@ -85,6 +112,7 @@ using varchar_t = char*;
 using enum_size_t = int32_t;
 using op_code_t = int32_t; // operation result
 using index_code_t = int32_t; // show the type of index
+using layout_code_t = int32_t; // show the storage layout of the table
 
 constexpr size_t_ PTR_SIZE = sizeof(char*);
 constexpr size_t_ ENUM_SIZE = sizeof(enum_size_t);
@@ -95,12 +123,27 @@ constexpr size_t_ DECIMAL_T_SIZE = sizeof(decimal_t);
 constexpr size_t_ INTEGER_T_SIZE = sizeof(integer_t);
 constexpr size_t_ BOOLEAN_T_SIZE = sizeof(boolean_t);
 
+/** a VARCHAR column occupies | offset in the tuple (4) | length (4) | in the fixed part of the tuple */
+constexpr size_t_ VARCHAR_SLOT_SZ = OFFSET_T_SIZE + SIZE_T_SIZE;
+
+/** a toasted VARCHAR stores | first overflow page id (4) | length of the string (4) | in the tuple instead */
+constexpr size_t_ TOAST_POINTER_SZ = PGID_T_SIZE + SIZE_T_SIZE;
+
 /** number of slots a LinkHashPage could contain */
 offset_t constexpr LK_HA_PG_SLOT_NUM = (PAGE_SIZE - COM_PG_HEADER_SZ) / PGID_T_SIZE;
 
 /** total slot number the link hash function has */
 offset_t constexpr Lk_HA_TOTAL_SLOT_NUM = LK_HA_PG_SLOT_NUM * LK_HA_PG_SLOT_NUM;
 
+/** number of the first level slots a parallel scan's worker takes each time */
+offset_t constexpr MORSEL_SLOT_NUM = 8;
+
+/** number of the tuples passed through an exchange's queue at a time */
+constexpr size_t_ EXCHANGE_CHUNK_SZ = 256;
+
+/** chunks each producer of an exchange could put in a queue before it waits for the consumer */
+constexpr size_t_ EXCHANGE_QUEUE_CHUNKS = 2;
+
 constexpr size_t MAX_EVENT_NUMBER = 1024;
 
 /** Thread number in the Server */
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "util/config.h"
+
+namespace dawn {
+
+/**
+ * LoserTree picks the smallest one among k sources, e.g. the runs merged by the external sort.
+ * Each internal node keeps the loser of the match between its children, so after the winner's
+ * source moves to its next element only log(k) matches on the path to the root are replayed.
+ *
+ * Less(i, j) returns true if the current element of source i should be output before source j's.
+ * Exhausted sources should lose to all the others.
+ *
+ * The leaf of source i is node k + i, and the internal nodes are 1 ... k-1, tree_[0] is the winner.
+ */
+template<typename Less>
+class LoserTree {
+public:
+    explicit LoserTree(Less less) : less_(less) {}
+
+    /** play all the matches from the leaves */
+    void init(size_t_ k) {
+        k_ = k;
+        tree_.assign(k_ > 0 ? k_ : 1, 0);
+        if (k_ <= 1)
+            return;
+
+        std::vector<size_t_> winners(2 * k_);
+        for (size_t_ i = 0; i < k_; i++)
+            winners[k_ + i] = i;
+        for (size_t_ node = k_ - 1; node > 0; node--) {
+            size_t_ left = winners[2 * node];
+            size_t_ right = winners[2 * node + 1];
+            bool left_win = !less_(right, left);
+            winners[node] = left_win ? left : right;
+            tree_[node] = left_win ? right : left;
+        }
+        tree_[0] = winners[1];
+    }
+
+    /** @return the source whose element is the smallest */
+    inline size_t_ get_winner() const { return tree_[0]; }
+
+    /** the winner's source has moved to its next element, replay its matches */
+    void replay() {
+        size_t_ winner = tree_[0];
+        for (size_t_ node = (k_ + winner) / 2; node > 0; node /= 2) {
+            if (less_(tree_[node], winner))
+                std::swap(tree_[node], winner);
+        }
+        tree_[0] = winner;
+    }
+
+private:
+    Less less_;
+    size_t_ k_ = 0;
+    std::vector<size_t_> tree_;
+};
+
+} // namespace dawn
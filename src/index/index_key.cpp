@@ -0,0 +1,174 @@
+#include "index/index_key.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace dawn {
+
+/** write the value in the form that encode_column() accepts */
+inline void serialize_value(const Value &value, const Column &col, char *buf) {
+    if (is_string_type(col.get_type_id())) {
+        size_t_ col_size = col.get_max_length();
+        memset(buf, 0, col_size);
+        memcpy(buf, value.get_value<char*>(), std::min(value.get_char_size(), col_size));
+        return;
+    }
+    value.serialize_to(buf);
+}
+
+/** write the bytes of the integer in the big endian */
+template<typename T>
+inline void store_big_endian(T val, char *dst) {
+    for (size_t i = 0; i < sizeof(T); i++) {
+        dst[sizeof(T) - 1 - i] = static_cast<char>(val & 0xFF);
+        val >>= 8;
+    }
+}
+
+void IndexKey::encode_column(const char *raw, const Column &col, char *dst) {
+    switch (col.get_type_id()) {
+        case TypeId::kInteger: {
+            uint32_t val = *reinterpret_cast<const uint32_t*>(raw);
+            store_big_endian<uint32_t>(val ^ 0x80000000u, dst);
+            break;
+        }
+        case TypeId::kDecimal: {
+            // -0.0 equals to 0.0 and all the NaNs are the same, so they're encoded into the same key
+            decimal_t dec;
+            memcpy(&dec, raw, DECIMAL_T_SIZE);
+            if (dec == 0)
+                dec = 0;
+            else if (std::isnan(dec))
+                dec = std::numeric_limits<decimal_t>::quiet_NaN();
+            uint64_t val;
+            memcpy(&val, &dec, DECIMAL_T_SIZE);
+            if (val & 0x8000000000000000ull)
+                val = ~val;
+            else
+                val ^= 0x8000000000000000ull;
+            store_big_endian<uint64_t>(val, dst);
+            break;
+        }
+        case TypeId::kBoolean: {
+            memset(dst, 0, BOOLEAN_T_SIZE);
+            dst[BOOLEAN_T_SIZE - 1] = *reinterpret_cast<const boolean_t*>(raw) ? 1 : 0;
+            break;
+        }
+        case TypeId::kChar:
+        case TypeId::kVarchar: {
+            // string stored in the tuple may be filled with garbage after '\0'
+            size_t_ col_size = col.get_max_length();
+            size_t_ len = strnlen(raw, col_size);
+            memcpy(dst, raw, len);
+            memset(dst + len, 0, col_size - len);
+            break;
+        }
+        default:
+            LOG("should not reach here");
+            break;
+    }
+}
+
+const char* IndexKey::get_raw_column(const char *tuple_data, const Column &col, char *buf) {
+    if (col.get_type_id() != TypeId::kVarchar)
+        return tuple_data + col.get_offset();
+
+    offset_t str_offset;
+    size_t_ str_size;
+    memcpy(&str_offset, tuple_data + col.get_offset(), OFFSET_T_SIZE);
+    memcpy(&str_size, tuple_data + col.get_offset() + OFFSET_T_SIZE, SIZE_T_SIZE);
+    // buf only holds the max length, a corrupted size shouldn't overflow it
+    str_size = std::min(str_size, col.get_max_length());
+    memcpy(buf, tuple_data + str_offset, str_size);
+    memset(buf + str_size, 0, col.get_max_length() - str_size);
+    return buf;
+}
+
+size_t_ IndexKey::get_key_size(const std::vector<Column> &key_cols) {
+    size_t_ size = 0;
+    for (auto &col : key_cols)
+        size += get_encoded_size(col);
+    return size;
+}
+
+IndexKey::IndexKey(const std::vector<Value> &key_values, const std::vector<Column> &key_cols)
+    : data_(get_key_size(key_cols)) {
+    if (key_values.size() != key_cols.size()) {
+        FATAL("number of the key values is not equal to the key columns");
+    }
+
+    char *dst = data_.data();
+    for (size_t i = 0; i < key_cols.size(); i++) {
+        size_t_ col_size = get_encoded_size(key_cols[i]);
+        std::vector<char> raw(col_size + 1);
+        serialize_value(key_values[i], key_cols[i], raw.data());
+        encode_column(raw.data(), key_cols[i], dst);
+        dst += col_size;
+    }
+}
+
+IndexKey::IndexKey(const Value &key_value, const Column &key_col)
+    : data_(get_encoded_size(key_col)) {
+    std::vector<char> raw(get_encoded_size(key_col) + 1);
+    serialize_value(key_value, key_col, raw.data());
+    encode_column(raw.data(), key_col, data_.data());
+}
+
+IndexKey::IndexKey(const char *tuple_data, const std::vector<Column> &key_cols)
+    : data_(get_key_size(key_cols)) {
+    char *dst = data_.data();
+    std::vector<char> buf;
+    for (auto &col : key_cols) {
+        buf.resize(get_encoded_size(col));
+        encode_column(get_raw_column(tuple_data, col, buf.data()), col, dst);
+        dst += get_encoded_size(col);
+    }
+}
+
+/** compare the string with the encoded column in place, bytes after the first '\0' are ignored as encode_column() does */
+inline bool is_string_equal_to_key(const char *str, size_t_ str_size, const char *key_data, size_t_ col_size) {
+    size_t_ len = strnlen(str, std::min(str_size, col_size));
+    if (memcmp(str, key_data, len) != 0)
+        return false;
+    for (size_t_ i = len; i < col_size; i++) {
+        if (key_data[i] != 0)
+            return false;
+    }
+    return true;
+}
+
+bool IndexKey::is_equal_to_tuple(const char *tuple_data, const std::vector<Column> &key_cols) const {
+    // it's called for every tuple in the probed pages, so nothing is allocated here
+    static_assert(INTEGER_T_SIZE <= DECIMAL_T_SIZE && BOOLEAN_T_SIZE <= DECIMAL_T_SIZE,
+        "the encoded fixed-width columns should fit in the buffer");
+    const char *key_data = data_.data();
+    char encoded[DECIMAL_T_SIZE];
+    for (auto &col : key_cols) {
+        size_t_ col_size = get_encoded_size(col);
+        switch (col.get_type_id()) {
+            case TypeId::kChar:
+                if (!is_string_equal_to_key(tuple_data + col.get_offset(), col_size, key_data, col_size))
+                    return false;
+                break;
+            case TypeId::kVarchar: {
+                offset_t str_offset;
+                size_t_ str_size;
+                memcpy(&str_offset, tuple_data + col.get_offset(), OFFSET_T_SIZE);
+                memcpy(&str_size, tuple_data + col.get_offset() + OFFSET_T_SIZE, SIZE_T_SIZE);
+                if (!is_string_equal_to_key(tuple_data + str_offset, str_size, key_data, col_size))
+                    return false;
+                break;
+            }
+            default:
+                encode_column(tuple_data + col.get_offset(), col, encoded);
+                if (memcmp(encoded, key_data, col_size) != 0)
+                    return false;
+                break;
+        }
+        key_data += col_size;
+    }
+    return true;
+}
+
+} // namespace dawn
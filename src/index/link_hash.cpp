@@ -2,18 +2,88 @@
 #include "storage/page/link_hash_page.h"
 #include "storage/page/table_page.h"
 
+#include <algorithm>
+#include <future>
+
 namespace dawn {
 
+/** a TablePage whose used space is less than this is sparse and should be merged into its neighbour */
+static constexpr size_t_ LK_HA_SPARSE_PAGE_SPACE = TablePage::get_tp_load_data_space() / 4;
+
+LinkHashDirectory::LinkHashDirectory(page_id_t first_page_id, BufferPoolManager *bpm)
+    : first_page_id_(first_page_id), bpm_(bpm) {
+    first_level_page_ = reinterpret_cast<LinkHashPage*>(bpm_->get_page(first_page_id_));
+    if (first_level_page_ == nullptr) {
+        FATAL("LinkHashDirectory can't get the first level page");
+    }
+
+    first_level_page_->r_lock();
+    for (offset_t i = 0; i < LK_HA_PG_SLOT_NUM; i++) {
+        sec_pgids_[i].store(first_level_page_->get_pgid_in_slot(i), std::memory_order_relaxed);
+    }
+    first_level_page_->r_unlock();
+}
+
+LinkHashDirectory::~LinkHashDirectory() {
+    // slots are written through, so the page is dirty only when we have allocated pages
+    bpm_->unpin_page(first_page_id_, true);
+}
+
+page_id_t LinkHashDirectory::get_or_create_sec_pgid(offset_t sec_pg_slot_num) {
+    page_id_t sec_pgid = get_sec_pgid(sec_pg_slot_num);
+    if (sec_pgid != INVALID_PAGE_ID) {
+        return sec_pgid;
+    }
+
+    std::lock_guard<std::mutex> guard(alloc_mutex_);
+
+    // someone else may have created it when we are waiting for the mutex
+    sec_pgid = sec_pgids_[sec_pg_slot_num].load(std::memory_order_acquire);
+    if (sec_pgid != INVALID_PAGE_ID) {
+        return sec_pgid;
+    }
+
+    LinkHashPage *sec_level_page = reinterpret_cast<LinkHashPage*>(bpm_->new_page());
+    if (sec_level_page == nullptr) {
+        return INVALID_PAGE_ID;
+    }
+    sec_pgid = sec_level_page->get_page_id();
+    sec_level_page->init();
+    bpm_->unpin_page(sec_pgid, true);
+
+    // write through, the page is flushed when it's unpinned at last
+    first_level_page_->w_lock();
+    first_level_page_->set_pgid_in_slot(sec_pg_slot_num, sec_pgid);
+    first_level_page_->w_unlock();
+
+    // publish after the page has been initialized
+    sec_pgids_[sec_pg_slot_num].store(sec_pgid, std::memory_order_release);
+    return sec_pgid;
+}
+
 /**
- * the returned value will be set in the second and third parameter
- * @param hash_val the input hash value
- * @param sec_pg_slot_num get the second level's page id with this
- * @param tb_pg_slot_num get the third level's page id with this
+ * search the encoded key in a TablePage, caller should hold the page's lock
+ * @param rid the key's position will be set in the rid when it's found
+ * @return true: find the key, false: the key is not in this page
  */
-inline void hash_to_slot(hash_t hash_val, offset_t *sec_pg_slot_num, offset_t *tb_pg_slot_num) {
-    offset_t slot_num = static_cast<offset_t>(hash_val % static_cast<hash_t>(Lk_HA_TOTAL_SLOT_NUM));
-    *sec_pg_slot_num = slot_num / LK_HA_PG_SLOT_NUM;
-    *tb_pg_slot_num = slot_num % LK_HA_PG_SLOT_NUM;
+bool search_key_in_page(TablePage *tb_page, hash_t hash_val, const IndexKey &key, const std::vector<Column> &key_cols, RID *rid) {
+    // skip the whole page when the key filter tells us the key is not here
+    if (!tb_page->may_contain_key(hash_val)) {
+        return false;
+    }
+
+    RID cur_rid;
+    RID next_rid;
+    std::vector<char> row(tb_page->is_pax() ? tb_page->get_pax_tuple_size() : 0);
+    while (tb_page->get_next_tuple_rid(cur_rid, &next_rid)) {
+        const char *tuple_data = tb_page->get_tuple_row(next_rid.get_slot_num(), row.data());
+        if (key.is_equal_to_tuple(tuple_data, key_cols)) {
+            *rid = next_rid;
+            return true;
+        }
+        cur_rid = next_rid;
+    }
+    return false;
 }
 
 /**
@@ -21,24 +91,17 @@ inline void hash_to_slot(hash_t hash_val, offset_t *sec_pg_slot_num, offset_t *t
  * @param dup_rid duplicate key's position will be set in the dup_rid if the dup_rid is not equal to nullptr
  * @return true: duplicate, false: not duplicate
  */
-bool lk_ha_check_duplicate_key(page_id_t first_page_id, const Value &key_value, const Schema &tb_schema, BufferPoolManager *bpm, RID *dup_rid = nullptr) {
-    // hash the value
-    hash_t hash_val = key_value.get_hash_value();
+bool lk_ha_check_duplicate_key(LinkHashDirectory *lk_ha_dir, const IndexKey &key, const Schema &tb_schema, BufferPoolManager *bpm, RID *dup_rid = nullptr) {
+    // hash the key
+    hash_t hash_val = key.get_hash_value();
     offset_t sec_pg_slot_num;
     offset_t tb_pg_slot_num;
 
     hash_to_slot(hash_val, &sec_pg_slot_num, &tb_pg_slot_num);
 
-    // the the first level's LinkHashPage
-    LinkHashPage *first_level_page = reinterpret_cast<LinkHashPage*>(bpm->get_page(first_page_id));
-    
-    // get the second level's LinkHashPage
+    // get the second level's LinkHashPage, the first level page is cached in the directory
     LinkHashPage *second_level_page;
-    first_level_page->r_lock();
-
-    page_id_t second_level_page_id = first_level_page->get_pgid_in_slot(sec_pg_slot_num);
-    first_level_page->r_unlock();
-    bpm->unpin_page(first_page_id, false);
+    page_id_t second_level_page_id = lk_ha_dir->get_sec_pgid(sec_pg_slot_num);
 
     if (second_level_page_id == INVALID_PAGE_ID) {
         return false;
@@ -46,208 +109,239 @@ bool lk_ha_check_duplicate_key(page_id_t first_page_id, const Value &key_value,
 
     second_level_page = reinterpret_cast<LinkHashPage*>(bpm->get_page(second_level_page_id));
 
-    // get the third level's TablePage
+    // get the third level's TablePage, the list isn't compacted while the second level page is read locked
     TablePage *third_level_page;
     second_level_page->r_lock();
     page_id_t third_level_page_id = second_level_page->get_pgid_in_slot(tb_pg_slot_num);
-    second_level_page->r_unlock();
-    bpm->unpin_page(second_level_page_id, false);
 
+    std::vector<Column> key_cols = get_key_columns(tb_schema);
+
+    bool found = false;
     while (third_level_page_id != INVALID_PAGE_ID) {
-        Tuple cmp_tuple;
-        RID rid;
         third_level_page = reinterpret_cast<TablePage*>(bpm->get_page(third_level_page_id));
         third_level_page->r_lock();
-        if (!third_level_page->get_the_first_tuple(&cmp_tuple)) {
-            third_level_page->r_unlock();
-            bpm->unpin_page(third_level_page_id, false);
-            return false;
-        }
 
         // check duplicate in this TablePage
-        rid = cmp_tuple.get_rid();
-        do {
-            third_level_page->get_tuple(&cmp_tuple, rid);
-            if (key_value == cmp_tuple.get_value(tb_schema, tb_schema.get_key_idx())) {
-                third_level_page->r_unlock();
-                bpm->unpin_page(third_level_page_id, false);
-                if (dup_rid != nullptr) {
-                    *dup_rid = rid;
-                }
-                return true; // find duplicate key
+        RID rid;
+        if (search_key_in_page(third_level_page, hash_val, key, key_cols, &rid)) {
+            third_level_page->r_unlock();
+            bpm->unpin_page(third_level_page_id, false);
+            if (dup_rid != nullptr) {
+                *dup_rid = rid;
             }
-        } while (third_level_page->get_next_tuple_rid(cmp_tuple.get_rid(), &rid));
+            found = true; // find duplicate key
+            break;
+        }
 
-        // jump to the next page
+        // jump to the next page, empty pages may stay in the middle of the link list
         third_level_page_id = third_level_page->get_next_page_id();
         third_level_page->r_unlock();
         bpm->unpin_page(third_level_page->get_page_id(), false);
     }
-    return false;
+    second_level_page->r_unlock();
+    bpm->unpin_page(second_level_page_id, false);
+    return found;
 }
 
 /**
- * It scans the TablePage list and deletes the empty page.
- * It's called every time when we delete the last tuple in a TablePage,
- * but in the concurrent environment the empty page may be filled with
- * tuples before deleted, so the lk_ha_clear_empty_page() is a function
- * that checks and deletes the empty pages instead of ensuring to delete a page.
+ * Move all the tuples in src_page to dst_page. Both pages should be write locked,
+ * and dst_page should have enough free space to contain them.
+ * Tuples marked as deleted keep the mark, and the key filter of dst_page is updated.
+ * @param moved_rids record the (old rid, new rid) pair of every moved tuple, nullable
+ */
+inline void lk_ha_move_tuples(TablePage *src_page, TablePage *dst_page, const std::vector<Column> &key_cols,
+    std::vector<std::pair<RID, RID>> *moved_rids) {
+    RID cur_rid;
+    RID next_rid;
+    Tuple tuple;
+    while (src_page->get_next_tuple_rid(cur_rid, &next_rid)) {
+        offset_t slot_num = next_rid.get_slot_num();
+        src_page->get_tuple(&tuple, next_rid);
+
+        RID new_rid;
+        if (!dst_page->insert_tuple(tuple, &new_rid)) {
+            FATAL("lk_ha_move_tuples: no enough space in the destination page");
+        }
+        if (src_page->is_marked_delete(slot_num))
+            dst_page->mark_delete(new_rid);
+        dst_page->add_key_hash(IndexKey(tuple.get_data(), key_cols).get_hash_value());
+
+        if (moved_rids != nullptr)
+            moved_rids->push_back(std::make_pair(next_rid, new_rid));
+        cur_rid = next_rid;
+    }
+}
+
+/**
+ * Compact the TablePage list of a slot. It's called when a TablePage becomes empty or sparse.
  * 
- * So far, we can only delete the empty pages at the beginning. Empty pages in the middle
- * of the link list is ignored, because we can't test this function and there is no need to implement it.
+ * It walks through the whole link list, and a page is removed from the list when:
+ *   1. it's empty, no matter where it is in the list
+ *   2. all its tuples could be moved into the previous page
+ * The removed pages are deleted from the disk. A page pinned by someone else (e.g. an iter staying on it,
+ * maybe on this thread) is neither removed nor merged into, it's kept as it is until a later compaction,
+ * rather than waited for. Tuples may be moved to another page, so their rids change, the caller should
+ * fix anything that refers to the old rids (e.g. secondary indexes).
  * 
- * For convenience, the last several unpin function's dirty flag is alway true.
- * We can control it when coming across any performance problem in this function.
+ * In the concurrent environment the list may have been changed when we get here, so this function
+ * checks the pages again instead of ensuring to delete a page.
  * 
- * Hold the locks of second level page and empty pages, because the link list may be changed
- * and we should resist others to access this list when it's unstable.
+ * Hold the lock of second level page during the whole procedure, because the list may be changed
+ * and we should resist others to access this list when it's unstable. The others walk the list with
+ * the second level page's read lock held, so they never reach a removed page. TablePages are write locked
+ * from the beginning to the end, and at most three of them (previous, current, next) are held at a time.
  * 
  * @param sec_pg_slot_num slot_num offset in the first level page, used for getting the second level page id
  * @param tb_pg_slot_num slot_num offset int the second level page, used for getting the first TablePage's page id
+ * @param moved_rids record the (old rid, new rid) pair of every moved tuple, nullable
  */
-void lk_ha_clear_empty_page(page_id_t first_page_id, BufferPoolManager *bpm, hash_t hash_val, offset_t sec_pg_slot_num, offset_t tb_pg_slot_num) {
-    // get the first level's page
-    LinkHashPage *first_level_pg = reinterpret_cast<LinkHashPage*>(bpm->get_page(first_page_id));
+void lk_ha_compact_link_list(LinkHashDirectory *lk_ha_dir, const Schema &tb_schema, BufferPoolManager *bpm,
+    offset_t sec_pg_slot_num, offset_t tb_pg_slot_num, std::vector<std::pair<RID, RID>> *moved_rids) {
+    std::vector<Column> key_cols = get_key_columns(tb_schema);
 
     // get the second level's page
-    first_level_pg->r_lock();
-    page_id_t sec_level_pgid = first_level_pg->get_pgid_in_slot(sec_pg_slot_num);
-    first_level_pg->r_unlock();
-    bpm->unpin_page(first_page_id, false);
-
+    page_id_t sec_level_pgid = lk_ha_dir->get_sec_pgid(sec_pg_slot_num);
     LinkHashPage *sec_level_pg = reinterpret_cast<LinkHashPage*>(bpm->get_page(sec_level_pgid));
-
-    // get the third level's first TablePage
     sec_level_pg->w_lock(); // the second level page may be changed, so hold the write lock all the time
-    page_id_t checked_pgid = sec_level_pg->get_pgid_in_slot(tb_pg_slot_num);
+    bool sec_dirty = false;
 
-    /**
-     * ATTENTION Do not release the lock when collecting empty pages
-     * 
-     * there may be several empty TablePage that are linked together at the beginning.
-     * Collect them and find the first non-empty TablePage.
-     * Delete the collected empty TablePages and change the page id in the second level
-     * page's slot to refer to the first non-empty TablePage.
-     */
-    std::vector<TablePage*> empty_pages; // store the empty pages that should be deleted
-    TablePage *checked_tb_page = reinterpret_cast<TablePage*>(bpm->get_page(checked_pgid));
-    checked_tb_page->w_lock();
-    while (checked_tb_page->get_stored_tuple_cnt() == 0) {
-        empty_pages.push_back(checked_tb_page);
+    TablePage *prev_page = nullptr; // nullptr means the current page is the head of the list
+    bool prev_dirty = false;
+    page_id_t cur_pgid = sec_level_pg->get_pgid_in_slot(tb_pg_slot_num);
+    while (cur_pgid != INVALID_PAGE_ID) {
+        TablePage *cur_page = reinterpret_cast<TablePage*>(bpm->get_page(cur_pgid));
+        cur_page->w_lock();
+        page_id_t next_pgid = cur_page->get_next_page_id();
 
-        // get the next page
-        checked_pgid = checked_tb_page->get_next_page_id();
-
-        // reach to the end, break out
-        if (checked_pgid == INVALID_PAGE_ID)
-            break;
-        
-        // jump to the next page
-        checked_tb_page = reinterpret_cast<TablePage*>(bpm->get_page(checked_pgid));
-        checked_tb_page->w_lock();
-    }
-
-    // delete the empty pages
-    if (empty_pages.size() > 0) {
-        for (size_t i = 0; i < empty_pages.size(); i++) {
-            empty_pages[i]->w_unlock();
-            bpm->unpin_page(empty_pages[i]->get_page_id(), false);
-            while (true) {
-                if (bpm->delete_page(empty_pages[i]->get_page_id())) {
-                    break;
-                }
+        /**
+         * the page pinned by others (e.g. an iter staying on it, maybe on this thread) is kept this time,
+         * they may go on along its next page id, which isn't maintained after the page is removed.
+         * Nothing is moved into such a page either, the moved tuples may land in the free slots the
+         * iter has passed, and the iter misses them.
+         */
+        bool in_use = cur_page->get_pin_count() > 1;
+        bool removed = false;
+        if (in_use) {
+            // keep it
+        } else if (cur_page->get_stored_tuple_cnt() == 0) {
+            removed = true;
+        } else if (prev_page != nullptr && prev_page->get_pin_count() == 1
+            && prev_page->get_free_space() >= cur_page->get_used_space()) {
+            lk_ha_move_tuples(cur_page, prev_page, key_cols, moved_rids);
+            prev_dirty = true;
+            removed = true;
+        }
 
-                // someone else is accessing the page, wait...
-                std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        if (!removed) {
+            if (prev_page != nullptr) {
+                prev_page->w_unlock();
+                bpm->unpin_page(prev_page->get_page_id(), prev_dirty);
             }
+            prev_page = cur_page;
+            prev_dirty = false;
+            cur_pgid = next_pgid;
+            continue;
         }
-    }
 
-    // reset the page id in the second level page's slot
-    sec_level_pg->set_pgid_in_slot(tb_pg_slot_num, checked_pgid);
+        // unlink the current page
+        page_id_t prev_pgid = INVALID_PAGE_ID;
+        if (prev_page == nullptr) {
+            sec_level_pg->set_pgid_in_slot(tb_pg_slot_num, next_pgid);
+            sec_dirty = true;
+        } else {
+            prev_pgid = prev_page->get_page_id();
+            prev_page->set_next_page_id(next_pgid);
+            prev_dirty = true;
+        }
+        if (next_pgid != INVALID_PAGE_ID) {
+            TablePage *next_page = reinterpret_cast<TablePage*>(bpm->get_page(next_pgid));
+            next_page->w_lock();
+            next_page->set_prev_page_id(prev_pgid);
+            next_page->w_unlock();
+            bpm->unpin_page(next_pgid, true);
+        }
 
-    // there is no non-empty pages in this slot
-    if (checked_pgid == INVALID_PAGE_ID) {
-        sec_level_pg->w_unlock();
-        bpm->unpin_page(sec_level_pgid, true); // for convenience, always true
-        return;
+        cur_page->w_unlock();
+        bpm->unpin_page(cur_pgid, false);
+        bpm->delete_page(cur_pgid, true);
+        cur_pgid = next_pgid;
     }
 
-    // set the first non-empty page's previous page id to the INVALID_PAGE_ID
-    checked_tb_page->set_prev_page_id(INVALID_PAGE_ID);
-    checked_tb_page->w_unlock();
+    if (prev_page != nullptr) {
+        prev_page->w_unlock();
+        bpm->unpin_page(prev_page->get_page_id(), prev_dirty);
+    }
     sec_level_pg->w_unlock();
-    bpm->unpin_page(checked_pgid, true); // for convenience, always true
-    bpm->unpin_page(sec_level_pgid, true); // for convenience, always true
+    bpm->unpin_page(sec_level_pgid, sec_dirty);
 }
 
 op_code_t lk_ha_insert_tuple(INSERT_TUPLE_FUNC_PARAMS) {
-    if (lk_ha_check_duplicate_key(first_page_id, (*tuple).get_value(tb_schema, tb_schema.get_key_idx()), tb_schema, bpm)) {
-        return DUP_KEY;
+    // the tuple can't be contained even by an empty page, or it doesn't match the PAX page
+    if (tuple->get_size() + TablePage::get_tuple_record_sz() > TablePage::get_tp_load_data_space()
+        || (tb_schema.is_pax() && tuple->get_size() != tb_schema.get_tuple_size())) {
+        return TUPLE_TOO_LARGE;
     }
 
-    offset_t key_idx = tb_schema.get_key_idx();
-    Value key_value = tuple->get_value(tb_schema, key_idx);
+    IndexKey key(tuple->get_data(), get_key_columns(tb_schema));
+    if (lk_ha_check_duplicate_key(lk_ha_dir, key, tb_schema, bpm)) {
+        return DUP_KEY;
+    }
 
-    // hash the value
-    hash_t hash_val = key_value.get_hash_value();
+    // hash the key
+    hash_t hash_val = key.get_hash_value();
     offset_t sec_pg_slot_num;
     offset_t tb_pg_slot_num;
 
     hash_to_slot(hash_val, &sec_pg_slot_num, &tb_pg_slot_num);
     
-    // the the first level's LinkHashPage
-    LinkHashPage *first_level_page = reinterpret_cast<LinkHashPage*>(bpm->get_page(first_page_id));
-    
-    // get the second level's LinkHashPage
-    LinkHashPage *second_level_page;
-    first_level_page->r_lock();
-    page_id_t second_level_page_id = first_level_page->get_pgid_in_slot(sec_pg_slot_num);
-    first_level_page->r_unlock();
-    bool first_level_pg_dirty = false;
-
+    // get the second level's LinkHashPage, it's created when nonexistent
+    page_id_t second_level_page_id = lk_ha_dir->get_or_create_sec_pgid(sec_pg_slot_num);
     if (second_level_page_id == INVALID_PAGE_ID) {
-        // create the second level page when it's nonexistent
-        second_level_page = reinterpret_cast<LinkHashPage*>(bpm->new_page());
-        second_level_page_id = second_level_page->get_page_id();
-        second_level_page->init();
-
-        // update the first level page
-        first_level_page->w_lock();
-        first_level_page->set_pgid_in_slot(sec_pg_slot_num, second_level_page_id);
-        first_level_page->w_unlock();
-        first_level_pg_dirty = true;
-    } else {
-        second_level_page = reinterpret_cast<LinkHashPage*>(bpm->get_page(second_level_page_id));
+        return NEW_PG_FAIL;
     }
+    LinkHashPage *second_level_page = reinterpret_cast<LinkHashPage*>(bpm->get_page(second_level_page_id));
 
-    bpm->unpin_page(first_page_id, first_level_pg_dirty);
-
-    // get the third level's TablePage
+    /**
+     * get the third level's TablePage, the second level page is latched until the TablePage is latched,
+     * or the compaction may unlink the page in between and the tuple is inserted into a removed page
+     */
     TablePage *third_level_page;
     second_level_page->r_lock();
     page_id_t third_level_page_id = second_level_page->get_pgid_in_slot(tb_pg_slot_num);
+    if (third_level_page_id != INVALID_PAGE_ID) {
+        third_level_page = reinterpret_cast<TablePage*>(bpm->get_page(third_level_page_id));
+        third_level_page->w_lock();
+    }
     second_level_page->r_unlock();
     bool second_level_pg_dirty = false;
 
     if (third_level_page_id == INVALID_PAGE_ID) {
-        // create the third level page when it's nonexistent
-        third_level_page = reinterpret_cast<TablePage*>(bpm->new_page());
-        third_level_page_id = third_level_page->get_page_id();
-        third_level_page->init(INVALID_PAGE_ID, INVALID_PAGE_ID);
+        // check again with the write lock, someone else may have created the page
         second_level_page->w_lock();
-        second_level_page->set_pgid_in_slot(tb_pg_slot_num, third_level_page_id);
+        third_level_page_id = second_level_page->get_pgid_in_slot(tb_pg_slot_num);
+        if (third_level_page_id == INVALID_PAGE_ID) {
+            // create the third level page when it's nonexistent
+            third_level_page = reinterpret_cast<TablePage*>(bpm->new_page());
+            if (third_level_page == nullptr) {
+                second_level_page->w_unlock();
+                bpm->unpin_page(second_level_page_id, false);
+                return NEW_PG_FAIL;
+            }
+            third_level_page_id = third_level_page->get_page_id();
+            third_level_page->init(INVALID_PAGE_ID, INVALID_PAGE_ID, tb_schema);
+            second_level_page->set_pgid_in_slot(tb_pg_slot_num, third_level_page_id);
+            second_level_pg_dirty = true;
+        } else {
+            third_level_page = reinterpret_cast<TablePage*>(bpm->get_page(third_level_page_id));
+        }
+        third_level_page->w_lock();
         second_level_page->w_unlock();
-        second_level_pg_dirty = true;
-    } else {
-        third_level_page = reinterpret_cast<TablePage*>(bpm->get_page(third_level_page_id));
     }
 
     bpm->unpin_page(second_level_page_id, second_level_pg_dirty);
 
     // insert the tuple
     RID rid;
-    third_level_page->w_lock();
     while (!third_level_page->insert_tuple(*tuple, &rid)) {
         // jump to the next TablePage or create a new TablePage
         third_level_page_id = third_level_page->get_next_page_id();
@@ -255,15 +349,16 @@ op_code_t lk_ha_insert_tuple(INSERT_TUPLE_FUNC_PARAMS) {
             // create a new TablePage
             TablePage *new_page = reinterpret_cast<TablePage*>(bpm->new_page());
             if (new_page == nullptr) {
+                third_level_page->w_unlock();
                 bpm->unpin_page(third_level_page->get_page_id(), false);
                 return NEW_PG_FAIL;
             }
 
             new_page->w_lock();
 
-            // update the link list
+            // update the link list, new page should be initialized or the key filter may contain garbage
+            new_page->init(third_level_page->get_page_id(), INVALID_PAGE_ID, tb_schema);
             third_level_page->set_next_page_id(new_page->get_page_id());
-            new_page->set_prev_page_id(third_level_page->get_page_id());
 
             third_level_page->w_unlock();
             bpm->unpin_page(third_level_page->get_page_id(), true);
@@ -274,15 +369,16 @@ op_code_t lk_ha_insert_tuple(INSERT_TUPLE_FUNC_PARAMS) {
             continue;
         }
 
-        // get the next page
+        // latch the next page before leaving this one, the compaction can't unlink it in between
         TablePage *next_page = reinterpret_cast<TablePage*>(bpm->get_page(third_level_page_id));
+        next_page->w_lock();
         third_level_page->w_unlock();
         bpm->unpin_page(third_level_page->get_page_id(), false);
 
         // jump to the next page
         third_level_page = next_page;
-        third_level_page->w_lock();
     }
+    third_level_page->add_key_hash(hash_val);
     third_level_page->w_unlock();
     bpm->unpin_page(third_level_page_id, true);
     tuple->set_rid(rid);
@@ -290,12 +386,157 @@ op_code_t lk_ha_insert_tuple(INSERT_TUPLE_FUNC_PARAMS) {
     return OP_SUCCESS;
 }
 
+/** delete the pages of a list that is invisible to others, e.g. the one failed to be built */
+inline void lk_ha_delete_link_list(page_id_t head_pgid, BufferPoolManager *bpm) {
+    page_id_t pgid = head_pgid;
+    while (pgid != INVALID_PAGE_ID) {
+        TablePage *tb_page = reinterpret_cast<TablePage*>(bpm->get_page(pgid));
+        if (tb_page == nullptr)
+            return;
+        page_id_t next_pgid = tb_page->get_next_page_id();
+        bpm->unpin_page(pgid, false);
+        bpm->delete_page(pgid);
+        pgid = next_pgid;
+    }
+}
+
+/**
+ * Build a TablePage list with the tuples in [begin, end) of the order, all of them are in the same slot.
+ * The pages are invisible to others until the slot refers to the head page, so they are not latched.
+ * RIDs are set only after the whole list has been built, and the pages are deleted if it fails.
+ * @param head_pgid return the head page's id
+ */
+inline op_code_t lk_ha_build_link_list(std::vector<Tuple> *tuples, const std::vector<size_t> &order,
+    const std::vector<hash_t> &hash_vals, size_t begin, size_t end, const Schema &tb_schema,
+    BufferPoolManager *bpm, page_id_t *head_pgid) {
+    std::vector<RID> rids(end - begin);
+    TablePage *tb_page = reinterpret_cast<TablePage*>(bpm->new_page());
+    if (tb_page == nullptr)
+        return NEW_PG_FAIL;
+    tb_page->init(INVALID_PAGE_ID, INVALID_PAGE_ID, tb_schema);
+    *head_pgid = tb_page->get_page_id();
+
+    for (size_t i = begin; i < end; i++) {
+        size_t idx = order[i];
+        if (!tb_page->insert_tuple((*tuples)[idx], &rids[i - begin])) {
+            // the page is full, append a new one
+            TablePage *new_page = reinterpret_cast<TablePage*>(bpm->new_page());
+            if (new_page == nullptr) {
+                bpm->unpin_page(tb_page->get_page_id(), true);
+                lk_ha_delete_link_list(*head_pgid, bpm);
+                return NEW_PG_FAIL;
+            }
+            new_page->init(tb_page->get_page_id(), INVALID_PAGE_ID, tb_schema);
+            tb_page->set_next_page_id(new_page->get_page_id());
+            bpm->unpin_page(tb_page->get_page_id(), true);
+            tb_page = new_page;
+
+            if (!tb_page->insert_tuple((*tuples)[idx], &rids[i - begin])) {
+                bpm->unpin_page(tb_page->get_page_id(), true);
+                lk_ha_delete_link_list(*head_pgid, bpm);
+                return TUPLE_TOO_LARGE;
+            }
+        }
+        tb_page->add_key_hash(hash_vals[idx]);
+    }
+    bpm->unpin_page(tb_page->get_page_id(), true);
+
+    for (size_t i = begin; i < end; i++)
+        (*tuples)[order[i]].set_rid(rids[i - begin]);
+    return OP_SUCCESS;
+}
+
+op_code_t lk_ha_bulk_load(BULK_LOAD_FUNC_PARAMS) {
+    std::vector<Column> key_cols = get_key_columns(tb_schema);
+    size_t tuple_num = tuples->size();
+
+    // encode the keys and find their slots
+    std::vector<IndexKey> keys;
+    std::vector<hash_t> hash_vals(tuple_num);
+    std::vector<offset_t> slots(tuple_num);
+    keys.reserve(tuple_num);
+    for (size_t i = 0; i < tuple_num; i++) {
+        (*tuples)[i].set_rid(RID());
+        keys.emplace_back((*tuples)[i].get_data(), key_cols);
+        hash_vals[i] = keys[i].get_hash_value();
+
+        offset_t sec_pg_slot_num;
+        offset_t tb_pg_slot_num;
+        hash_to_slot(hash_vals[i], &sec_pg_slot_num, &tb_pg_slot_num);
+        slots[i] = sec_pg_slot_num * LK_HA_PG_SLOT_NUM + tb_pg_slot_num;
+    }
+
+    // sort by the slot, and by the key in the same slot so that duplicated keys are adjacent
+    std::vector<size_t> order(tuple_num);
+    for (size_t i = 0; i < tuple_num; i++)
+        order[i] = i;
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        if (slots[a] != slots[b])
+            return slots[a] < slots[b];
+        return keys[a] < keys[b];
+    });
+    for (size_t i = 1; i < tuple_num; i++) {
+        if (slots[order[i]] == slots[order[i - 1]] && keys[order[i]] == keys[order[i - 1]])
+            return DUP_KEY;
+    }
+
+    std::vector<size_t> rest; // tuples whose slot has had a TablePage list
+    size_t i = 0;
+    while (i < tuple_num) {
+        offset_t sec_pg_slot_num = slots[order[i]] / LK_HA_PG_SLOT_NUM;
+        page_id_t sec_level_pgid = lk_ha_dir->get_or_create_sec_pgid(sec_pg_slot_num);
+        if (sec_level_pgid == INVALID_PAGE_ID)
+            return NEW_PG_FAIL;
+        LinkHashPage *sec_level_pg = reinterpret_cast<LinkHashPage*>(bpm->get_page(sec_level_pgid));
+        bool dirty = false;
+        op_code_t op_code = OP_SUCCESS;
+
+        sec_level_pg->w_lock();
+        while (i < tuple_num && slots[order[i]] / LK_HA_PG_SLOT_NUM == sec_pg_slot_num) {
+            offset_t tb_pg_slot_num = slots[order[i]] % LK_HA_PG_SLOT_NUM;
+            size_t end = i;
+            while (end < tuple_num && slots[order[end]] == slots[order[i]])
+                end++;
+
+            if (sec_level_pg->get_pgid_in_slot(tb_pg_slot_num) != INVALID_PAGE_ID) {
+                for (; i < end; i++)
+                    rest.push_back(order[i]);
+                continue;
+            }
+
+            page_id_t head_pgid;
+            op_code = lk_ha_build_link_list(tuples, order, hash_vals, i, end, tb_schema, bpm, &head_pgid);
+            if (op_code != OP_SUCCESS)
+                break;
+            sec_level_pg->set_pgid_in_slot(tb_pg_slot_num, head_pgid);
+            dirty = true;
+            i = end;
+        }
+        sec_level_pg->w_unlock();
+        bpm->unpin_page(sec_level_pgid, dirty);
+
+        if (op_code != OP_SUCCESS)
+            return op_code;
+    }
+
+    // keys may be duplicated with the existing ones, skip them and keep loading
+    op_code_t result = OP_SUCCESS;
+    for (auto idx : rest) {
+        op_code_t op_code = lk_ha_insert_tuple(lk_ha_dir, &(*tuples)[idx], tb_schema, bpm);
+        if (op_code == NEW_PG_FAIL)
+            return op_code;
+        if (op_code != OP_SUCCESS && result == OP_SUCCESS)
+            result = op_code;
+    }
+    return result;
+}
+
 /**
  * @param tuple tuple is return by this pointer
  */
 op_code_t lk_ha_get_tuple(GET_TUPLE_FUNC_PARAMS) {
     RID rid;
-    if (!lk_ha_check_duplicate_key(first_page_id, key_value, tb_schema, bpm, &rid)) {
+    if (!lk_ha_check_duplicate_key(lk_ha_dir, key, tb_schema, bpm, &rid)) {
         // can't find the tuple
         return TUPLE_NOT_FOUND;
     }
@@ -314,9 +555,139 @@ op_code_t lk_ha_get_tuple(GET_TUPLE_FUNC_PARAMS) {
     return TUPLE_NOT_FOUND;
 }
 
+/**
+ * position of a key in the link hash, keys are sorted by it
+ * so that each page only needs to be pinned once.
+ */
+struct LinkHashProbe {
+    offset_t sec_pg_slot_num;
+    offset_t tb_pg_slot_num;
+    hash_t hash_val;
+    size_t idx; // index in the keys
+};
+
+size_t_ lk_ha_get_tuples_batch(GET_TUPLES_FUNC_PARAMS) {
+    size_t key_num = keys.size();
+    tuples->clear();
+    tuples->resize(key_num);
+    if (key_num == 0) {
+        return 0;
+    }
+
+    // hash all the keys and sort them by the slots they will visit
+    std::vector<LinkHashProbe> probes(key_num);
+    for (size_t i = 0; i < key_num; i++) {
+        probes[i].hash_val = keys[i].get_hash_value();
+        probes[i].idx = i;
+        hash_to_slot(probes[i].hash_val, &probes[i].sec_pg_slot_num, &probes[i].tb_pg_slot_num);
+    }
+    std::sort(probes.begin(), probes.end(), [](const LinkHashProbe &a, const LinkHashProbe &b) {
+        if (a.sec_pg_slot_num != b.sec_pg_slot_num)
+            return a.sec_pg_slot_num < b.sec_pg_slot_num;
+        return a.tb_pg_slot_num < b.tb_pg_slot_num;
+    });
+
+    std::vector<Column> key_cols = get_key_columns(tb_schema);
+
+    // collect all the second level pages' ids from the directory
+    std::vector<page_id_t> sec_level_pgids(key_num);
+    for (size_t i = 0; i < key_num; i++) {
+        sec_level_pgids[i] = lk_ha_dir->get_sec_pgid(probes[i].sec_pg_slot_num);
+    }
+
+    /**
+     * the next second level page is read from the disk while the lists of the current one are walked,
+     * it's pinned by the prefetching thread and the pin is taken over when it's visited
+     */
+    std::future<Page*> prefetch;
+    page_id_t prefetch_pgid = INVALID_PAGE_ID;
+
+    size_t_ found_num = 0;
+    size_t sec_begin = 0;
+    while (sec_begin < key_num) {
+        // keys in [sec_begin, sec_end) share the same second level page
+        size_t sec_end = sec_begin;
+        while (sec_end < key_num && probes[sec_end].sec_pg_slot_num == probes[sec_begin].sec_pg_slot_num)
+            sec_end++;
+
+        page_id_t sec_level_pgid = sec_level_pgids[sec_begin];
+        if (sec_level_pgid == INVALID_PAGE_ID) {
+            sec_begin = sec_end;
+            continue;
+        }
+
+        Page *page = nullptr;
+        if (prefetch_pgid == sec_level_pgid)
+            page = prefetch.get();
+        if (page == nullptr)
+            page = bpm->get_page(sec_level_pgid);
+        LinkHashPage *sec_level_page = reinterpret_cast<LinkHashPage*>(page);
+
+        size_t next_begin = sec_end;
+        while (next_begin < key_num && sec_level_pgids[next_begin] == INVALID_PAGE_ID)
+            next_begin++;
+        prefetch_pgid = INVALID_PAGE_ID;
+        if (next_begin < key_num) {
+            prefetch_pgid = sec_level_pgids[next_begin];
+            prefetch = std::async(std::launch::async, [bpm, prefetch_pgid] { return bpm->get_page(prefetch_pgid); });
+        }
+
+        /**
+         * collect the head of the link lists with only one pin of the second level page, it's read locked
+         * until the lists are walked so that they aren't compacted in the meantime
+         */
+        std::vector<page_id_t> tb_pgids(sec_end - sec_begin);
+        sec_level_page->r_lock();
+        for (size_t i = sec_begin; i < sec_end; i++) {
+            tb_pgids[i - sec_begin] = sec_level_page->get_pgid_in_slot(probes[i].tb_pg_slot_num);
+        }
+
+        size_t tb_begin = sec_begin;
+        while (tb_begin < sec_end) {
+            // keys in [tb_begin, tb_end) share the same link list
+            size_t tb_end = tb_begin;
+            while (tb_end < sec_end && probes[tb_end].tb_pg_slot_num == probes[tb_begin].tb_pg_slot_num)
+                tb_end++;
+
+            // walk the link list only once for all of these keys
+            size_t_ pending = tb_end - tb_begin;
+            page_id_t tb_pgid = tb_pgids[tb_begin - sec_begin];
+            while (tb_pgid != INVALID_PAGE_ID && pending > 0) {
+                TablePage *tb_page = reinterpret_cast<TablePage*>(bpm->get_page(tb_pgid));
+                tb_page->r_lock();
+                for (size_t i = tb_begin; i < tb_end; i++) {
+                    size_t idx = probes[i].idx;
+                    Tuple &tuple = (*tuples)[idx];
+                    if (tuple.get_rid().get_page_id() != INVALID_PAGE_ID) {
+                        continue; // has been found
+                    }
+
+                    RID rid;
+                    if (search_key_in_page(tb_page, probes[i].hash_val, keys[idx], key_cols, &rid)) {
+                        tb_page->get_tuple(&tuple, rid);
+                        found_num++;
+                        pending--;
+                    }
+                }
+                page_id_t next_pgid = tb_page->get_next_page_id();
+                tb_page->r_unlock();
+                bpm->unpin_page(tb_pgid, false);
+                tb_pgid = next_pgid;
+            }
+            tb_begin = tb_end;
+        }
+        sec_level_page->r_unlock();
+        bpm->unpin_page(sec_level_pgid, false);
+        sec_begin = sec_end;
+    }
+
+    return found_num;
+}
+
 op_code_t lk_ha_update_tuple(UPDATE_TUPLE_FUNC_PARAMS) {
     // get the old tuple first
-    Value key_val = new_tuple->get_value(tb_schema, tb_schema.get_key_idx());
+    std::vector<Column> key_cols = get_key_columns(tb_schema);
+    IndexKey new_key(new_tuple->get_data(), key_cols);
     Tuple old_tuple;
     if (get_tuple_directly(old_rid, &old_tuple, bpm) != OP_SUCCESS) {
         return TUPLE_NOT_FOUND;
@@ -325,17 +696,32 @@ op_code_t lk_ha_update_tuple(UPDATE_TUPLE_FUNC_PARAMS) {
     TablePage *tb_page = reinterpret_cast<TablePage*>(bpm->get_page(old_rid.get_page_id()));
 
     // compare the key
-    if (key_val == old_tuple.get_value(tb_schema, tb_schema.get_key_idx())) {
+    if (new_key == IndexKey(old_tuple.get_data(), key_cols)) {
         // update the tuple in place
         tb_page->w_lock();
-        tb_page->update_tuple(*new_tuple, old_rid);
+        bool ok = tb_page->update_tuple(*new_tuple, old_rid);
+        if (ok) {
+            tb_page->w_unlock();
+            bpm->unpin_page(old_rid.get_page_id(), true);
+            new_tuple->set_rid(old_rid);
+            return OP_SUCCESS;
+        }
+
+        // the larger tuple can't be put into this page, move it to another page of the list
+        tb_page->mark_delete(old_rid);
+        tb_page->apply_delete(old_rid);
         tb_page->w_unlock();
         bpm->unpin_page(old_rid.get_page_id(), true);
-        new_tuple->set_rid(old_rid);
-        return OP_SUCCESS;
+
+        op_code_t op_code = lk_ha_insert_tuple(lk_ha_dir, new_tuple, tb_schema, bpm);
+        if (op_code != OP_SUCCESS) {
+            // put the old tuple back, it's removed just now so that there should be enough space
+            lk_ha_insert_tuple(lk_ha_dir, &old_tuple, tb_schema, bpm);
+        }
+        return op_code;
     }
 
-    op_code_t op_code = lk_ha_insert_tuple(first_page_id, new_tuple, tb_schema, bpm);
+    op_code_t op_code = lk_ha_insert_tuple(lk_ha_dir, new_tuple, tb_schema, bpm);
 
     if (op_code == DUP_KEY) {
         return DUP_KEY;
@@ -357,8 +743,8 @@ op_code_t lk_ha_update_tuple(UPDATE_TUPLE_FUNC_PARAMS) {
 
 op_code_t lk_ha_mark_delete(MARK_DELETE_FUNC_PARAMS) {
     Tuple tuple;
-    if (!lk_ha_get_tuple(first_page_id, key_value, &tuple, tb_schema, bpm)) {
-        return false;
+    if (lk_ha_get_tuple(lk_ha_dir, key, &tuple, tb_schema, bpm) != OP_SUCCESS) {
+        return TUPLE_NOT_FOUND;
     }
 
     page_id_t page_id = tuple.get_rid().get_page_id();
@@ -377,27 +763,35 @@ op_code_t lk_ha_mark_delete(MARK_DELETE_FUNC_PARAMS) {
 
 void lk_ha_apply_delete(APPLY_DELETE_FUNC_PARAMS) {
     Tuple tuple;
-    if (lk_ha_get_tuple(first_page_id, key_value, &tuple, tb_schema, bpm) != OP_SUCCESS) {
+    if (lk_ha_get_tuple(lk_ha_dir, key, &tuple, tb_schema, bpm) != OP_SUCCESS) {
         return;
     }
 
     page_id_t page_id = tuple.get_rid().get_page_id();
     TablePage *tb_page = reinterpret_cast<TablePage*>(bpm->get_page(page_id));
     tb_page->w_lock();
+    size_t_ used_before = tb_page->get_used_space();
     tb_page->apply_delete(tuple.get_rid());
-    size_t_ tuple_cnt = tb_page->get_stored_tuple_cnt();
+    size_t_ used_after = tb_page->get_used_space();
+    page_id_t prev_pgid = tb_page->get_prev_page_id();
+    page_id_t next_pgid = tb_page->get_next_page_id();
     tb_page->w_unlock();
     bpm->unpin_page(page_id, true);
-    if (tuple_cnt == 0) {
+
+    /**
+     * compact the list when the page becomes empty, or when it just becomes sparse and
+     * has a neighbour to merge with. Only the crossing of the threshold triggers the
+     * compaction, so deleting from an already sparse page doesn't walk the list again.
+     */
+    bool has_neighbour = prev_pgid != INVALID_PAGE_ID || next_pgid != INVALID_PAGE_ID;
+    bool become_sparse = used_before >= LK_HA_SPARSE_PAGE_SPACE && used_after < LK_HA_SPARSE_PAGE_SPACE;
+    if (used_after == 0 || (become_sparse && has_neighbour)) {
         offset_t sec_pg_slot_num;
         offset_t tb_pg_slot_num;
-        hash_to_slot(key_value.get_hash_value(), &sec_pg_slot_num, &tb_pg_slot_num);
+        hash_to_slot(key.get_hash_value(), &sec_pg_slot_num, &tb_pg_slot_num);
 
-        /**
-         * TODO: run a background thread to clear empty pages from time to time
-         * It's very inefficient to scan all the table every time we want to delete a single page.
-         */
-        lk_ha_clear_empty_page(first_page_id, bpm, key_value.get_hash_value(), sec_pg_slot_num, tb_pg_slot_num);
+        // TODO: run a background thread to compact the lists from time to time
+        lk_ha_compact_link_list(lk_ha_dir, tb_schema, bpm, sec_pg_slot_num, tb_pg_slot_num, moved_rids);
     }
 }
 
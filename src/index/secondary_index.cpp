@@ -0,0 +1,217 @@
+#include "index/secondary_index.h"
+#include "storage/page/link_hash_page.h"
+#include "storage/page/table_page.h"
+
+namespace dawn {
+
+SecondaryIndex::SecondaryIndex(BufferPoolManager *bpm, page_id_t first_page_id, const std::vector<offset_t> &col_idxs,
+    const Schema &tb_schema, index_code_t index_type, bool from_scratch)
+    : bpm_(bpm), first_page_id_(first_page_id), col_idxs_(col_idxs), index_type_(index_type), lk_ha_dir_(nullptr) {
+    for (offset_t col_idx : col_idxs_)
+        key_cols_.push_back(tb_schema.get_column(col_idx));
+    key_size_ = IndexKey::get_key_size(key_cols_);
+
+    if (index_type_ != LINK_HASH) {
+        FATAL("only the link hash is supported by the secondary index so far");
+    }
+
+    if (from_scratch) {
+        LinkHashPage *first_level_page = reinterpret_cast<LinkHashPage*>(bpm_->get_page(first_page_id_));
+        if (first_level_page == nullptr) {
+            FATAL("can't get the secondary index's first level page");
+        }
+        first_level_page->init();
+        bpm_->unpin_page(first_page_id_, true);
+    }
+
+    lk_ha_dir_ = new LinkHashDirectory(first_page_id_, bpm_);
+}
+
+SecondaryIndex::~SecondaryIndex() {
+    delete lk_ha_dir_;
+}
+
+page_id_t SecondaryIndex::get_list_head(hash_t hash_val) {
+    offset_t sec_pg_slot_num;
+    offset_t tb_pg_slot_num;
+    hash_to_slot(hash_val, &sec_pg_slot_num, &tb_pg_slot_num);
+
+    page_id_t sec_level_pgid = lk_ha_dir_->get_sec_pgid(sec_pg_slot_num);
+    if (sec_level_pgid == INVALID_PAGE_ID) {
+        return INVALID_PAGE_ID;
+    }
+
+    LinkHashPage *sec_level_page = reinterpret_cast<LinkHashPage*>(bpm_->get_page(sec_level_pgid));
+    sec_level_page->r_lock();
+    page_id_t head_pgid = sec_level_page->get_pgid_in_slot(tb_pg_slot_num);
+    sec_level_page->r_unlock();
+    bpm_->unpin_page(sec_level_pgid, false);
+    return head_pgid;
+}
+
+bool SecondaryIndex::insert_entry(const IndexKey &key, const RID &rid) {
+    hash_t hash_val = key.get_hash_value();
+
+    offset_t sec_pg_slot_num;
+    offset_t tb_pg_slot_num;
+    hash_to_slot(hash_val, &sec_pg_slot_num, &tb_pg_slot_num);
+
+    // make the entry
+    Tuple entry(RID(), get_entry_size());
+    memcpy(entry.get_data(), key.get_data(), key_size_);
+    *reinterpret_cast<page_id_t*>(entry.get_data() + key_size_) = rid.get_page_id();
+    *reinterpret_cast<offset_t*>(entry.get_data() + key_size_ + PGID_T_SIZE) = rid.get_slot_num();
+
+    // get the second level page
+    page_id_t sec_level_pgid = lk_ha_dir_->get_or_create_sec_pgid(sec_pg_slot_num);
+    if (sec_level_pgid == INVALID_PAGE_ID) {
+        return false;
+    }
+    LinkHashPage *sec_level_page = reinterpret_cast<LinkHashPage*>(bpm_->get_page(sec_level_pgid));
+
+    // get the head of the link list, create it when it's nonexistent
+    bool sec_level_pg_dirty = false;
+    sec_level_page->w_lock();
+    page_id_t tb_pgid = sec_level_page->get_pgid_in_slot(tb_pg_slot_num);
+    TablePage *tb_page;
+    if (tb_pgid == INVALID_PAGE_ID) {
+        tb_page = reinterpret_cast<TablePage*>(bpm_->new_page());
+        if (tb_page == nullptr) {
+            sec_level_page->w_unlock();
+            bpm_->unpin_page(sec_level_pgid, false);
+            return false;
+        }
+        tb_pgid = tb_page->get_page_id();
+        tb_page->init(INVALID_PAGE_ID, INVALID_PAGE_ID);
+        sec_level_page->set_pgid_in_slot(tb_pg_slot_num, tb_pgid);
+        sec_level_pg_dirty = true;
+    } else {
+        tb_page = reinterpret_cast<TablePage*>(bpm_->get_page(tb_pgid));
+    }
+    sec_level_page->w_unlock();
+    bpm_->unpin_page(sec_level_pgid, sec_level_pg_dirty);
+
+    // insert the entry into the first page that has enough space
+    RID entry_rid;
+    tb_page->w_lock();
+    while (!tb_page->insert_tuple(entry, &entry_rid)) {
+        page_id_t next_pgid = tb_page->get_next_page_id();
+        TablePage *next_page;
+        if (next_pgid == INVALID_PAGE_ID) {
+            next_page = reinterpret_cast<TablePage*>(bpm_->new_page());
+            if (next_page == nullptr) {
+                tb_page->w_unlock();
+                bpm_->unpin_page(tb_pgid, false);
+                return false;
+            }
+            next_page->w_lock();
+            next_page->init(tb_pgid, INVALID_PAGE_ID);
+            tb_page->set_next_page_id(next_page->get_page_id());
+            tb_page->w_unlock();
+            bpm_->unpin_page(tb_pgid, true);
+        } else {
+            next_page = reinterpret_cast<TablePage*>(bpm_->get_page(next_pgid));
+            tb_page->w_unlock();
+            bpm_->unpin_page(tb_pgid, false);
+            next_page->w_lock();
+        }
+        tb_page = next_page;
+        tb_pgid = tb_page->get_page_id();
+    }
+    tb_page->add_key_hash(hash_val);
+    tb_page->w_unlock();
+    bpm_->unpin_page(tb_pgid, true);
+    return true;
+}
+
+bool SecondaryIndex::delete_entry(const IndexKey &key, const RID &rid) {
+    hash_t hash_val = key.get_hash_value();
+
+    page_id_t tb_pgid = get_list_head(hash_val);
+    while (tb_pgid != INVALID_PAGE_ID) {
+        TablePage *tb_page = reinterpret_cast<TablePage*>(bpm_->get_page(tb_pgid));
+        tb_page->w_lock();
+        if (tb_page->may_contain_key(hash_val)) {
+            RID cur_rid;
+            RID next_rid;
+            while (tb_page->get_next_tuple_rid(cur_rid, &next_rid)) {
+                char *entry_data = tb_page->get_tuple_data(next_rid.get_slot_num());
+                if (memcmp(entry_data, key.get_data(), key_size_) == 0 &&
+                    *reinterpret_cast<page_id_t*>(entry_data + key_size_) == rid.get_page_id() &&
+                    *reinterpret_cast<offset_t*>(entry_data + key_size_ + PGID_T_SIZE) == rid.get_slot_num()) {
+                    tb_page->mark_delete(next_rid);
+                    tb_page->apply_delete(next_rid);
+                    tb_page->w_unlock();
+                    bpm_->unpin_page(tb_pgid, true);
+                    return true;
+                }
+                cur_rid = next_rid;
+            }
+        }
+        page_id_t next_pgid = tb_page->get_next_page_id();
+        tb_page->w_unlock();
+        bpm_->unpin_page(tb_pgid, false);
+        tb_pgid = next_pgid;
+    }
+    return false;
+}
+
+void SecondaryIndex::scan_key(const IndexKey &key, std::vector<RID> *rids) {
+    hash_t hash_val = key.get_hash_value();
+
+    page_id_t tb_pgid = get_list_head(hash_val);
+    while (tb_pgid != INVALID_PAGE_ID) {
+        TablePage *tb_page = reinterpret_cast<TablePage*>(bpm_->get_page(tb_pgid));
+        tb_page->r_lock();
+        if (tb_page->may_contain_key(hash_val)) {
+            RID cur_rid;
+            RID next_rid;
+            while (tb_page->get_next_tuple_rid(cur_rid, &next_rid)) {
+                char *entry_data = tb_page->get_tuple_data(next_rid.get_slot_num());
+                if (memcmp(entry_data, key.get_data(), key_size_) == 0) {
+                    rids->push_back(RID(*reinterpret_cast<page_id_t*>(entry_data + key_size_),
+                        *reinterpret_cast<offset_t*>(entry_data + key_size_ + PGID_T_SIZE)));
+                }
+                cur_rid = next_rid;
+            }
+        }
+        page_id_t next_pgid = tb_page->get_next_page_id();
+        tb_page->r_unlock();
+        bpm_->unpin_page(tb_pgid, false);
+        tb_pgid = next_pgid;
+    }
+}
+
+void SecondaryIndex::delete_all_data() {
+    // collect all the pages first
+    std::vector<page_id_t> pgids;
+    for (offset_t i = 0; i < LK_HA_PG_SLOT_NUM; i++) {
+        page_id_t sec_level_pgid = lk_ha_dir_->get_sec_pgid(i);
+        if (sec_level_pgid == INVALID_PAGE_ID)
+            continue;
+        pgids.push_back(sec_level_pgid);
+
+        LinkHashPage *sec_level_page = reinterpret_cast<LinkHashPage*>(bpm_->get_page(sec_level_pgid));
+        for (offset_t j = 0; j < LK_HA_PG_SLOT_NUM; j++) {
+            page_id_t tb_pgid = sec_level_page->get_pgid_in_slot(j);
+            while (tb_pgid != INVALID_PAGE_ID) {
+                pgids.push_back(tb_pgid);
+                TablePage *tb_page = reinterpret_cast<TablePage*>(bpm_->get_page(tb_pgid));
+                page_id_t next_pgid = tb_page->get_next_page_id();
+                bpm_->unpin_page(tb_pgid, false);
+                tb_pgid = next_pgid;
+            }
+        }
+        bpm_->unpin_page(sec_level_pgid, false);
+    }
+
+    // release the first level page before deleting it
+    delete lk_ha_dir_;
+    lk_ha_dir_ = nullptr;
+    pgids.push_back(first_page_id_);
+
+    for (page_id_t pgid : pgids)
+        bpm_->delete_page(pgid);
+}
+
+} // namespace dawn
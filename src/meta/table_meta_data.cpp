@@ -1,5 +1,6 @@
 #include "meta/table_meta_data.h"
 #include "storage/page/link_hash_page.h"
+#include "table/lk_ha_tb_iter.h"
 
 namespace dawn {
 /** 
@@ -52,6 +53,8 @@ TableMetaData::TableMetaData(BufferPoolManager *bpm, const string_t &table_name,
         // make column
         if (type_id == TypeId::kChar) {
             cols.push_back(Column(name, offset_in_tp, data_size));
+        } else if (type_id == TypeId::kVarchar) {
+            cols.push_back(Column(name, offset_in_tp, data_size, TypeId::kVarchar));
         } else {
             cols.push_back(Column(type_id, name, offset_in_tp));
         }
@@ -60,8 +63,27 @@ TableMetaData::TableMetaData(BufferPoolManager *bpm, const string_t &table_name,
     // create Schema
     table_schema_ = new Schema(cols);
 
+    // the old version doesn't record the key, and the default key is used
+    size_t_ key_col_num = *reinterpret_cast<size_t_*>(data_ + KEY_COL_NUM_OFFSET);
+    if (key_col_num > 0 && key_col_num <= MAX_KEY_COL_NUM) {
+        std::vector<offset_t> key_idxs;
+        for (size_t_ i = 0; i < key_col_num; i++) {
+            offset_t key_idx = *reinterpret_cast<offset_t*>(data_ + FIRST_KEY_COL_OFFSET + i * OFFSET_T_SIZE);
+            if (key_idx < 0 || key_idx >= column_num) {
+                key_idxs.clear();
+                break;
+            }
+            key_idxs.push_back(key_idx);
+        }
+        table_schema_->set_key_idxs(key_idxs);
+    }
+
+    // the reserved space is 0 in the old version, it's ROW_LAYOUT
+    table_schema_->set_layout(*reinterpret_cast<layout_code_t*>(data_ + LAYOUT_OFFSET));
+
     // create Table
     table_ = new Table(bpm_, first_table_page_id_, false);
+    load_indexes();
 }
 
 /** 
@@ -84,6 +106,15 @@ TableMetaData::TableMetaData(BufferPoolManager *bpm, const string_t &table_name,
     // write data to the memory
     *reinterpret_cast<size_t_*>(data_ + COLUMN_NUM_OFFSET) = col_num;
 
+    const std::vector<offset_t> &key_idxs = schema.get_key_idxs();
+    if (key_idxs.size() > MAX_KEY_COL_NUM) {
+        FATAL("too many key columns");
+    }
+    *reinterpret_cast<size_t_*>(data_ + KEY_COL_NUM_OFFSET) = key_idxs.size();
+    for (size_t i = 0; i < key_idxs.size(); i++)
+        *reinterpret_cast<offset_t*>(data_ + FIRST_KEY_COL_OFFSET + i * OFFSET_T_SIZE) = key_idxs[i];
+    *reinterpret_cast<layout_code_t*>(data_ + LAYOUT_OFFSET) = schema.get_layout();
+
     size_t_ col_size = 0; // record how large space this column's info occupy
     size_t_ col_name_len_offset = FIRST_COLUMN_OFFSET;
     size_t_ name_offset;
@@ -103,7 +134,7 @@ TableMetaData::TableMetaData(BufferPoolManager *bpm, const string_t &table_name,
         type_id_offset = offset_offset + OFFSET_T_SIZE;
         *reinterpret_cast<TypeId*>(data_ + type_id_offset) = col.get_type_id();
         data_size_offset = type_id_offset + ENUM_SIZE;
-        *reinterpret_cast<size_t_*>(data_ + data_size_offset) = col.get_data_size();
+        *reinterpret_cast<size_t_*>(data_ + data_size_offset) = col.get_max_length();
 
         for (offset_t i = 0; i < (offset_t)name_len; i++)
             *reinterpret_cast<char*>(data_ + name_offset + i) = col_name[i];
@@ -146,17 +177,126 @@ TableMetaData::TableMetaData(BufferPoolManager *bpm, const string_t &table_name,
         exit(-1);
     }
     index_header_page_id_ = page->get_page_id();
-    bpm_->unpin_page(index_header_page_id_, false);
+    *reinterpret_cast<size_t_*>(page->get_data() + INDEX_NUM_OFFSET) = 0;
+    bpm_->unpin_page(index_header_page_id_, true);
     *reinterpret_cast<page_id_t*>(data_ + INDEX_HEADER_PGID_OFFSET) = index_header_page_id_;
 
     table_ = new Table(bpm_, first_table_page_id_, true);
 }
 
-// TODO delete index data(index_header_page_id_)
 void TableMetaData::delete_table_data() {
     latch_.w_lock();
-    table_->delete_all_data();
+    table_->delete_all_data(*table_schema_); // indexes' data is deleted together
+    latch_.w_unlock();
+}
+
+void TableMetaData::load_indexes() {
+    Page *page = bpm_->get_page(index_header_page_id_);
+    if (page == nullptr) {
+        LOG("ERROR! can't get the index header page");
+        return;
+    }
+    char *data = page->get_data();
+    size_t_ index_num = *reinterpret_cast<size_t_*>(data + INDEX_NUM_OFFSET);
+
+    // the page may be never written by the old version
+    if (index_num < 0 || index_num > MAX_INDEX_NUM) {
+        bpm_->unpin_page(index_header_page_id_, false);
+        return;
+    }
+
+    for (size_t_ i = 0; i < index_num; i++) {
+        char *info = data + FIRST_INDEX_OFFSET + i * INDEX_INFO_SIZE;
+        size_t_ col_num = *reinterpret_cast<size_t_*>(info);
+        std::vector<offset_t> col_idxs;
+        for (size_t_ j = 0; j < col_num; j++)
+            col_idxs.push_back(*reinterpret_cast<offset_t*>(info + SIZE_T_SIZE + j * OFFSET_T_SIZE));
+        info += SIZE_T_SIZE + OFFSET_T_SIZE * MAX_KEY_COL_NUM;
+        index_code_t index_type = *reinterpret_cast<index_code_t*>(info);
+        page_id_t first_page_id = *reinterpret_cast<page_id_t*>(info + sizeof(index_code_t));
+        table_->add_index(new SecondaryIndex(bpm_, first_page_id, col_idxs, *table_schema_, index_type, false));
+    }
+    bpm_->unpin_page(index_header_page_id_, false);
+}
+
+bool TableMetaData::create_index(const std::vector<offset_t> &col_idxs, index_code_t index_type) {
+    if (col_idxs.empty() || col_idxs.size() > MAX_KEY_COL_NUM) {
+        return false;
+    }
+
+    for (offset_t col_idx : col_idxs) {
+        if (col_idx < 0 || col_idx >= table_schema_->get_column_num())
+            return false;
+    }
+
+    if (index_type != LINK_HASH) {
+        LOG("only the link hash is supported by the secondary index so far");
+        return false;
+    }
+
+    latch_.w_lock();
+    if (table_->get_index(col_idxs) != nullptr) {
+        latch_.w_unlock();
+        return false;
+    }
+
+    Page *header_page = bpm_->get_page(index_header_page_id_);
+    if (header_page == nullptr) {
+        latch_.w_unlock();
+        return false;
+    }
+    char *data = header_page->get_data();
+    size_t_ index_num = *reinterpret_cast<size_t_*>(data + INDEX_NUM_OFFSET);
+    if (index_num < 0 || index_num > MAX_INDEX_NUM) {
+        // the page may be never written by the old version
+        index_num = table_->get_indexes().size();
+    }
+
+    // the header page is full, check it before allocating anything
+    if (index_num >= MAX_INDEX_NUM) {
+        bpm_->unpin_page(index_header_page_id_, false);
+        latch_.w_unlock();
+        return false;
+    }
+
+    Page *first_page = bpm_->new_page();
+    if (first_page == nullptr) {
+        bpm_->unpin_page(index_header_page_id_, false);
+        latch_.w_unlock();
+        return false;
+    }
+    page_id_t first_page_id = first_page->get_page_id();
+    bpm_->unpin_page(first_page_id, true);
+
+    SecondaryIndex *index = new SecondaryIndex(bpm_, first_page_id, col_idxs, *table_schema_, index_type, true);
+
+    // index the existing tuples, the writers wait until the index is registered
+    table_->block_writers();
+    LinkHashTableIter iter(first_table_page_id_, bpm_);
+    Tuple tuple;
+    while (iter->get_rid().get_page_id() != INVALID_PAGE_ID) {
+        // the indexed columns of the existing tuples may have been toasted
+        tuple = *iter;
+        toast_fetch(&tuple, *table_schema_, col_idxs, bpm_);
+        index->insert_entry(index->get_key(tuple), iter->get_rid());
+        ++iter;
+    }
+
+    // persist the index's info
+    char *info = data + FIRST_INDEX_OFFSET + index_num * INDEX_INFO_SIZE;
+    *reinterpret_cast<size_t_*>(info) = col_idxs.size();
+    for (size_t i = 0; i < col_idxs.size(); i++)
+        *reinterpret_cast<offset_t*>(info + SIZE_T_SIZE + i * OFFSET_T_SIZE) = col_idxs[i];
+    info += SIZE_T_SIZE + OFFSET_T_SIZE * MAX_KEY_COL_NUM;
+    *reinterpret_cast<index_code_t*>(info) = index_type;
+    *reinterpret_cast<page_id_t*>(info + sizeof(index_code_t)) = first_page_id;
+    *reinterpret_cast<size_t_*>(data + INDEX_NUM_OFFSET) = index_num + 1;
+    bpm_->unpin_page(index_header_page_id_, true);
+
+    table_->add_index(index);
+    table_->unblock_writers();
     latch_.w_unlock();
+    return true;
 }
 
 } // namespace dawn
@@ -9,6 +9,7 @@ static std::map<string_t, int> key_words{
     {"table", TOKEN_TABLE}, {"TABLE", TOKEN_TABLE},
     {"primary key", TOKEN_PRIMARY_KEY}, {"PRIMARY KEY", TOKEN_PRIMARY_KEY},
     {"char", TOKEN_CHAR}, {"CHAR", TOKEN_CHAR},
+    {"varchar", TOKEN_VARCHAR}, {"VARCHAR", TOKEN_VARCHAR},
     {"int", TOKEN_INT}, {"INT", TOKEN_INT},
     {"decimal", TOKEN_DECIMAL}, {"DECIMAL", TOKEN_DECIMAL},
     {"boolean", TOKEN_BOOLEAN}, {"BOOLEAN", TOKEN_BOOLEAN},
@@ -178,6 +178,11 @@ data_type(A) ::= CHAR LEFT_PARENTHESES INT_NUM(B) RIGHT_PARENTHESES. {
     A = new dawn::DataTypeNode(dawn::TypeId::kChar, B.val_.integer_);
 }
 
+data_type(A) ::= VARCHAR LEFT_PARENTHESES INT_NUM(B) RIGHT_PARENTHESES. {
+    debug_print("data_type: VARCHAR '(' NUMBER ')'");
+    A = new dawn::DataTypeNode(dawn::TypeId::kVarchar, B.val_.integer_);
+}
+
 data_type(A) ::= INT. {
     debug_print("data_type: INT");
     A = new dawn::DataTypeNode(dawn::TypeId::kInteger);
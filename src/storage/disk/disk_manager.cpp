@@ -156,6 +156,33 @@ void DiskManager::from_mtd(const string_t &meta_name) {
 
         catalog_pgid_offset = max_ava_pgid_offset + PGID_T_SIZE;
         catalog_page_id_ = *reinterpret_cast<page_id_t*>(meta_buffer + catalog_pgid_offset);
+
+        page_size_offset = catalog_pgid_offset + PGID_T_SIZE;
+        size_t_ page_size = *reinterpret_cast<size_t_*>(meta_buffer + page_size_offset);
+
+        // the page size is recorded after the format changed, so the files without the version are of version 1 if it's recorded
+        format_version_offset = page_size_offset + SIZE_T_SIZE;
+        int32_t format_version = *reinterpret_cast<int32_t*>(meta_buffer + format_version_offset);
+        if (format_version == 0 && page_size != 0)
+            format_version = 1;
+        if (format_version != DB_FORMAT_VERSION) {
+            // the pages have no key filter and the keys are hashed to other slots, they can't be read
+            string_t info("ERROR! ");
+            info += "The database is of format version " + std::to_string(format_version) + ", but the version is "
+                + std::to_string(DB_FORMAT_VERSION) + ", please rebuild the database";
+            LOG(info);
+            shutdown();
+            return;
+        }
+
+        if (page_size != PAGE_SIZE) {
+            string_t info("ERROR! ");
+            info += "The database uses " + std::to_string(page_size) + " bytes pages, but the page size is "
+                + std::to_string(PAGE_SIZE);
+            LOG(info);
+            shutdown();
+            return;
+        }
     }
 
     // initialize the alloced_pgid_ and free_pgid_
@@ -252,9 +279,10 @@ bool DiskManager::write_page(page_id_t page_id, const char *data) {
         LOG("WRITE FAIL!!!");
         return false;
     }
-    db_io_latch_.w_unlock();
 
+    // the stream is shared by all the threads, flush it with the latch held as well
     db_io_.flush();
+    db_io_latch_.w_unlock();
     return true;
 }
 
@@ -312,9 +340,9 @@ page_id_t DiskManager::alloc_page(char flag) {
     alloced_pgid_.insert(new_page_id);
     latch_.w_unlock();
 
-    page_buf[0] = flag;
     db_io_latch_.w_lock();
-    db_io_.seekg(new_page_id * PAGE_SIZE);
+    page_buf[0] = flag;
+    db_io_.seekg(static_cast<long>(new_page_id) * PAGE_SIZE);
     db_io_.write(page_buf, PAGE_SIZE);
 
     if (db_io_.fail()) {
@@ -352,15 +380,15 @@ bool DiskManager::free_page(page_id_t page_id) {
     // change the page's status on disk
     char c = STATUS_FREE;
     db_io_latch_.w_lock();
-    db_io_.seekg(page_id * PAGE_SIZE);
+    db_io_.seekg(static_cast<long>(page_id) * PAGE_SIZE);
     db_io_.write(&c, 1);
     if (db_io_.fail()) {
         db_io_latch_.w_unlock();
         LOG("free page fail");
         return false;
     }
-    db_io_latch_.w_unlock();
     db_io_.flush();
+    db_io_latch_.w_unlock();
 
     // update the meta data
     latch_.w_lock();
@@ -415,8 +443,14 @@ bool DiskManager::write_meta_data() {
     catalog_pgid_offset = max_ava_pgid_offset + PGID_T_SIZE;
     *reinterpret_cast<page_id_t*>(meta_buffer+catalog_pgid_offset) = catalog_page_id_;
 
-    reserved_offset = catalog_pgid_offset + PGID_T_SIZE;
-    memset(meta_buffer + reserved_offset, 0, 128);
+    page_size_offset = catalog_pgid_offset + PGID_T_SIZE;
+    *reinterpret_cast<size_t_*>(meta_buffer+page_size_offset) = PAGE_SIZE;
+
+    format_version_offset = page_size_offset + SIZE_T_SIZE;
+    *reinterpret_cast<int32_t*>(meta_buffer+format_version_offset) = DB_FORMAT_VERSION;
+
+    reserved_offset = format_version_offset + sizeof(int32_t);
+    memset(meta_buffer + reserved_offset, 0, 120);
 
     // write meta data to the meta file
     meta_io_.seekg(0);
@@ -0,0 +1,143 @@
+#include "storage/page/slot_search.h"
+
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define DAWN_SLOT_SEARCH_X86
+#include <immintrin.h>
+#endif
+
+namespace dawn {
+
+static constexpr size_t_ RECORD_SZ = OFFSET_T_SIZE + SIZE_T_SIZE;
+static_assert(RECORD_SZ == 8, "SIMD slot search supposes the tuple record is 8 bytes");
+
+/** bits of the tuple offsets in a mask of 8 records, the odd bits belong to the tuple sizes */
+static constexpr uint32_t OFFSET_BITS = 0x5555;
+
+inline offset_t get_record_offset(const char *records, offset_t slot_num) {
+    offset_t offset;
+    memcpy(&offset, records + slot_num * RECORD_SZ, OFFSET_T_SIZE);
+    return offset;
+}
+
+inline offset_t scalar_find_slot(const char *records, offset_t begin, offset_t end, bool empty) {
+    for (offset_t slot_num = begin; slot_num < end; slot_num++) {
+        if ((get_record_offset(records, slot_num) == 0) == empty)
+            return slot_num;
+    }
+    return end;
+}
+
+inline size_t_ scalar_count_live(const char *records, size_t_ count) {
+    size_t_ cnt = 0;
+    for (size_t_ slot_num = 0; slot_num < count; slot_num++) {
+        if (get_record_offset(records, slot_num) != 0)
+            cnt++;
+    }
+    return cnt;
+}
+
+#ifdef DAWN_SLOT_SEARCH_X86
+
+/** @return bit 2*i is set when the i-th record's offset is 0 */
+__attribute__((target("sse4.1")))
+inline uint32_t sse4_zero_mask(const char *p) {
+    const __m128i zero = _mm_setzero_si128();
+    uint32_t mask = 0;
+    for (int i = 0; i < 4; i++) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i * 16));
+        mask |= static_cast<uint32_t>(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(v, zero)))) << (i * 4);
+    }
+    return mask;
+}
+
+__attribute__((target("avx2")))
+inline uint32_t avx2_zero_mask(const char *p) {
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 32));
+    uint32_t lo_mask = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(lo, zero)));
+    uint32_t hi_mask = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(hi, zero)));
+    return lo_mask | (hi_mask << 8);
+}
+
+__attribute__((target("sse4.1")))
+inline offset_t sse4_find_slot(const char *records, offset_t begin, offset_t end, bool empty) {
+    offset_t slot_num = begin;
+    for (; slot_num + 8 <= end; slot_num += 8) {
+        uint32_t mask = sse4_zero_mask(records + slot_num * RECORD_SZ);
+        mask = (empty ? mask : ~mask) & OFFSET_BITS;
+        if (mask != 0)
+            return slot_num + __builtin_ctz(mask) / 2;
+    }
+    return scalar_find_slot(records, slot_num, end, empty);
+}
+
+__attribute__((target("sse4.1,popcnt")))
+inline size_t_ sse4_count_live(const char *records, size_t_ count) {
+    size_t_ cnt = 0;
+    size_t_ slot_num = 0;
+    for (; slot_num + 8 <= count; slot_num += 8)
+        cnt += __builtin_popcount(~sse4_zero_mask(records + slot_num * RECORD_SZ) & OFFSET_BITS);
+    return cnt + scalar_count_live(records + slot_num * RECORD_SZ, count - slot_num);
+}
+
+__attribute__((target("avx2")))
+inline offset_t avx2_find_slot(const char *records, offset_t begin, offset_t end, bool empty) {
+    offset_t slot_num = begin;
+    for (; slot_num + 8 <= end; slot_num += 8) {
+        uint32_t mask = avx2_zero_mask(records + slot_num * RECORD_SZ);
+        mask = (empty ? mask : ~mask) & OFFSET_BITS;
+        if (mask != 0)
+            return slot_num + __builtin_ctz(mask) / 2;
+    }
+    return scalar_find_slot(records, slot_num, end, empty);
+}
+
+__attribute__((target("avx2,popcnt")))
+inline size_t_ avx2_count_live(const char *records, size_t_ count) {
+    size_t_ cnt = 0;
+    size_t_ slot_num = 0;
+    for (; slot_num + 8 <= count; slot_num += 8)
+        cnt += __builtin_popcount(~avx2_zero_mask(records + slot_num * RECORD_SZ) & OFFSET_BITS);
+    return cnt + scalar_count_live(records + slot_num * RECORD_SZ, count - slot_num);
+}
+
+#endif
+
+static const SlotSearchFuncs scalar_funcs{scalar_find_slot, scalar_count_live};
+#ifdef DAWN_SLOT_SEARCH_X86
+static const SlotSearchFuncs sse4_funcs{sse4_find_slot, sse4_count_live};
+static const SlotSearchFuncs avx2_funcs{avx2_find_slot, avx2_count_live};
+#endif
+
+const SlotSearchFuncs* get_slot_search_funcs(SlotSearchKernel kernel) {
+    switch (kernel) {
+        case SlotSearchKernel::kScalar:
+            return &scalar_funcs;
+#ifdef DAWN_SLOT_SEARCH_X86
+        case SlotSearchKernel::kSSE4:
+            return __builtin_cpu_supports("sse4.1") && __builtin_cpu_supports("popcnt") ? &sse4_funcs : nullptr;
+        case SlotSearchKernel::kAVX2:
+            return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt") ? &avx2_funcs : nullptr;
+#endif
+        default:
+            return nullptr;
+    }
+}
+
+const SlotSearchFuncs& get_slot_search_funcs() {
+    // the best kernel is chosen once when it's called at the first time
+    static const SlotSearchFuncs *funcs = [] {
+        for (auto kernel : {SlotSearchKernel::kAVX2, SlotSearchKernel::kSSE4}) {
+            const SlotSearchFuncs *f = get_slot_search_funcs(kernel);
+            if (f != nullptr)
+                return f;
+        }
+        return &scalar_funcs;
+    }();
+    return *funcs;
+}
+
+} // namespace dawn
@@ -10,31 +10,57 @@ void TablePage::init(const page_id_t prev_pgid, const page_id_t next_pgid) {
     set_free_space_pointer(INVALID_FREE_SPACE_PTR);
 }
 
-// TODO slow, may be we can use bitmap?
-offset_t TablePage::get_empty_slot() {
-    size_t_ tuple_count = get_tuple_count();
-    for (size_t_ slot_num = 0; slot_num < tuple_count; slot_num++) {
-        offset_t offset = get_tuple_offset(slot_num);
-        if (offset == 0)
-            return slot_num;
-    }
+void TablePage::init(const page_id_t prev_pgid, const page_id_t next_pgid, const Schema &tb_schema) {
+    init(prev_pgid, next_pgid);
+    if (!tb_schema.is_pax())
+        return;
 
-    size_t_ free_space = get_free_space();
-    if (free_space < TUPLE_RECORD_SZ)
-        return -1;
+    // column sizes are at the end of the page, and the mini pages are put before them
+    size_t_ col_num = tb_schema.get_column_num();
+    offset_t col_sizes_offset = PAGE_SIZE - col_num * SIZE_T_SIZE;
+    for (size_t_ i = 0; i < col_num; i++) {
+        size_t_ col_size = tb_schema.get_column_size(i);
+        memcpy(get_data() + col_sizes_offset + i * SIZE_T_SIZE, &col_size, SIZE_T_SIZE);
+    }
 
-    set_tuple_count(tuple_count + 1);
-    return tuple_count;
+    size_t_ tuple_size = tb_schema.get_tuple_size();
+    size_t_ capacity = (col_sizes_offset - FIRST_TUPLE_OFFSET) / (tuple_size + TUPLE_RECORD_SZ);
+    memcpy(get_data() + PAX_CAPACITY_OFFSET, &capacity, SIZE_T_SIZE);
+    memcpy(get_data() + PAX_COL_NUM_OFFSET, &col_num, SIZE_T_SIZE);
+    set_free_space_pointer(col_sizes_offset - capacity * tuple_size);
 }
 
 bool TablePage::insert_tuple(const Tuple &tuple, RID *rid) {
-    // check we have enough space to insert the tuple
-    offset_t inserted_slot_num = get_empty_slot();
-    size_t_ free_space = get_free_space();
+    // reuse an empty slot after the hint, or append a new one which needs one more record
+    size_t_ tuple_count = get_tuple_count();
+    offset_t inserted_slot_num = tuple_count;
+    if (get_free_slot_count() > 0)
+        inserted_slot_num = slot_search_find(get_tuple_records(), get_free_slot_hint(), tuple_count, true);
+    size_t_ record_sz = inserted_slot_num < tuple_count ? 0 : TUPLE_RECORD_SZ;
+
+    // check we have enough space to insert the tuple, the PAX page only checks the slot
     size_t_ tuple_size = tuple.get_size();
-    if (free_space < tuple_size) {
+    if (is_pax()) {
+        if (tuple_size != get_pax_tuple_size() || (record_sz != 0 && tuple_count >= get_pax_capacity()))
+            return false;
+    } else if (get_free_space() < tuple_size + record_sz) {
         return false;
     }
+    if (record_sz != 0) {
+        // no empty slot after the hint, the free slot count is stale if it isn't 0
+        set_tuple_count(tuple_count + 1);
+        set_free_slot_count(0);
+    } else {
+        set_free_slot_count(get_free_slot_count() - 1);
+    }
+    set_free_slot_hint(inserted_slot_num + 1);
+
+    if (is_pax()) {
+        write_pax_tuple(inserted_slot_num, tuple.get_data());
+        rid->set(get_page_id(), inserted_slot_num);
+        insert_tuple_record(inserted_slot_num, get_free_space_pointer(), tuple_size);
+        return true;
+    }
     
     // write data
     offset_t free_space_pointer = get_free_space_pointer();
@@ -83,8 +109,10 @@ void TablePage::apply_delete(const RID &rid) {
     offset_t free_space_pointer = get_free_space_pointer();
     deleted_tuple_size = unset_deleted_flag(get_tuple_size(deleted_slot_num));
     
-    // delete the tuple's record
+    // delete the tuple's record, the PAX page has nothing to move
     delete_tuple_record(deleted_slot_num);
+    if (is_pax())
+        return;
 
     // move the tuple's data
     memmove(get_data() + free_space_pointer + deleted_tuple_size, 
@@ -105,14 +133,49 @@ void TablePage::apply_delete(const RID &rid) {
 
 bool TablePage::update_tuple(const Tuple &new_tuple, const RID &rid) {
     offset_t slot_num = rid.get_slot_num();
-    offset_t tuple_offset = get_tuple_offset(slot_num);
-    size_t_ tuple_size = get_tuple_size(slot_num);
     page_id_t page_id = rid.get_page_id();
 
     // check if it's legal
-    if (slot_num >= get_tuple_count() || tuple_offset == 0 || 
-        tuple_size != new_tuple.get_size() || page_id != get_page_id())
+    if (slot_num < 0 || slot_num >= get_tuple_count() || get_tuple_offset(slot_num) == 0 || page_id != get_page_id())
         return false;
+
+    offset_t tuple_offset = get_tuple_offset(slot_num);
+    size_t_ tuple_size = get_tuple_size(slot_num);
+    size_t_ old_size = unset_deleted_flag(tuple_size);
+    size_t_ new_size = new_tuple.get_size();
+    if (is_pax()) {
+        if (new_size != old_size)
+            return false;
+        write_pax_tuple(slot_num, new_tuple.get_data());
+        return true;
+    }
+
+    if (new_size != old_size) {
+        size_t_ delta = new_size - old_size;
+        if (delta > 0 && get_free_space() < delta)
+            return false;
+
+        /**
+         * keep the tuples' data contiguous: the end of this tuple stays, and the tuples
+         * stored before it (they have lower offsets) are moved by delta
+         */
+        offset_t free_space_pointer = get_free_space_pointer();
+        memmove(get_data() + free_space_pointer - delta,
+            get_data() + free_space_pointer,
+            tuple_offset - free_space_pointer);
+        set_free_space_pointer(free_space_pointer - delta);
+
+        size_t_ tuple_count = get_tuple_count();
+        for (size_t_ i = 0; i < tuple_count; i++) {
+            offset_t offset = get_tuple_offset(i);
+            if (offset != 0 && offset < tuple_offset)
+                set_tuple_offset(i, offset - delta);
+        }
+
+        tuple_offset -= delta;
+        set_tuple_offset(slot_num, tuple_offset);
+        set_tuple_size(slot_num, is_deleted(tuple_size) ? set_deleted_flag(new_size) : new_size);
+    }
     
     new_tuple.serialize_to(get_data() + tuple_offset);
 
@@ -131,71 +194,117 @@ bool TablePage::get_tuple(Tuple *tuple, const RID &rid) const {
     if (slot_num >= get_tuple_count() || tuple_offset == 0)
         return false;
     
-    tuple->size_ = tuple_size;
-    if (tuple->allocated_) {
-        delete[] tuple->data_;
-    }
-    tuple->data_ = new char[tuple_size];
-    tuple->allocated_ = true;
+    tuple->reserve(tuple_size);
     tuple->set_rid(rid);
+    if (is_pax()) {
+        read_pax_tuple(slot_num, tuple->data_);
+        return true;
+    }
     tuple->deserialize_from(get_data() + tuple_offset);
 
     return true;
 }
 
-bool TablePage::get_next_tuple_rid(const RID &cur_rid, RID *next_rid) const {
-    if (cur_rid.get_page_id() == INVALID_PAGE_ID) {
-        // get the first tuple's position
-        size_t_ count = get_tuple_count();
-        for (size_t_ slot_num = 0; slot_num < count; slot_num++) {
-            offset_t offset = get_tuple_offset(slot_num);
-            if (offset != 0) {
-                next_rid->set(get_page_id(), slot_num);
-                return true;
-            }
-        }
+bool TablePage::get_tuple_ref(Tuple *tuple, const RID &rid) const {
+    offset_t slot_num = rid.get_slot_num();
+    char *data = get_tuple_data(slot_num);
+    if (data == nullptr)
+        return false;
+
+    size_t_ tuple_size = get_tuple_size(slot_num);
+    if (is_deleted(tuple_size))
+        tuple_size = unset_deleted_flag(tuple_size);
+    tuple->attach(data, tuple_size, rid);
+    return true;
+}
+
+bool TablePage::get_tuple_columns(Tuple *tuple, const RID &rid, const std::vector<offset_t> &col_idxs) const {
+    if (!is_pax())
+        return get_tuple(tuple, rid);
 
+    offset_t slot_num = rid.get_slot_num();
+    if (slot_num < 0 || slot_num >= get_tuple_count() || get_tuple_offset(slot_num) == 0)
         return false;
+
+    size_t_ tuple_size = get_pax_tuple_size();
+    tuple->reserve(tuple_size);
+    memset(tuple->data_, 0, tuple_size);
+    tuple->set_rid(rid);
+
+    size_t_ capacity = get_pax_capacity();
+    const char *mini_pages = get_data() + get_free_space_pointer();
+    for (auto col_idx : col_idxs) {
+        offset_t col_offset = 0;
+        for (offset_t i = 0; i < col_idx; i++)
+            col_offset += get_pax_col_size(i);
+        size_t_ col_size = get_pax_col_size(col_idx);
+        memcpy(tuple->data_ + col_offset, mini_pages + capacity * col_offset + slot_num * col_size, col_size);
     }
+    return true;
+}
 
-    offset_t slot_num = cur_rid.get_slot_num();
+bool TablePage::get_next_tuple_rid(const RID &cur_rid, RID *next_rid) const {
+    // get the first tuple's position when the cur_rid is invalid
+    offset_t begin = cur_rid.get_page_id() == INVALID_PAGE_ID ? 0 : cur_rid.get_slot_num() + 1;
     size_t_ tuple_count = get_tuple_count();
-    for (size_t_ i = slot_num + 1; i < tuple_count; i++) {
-        offset_t offset = get_tuple_offset(i);
-        if (offset == 0)
-            continue;
-        next_rid->set(get_page_id(), i);
+    offset_t slot_num = slot_search_find(get_tuple_records(), begin, tuple_count, false);
+    if (slot_num < tuple_count) {
+        next_rid->set(get_page_id(), slot_num);
         return true;
     }
 
-    next_rid->set(INVALID_PAGE_ID, -1);
+    if (cur_rid.get_page_id() != INVALID_PAGE_ID)
+        next_rid->set(INVALID_PAGE_ID, -1);
     return false;
 }
 
 bool TablePage::get_the_first_tuple(Tuple *tuple) const {
     size_t_ count = get_tuple_count();
-    for (size_t_ slot_num = 0; slot_num < count; slot_num++) {
-        offset_t offset = get_tuple_offset(slot_num);
-        if (offset != 0) {
-            Tuple tmp(RID(get_page_id(), slot_num), get_tuple_size(slot_num));
-            tmp.deserialize_from(get_data() + offset);
-            *tuple = tmp;
-            return true;
-        }
-    }
+    offset_t slot_num = slot_search_find(get_tuple_records(), 0, count, false);
+    if (slot_num >= count)
+        return false;
 
-    return false;
+    return get_tuple(tuple, RID(get_page_id(), slot_num));
 }
 
 size_t_ TablePage::get_stored_tuple_cnt() const {
+    return slot_search_count_live(get_tuple_records(), get_tuple_count());
+}
+
+size_t_ TablePage::get_used_space() const {
     size_t_ tuple_cnt = get_tuple_count();
-    size_t_ cnt = 0;
+    size_t_ used = 0;
     for (size_t_ slot_num = 0; slot_num < tuple_cnt; slot_num++) {
-        offset_t offset = get_tuple_offset(slot_num);
-        if (offset != 0)
-            cnt++;
+        if (get_tuple_offset(slot_num) != 0)
+            used += unset_deleted_flag(get_tuple_size(slot_num)) + TUPLE_RECORD_SZ;
+    }
+    return used;
+}
+
+void TablePage::write_pax_tuple(offset_t slot_num, const char *tuple_data) {
+    size_t_ capacity = get_pax_capacity();
+    size_t_ col_num = get_pax_col_num();
+    char *mini_page = get_data() + get_free_space_pointer();
+    offset_t col_offset = 0;
+    for (offset_t i = 0; i < col_num; i++) {
+        size_t_ col_size = get_pax_col_size(i);
+        memcpy(mini_page + slot_num * col_size, tuple_data + col_offset, col_size);
+        mini_page += capacity * col_size;
+        col_offset += col_size;
+    }
+}
+
+void TablePage::read_pax_tuple(offset_t slot_num, char *tuple_data) const {
+    size_t_ capacity = get_pax_capacity();
+    size_t_ col_num = get_pax_col_num();
+    const char *mini_page = get_data() + get_free_space_pointer();
+    offset_t col_offset = 0;
+    for (offset_t i = 0; i < col_num; i++) {
+        size_t_ col_size = get_pax_col_size(i);
+        memcpy(tuple_data + col_offset, mini_page + slot_num * col_size, col_size);
+        mini_page += capacity * col_size;
+        col_offset += col_size;
     }
-    return cnt;
 }
 
 } // namespace dawn
@@ -3,25 +3,26 @@
 
 namespace dawn {
 
-LinkHashTableIter::LinkHashTableIter(page_id_t first_page_id, BufferPoolManager *bpm) 
-    : first_page_id_(first_page_id), bpm_(bpm) {
+LinkHashTableIter::LinkHashTableIter(page_id_t first_page_id, BufferPoolManager *bpm,
+    const std::vector<offset_t> &col_idxs, offset_t slot1_begin, offset_t slot1_end)
+    : first_page_id_(first_page_id), bpm_(bpm), col_idxs_(col_idxs), slot1_end_(slot1_end) {
 
-    tuple_ = new Tuple();
+    view_ = new TupleView();
     
     LinkHashPage *level1_page = reinterpret_cast<LinkHashPage*>(bpm_->get_page(first_page_id_));
-    offset_t slot1_num = -1; // refer to the first level page's slot
+    offset_t slot1_num = slot1_begin - 1; // refer to the first level page's slot
     
     /**
      * set the iterator's position to the first tuple's position
      * 
-     * "while (++slot_num < LK_HA_PG_SLOT_NUM)" traverses the first level page's slot to get the
+     * "while (++slot_num < slot1_end_)" traverses the first level page's slot to get the
      * second level page's page id.
      * 
      * "for (; slot_num < LK_HA_PG_SLOT_NUM; slot_num++)" traverses the second level page's slot to
      * get the third level page's page id.
      */
     level1_page->r_lock();
-    while (++slot1_num < LK_HA_PG_SLOT_NUM) {
+    while (++slot1_num < slot1_end_) {
         // find an available second level page
         page_id_t sec_page_id = level1_page->get_pgid_in_slot(slot1_num);
         if (sec_page_id == INVALID_PAGE_ID) {
@@ -31,29 +32,32 @@ LinkHashTableIter::LinkHashTableIter(page_id_t first_page_id, BufferPoolManager
 
         LinkHashPage *level2_page = reinterpret_cast<LinkHashPage*>(bpm_->get_page(sec_page_id));
 
-        // traverse the second level page to find an available third level page
-        page_id_t level3_page_id = INVALID_PAGE_ID;
+        /**
+         * traverse the second level page to find the first tuple, it's read locked so that the lists
+         * aren't compacted in the meantime. A TablePage may stay empty for a while before the
+         * compaction removes it, e.g. its last tuple is being deleted by others.
+         */
+        bool found = false;
         level2_page->r_lock();
         offset_t slot2_num = 0;
         for (; slot2_num < LK_HA_PG_SLOT_NUM; slot2_num++) {
-            level3_page_id = level2_page->get_pgid_in_slot(slot2_num);
-            if (level3_page_id != INVALID_PAGE_ID)
+            page_id_t level3_page_id = level2_page->get_pgid_in_slot(slot2_num);
+            while (level3_page_id != INVALID_PAGE_ID && !found) {
+                TablePage *level3_page = reinterpret_cast<TablePage*>(bpm_->get_page(level3_page_id));
+                level3_page->w_lock();
+                found = read_first_tuple(level3_page);
+                page_id_t next_page_id = level3_page->get_next_page_id();
+                level3_page->w_unlock();
+                bpm_->unpin_page(level3_page_id, false);
+                level3_page_id = next_page_id;
+            }
+            if (found)
                 break;
         }
         level2_page->r_unlock();
+        bpm_->unpin_page(sec_page_id, false);
 
-        // find an available third level page
-        if (level3_page_id != INVALID_PAGE_ID) {
-            TablePage *level3_page = reinterpret_cast<TablePage*>(bpm_->get_page(level3_page_id));
-            level3_page->w_lock();
-            if (!level3_page->get_the_first_tuple(tuple_)) {
-                // the first page of the third level should always be non-empty
-                // It's a bug if we get an empty TablePage
-                LOG("should not reach here");
-                exit(-1);
-            }
-            level3_page->w_unlock();
-            bpm_->unpin_page(level3_page_id, false);
+        if (found) {
             slot1_num_ = slot1_num;
             slot2_num_ = slot2_num;
             break;
@@ -66,10 +70,11 @@ LinkHashTableIter::LinkHashTableIter(page_id_t first_page_id, BufferPoolManager
          */
     }
     level1_page->r_unlock();
+    bpm_->unpin_page(first_page_id_, false);
 
     // can't find any tuple
-    if (slot1_num >= LK_HA_PG_SLOT_NUM) {
-        tuple_->set_rid(RID(INVALID_PAGE_ID, INVALID_SLOT_NUM));
+    if (slot1_num >= slot1_end_) {
+        set_end();
         slot1_num_ = INVALID_SLOT_NUM;
         return;
     }
@@ -81,10 +86,10 @@ TableIterAbstract& LinkHashTableIter::operator++() {
      * 2. try to get next tuple in the link list
      * 3. try to get next tuple by traversing the second level pages
      */
-    RID cur_rid = tuple_->get_rid();
+    RID cur_rid = (*view_)->get_rid();
     page_id_t cur_tb_pgid = cur_rid.get_page_id();
     if (cur_tb_pgid == INVALID_PAGE_ID) {
-        tuple_->set_rid(RID(INVALID_PAGE_ID, INVALID_SLOT_NUM));
+        set_end();
         return *this;
     }
 
@@ -104,10 +109,8 @@ TableIterAbstract& LinkHashTableIter::operator++() {
          * Need this judgement after switching to the next second level page,
          * because we should find the first available TablePage.
          */
-        if (cur_tb_pgid == INVALID_PAGE_ID) {
-            while (cur_slot2_num < LK_HA_PG_SLOT_NUM && cur_tb_pgid == INVALID_PAGE_ID)
-                cur_tb_pgid = level2_page->get_pgid_in_slot(++cur_slot2_num);
-        }
+        while (cur_tb_pgid == INVALID_PAGE_ID && ++cur_slot2_num < LK_HA_PG_SLOT_NUM)
+            cur_tb_pgid = level2_page->get_pgid_in_slot(cur_slot2_num);
 
         do {
             // jump out this second level page's loop because it contains nothing
@@ -122,10 +125,9 @@ TableIterAbstract& LinkHashTableIter::operator++() {
                 RID next_rid;
                 bool ok;
                 if (cur_rid.get_page_id() == cur_tb_page->get_page_id()) {
-                    ok = cur_tb_page->get_next_tuple_rid(cur_rid, &next_rid);
-                    cur_tb_page->get_tuple(tuple_, next_rid);
+                    ok = cur_tb_page->get_next_tuple_rid(cur_rid, &next_rid) && read_tuple(cur_tb_page, next_rid);
                 } else {
-                    ok = cur_tb_page->get_the_first_tuple(tuple_);
+                    ok = read_first_tuple(cur_tb_page);
                 }
 
                 if (ok) {
@@ -143,17 +145,16 @@ TableIterAbstract& LinkHashTableIter::operator++() {
                     return *this;
                 }
 
+                // it's the last tuple in the TablePage, jump to the next TablePage in link list
+                page_id_t next_tb_pgid = cur_tb_page->get_next_page_id();
                 cur_tb_page->w_unlock();
                 bpm_->unpin_page(cur_tb_pgid, false);
-
-                // it's the last tuple in the TablePage, jump to the next TablePage in link list
-                cur_tb_pgid = cur_tb_page->get_next_page_id();
+                cur_tb_pgid = next_tb_pgid;
             } while (cur_tb_pgid != INVALID_PAGE_ID); // loop in the link list
 
             // find the next link list containing tuples in the same second level page
-            do {
-                cur_tb_pgid = level2_page->get_pgid_in_slot(++cur_slot2_num);
-            } while (cur_slot2_num < LK_HA_PG_SLOT_NUM && cur_tb_pgid == INVALID_PAGE_ID);
+            while (cur_tb_pgid == INVALID_PAGE_ID && ++cur_slot2_num < LK_HA_PG_SLOT_NUM)
+                cur_tb_pgid = level2_page->get_pgid_in_slot(cur_slot2_num);
 
         } while (cur_slot2_num < LK_HA_PG_SLOT_NUM); // loop in an second level page
 
@@ -162,16 +163,17 @@ TableIterAbstract& LinkHashTableIter::operator++() {
         bpm_->unpin_page(level2_page->get_page_id(), false);
         
         // find the next available second level page
-        do {
-            cur_level2_pgid = level1_page->get_pgid_in_slot(++cur_slot1_num);
-        } while (cur_slot1_num < LK_HA_PG_SLOT_NUM && cur_level2_pgid == INVALID_PAGE_ID);
+        cur_level2_pgid = INVALID_PAGE_ID;
+        while (cur_level2_pgid == INVALID_PAGE_ID && ++cur_slot1_num < slot1_end_)
+            cur_level2_pgid = level1_page->get_pgid_in_slot(cur_slot1_num);
         
         cur_slot2_num = -1; // reset the second level page's slot num
-    } while (cur_slot1_num < LK_HA_PG_SLOT_NUM); // loop in the first level page
+        cur_tb_pgid = INVALID_PAGE_ID;
+    } while (cur_slot1_num < slot1_end_); // loop in the first level page
 
     level1_page->r_unlock();
     bpm_->unpin_page(first_page_id_, false);
-    tuple_->set_rid(RID(INVALID_PAGE_ID, INVALID_SLOT_NUM));
+    set_end();
     slot1_num_ = INVALID_SLOT_NUM;
     slot2_num_ = INVALID_SLOT_NUM;
     
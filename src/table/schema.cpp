@@ -18,6 +18,11 @@ Schema* create_table_schema(
             offset += char_len[j++];
             continue;
         }
+        if (types[i] == TypeId::kVarchar) {
+            cols.push_back(Column(names[i], offset, char_len[j++], TypeId::kVarchar));
+            offset += VARCHAR_SLOT_SZ;
+            continue;
+        }
         cols.push_back(Column(types[i], names[i], offset));
         offset += Type::get_type_size(types[i]);
     }
@@ -37,6 +42,9 @@ bool is_table_schemas_equal(const Schema &ts1, const Schema &ts2) {
     if (ts1.get_tuple_size() != ts2.get_tuple_size())
         return false;
 
+    if (ts1.get_key_idxs() != ts2.get_key_idxs())
+        return false;
+
     for (size_t i = 0; i < col_num; i++) {
         if (Column::is_columns_equal(cols1[i], cols2[i])) {
             continue;
@@ -47,4 +55,20 @@ bool is_table_schemas_equal(const Schema &ts1, const Schema &ts2) {
     return true;
 }
 
+Schema* create_join_schema(const Schema &left, const Schema &right) {
+    std::vector<TypeId> types;
+    std::vector<string_t> names;
+    std::vector<size_t_> char_len;
+    for (const Schema *schema : {&left, &right}) {
+        for (int i = 0; i < schema->get_column_num(); i++) {
+            Column col = schema->get_column(i);
+            types.push_back(col.get_type_id());
+            names.push_back(col.get_column_name());
+            if (is_string_type(col.get_type_id()))
+                char_len.push_back(col.get_max_length());
+        }
+    }
+    return create_table_schema(types, names, char_len);
+}
+
 } // namespace dawn
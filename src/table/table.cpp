@@ -1,5 +1,7 @@
 #include "table/table.h"
 #include "storage/page/link_hash_page.h"
+#include "table/lk_ha_tb_iter.h"
+#include <algorithm>
 #include <set>
 
 namespace dawn {
@@ -15,6 +17,8 @@ Table::Table(BufferPoolManager *bpm, const page_id_t first_table_page_id, bool f
             rollback_delete_func = lk_ha_rollback_delete;
             get_tuple_func = lk_ha_get_tuple;
             update_tuple_func = lk_ha_update_tuple;
+            get_tuples_func = lk_ha_get_tuples_batch;
+            bulk_load_func = lk_ha_bulk_load;
             break;
         case BP_TREE:
             break;
@@ -22,8 +26,10 @@ Table::Table(BufferPoolManager *bpm, const page_id_t first_table_page_id, bool f
             break;
     }
 
-    if (!from_scratch)
+    if (!from_scratch) {
+        init_directory();
         return;
+    }
     
     Page *page = bpm_->get_page(first_table_page_id_);
     if (page == nullptr) {
@@ -49,9 +55,40 @@ Table::Table(BufferPoolManager *bpm, const page_id_t first_table_page_id, bool f
     }
 
     bpm_->unpin_page(first_table_page_id_, true);
+    init_directory();
+}
+
+void Table::init_directory() {
+    switch (index_type_) {
+        case LINK_HASH:
+            lk_ha_dir_ = new LinkHashDirectory(first_table_page_id_, bpm_);
+            break;
+        default:
+            break;
+    }
 }
 
-void Table::delete_all_data() {
+void Table::delete_all_data(const Schema &tb_schema) {
+    // the overflow pages can only be found through the tuples
+    {
+        LinkHashTableIter iter(first_table_page_id_, bpm_);
+        while (iter->get_rid().get_page_id() != INVALID_PAGE_ID) {
+            toast_delete(*iter, tb_schema, bpm_);
+            ++iter;
+        }
+    }
+
+    for (auto index : indexes_) {
+        index->delete_all_data();
+        delete index;
+    }
+    indexes_.clear();
+
+    // the first level page is pinned by the directory
+    delete lk_ha_dir_;
+    lk_ha_dir_ = nullptr;
+
+
     std::set<page_id_t> deleted_pages;
     page_id_t next_page_id = first_table_page_id_;
     
@@ -72,8 +109,8 @@ void Table::delete_all_data() {
         bpm_->delete_page(page_id);
 }
 
-bool Table::mark_delete(const Value &key_value, const Schema &tb_schema) {
-    if (mark_delete_func(first_table_page_id_, key_value, tb_schema, bpm_) == OP_SUCCESS)
+bool Table::mark_delete(const IndexKey &key, const Schema &tb_schema) {
+    if (mark_delete_func(lk_ha_dir_, key, tb_schema, bpm_) == OP_SUCCESS)
         return true;
     return false;
 }
@@ -92,31 +129,62 @@ bool Table::mark_delete(const RID &rid) {
     return ok;
 }
 
-void Table::apply_delete(const Value &key_value, const Schema &tb_schema) {
+void Table::apply_delete(const IndexKey &key, const Schema &tb_schema) {
+    latch_.r_lock();
     Tuple tuple;
-    if (!get_tuple(key_value, &tuple, tb_schema)) {
+    if (!get_tuple(key, &tuple, tb_schema)) {
+        latch_.r_unlock();
         return;
     }
 
-    apply_delete_func(first_table_page_id_, key_value, tb_schema, bpm_);
+    // compaction may move some tuples to other pages, the indexes should refer to their new rids
+    std::vector<std::pair<RID, RID>> moved_rids;
+    apply_delete_func(lk_ha_dir_, key, tb_schema, bpm_, indexes_.empty() ? nullptr : &moved_rids);
+    for (auto index : indexes_)
+        index->delete_entry(get_index_key(index, tuple, tb_schema), tuple.get_rid());
+    toast_delete(tuple, tb_schema, bpm_);
+
+    Tuple moved_tuple;
+    for (auto &moved : moved_rids) {
+        if (!get_tuple(&moved_tuple, moved.second))
+            continue;
+        for (auto index : indexes_) {
+            IndexKey index_key = get_index_key(index, moved_tuple, tb_schema);
+            index->delete_entry(index_key, moved.first);
+            index->insert_entry(index_key, moved.second);
+        }
+    }
+    latch_.r_unlock();
 }
 
-void Table::apply_delete(const RID &rid) {
+void Table::apply_delete(const RID &rid, const Schema &tb_schema) {
     page_id_t page_id = rid.get_page_id();
     if (page_id < 0)
         return;
     
     TablePage *table_page = reinterpret_cast<TablePage*>(bpm_->get_page(page_id));
     if (table_page == nullptr)
-        return;    
+        return;
+    latch_.r_lock();
     table_page->w_lock();
+
+    // get the tuple before it's gone, so that we can delete it from the indexes and free its overflow pages
+    Tuple tuple;
+    bool has_tuple = table_page->get_tuple(&tuple, rid);
     table_page->apply_delete(rid);
     table_page->w_unlock();
     bpm_->unpin_page(page_id, true);
+
+    if (has_tuple) {
+        for (auto index : indexes_)
+            index->delete_entry(get_index_key(index, tuple, tb_schema), rid);
+        toast_delete(tuple, tb_schema, bpm_);
+    }
+    latch_.r_unlock();
 }
 
-void Table::rollback_delete(const Value &key_value, const Schema &tb_schema) {
-    rollback_delete_func(first_table_page_id_, key_value, tb_schema, bpm_);
+void Table::rollback_delete(const IndexKey &key, const Schema &tb_schema) {
+    rollback_delete_func(lk_ha_dir_, key, tb_schema, bpm_);
 }
 
 void Table::rollback_delete(const RID &rid) {
@@ -140,28 +208,154 @@ bool Table::get_tuple(Tuple *tuple, const RID &rid) {
     return false;
 }
 
-bool Table::get_tuple(const Value &key_value, Tuple *tuple, const Schema &tb_schema) {
-    op_code_t op_code = get_tuple_func(first_table_page_id_, key_value, tuple, tb_schema, bpm_);
+bool Table::get_tuple(const IndexKey &key, Tuple *tuple, const Schema &tb_schema) {
+    op_code_t op_code = get_tuple_func(lk_ha_dir_, key, tuple, tb_schema, bpm_);
     if (op_code == OP_SUCCESS) {
         return true;
     }
     return false;
 }
 
+size_t_ Table::get_tuples(const std::vector<IndexKey> &keys, std::vector<Tuple> *tuples, const Schema &tb_schema) {
+    return get_tuples_func(lk_ha_dir_, keys, tuples, tb_schema, bpm_);
+}
+
+size_t_ Table::get_tuples(const std::vector<Value> &key_values, std::vector<Tuple> *tuples, const Schema &tb_schema) {
+    std::vector<IndexKey> keys;
+    keys.reserve(key_values.size());
+    for (auto &key_value : key_values)
+        keys.push_back(make_key(key_value, tb_schema));
+    return get_tuples(keys, tuples, tb_schema);
+}
+
 bool Table::insert_tuple(Tuple *tuple, const Schema &tb_schema) {
-    op_code_t op_code = insert_tuple_func(first_table_page_id_, tuple, tb_schema, bpm_);
-    if (op_code == OP_SUCCESS) {
-        return true;
+    // the caller's tuple is kept as it is, only the stored one has the pointers to the overflow pages
+    latch_.r_lock();
+    Tuple toasted;
+    Tuple *stored = tuple;
+    if (toast_needed(*tuple)) {
+        if (toast_tuple(*tuple, &toasted, tb_schema, get_inline_cols(tb_schema), bpm_) != OP_SUCCESS) {
+            latch_.r_unlock();
+            return false;
+        }
+        stored = &toasted;
     }
-    return false;
+
+    op_code_t op_code = insert_tuple_func(lk_ha_dir_, stored, tb_schema, bpm_);
+    if (op_code != OP_SUCCESS) {
+        if (stored != tuple)
+            toast_delete(toasted, tb_schema, bpm_);
+        latch_.r_unlock();
+        return false;
+    }
+    tuple->set_rid(stored->get_rid());
+
+    for (auto index : indexes_)
+        index->insert_entry(index->get_key(*tuple), tuple->get_rid());
+    latch_.r_unlock();
+    return true;
+}
+
+bool Table::bulk_load(std::vector<Tuple> *tuples, const Schema &tb_schema) {
+    latch_.r_lock();
+    // the caller's tuples are kept as they are, only the stored ones have the pointers to the overflow pages
+    std::vector<Tuple> toasted;
+    std::vector<Tuple> *stored = tuples;
+    bool need_toast = std::any_of(tuples->begin(), tuples->end(), [](const Tuple &tuple) { return toast_needed(tuple); });
+    if (need_toast) {
+        std::vector<offset_t> inline_cols = get_inline_cols(tb_schema);
+        toasted.resize(tuples->size());
+        for (size_t i = 0; i < tuples->size(); i++) {
+            if (!toast_needed((*tuples)[i])) {
+                toasted[i] = (*tuples)[i];
+                continue;
+            }
+            if (toast_tuple((*tuples)[i], &toasted[i], tb_schema, inline_cols, bpm_) != OP_SUCCESS) {
+                for (size_t j = 0; j < i; j++)
+                    toast_delete(toasted[j], tb_schema, bpm_);
+                latch_.r_unlock();
+                return false;
+            }
+        }
+        stored = &toasted;
+    }
+
+    op_code_t op_code = bulk_load_func(lk_ha_dir_, stored, tb_schema, bpm_);
+
+    // tuples may be partially loaded when failing, index the loaded ones
+    for (size_t i = 0; i < tuples->size(); i++) {
+        Tuple &tuple = (*tuples)[i];
+        tuple.set_rid((*stored)[i].get_rid());
+        if (tuple.get_rid().get_page_id() == INVALID_PAGE_ID) {
+            if (stored != tuples)
+                toast_delete(toasted[i], tb_schema, bpm_);
+            continue;
+        }
+        for (auto index : indexes_)
+            index->insert_entry(index->get_key(tuple), tuple.get_rid());
+    }
+    latch_.r_unlock();
+    return op_code == OP_SUCCESS;
 }
 
 bool Table::update_tuple(Tuple *new_tuple, const RID &old_rid, const Schema &tb_schema) {
-    op_code_t op_code = update_tuple_func(first_table_page_id_, new_tuple, old_rid, tb_schema, bpm_);
-    if (op_code == OP_SUCCESS) {
-        return true;
+    latch_.r_lock();
+    Tuple old_tuple;
+    if (get_tuple_directly(old_rid, &old_tuple, bpm_) != OP_SUCCESS) {
+        latch_.r_unlock();
+        return false;
     }
-    return false;
+
+    // the new tuple may still refer to the old tuple's overflow pages if it's got from the table
+    Tuple toasted;
+    Tuple *stored = new_tuple;
+    if (toast_needed(*new_tuple)) {
+        if (toast_tuple(*new_tuple, &toasted, tb_schema, get_inline_cols(tb_schema), bpm_) != OP_SUCCESS) {
+            latch_.r_unlock();
+            return false;
+        }
+        stored = &toasted;
+    }
+
+    op_code_t op_code = update_tuple_func(lk_ha_dir_, stored, old_rid, tb_schema, bpm_);
+    if (op_code != OP_SUCCESS) {
+        if (stored != new_tuple)
+            toast_delete(toasted, tb_schema, bpm_, &old_tuple);
+        latch_.r_unlock();
+        return false;
+    }
+    new_tuple->set_rid(stored->get_rid());
+    toast_delete(old_tuple, tb_schema, bpm_, stored);
+
+    // only the entries whose key or position has been changed need to be updated
+    for (auto index : indexes_) {
+        IndexKey old_key = get_index_key(index, old_tuple, tb_schema);
+        IndexKey new_key = get_index_key(index, *new_tuple, tb_schema);
+        if (old_key == new_key && old_rid == new_tuple->get_rid())
+            continue;
+        index->delete_entry(old_key, old_rid);
+        index->insert_entry(new_key, new_tuple->get_rid());
+    }
+    latch_.r_unlock();
+    return true;
+}
+
+std::vector<offset_t> Table::get_inline_cols(const Schema &tb_schema) const {
+    std::vector<offset_t> inline_cols = tb_schema.get_key_idxs();
+    for (auto index : indexes_)
+        inline_cols.insert(inline_cols.end(), index->get_col_idxs().begin(), index->get_col_idxs().end());
+    return inline_cols;
+}
+
+IndexKey Table::get_index_key(SecondaryIndex *index, const Tuple &tuple, const Schema &tb_schema) const {
+    for (auto col_idx : index->get_col_idxs()) {
+        if (tuple.is_toasted(tb_schema, col_idx)) {
+            Tuple fetched(tuple);
+            toast_fetch(&fetched, tb_schema, index->get_col_idxs(), bpm_);
+            return index->get_key(fetched);
+        }
+    }
+    return index->get_key(tuple);
 }
 
 } // namespace dawn
@@ -0,0 +1,82 @@
+#include "table/tmp_page_chain.h"
+
+namespace dawn {
+
+void TmpPageChain::append(const Tuple &tuple, BufferPoolManager *bpm) {
+    RID rid;
+    tuple_num_++;
+    if (last_page_ != nullptr && last_page_->insert_tuple(tuple, &rid))
+        return;
+
+    // new_tmp_page() doesn't initialize the page
+    TablePage *page = reinterpret_cast<TablePage*>(bpm->new_tmp_page());
+    if (page == nullptr)
+        FATAL("TmpPageChain Error: fail to get a temporary page");
+    if (last_page_ == nullptr) {
+        page->init(INVALID_PAGE_ID, INVALID_PAGE_ID);
+        first_pgid_ = page->get_page_id();
+    } else {
+        page->init(last_page_->get_page_id(), INVALID_PAGE_ID);
+        last_page_->set_next_page_id(page->get_page_id());
+        bpm->unpin_page(last_page_->get_page_id(), true);
+    }
+    last_page_ = page;
+
+    if (!page->insert_tuple(tuple, &rid))
+        FATAL("TmpPageChain Error: the tuple is larger than a page");
+}
+
+void TmpPageChain::finish(BufferPoolManager *bpm) {
+    if (last_page_ == nullptr)
+        return;
+    bpm->unpin_page(last_page_->get_page_id(), true);
+    last_page_ = nullptr;
+}
+
+void TmpPageChain::destroy(BufferPoolManager *bpm) {
+    finish(bpm);
+    page_id_t page_id = first_pgid_;
+    while (page_id != INVALID_PAGE_ID) {
+        TablePage *page = reinterpret_cast<TablePage*>(bpm->get_page(page_id));
+        page_id_t next_pgid = page->get_next_page_id();
+        bpm->unpin_page(page_id, false);
+        bpm->delete_page(page_id);
+        page_id = next_pgid;
+    }
+    first_pgid_ = INVALID_PAGE_ID;
+    tuple_num_ = 0;
+}
+
+void TmpChainReader::open(page_id_t first_pgid, BufferPoolManager *bpm) {
+    close();
+    bpm_ = bpm;
+    page_ = first_pgid == INVALID_PAGE_ID ? nullptr : reinterpret_cast<TablePage*>(bpm_->get_page(first_pgid));
+    pos_.set(INVALID_PAGE_ID, INVALID_SLOT_NUM);
+}
+
+bool TmpChainReader::next(Tuple *tuple) {
+    RID next_pos;
+    while (page_ != nullptr) {
+        if (page_->get_next_tuple_rid(pos_, &next_pos)) {
+            pos_ = next_pos;
+            if (!page_->get_tuple_ref(tuple, pos_))
+                FATAL("TmpChainReader Error: fail to read the tuple");
+            return true;
+        }
+
+        // jump to the next page of the chain
+        page_id_t next_pgid = page_->get_next_page_id();
+        bpm_->unpin_page(page_->get_page_id(), false);
+        page_ = next_pgid == INVALID_PAGE_ID ? nullptr : reinterpret_cast<TablePage*>(bpm_->get_page(next_pgid));
+        pos_.set(INVALID_PAGE_ID, INVALID_SLOT_NUM);
+    }
+    return false;
+}
+
+void TmpChainReader::close() {
+    if (page_ != nullptr)
+        bpm_->unpin_page(page_->get_page_id(), false);
+    page_ = nullptr;
+}
+
+} // namespace dawn
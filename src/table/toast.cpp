@@ -0,0 +1,153 @@
+#include "table/toast.h"
+#include "storage/page/overflow_page.h"
+
+#include <algorithm>
+
+namespace dawn {
+
+op_code_t toast_tuple(const Tuple &tuple, Tuple *toasted, const Schema &tb_schema,
+    const std::vector<offset_t> &inline_cols, BufferPoolManager *bpm) {
+    *toasted = tuple;
+    std::vector<page_id_t> written;
+    while (toast_needed(*toasted)) {
+        // move the largest value out first, so that as few values as possible are toasted
+        int victim = -1;
+        size_t_ victim_size = TOAST_POINTER_SZ;
+        for (int i = 0; i < tb_schema.get_column_num(); i++) {
+            if (tb_schema.get_column_type(i) != TypeId::kVarchar || toasted->is_toasted(tb_schema, i))
+                continue;
+            if (std::find(inline_cols.begin(), inline_cols.end(), i) != inline_cols.end())
+                continue;
+            size_t_ size = toasted->get_varchar_stored_size(tb_schema, i);
+            if (size > victim_size) {
+                victim = i;
+                victim_size = size;
+            }
+        }
+
+        // no value is worth moving, the tuple may be still too large for the page
+        if (victim == -1)
+            break;
+
+        Value value = toasted->get_value(tb_schema, victim);
+        page_id_t first_pgid = toast_write_value(value.get_value<char*>(), victim_size, bpm);
+        if (first_pgid == INVALID_PAGE_ID) {
+            for (auto page_id : written)
+                toast_delete_value(page_id, bpm);
+            return NEW_PG_FAIL;
+        }
+        written.push_back(first_pgid);
+        toasted->set_toast_pointer(tb_schema, victim, first_pgid, victim_size);
+    }
+    return OP_SUCCESS;
+}
+
+Value toast_fetch_value(const Tuple &tuple, const Schema &tb_schema, int idx, BufferPoolManager *bpm) {
+    if (!tuple.is_toasted(tb_schema, idx))
+        return tuple.get_value(tb_schema, idx);
+
+    page_id_t first_pgid;
+    size_t_ str_size;
+    tuple.get_toast_pointer(tb_schema, idx, &first_pgid, &str_size);
+    std::vector<char> str(str_size + 1, '\0');
+    if (!toast_read_value(first_pgid, str_size, str.data(), bpm))
+        LOG("fail to read the toasted value");
+    return Value(str.data(), TypeId::kChar, str_size);
+}
+
+void toast_fetch(Tuple *tuple, const Schema &tb_schema, const std::vector<offset_t> &col_idxs, BufferPoolManager *bpm) {
+    for (auto idx : col_idxs) {
+        if (!tuple->is_toasted(tb_schema, idx))
+            continue;
+        Value value = toast_fetch_value(*tuple, tb_schema, idx, bpm);
+        tuple->set_value(tb_schema, &value, idx);
+    }
+}
+
+void toast_fetch(Tuple *tuple, const Schema &tb_schema, BufferPoolManager *bpm) {
+    std::vector<offset_t> col_idxs;
+    for (int i = 0; i < tb_schema.get_column_num(); i++)
+        col_idxs.push_back(i);
+    toast_fetch(tuple, tb_schema, col_idxs, bpm);
+}
+
+void toast_delete(const Tuple &tuple, const Schema &tb_schema, BufferPoolManager *bpm, const Tuple *kept) {
+    std::vector<page_id_t> kept_pgids;
+    if (kept != nullptr) {
+        for (int i = 0; i < tb_schema.get_column_num(); i++) {
+            if (!kept->is_toasted(tb_schema, i))
+                continue;
+            page_id_t first_pgid;
+            size_t_ str_size;
+            kept->get_toast_pointer(tb_schema, i, &first_pgid, &str_size);
+            kept_pgids.push_back(first_pgid);
+        }
+    }
+
+    for (int i = 0; i < tb_schema.get_column_num(); i++) {
+        if (!tuple.is_toasted(tb_schema, i))
+            continue;
+        page_id_t first_pgid;
+        size_t_ str_size;
+        tuple.get_toast_pointer(tb_schema, i, &first_pgid, &str_size);
+        if (std::find(kept_pgids.begin(), kept_pgids.end(), first_pgid) == kept_pgids.end())
+            toast_delete_value(first_pgid, bpm);
+    }
+}
+
+page_id_t toast_write_value(const char *src, size_t_ size, BufferPoolManager *bpm) {
+    // write from the last part, so that each page knows its next page when it's written
+    size_t_ capacity = OverflowPage::get_capacity();
+    size_t_ page_num = std::max((size + capacity - 1) / capacity, 1);
+    page_id_t next_pgid = INVALID_PAGE_ID;
+    for (size_t_ i = page_num - 1; i >= 0; i--) {
+        OverflowPage *page = reinterpret_cast<OverflowPage*>(bpm->new_page());
+        if (page == nullptr) {
+            toast_delete_value(next_pgid, bpm);
+            return INVALID_PAGE_ID;
+        }
+
+        offset_t offset = i * capacity;
+        page->init(next_pgid);
+        page->write_data(src + offset, std::min(capacity, size - offset));
+        next_pgid = page->get_page_id();
+        bpm->unpin_page(next_pgid, true);
+    }
+    return next_pgid;
+}
+
+bool toast_read_value(page_id_t first_pgid, size_t_ size, char *dst, BufferPoolManager *bpm) {
+    size_t_ read_size = 0;
+    page_id_t page_id = first_pgid;
+    while (page_id != INVALID_PAGE_ID && read_size < size) {
+        OverflowPage *page = reinterpret_cast<OverflowPage*>(bpm->get_page(page_id));
+        if (page == nullptr)
+            return false;
+        // the size recorded in the tuple and the pages may disagree when the pages are corrupted
+        size_t_ copied = page->read_data(dst + read_size, size - read_size);
+        page_id_t next_pgid = page->get_next_page_id();
+        bpm->unpin_page(page_id, false);
+        if (copied < 0)
+            return false;
+        read_size += copied;
+        page_id = next_pgid;
+    }
+    return read_size == size;
+}
+
+void toast_delete_value(page_id_t first_pgid, BufferPoolManager *bpm) {
+    page_id_t page_id = first_pgid;
+    while (page_id != INVALID_PAGE_ID) {
+        OverflowPage *page = reinterpret_cast<OverflowPage*>(bpm->get_page(page_id));
+        if (page == nullptr) {
+            LOG("fail to get the overflow page");
+            return;
+        }
+        page_id_t next_pgid = page->get_next_page_id();
+        bpm->unpin_page(page_id, false);
+        bpm->delete_page(page_id);
+        page_id = next_pgid;
+    }
+}
+
+} // namespace dawn
@@ -5,21 +5,42 @@ namespace dawn {
 Value Tuple::get_value(const Schema &schema, int idx) const {
     Column col = schema.get_column(idx);
     TypeId type_id = col.get_type_id();
+    if (type_id == TypeId::kVarchar) {
+        assert(!is_toasted(schema, idx));
+        offset_t str_offset;
+        size_t_ str_size;
+        get_varchar_slot(col, &str_offset, &str_size);
+        Value value;
+        value.construct_padded(data_ + str_offset, str_size);
+        return value;
+    }
     if (type_id == TypeId::kChar) {
-        size_t_ str_size = col.get_data_size();
-
-        // we have to create a temporary string, because the Tuple and string stored on the disk doesn't end with '\0'
-        char tmp[str_size+1];
-        memcpy(tmp, data_ + col.get_offset(), str_size);
-        tmp[str_size] = '\0';
-        return Value(tmp, TypeId::kChar, str_size);
+        // the string stored in the Tuple doesn't end with '\0'
+        Value value;
+        value.construct_padded(data_ + col.get_offset(), col.get_data_size());
+        return value;
     }
     return Value(data_ + col.get_offset(), type_id);
 }
 
 // ATTENTION length of string is not checked here
 void Tuple::set_value(const Schema &schema, Value *value, int idx) {
+    own_data();
     Column col = schema.get_column(idx);
+    if (col.get_type_id() == TypeId::kVarchar) {
+        offset_t str_offset;
+        size_t_ str_size;
+        get_varchar_slot(col, &str_offset, &str_size);
+        size_t_ new_size = get_varchar_size(*value, col);
+        if (new_size == str_size && !is_toasted(schema, idx)) {
+            memcpy(data_ + str_offset, value->get_value<char*>(), str_size);
+            return;
+        }
+
+        // the length is changed, lay out the strings again
+        replace_varchar(schema, idx, value->get_value<char*>(), new_size, false);
+        return;
+    }
     if (col.get_type_id() == TypeId::kChar) {
         size_t_ str_size = col.get_data_size();
         // we have to create a temporary string, because the string stored on the disk and Tupe doesn't end with '\0'
@@ -31,6 +52,60 @@ void Tuple::set_value(const Schema &schema, Value *value, int idx) {
     value->serialize_to(data_ + col.get_offset());
 }
 
+void Tuple::get_toast_pointer(const Schema &schema, int idx, page_id_t *first_pgid, size_t_ *str_size) const {
+    offset_t ptr_offset;
+    size_t_ ptr_size;
+    get_varchar_slot(schema.get_column(idx), &ptr_offset, &ptr_size);
+    memcpy(first_pgid, data_ + ptr_offset, PGID_T_SIZE);
+    memcpy(str_size, data_ + ptr_offset + PGID_T_SIZE, SIZE_T_SIZE);
+}
+
+void Tuple::set_toast_pointer(const Schema &schema, int idx, page_id_t first_pgid, size_t_ str_size) {
+    char ptr[TOAST_POINTER_SZ];
+    memcpy(ptr, &first_pgid, PGID_T_SIZE);
+    memcpy(ptr + PGID_T_SIZE, &str_size, SIZE_T_SIZE);
+    replace_varchar(schema, idx, ptr, TOAST_POINTER_SZ, true);
+}
+
+void Tuple::replace_varchar(const Schema &schema, int idx, const char *str, size_t_ str_size, bool toasted) {
+    size_t_ col_num = schema.get_column_num();
+    size_t_ fixed_size = schema.get_tuple_size();
+    size_t_ new_size = fixed_size;
+    for (size_t_ i = 0; i < col_num; i++) {
+        if (schema.get_column_type(i) == TypeId::kVarchar)
+            new_size += i == idx ? str_size : get_varchar_stored_size(schema, i);
+    }
+
+    char *new_data = new char[new_size];
+    memcpy(new_data, data_, fixed_size);
+    offset_t new_offset = fixed_size;
+    for (size_t_ i = 0; i < col_num; i++) {
+        Column col = schema.get_column(i);
+        if (col.get_type_id() != TypeId::kVarchar)
+            continue;
+
+        offset_t old_offset;
+        size_t_ old_size;
+        get_varchar_slot(col, &old_offset, &old_size);
+        const char *src = i == idx ? str : data_ + old_offset;
+        size_t_ size = i == idx ? str_size : old_size;
+        size_t_ flagged_size = size;
+        if (i == idx ? toasted : is_toasted(schema, i))
+            flagged_size = static_cast<size_t_>(size | TOAST_MASK);
+
+        memcpy(new_data + col.get_offset(), &new_offset, OFFSET_T_SIZE);
+        memcpy(new_data + col.get_offset() + OFFSET_T_SIZE, &flagged_size, SIZE_T_SIZE);
+        memcpy(new_data + new_offset, src, size);
+        new_offset += size;
+    }
+
+    if (allocated_)
+        delete[] data_;
+    data_ = new_data;
+    size_ = new_size;
+    allocated_ = true;
+}
+
 string_t Tuple::to_string(const Schema &schema) const {
     std::ostringstream os;
     int col_num = schema.get_column_num();
@@ -48,6 +123,10 @@ string_t Tuple::to_string(const Schema &schema) const {
             first = false;
         }
 
+        if (is_toasted(schema, i)) {
+            os << type_to_string(col.get_type_id()) << ": (toasted)";
+            continue;
+        }
         Value value = get_value(schema, i);
         os << type_to_string(col.get_type_id()) << ": " << value.to_string();
     }
@@ -57,18 +136,35 @@ string_t Tuple::to_string(const Schema &schema) const {
 }
 
 void Tuple::init(std::vector<Value> *values, const Schema &schema) {
+    size_t_ col_num = schema.get_column_num();
     size_ = schema.get_tuple_size();
+    for (size_t_ i = 0; i < col_num; i++) {
+        Column col = schema.get_column(i);
+        if (col.get_type_id() == TypeId::kVarchar)
+            size_ += get_varchar_size((*values)[i], col);
+    }
     allocated_ = true;
     data_ = new char[size_];
 
-    size_t_ col_num = schema.get_column_num();
+    // strings of the VARCHAR columns are appended after the fixed part one by one
+    offset_t str_offset = schema.get_tuple_size();
     for (size_t_ i = 0; i < col_num; i++) {
-        set_value(schema, &((*values)[i]), i);
+        Column col = schema.get_column(i);
+        if (col.get_type_id() != TypeId::kVarchar) {
+            set_value(schema, &((*values)[i]), i);
+            continue;
+        }
+
+        size_t_ str_size = get_varchar_size((*values)[i], col);
+        memcpy(data_ + col.get_offset(), &str_offset, OFFSET_T_SIZE);
+        memcpy(data_ + col.get_offset() + OFFSET_T_SIZE, &str_size, SIZE_T_SIZE);
+        memcpy(data_ + str_offset, (*values)[i].get_value<char*>(), str_size);
+        str_offset += str_size;
     }
 }
 
 bool Tuple::operator==(const Tuple &tuple) const {
-    if (allocated_ != tuple.allocated_) {
+    if ((data_ == nullptr) != (tuple.data_ == nullptr)) {
         return false;
     }
 
@@ -76,7 +172,7 @@ bool Tuple::operator==(const Tuple &tuple) const {
         return false;
     }
 
-    if (allocated_) {
+    if (data_ != nullptr) {
         for (size_t_ i = 0; i < size_; i++)
             if (data_[i] != tuple.data_[i]) {
                 return false;
@@ -87,7 +183,7 @@ bool Tuple::operator==(const Tuple &tuple) const {
 }
 
 bool Tuple::is_equal(const Tuple &tuple) const {
-    if (allocated_ != tuple.allocated_) {
+    if ((data_ == nullptr) != (tuple.data_ == nullptr)) {
         return false;
     }
 
@@ -95,7 +191,7 @@ bool Tuple::is_equal(const Tuple &tuple) const {
         return false;
     }
 
-    if (allocated_) {
+    if (data_ != nullptr) {
         for (size_t_ i = 0; i < size_; i++)
             if (data_[i] != tuple.data_[i]) {
                 return false;
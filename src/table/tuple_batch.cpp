@@ -0,0 +1,167 @@
+#include "table/tuple_batch.h"
+#include "table/toast.h"
+
+namespace dawn {
+
+void ColumnVector::init(TypeId type_id, size_t_ width) {
+    type_id_ = type_id;
+    width_ = width;
+    data_.assign(TUPLE_BATCH_SZ * width_, 0);
+    if (type_id_ == TypeId::kVarchar)
+        lens_.assign(TUPLE_BATCH_SZ, 0);
+}
+
+Value ColumnVector::get_value(int row) const {
+    const char *slot = get_slot(row);
+    Value value;
+    if (type_id_ == TypeId::kVarchar) {
+        value.construct_padded(slot, lens_[row]);
+        return value;
+    }
+    if (type_id_ == TypeId::kChar) {
+        value.construct_padded(slot, width_);
+        return value;
+    }
+    return Value(const_cast<char*>(slot), type_id_);
+}
+
+void ColumnVector::set_value(int row, const Value &value) {
+    if (is_string_type(type_id_)) {
+        const char *str = value.get_value<char*>();
+        set_str(row, str, strnlen(str, width_));
+        return;
+    }
+    value.serialize_to(get_slot(row));
+}
+
+void ColumnVector::set_str(int row, const char *str, size_t_ len) {
+    char *slot = get_slot(row);
+    len = std::min(len, width_);
+    memcpy(slot, str, len);
+    memset(slot + len, 0, width_ - len);
+    if (type_id_ == TypeId::kVarchar)
+        lens_[row] = len;
+}
+
+void ColumnVector::copy_rows(const ColumnVector &src, const int *sel, size_t_ num) {
+    if (type_id_ != src.type_id_ || width_ != src.width_) {
+        // the string columns of different lengths
+        for (size_t_ i = 0; i < num; i++)
+            set_value(i, src.get_value(sel == nullptr ? i : sel[i]));
+        return;
+    }
+
+    if (sel == nullptr) {
+        memcpy(data_.data(), src.data_.data(), num * width_);
+        if (type_id_ == TypeId::kVarchar)
+            memcpy(lens_.data(), src.lens_.data(), num * sizeof(size_t_));
+        return;
+    }
+
+    switch (type_id_) {
+        case TypeId::kInteger: {
+            integer_t *dst_data = get_data<integer_t>();
+            const integer_t *src_data = src.get_data<integer_t>();
+            for (size_t_ i = 0; i < num; i++)
+                dst_data[i] = src_data[sel[i]];
+            break;
+        }
+        case TypeId::kDecimal: {
+            decimal_t *dst_data = get_data<decimal_t>();
+            const decimal_t *src_data = src.get_data<decimal_t>();
+            for (size_t_ i = 0; i < num; i++)
+                dst_data[i] = src_data[sel[i]];
+            break;
+        }
+        default: {
+            for (size_t_ i = 0; i < num; i++)
+                memcpy(get_slot(i), src.get_slot(sel[i]), width_);
+            if (type_id_ == TypeId::kVarchar)
+                for (size_t_ i = 0; i < num; i++)
+                    lens_[i] = src.lens_[sel[i]];
+        }
+    }
+}
+
+void TupleBatch::init(const Schema *schema, const std::vector<offset_t> &col_idxs) {
+    schema_ = schema;
+    columns_.clear();
+    columns_.resize(schema_->get_column_num());
+    loaded_cols_.clear();
+    loaded_offsets_.clear();
+    rids_.resize(TUPLE_BATCH_SZ);
+    sel_.resize(TUPLE_BATCH_SZ);
+    reset();
+
+    if (!col_idxs.empty()) {
+        require_cols(col_idxs);
+        return;
+    }
+    std::vector<offset_t> all_cols;
+    for (int i = 0; i < schema_->get_column_num(); i++)
+        all_cols.push_back(i);
+    require_cols(all_cols);
+}
+
+void TupleBatch::require_cols(const std::vector<offset_t> &col_idxs) {
+    for (auto idx : col_idxs) {
+        if (columns_[idx].is_valid())
+            continue;
+        Column col = schema_->get_column(idx);
+        columns_[idx].init(col.get_type_id(), is_string_type(col.get_type_id()) ? col.get_max_length() : col.get_data_size());
+        loaded_cols_.push_back(idx);
+        loaded_offsets_.push_back(col.get_offset());
+    }
+}
+
+bool TupleBatch::append(const Tuple &tuple, BufferPoolManager *bpm) {
+    if (is_full())
+        return false;
+
+    const char *data = tuple.get_data();
+    size_t_ col_num = loaded_cols_.size();
+    for (size_t_ i = 0; i < col_num; i++) {
+        ColumnVector &vec = columns_[loaded_cols_[i]];
+        if (vec.get_type_id() != TypeId::kVarchar) {
+            memcpy(vec.get_slot(size_), data + loaded_offsets_[i], vec.get_width());
+            continue;
+        }
+
+        if (tuple.is_toasted(*schema_, loaded_cols_[i])) {
+            Value value = toast_fetch_value(tuple, *schema_, loaded_cols_[i], bpm);
+            vec.set_str(size_, value.get_value<char*>(), value.get_char_size());
+            continue;
+        }
+
+        // | offset | size | of the string, see Tuple
+        offset_t str_offset;
+        size_t_ str_size;
+        memcpy(&str_offset, data + loaded_offsets_[i], OFFSET_T_SIZE);
+        memcpy(&str_size, data + loaded_offsets_[i] + OFFSET_T_SIZE, SIZE_T_SIZE);
+        vec.set_str(size_, data + str_offset, str_size);
+    }
+    rids_[size_] = tuple.get_rid();
+    size_++;
+    return true;
+}
+
+void TupleBatch::get_tuple(int row, Tuple *tuple) const {
+    std::vector<Value> values;
+    values.reserve(columns_.size());
+    char zero[DECIMAL_T_SIZE] = {0};
+    for (size_t_ i = 0; i < static_cast<size_t_>(columns_.size()); i++) {
+        if (columns_[i].is_valid()) {
+            values.push_back(columns_[i].get_value(row));
+            continue;
+        }
+        TypeId type_id = schema_->get_column(i).get_type_id();
+        if (is_string_type(type_id))
+            values.push_back(Value(""));
+        else
+            values.push_back(Value(zero, type_id));
+    }
+    tuple->reconstruct(&values, *schema_);
+    tuple->set_rid(rids_[row]);
+}
+
+} // namespace dawn
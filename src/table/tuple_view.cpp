@@ -0,0 +1,20 @@
+#include "table/tuple_view.h"
+
+namespace dawn {
+
+bool TupleView::refer(TablePage *tb_page, const RID &rid, const std::vector<offset_t> &col_idxs) {
+    release();
+    if (tb_page->is_pax() && !col_idxs.empty())
+        return tb_page->get_tuple_columns(&tuple_, rid, col_idxs);
+    return tb_page->get_tuple(&tuple_, rid);
+}
+
+void TupleView::refer(const TupleView &view) {
+    if (view.tuple_.is_attached()) {
+        tuple_ = view.tuple_;
+        return;
+    }
+    tuple_.attach(view.tuple_.get_data(), view.tuple_.get_size(), view.tuple_.get_rid());
+}
+
+} // namespace dawn
@@ -86,7 +86,7 @@ public:
     
     Page* get_page_test(page_id_t page_id) { return get_page(page_id); }
     Page* new_page_test() { return new_page(); }
-    bool delete_page_test(page_id_t page_id) { return delete_page(page_id); }
+    bool delete_page_test(page_id_t page_id, bool defer = false) { return delete_page(page_id, defer); }
     void unpin_page_test(page_id_t page_id, bool is_dirty) { unpin_page(page_id, is_dirty); }
     bool flush_page_test(page_id_t page_id) { return flush_page(page_id); }
     bool flush_all_test() { return flush_all(); }
@@ -97,7 +97,10 @@ public:
      * with the use of replacer's victim
      * DO NOT USE THIS FUNCTION as possible as you can
      */
-    void evict_page_test(page_id_t page_id) { evict_page(page_id, get_frame_id(page_id)); }
+    void evict_page_test(page_id_t page_id) { evict_page(page_id, get_frame_id(page_id), true); }
+
+    /** evict the page as a victim picked by the replacer, it's kept if it's pinned */
+    void evict_victim_test(page_id_t page_id) { evict_page(page_id, get_frame_id(page_id)); }
 
     void write_page(Page *page, const offset_t &offset, const char *src, const int size);
     void read_page(Page *page, const offset_t &offset, char *dst, const int &size);
@@ -151,6 +154,9 @@ page_list& initPageList(page_list& pageList, size_t& LIST_SIZE, BufferPoolManage
  *   3. first phase: get large number of pages, write, unpin and flush them
  *      second phase: get them from bpm and check the content has been written
  *   4. ensure the information of page id can be consistent after the restart
+ *   5. the threshold pages are shared by the executors and never block when they are used up
+ *   6. the page deleted while it's pinned is deleted by the last unpin
+ *   7. the victim pinned again before it's evicted is kept, and the evicted one is flushed
  */
 TEST_F(BPBasicTest, Test1) {
     DiskManager *dm = DiskManagerFactory::create_DiskManager(meta, true);
@@ -524,4 +530,85 @@ TEST_F(BPBasicTest, Test4) {
     }
 }
 
+TEST_F(BPBasicTest, Test5) {
+    DiskManager *dm = DiskManagerFactory::create_DiskManager(meta, true);
+    ASSERT_NE(dm, nullptr);
+
+    {
+        // 16 of the 20 pages are available for the executors
+        BufferPoolManagerTest bpmt(dm, POOL_SIZE);
+        size_t_ first = bpmt.get_threshold_page(4);
+        size_t_ second = bpmt.get_threshold_page(4);
+        ASSERT_EQ(8, first);
+        ASSERT_EQ(4, second);
+
+        // only 4 pages are left, it still gets the minimum instead of waiting
+        size_t_ third = bpmt.get_threshold_page(4);
+        ASSERT_EQ(4, third);
+        size_t_ fourth = bpmt.get_threshold_page();
+        ASSERT_EQ(1, fourth);
+
+        bpmt.return_threshold_page(first);
+        bpmt.return_threshold_page(second);
+        bpmt.return_threshold_page(third);
+        bpmt.return_threshold_page(fourth);
+        ASSERT_EQ(8, bpmt.get_threshold_page());
+    }
+
+    delete dm;
+}
+
+TEST_F(BPBasicTest, Test6) {
+    DiskManager *dm = DiskManagerFactory::create_DiskManager(meta, true);
+    ASSERT_NE(dm, nullptr);
+
+    {
+        BufferPoolManagerTest bpmt(dm, POOL_SIZE);
+        Page *page = bpmt.new_page_test();
+        ASSERT_NE(nullptr, page);
+        page_id_t page_id = page->get_page_id();
+        ASSERT_EQ(page, bpmt.get_page_test(page_id));
+
+        // pinned twice, it's still in use after the first unpin
+        ASSERT_FALSE(bpmt.delete_page_test(page_id, true));
+        bpmt.unpin_page_test(page_id, true);
+        ASSERT_TRUE(bpmt.is_in_bpm(page_id));
+        ASSERT_FALSE(dm->is_free(page_id));
+
+        bpmt.unpin_page_test(page_id, false);
+        ASSERT_FALSE(bpmt.is_in_bpm(page_id));
+        ASSERT_TRUE(dm->is_free(page_id));
+    }
+
+    delete dm;
+}
+
+TEST_F(BPBasicTest, Test7) {
+    DiskManager *dm = DiskManagerFactory::create_DiskManager(meta, true);
+    ASSERT_NE(dm, nullptr);
+
+    {
+        BufferPoolManagerTest bpmt(dm, POOL_SIZE);
+        Page *page = bpmt.new_page_test();
+        ASSERT_NE(nullptr, page);
+        page_id_t page_id = page->get_page_id();
+        const char *s = "12345";
+        bpmt.write_page(page, COM_PG_HEADER_SZ, s, 6);
+
+        // someone got it after it had been picked as the victim
+        bpmt.evict_victim_test(page_id);
+        ASSERT_TRUE(bpmt.is_in_bpm(page_id));
+
+        bpmt.unpin_page_test(page_id, true);
+        bpmt.evict_victim_test(page_id);
+        ASSERT_FALSE(bpmt.is_in_bpm(page_id));
+
+        char page_buf[PAGE_SIZE];
+        ASSERT_TRUE(dm->read_page(page_id, page_buf));
+        ASSERT_EQ(0, strcmp(s, page_buf + COM_PG_HEADER_SZ));
+    }
+
+    delete dm;
+}
+
 } // namespace dawn
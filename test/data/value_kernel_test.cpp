@@ -0,0 +1,217 @@
+#include "gtest/gtest.h"
+#include "data/kernels.h"
+#include "table/schema.h"
+#include "table/tuple.h"
+#include "sql/expressions/col_value_expr.h"
+#include "sql/expressions/comparison_expr.h"
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+namespace dawn {
+
+/**
+ * Test List:
+ *   1. compare the values of the same type and mixed numeric types
+ *   2. compute the numeric values, the result is decimal if any of them is decimal
+ *   3. the pairs without the specialized kernel fall back to the Type
+ *   4. the comparison expression selects the kernel by the columns' types
+ */
+TEST(ValueKernelTest, BasicTest) {
+    PRINT("start the value kernel tests...");
+    const ComparisonType cmp_types[] = {ComparisonType::kEqual, ComparisonType::kNotEqual,
+        ComparisonType::kLessThan, ComparisonType::kLessThanOrEqual,
+        ComparisonType::kGreaterThan, ComparisonType::kGreaterThanOrEqual};
+    // results of comparing 1 with 2 and 2 with 2
+    const bool less_expected[] = {false, true, true, true, false, false};
+    const bool eq_expected[] = {true, false, false, true, false, true};
+
+    auto check = [&](const Value &small, const Value &big, const Value &same) {
+        for (int i = 0; i < 6; i++) {
+            cmp_kernel_t kernel = get_cmp_kernel(small.get_type_id(), big.get_type_id(), cmp_types[i]);
+            ASSERT_EQ(less_expected[i], kernel(small, big) == CmpResult::kTrue);
+            ASSERT_EQ(eq_expected[i], kernel(same, big) == CmpResult::kTrue);
+        }
+    };
+
+    // ********************* test 1 ********************* //
+    check(Value(1), Value(2), Value(2));
+    check(Value(static_cast<decimal_t>(1.5)), Value(static_cast<decimal_t>(2.5)), Value(static_cast<decimal_t>(2.5)));
+    check(Value(1), Value(static_cast<decimal_t>(2.0)), Value(2));
+    check(Value(static_cast<decimal_t>(1.5)), Value(2), Value(static_cast<decimal_t>(2.0)));
+    check(Value("apple"), Value("banana"), Value("banana"));
+    check(Value(false), Value(true), Value(true));
+    PRINT("***test 1 pass***");
+
+    // ********************* test 2 ********************* //
+    Value int_val(7);
+    Value dec_val(static_cast<decimal_t>(0.5));
+    ASSERT_EQ(Value(9), get_arith_kernel(INTEGER_T, INTEGER_T, ArithmeticType::kAdd)(int_val, Value(2)));
+    ASSERT_EQ(Value(3), get_arith_kernel(INTEGER_T, INTEGER_T, ArithmeticType::kDivide)(int_val, Value(2)));
+    ASSERT_EQ(Value(2), get_arith_kernel(INTEGER_T, INTEGER_T, ArithmeticType::kMin)(int_val, Value(2)));
+    ASSERT_EQ(Value(static_cast<decimal_t>(7.5)),
+        get_arith_kernel(INTEGER_T, DECIMAL_T, ArithmeticType::kAdd)(int_val, dec_val));
+    ASSERT_EQ(Value(static_cast<decimal_t>(-6.5)),
+        get_arith_kernel(DECIMAL_T, INTEGER_T, ArithmeticType::kMinus)(dec_val, int_val));
+    ASSERT_EQ(Value(static_cast<decimal_t>(3.5)),
+        get_arith_kernel(DECIMAL_T, INTEGER_T, ArithmeticType::kMultiply)(dec_val, int_val));
+    ASSERT_EQ(Value(static_cast<decimal_t>(7)),
+        get_arith_kernel(INTEGER_T, DECIMAL_T, ArithmeticType::kMax)(int_val, dec_val));
+    PRINT("***test 2 pass***");
+
+    // ********************* test 3 ********************* //
+    cmp_kernel_t kernel = get_cmp_kernel(BOOLEAN_T, INTEGER_T, ComparisonType::kEqual);
+    ASSERT_EQ(CMP_EQ(BOOLEAN_T, Value(true), Value(1)), kernel(Value(true), Value(1)));
+    arith_kernel_t arith = get_arith_kernel(BOOLEAN_T, BOOLEAN_T, ArithmeticType::kAdd);
+    ASSERT_EQ(TypeId::kInvalid, arith(Value(true), Value(true)).get_type_id());
+    PRINT("***test 3 pass***");
+
+    // ********************* test 4 ********************* //
+    Schema *schema = create_table_schema(std::vector<TypeId>{TypeId::kInteger, TypeId::kDecimal, TypeId::kChar},
+        std::vector<string_t>{"col1", "col2", "col3"}, std::vector<size_t_>{10});
+    char str[11];
+    fill_char_array("str", str);
+    std::vector<Value> values{Value(2), Value(static_cast<decimal_t>(1.5)), Value(str)};
+    Tuple tuple(&values, *schema);
+
+    ColumnValueExpression col1(0), col2(1), col3(2);
+    ComparisonExpression greater(std::vector<ExpressionAbstract*>{&col1, &col2}, ComparisonType::kGreaterThan);
+    ASSERT_EQ(Value(true), greater.evaluate(&tuple, schema));
+    ComparisonExpression bound(std::vector<ExpressionAbstract*>{&col2, &col1}, ComparisonType::kGreaterThan,
+        TypeId::kDecimal, TypeId::kInteger);
+    ASSERT_EQ(Value(false), bound.evaluate(&tuple, schema));
+    ComparisonExpression str_eq(std::vector<ExpressionAbstract*>{&col3, &col3}, ComparisonType::kEqual);
+    ASSERT_EQ(Value(true), str_eq.evaluate(&tuple, schema));
+    delete schema;
+    PRINT("***test 4 pass***");
+}
+
+/**
+ * Test List:
+ *   1. the AVX2 kernels select the same rows as the scalar ones, for each comparison, either side
+ *      of the constant, and the lengths not aligned to the registers
+ *   2. the rows are selected from the selection of the previous predicate, e.g. a range
+ */
+TEST(ValueKernelTest, SimdSelectTest) {
+    PRINT("start the simd selection kernel tests...");
+    if (get_simd_sel_kernel(INTEGER_T, ComparisonType::kEqual) == nullptr)
+        GTEST_SKIP();
+
+    const ComparisonType cmp_types[] = {ComparisonType::kEqual, ComparisonType::kNotEqual,
+        ComparisonType::kLessThan, ComparisonType::kLessThanOrEqual,
+        ComparisonType::kGreaterThan, ComparisonType::kGreaterThanOrEqual};
+    const size_t_ num = 1021;
+    std::vector<integer_t> ints(num);
+    std::vector<decimal_t> decs(num);
+    for (size_t_ i = 0; i < num; i++) {
+        ints[i] = (i * 7919) % 100 - 50;
+        decs[i] = static_cast<decimal_t>(ints[i]) / 4;
+    }
+    integer_t int_val = 3;
+    decimal_t dec_val = 0.75;
+    std::vector<int> expected(num), selected(num);
+
+    // ********************* test 1 ********************* //
+    auto check = [&](const char *col, const char *val, TypeId type_id, size_t_ rows) {
+        for (auto cmp_type : cmp_types) {
+            sel_kernel_t simd = get_simd_sel_kernel(type_id, cmp_type);
+            sel_kernel_t scalar = type_id == INTEGER_T ? select_sel_kernel<TypeId::kInteger, TypeId::kInteger>(cmp_type)
+                : select_sel_kernel<TypeId::kDecimal, TypeId::kDecimal>(cmp_type);
+            size_t_ cnt = scalar(col, false, val, true, nullptr, rows, expected.data());
+            ASSERT_EQ(cnt, simd(col, false, val, true, nullptr, rows, selected.data()));
+            ASSERT_TRUE(std::equal(expected.begin(), expected.begin() + cnt, selected.begin()));
+
+            cnt = scalar(val, true, col, false, nullptr, rows, expected.data());
+            ASSERT_EQ(cnt, simd(val, true, col, false, nullptr, rows, selected.data()));
+            ASSERT_TRUE(std::equal(expected.begin(), expected.begin() + cnt, selected.begin()));
+        }
+    };
+    for (size_t_ rows : {num, static_cast<size_t_>(1), static_cast<size_t_>(64), static_cast<size_t_>(67)}) {
+        check(reinterpret_cast<char*>(ints.data()), reinterpret_cast<char*>(&int_val), INTEGER_T, rows);
+        check(reinterpret_cast<char*>(decs.data()), reinterpret_cast<char*>(&dec_val), DECIMAL_T, rows);
+    }
+    PRINT("***test 1 pass***");
+
+    // ********************* test 2 ********************* //
+    // -10 <= col < 3, the second predicate works on the selection in place
+    integer_t low = -10;
+    const char *col = reinterpret_cast<char*>(ints.data());
+    size_t_ cnt = get_simd_sel_kernel(INTEGER_T, ComparisonType::kGreaterThanOrEqual)(
+        col, false, reinterpret_cast<char*>(&low), true, nullptr, num, selected.data());
+    cnt = get_simd_sel_kernel(INTEGER_T, ComparisonType::kLessThan)(
+        col, false, reinterpret_cast<char*>(&int_val), true, selected.data(), cnt, selected.data());
+    size_t_ expected_cnt = 0;
+    for (size_t_ i = 0; i < num; i++)
+        if (ints[i] >= low && ints[i] < int_val)
+            expected[expected_cnt++] = i;
+    ASSERT_EQ(expected_cnt, cnt);
+    ASSERT_TRUE(std::equal(expected.begin(), expected.begin() + cnt, selected.begin()));
+    PRINT("***test 2 pass***");
+}
+
+/**
+ * compare the integers with the CMP_* macros and the kernels, the kernel is selected
+ * before the loop just like the comparison expression does
+ */
+TEST(ValueKernelTest, Benchmark) {
+    PRINT("start the value kernel benchmark...");
+    const int value_num = 1024;
+    const int round = 10000;
+    std::vector<Value> values;
+    for (int i = 0; i < value_num; i++)
+        values.push_back(Value(static_cast<integer_t>((i * 7919) % value_num)));
+    Value pivot(static_cast<integer_t>(value_num / 2));
+
+    auto start = std::chrono::steady_clock::now();
+    integer_t macro_cnt = 0;
+    for (int r = 0; r < round; r++)
+        for (int i = 0; i < value_num; i++)
+            if (CMP_LESS(values[i].get_type_id(), values[i], pivot) == CmpResult::kTrue)
+                macro_cnt++;
+    auto mid = std::chrono::steady_clock::now();
+
+    cmp_kernel_t kernel = get_cmp_kernel(INTEGER_T, INTEGER_T, ComparisonType::kLessThan);
+    integer_t kernel_cnt = 0;
+    for (int r = 0; r < round; r++)
+        for (int i = 0; i < value_num; i++)
+            if (kernel(values[i], pivot) == CmpResult::kTrue)
+                kernel_cnt++;
+    auto end = std::chrono::steady_clock::now();
+    ASSERT_EQ(macro_cnt, kernel_cnt);
+
+    auto macro_us = std::chrono::duration_cast<std::chrono::microseconds>(mid - start).count();
+    auto kernel_us = std::chrono::duration_cast<std::chrono::microseconds>(end - mid).count();
+    PRINT("comparisons:", value_num * round, "CMP_LESS:", macro_us, "us", "kernel:", kernel_us, "us");
+
+    // select the rows of the batches with the scalar and the AVX2 kernels
+    std::vector<integer_t> col(value_num);
+    for (int i = 0; i < value_num; i++)
+        col[i] = values[i].get_value<integer_t>();
+    integer_t val = pivot.get_value<integer_t>();
+    std::vector<int> sel(value_num);
+    sel_kernel_t scalar = select_sel_kernel<TypeId::kInteger, TypeId::kInteger>(ComparisonType::kLessThan);
+    sel_kernel_t simd = get_simd_sel_kernel(INTEGER_T, ComparisonType::kLessThan);
+    if (simd == nullptr)
+        return;
+
+    start = std::chrono::steady_clock::now();
+    integer_t scalar_cnt = 0;
+    for (int r = 0; r < round; r++)
+        scalar_cnt += scalar(reinterpret_cast<char*>(col.data()), false, reinterpret_cast<char*>(&val), true,
+            nullptr, value_num, sel.data());
+    mid = std::chrono::steady_clock::now();
+    integer_t simd_cnt = 0;
+    for (int r = 0; r < round; r++)
+        simd_cnt += simd(reinterpret_cast<char*>(col.data()), false, reinterpret_cast<char*>(&val), true,
+            nullptr, value_num, sel.data());
+    end = std::chrono::steady_clock::now();
+    ASSERT_EQ(macro_cnt, scalar_cnt);
+    ASSERT_EQ(macro_cnt, simd_cnt);
+
+    auto scalar_us = std::chrono::duration_cast<std::chrono::microseconds>(mid - start).count();
+    auto simd_us = std::chrono::duration_cast<std::chrono::microseconds>(end - mid).count();
+    PRINT("selections:", value_num * round, "scalar:", scalar_us, "us", "avx2:", simd_us, "us");
+}
+
+} // namespace dawn
@@ -0,0 +1,91 @@
+#include "gtest/gtest.h"
+#include "data/values.h"
+#include "util/util.h"
+
+#include <vector>
+#include <utility>
+
+namespace dawn {
+
+/**
+ * Test List:
+ *   1. short strings are stored in the Value, and the long ones on the heap
+ *   2. copy, move and swap the values between the inline and heap strings
+ *   3. values are moved instead of copied when the vector grows
+ *   4. the padded string is filled with 0, it's equal to the one constructed from the same string
+ */
+TEST(ValueStorageTest, InlineStringTest) {
+    PRINT("start the value storage tests...");
+    string_t short_str("apple");
+    string_t long_str(100, 'x');
+
+    // ********************* test 1 ********************* //
+    Value short_val(short_str);
+    Value long_val(long_str);
+    ASSERT_TRUE(short_val.is_inline_str());
+    ASSERT_FALSE(long_val.is_inline_str());
+    ASSERT_EQ(short_str, short_val.to_string());
+    ASSERT_EQ(long_str, long_val.to_string());
+    ASSERT_FALSE(Value(1).is_inline_str());
+    PRINT("***test 1 pass***");
+
+    // ********************* test 2 ********************* //
+    Value copied(short_val);
+    ASSERT_TRUE(copied.is_inline_str());
+    ASSERT_NE(copied.get_value<char*>(), short_val.get_value<char*>());
+    ASSERT_EQ(short_val, copied);
+
+    char *heap_str = long_val.get_value<char*>();
+    Value moved(std::move(long_val));
+    ASSERT_EQ(heap_str, moved.get_value<char*>());
+    ASSERT_EQ(TypeId::kInvalid, long_val.get_type_id());
+
+    Value inline_moved(std::move(copied));
+    ASSERT_TRUE(inline_moved.is_inline_str());
+    ASSERT_EQ(short_val, inline_moved);
+
+    // assign between the inline and heap strings, and other types
+    Value val(3);
+    val = moved;
+    ASSERT_EQ(long_str, val.to_string());
+    val = short_val;
+    ASSERT_TRUE(val.is_inline_str());
+    ASSERT_EQ(short_val, val);
+    val = Value(static_cast<decimal_t>(1.5));
+    ASSERT_EQ(Value(static_cast<decimal_t>(1.5)), val);
+    val = std::move(moved);
+    ASSERT_EQ(long_str, val.to_string());
+
+    Value lhs(short_str);
+    Value rhs(long_str);
+    lhs.swap(rhs);
+    ASSERT_EQ(long_str, lhs.to_string());
+    ASSERT_EQ(short_str, rhs.to_string());
+    ASSERT_TRUE(rhs.is_inline_str());
+    PRINT("***test 2 pass***");
+
+    // ********************* test 3 ********************* //
+    std::vector<Value> values;
+    for (int i = 0; i < 100; i++)
+        values.push_back(Value(std::to_string(i)));
+    for (int i = 0; i < 100; i++) {
+        ASSERT_TRUE(values[i].is_inline_str());
+        ASSERT_EQ(std::to_string(i), values[i].to_string());
+    }
+    PRINT("***test 3 pass***");
+
+    // ********************* test 4 ********************* //
+    char stored[10] = {'a', 'p', 'p', 'l', 'e', '\0', 'z', 'z', 'z', 'z'};
+    Value padded;
+    padded.construct_padded(stored, 10);
+    ASSERT_EQ(10, padded.get_char_size());
+    char expected[11];
+    fill_char_array(short_str, expected);
+    memset(expected + short_str.length(), 0, 11 - short_str.length());
+    Value expected_val(expected, TypeId::kChar, 10);
+    ASSERT_EQ(expected_val, padded);
+    ASSERT_EQ(expected_val.get_hash_value(), padded.get_hash_value());
+    PRINT("***test 4 pass***");
+}
+
+} // namespace dawn
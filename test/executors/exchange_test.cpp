@@ -0,0 +1,223 @@
+#include <memory>
+#include <thread>
+
+#include "gtest/gtest.h"
+#include "test_util.h"
+#include "table/schema.h"
+#include "manager/db_manager.h"
+#include "executors/gather_executor.h"
+#include "executors/repartition_executor.h"
+#include "executors/external_sort_executor.h"
+
+namespace dawn {
+
+extern std::unique_ptr<DBManager> db_manager;
+
+const char *meta = "test";
+const char *mtdf = "test.mtd";
+const char *dbf = "test.db";
+const char *logf = "test.log";
+
+class ExchangeTest : public testing::Test {
+public:
+    void SetUp() {
+        DBManager::set_default_pool_size(50);
+        remove(mtdf);
+        remove(dbf);
+        remove(logf);
+    }
+
+    void TearDown() {
+        remove(mtdf);
+        remove(dbf);
+        remove(logf);
+    }
+};
+
+/**
+ * column types:
+ * ---------------------------------------
+ * | integer (key) | integer (seq) | char (20) |
+ * ---------------------------------------
+ *
+ * Test List:
+ *   1. the threads are taken from the query's budget and returned
+ *   2. gather the workers' tuples with fewer threads than the workers
+ *   3. repartition the producers' tuples, the same keys go to the same consumer
+ *   4. gather the consumers of a repartition and close them before they finish
+ *   5. the consumers of a repartition get a thread each even if the budget is used up
+ */
+TEST_F(ExchangeTest, BasicTest) {
+    PRINT("start the exchange tests...");
+    Schema *schema = create_table_schema(std::vector<TypeId>{TypeId::kInteger, TypeId::kInteger, TypeId::kChar},
+        std::vector<string_t>{"col1", "col2", "col3"}, std::vector<size_t_>{20});
+
+    db_manager.reset(new DBManager(meta, true));
+    ASSERT_TRUE(db_manager->get_status());
+    BufferPoolManager *bpm = db_manager->get_buffer_pool_manager();
+
+    // each producer has its own tuples, seq is unique among all of them
+    const int producer_num = 4;
+    const integer_t tuple_num = 5000;
+    std::vector<std::vector<Tuple>> tuples(producer_num);
+    char str[21];
+    for (integer_t i = 0; i < tuple_num * producer_num; i++) {
+        fill_char_array("str" + std::to_string(i), str);
+        std::vector<Value> values{Value(i % 777), Value(i), Value(str)};
+        tuples[i % producer_num].push_back(Tuple(&values, *schema));
+    }
+
+    // ********************* test 1 ********************* //
+    {
+        ExecutorContext exec_ctx(bpm, 4);
+        ASSERT_EQ(4, exec_ctx.get_thread_budget());
+        ASSERT_EQ(3, exec_ctx.acquire_threads(3));
+        ASSERT_EQ(1, exec_ctx.acquire_threads(3));
+        // at least 1 thread is granted
+        ASSERT_EQ(1, exec_ctx.acquire_threads(2));
+        exec_ctx.release_threads(5);
+        ASSERT_EQ(2, exec_ctx.acquire_threads(2));
+        // the minimum is granted beyond the budget
+        ASSERT_EQ(3, exec_ctx.acquire_threads(3, 3));
+        exec_ctx.release_threads(5);
+    }
+    PRINT("***test 1 pass***");
+
+    // ********************* test 2 ********************* //
+    {
+        ExecutorContext exec_ctx(bpm, 2);
+        std::vector<std::unique_ptr<TupleListExecutor>> lists;
+        std::vector<ExecutorAbstract*> workers;
+        for (int i = 0; i < producer_num; i++) {
+            lists.emplace_back(new TupleListExecutor(&exec_ctx, &tuples[i]));
+            workers.push_back(lists.back().get());
+        }
+        GatherExecutor gather(&exec_ctx, workers);
+        std::vector<int> seen(tuple_num * producer_num, 0);
+        Tuple tuple;
+        gather.open();
+        ASSERT_EQ(2, gather.get_thread_num());
+        while (gather.get_next(&tuple))
+            seen[tuple.get_value(*schema, 1).get_value<integer_t>()]++;
+        gather.close();
+        for (auto cnt : seen)
+            ASSERT_EQ(1, cnt);
+        ASSERT_EQ(2, exec_ctx.acquire_threads(2));
+    }
+    PRINT("***test 2 pass***");
+
+    // every consumer of the repartition has its own thread
+    ExecutorContext exec_ctx(bpm, 16);
+    std::vector<std::unique_ptr<TupleListExecutor>> lists;
+    std::vector<ExecutorAbstract*> producers;
+    for (int i = 0; i < producer_num; i++) {
+        lists.emplace_back(new TupleListExecutor(&exec_ctx, &tuples[i]));
+        producers.push_back(lists.back().get());
+    }
+
+    // ********************* test 3 ********************* //
+    {
+        const int partition_num = 3;
+        RepartitionExchange exchange(&exec_ctx, producers, schema, std::vector<offset_t>{0}, partition_num);
+        std::vector<std::unique_ptr<RepartitionExecutor>> consumers;
+        for (int i = 0; i < partition_num; i++)
+            consumers.emplace_back(new RepartitionExecutor(&exec_ctx, &exchange, i));
+
+        for (int round = 0; round < 2; round++) {
+            // the partition each key goes to, -1 if it's not seen yet
+            std::vector<int> key_parts(777, -1);
+            std::vector<int> seen(tuple_num * producer_num, 0);
+            std::vector<std::vector<Tuple>> outputs(partition_num);
+            for (auto &consumer : consumers)
+                consumer->open();
+            std::vector<std::thread> threads;
+            for (int i = 0; i < partition_num; i++) {
+                threads.emplace_back([&, i] {
+                    Tuple tuple;
+                    while (consumers[i]->get_next(&tuple))
+                        outputs[i].push_back(tuple);
+                });
+            }
+            for (auto &thd : threads)
+                thd.join();
+            for (auto &consumer : consumers)
+                consumer->close();
+
+            for (int i = 0; i < partition_num; i++) {
+                for (auto &tuple : outputs[i]) {
+                    integer_t key = tuple.get_value(*schema, 0).get_value<integer_t>();
+                    if (key_parts[key] == -1)
+                        key_parts[key] = i;
+                    ASSERT_EQ(key_parts[key], i);
+                    seen[tuple.get_value(*schema, 1).get_value<integer_t>()]++;
+                }
+            }
+            for (auto cnt : seen)
+                ASSERT_EQ(1, cnt);
+        }
+    }
+    PRINT("***test 3 pass***");
+
+    // ********************* test 4 ********************* //
+    {
+        const int partition_num = 4;
+        RepartitionExchange exchange(&exec_ctx, producers, schema, std::vector<offset_t>{0}, partition_num);
+        std::vector<std::unique_ptr<RepartitionExecutor>> consumers;
+        std::vector<ExecutorAbstract*> workers;
+        for (int i = 0; i < partition_num; i++) {
+            consumers.emplace_back(new RepartitionExecutor(&exec_ctx, &exchange, i));
+            workers.push_back(consumers.back().get());
+        }
+        GatherExecutor gather(&exec_ctx, workers);
+
+        std::vector<int> seen(tuple_num * producer_num, 0);
+        Tuple tuple;
+        gather.open();
+        while (gather.get_next(&tuple))
+            seen[tuple.get_value(*schema, 1).get_value<integer_t>()]++;
+        gather.close();
+        for (auto cnt : seen)
+            ASSERT_EQ(1, cnt);
+
+        // the producers and the consumers are stopped
+        gather.open();
+        for (int i = 0; i < 10; i++)
+            ASSERT_TRUE(gather.get_next(&tuple));
+        gather.close();
+    }
+    PRINT("***test 4 pass***");
+
+    // ********************* test 5 ********************* //
+    {
+        ExecutorContext one_thread_ctx(bpm, 1);
+        const int partition_num = 3;
+        RepartitionExchange exchange(&one_thread_ctx, producers, schema, std::vector<offset_t>{0}, partition_num);
+        std::vector<std::unique_ptr<RepartitionExecutor>> consumers;
+        std::vector<std::unique_ptr<ExternalSortExecutor>> sorts;
+        std::vector<ExecutorAbstract*> workers;
+        for (int i = 0; i < partition_num; i++) {
+            consumers.emplace_back(new RepartitionExecutor(&one_thread_ctx, &exchange, i));
+            sorts.emplace_back(new ExternalSortExecutor(&one_thread_ctx, consumers.back().get(), schema,
+                std::vector<offset_t>{1}));
+            ASSERT_TRUE(sorts.back()->need_own_thread());
+            workers.push_back(sorts.back().get());
+        }
+        GatherExecutor gather(&one_thread_ctx, workers);
+
+        std::vector<int> seen(tuple_num * producer_num, 0);
+        Tuple tuple;
+        gather.open();
+        ASSERT_EQ(partition_num, gather.get_thread_num());
+        while (gather.get_next(&tuple))
+            seen[tuple.get_value(*schema, 1).get_value<integer_t>()]++;
+        gather.close();
+        for (auto cnt : seen)
+            ASSERT_EQ(1, cnt);
+    }
+    PRINT("***test 5 pass***");
+
+    db_manager.reset(nullptr);
+    delete schema;
+}
+
+} // namespace dawn
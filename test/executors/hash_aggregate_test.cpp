@@ -0,0 +1,187 @@
+#include <map>
+
+#include "gtest/gtest.h"
+#include "test_util.h"
+#include "table/schema.h"
+#include "manager/db_manager.h"
+#include "executors/hash_aggregate_executor.h"
+#include "sql/expressions/col_value_expr.h"
+
+namespace dawn {
+
+extern std::unique_ptr<DBManager> db_manager;
+
+const char *meta = "test";
+const char *mtdf = "test.mtd";
+const char *dbf = "test.db";
+const char *logf = "test.log";
+
+class HashAggregateTest : public testing::Test {
+public:
+    void SetUp() {
+        DBManager::set_default_pool_size(50);
+        remove(mtdf);
+        remove(dbf);
+        remove(logf);
+    }
+
+    void TearDown() {
+        remove(mtdf);
+        remove(dbf);
+        remove(logf);
+    }
+};
+
+/** the expected aggregations of a group */
+struct GroupResult {
+    integer_t cnt = 0;
+    integer_t sum = 0;
+    integer_t min = 0;
+    integer_t max = 0;
+};
+
+/**
+ * input column types:
+ * ------------------------------------------
+ * | integer (key) | integer (val) | char (100) |
+ * ------------------------------------------
+ * output column types:
+ * ----------------------------------------------------------------
+ * | integer (key) | COUNT(*) | SUM(val) | MIN(val) | MAX(val) |
+ * ----------------------------------------------------------------
+ *
+ * Test List:
+ *   1. group by the key in the memory
+ *   2. too many groups to be held by the table, they're spilled to the partitions
+ *   3. no GROUP BY, the child is empty or not
+ */
+TEST_F(HashAggregateTest, BasicTest) {
+    PRINT("start the hash aggregate tests...");
+    Schema *schema = create_table_schema(std::vector<TypeId>{TypeId::kInteger, TypeId::kInteger, TypeId::kChar},
+        std::vector<string_t>{"col1", "col2", "col3"}, std::vector<size_t_>{100});
+    Schema *out_schema = create_table_schema(std::vector<TypeId>{TypeId::kInteger, TypeId::kInteger,
+        TypeId::kInteger, TypeId::kInteger, TypeId::kInteger},
+        std::vector<string_t>{"key", "cnt", "sum", "min", "max"}, std::vector<size_t_>{});
+    Schema *total_schema = create_table_schema(std::vector<TypeId>{TypeId::kInteger, TypeId::kInteger},
+        std::vector<string_t>{"cnt", "sum"}, std::vector<size_t_>{});
+
+    db_manager.reset(new DBManager(meta, true));
+    ASSERT_TRUE(db_manager->get_status());
+    ExecutorContext exec_ctx(db_manager->get_buffer_pool_manager());
+
+    ColumnValueExpression key_expr(0), val_expr(1);
+    std::vector<AggregationType> agg_types{AggregationType::kCountAggregate, AggregationType::kSumAggregate,
+        AggregationType::kMinAggregate, AggregationType::kMaxAggregate};
+    std::vector<ExpressionAbstract*> agg_exprs{nullptr, &val_expr, &val_expr, &val_expr};
+
+    char str[101];
+    auto make_tuples = [&](integer_t num, integer_t mod, std::vector<Tuple> *tuples,
+        std::map<integer_t, GroupResult> *expected) {
+        tuples->clear();
+        expected->clear();
+        for (integer_t i = 0; i < num; i++) {
+            integer_t key = (i * 7919) % mod;
+            integer_t val = i % 97 - 40;
+            fill_char_array("str" + std::to_string(i), str);
+            std::vector<Value> values{Value(key), Value(val), Value(str)};
+            tuples->push_back(Tuple(&values, *schema));
+
+            GroupResult &res = (*expected)[key];
+            res.min = res.cnt == 0 ? val : std::min(res.min, val);
+            res.max = res.cnt == 0 ? val : std::max(res.max, val);
+            res.sum += val;
+            res.cnt++;
+        }
+    };
+
+    auto check_groups = [&](HashAggregateExecutor *agg, const std::map<integer_t, GroupResult> &expected) {
+        std::map<integer_t, GroupResult> results;
+        Tuple tuple;
+        agg->open();
+        while (agg->get_next(&tuple)) {
+            integer_t key = tuple.get_value(*out_schema, 0).get_value<integer_t>();
+            ASSERT_EQ(0, results.count(key));
+            GroupResult &res = results[key];
+            res.cnt = tuple.get_value(*out_schema, 1).get_value<integer_t>();
+            res.sum = tuple.get_value(*out_schema, 2).get_value<integer_t>();
+            res.min = tuple.get_value(*out_schema, 3).get_value<integer_t>();
+            res.max = tuple.get_value(*out_schema, 4).get_value<integer_t>();
+        }
+        ASSERT_EQ(expected.size(), results.size());
+        for (auto &kv : expected) {
+            const GroupResult &res = results[kv.first];
+            ASSERT_EQ(kv.second.cnt, res.cnt);
+            ASSERT_EQ(kv.second.sum, res.sum);
+            ASSERT_EQ(kv.second.min, res.min);
+            ASSERT_EQ(kv.second.max, res.max);
+        }
+    };
+
+    // ********************* test 1 ********************* //
+    {
+        std::vector<Tuple> tuples;
+        std::map<integer_t, GroupResult> expected;
+        make_tuples(3000, 100, &tuples, &expected);
+        TupleListExecutor child(&exec_ctx, &tuples);
+        HashAggregateExecutor agg(&exec_ctx, &child, std::vector<ExpressionAbstract*>{&key_expr},
+            agg_types, agg_exprs, schema, out_schema);
+        check_groups(&agg, expected);
+        ASSERT_EQ(0, agg.get_spilled_partition_num());
+        agg.close();
+    }
+    PRINT("***test 1 pass***");
+
+    // ********************* test 2 ********************* //
+    {
+        std::vector<Tuple> tuples;
+        std::map<integer_t, GroupResult> expected;
+        make_tuples(20000, 6000, &tuples, &expected);
+        TupleListExecutor child(&exec_ctx, &tuples);
+        HashAggregateExecutor agg(&exec_ctx, &child, std::vector<ExpressionAbstract*>{&key_expr},
+            agg_types, agg_exprs, schema, out_schema);
+        check_groups(&agg, expected);
+        ASSERT_LT(0, agg.get_spilled_partition_num());
+        agg.close();
+
+        // the pages of the partitions are all returned
+        check_groups(&agg, expected);
+        agg.close();
+    }
+    PRINT("***test 2 pass***");
+
+    // ********************* test 3 ********************* //
+    {
+        std::vector<Tuple> tuples;
+        std::map<integer_t, GroupResult> expected;
+        TupleListExecutor child(&exec_ctx, &tuples);
+        HashAggregateExecutor agg(&exec_ctx, &child, std::vector<ExpressionAbstract*>{},
+            std::vector<AggregationType>{AggregationType::kCountAggregate, AggregationType::kSumAggregate},
+            std::vector<ExpressionAbstract*>{nullptr, &val_expr}, schema, total_schema);
+        Tuple tuple;
+        agg.open();
+        ASSERT_TRUE(agg.get_next(&tuple));
+        ASSERT_EQ(Value(0), tuple.get_value(*total_schema, 0));
+        ASSERT_EQ(Value(0), tuple.get_value(*total_schema, 1));
+        ASSERT_FALSE(agg.get_next(&tuple));
+        agg.close();
+
+        make_tuples(1000, 10, &tuples, &expected);
+        integer_t sum = 0;
+        for (auto &kv : expected)
+            sum += kv.second.sum;
+        agg.open();
+        ASSERT_TRUE(agg.get_next(&tuple));
+        ASSERT_EQ(Value(1000), tuple.get_value(*total_schema, 0));
+        ASSERT_EQ(Value(sum), tuple.get_value(*total_schema, 1));
+        ASSERT_FALSE(agg.get_next(&tuple));
+        agg.close();
+    }
+    PRINT("***test 3 pass***");
+
+    db_manager.reset(nullptr);
+    delete schema;
+    delete out_schema;
+    delete total_schema;
+}
+
+} // namespace dawn
@@ -0,0 +1,199 @@
+#include <map>
+
+#include "gtest/gtest.h"
+#include "test_util.h"
+#include "table/schema.h"
+#include "manager/db_manager.h"
+#include "executors/hash_join_executor.h"
+
+namespace dawn {
+
+extern std::unique_ptr<DBManager> db_manager;
+
+const char *meta = "test";
+const char *mtdf = "test.mtd";
+const char *dbf = "test.db";
+const char *logf = "test.log";
+
+class HashJoinTest : public testing::Test {
+public:
+    void SetUp() {
+        DBManager::set_default_pool_size(50);
+        remove(mtdf);
+        remove(dbf);
+        remove(logf);
+    }
+
+    void TearDown() {
+        remove(mtdf);
+        remove(dbf);
+        remove(logf);
+    }
+};
+
+/**
+ * left column types:
+ * --------------------------------------
+ * | integer | char (100) | varchar     |
+ * --------------------------------------
+ * right column types:
+ * ------------------------
+ * | integer | integer    |
+ * ------------------------
+ * join on left.col1 = right.col1
+ *
+ * @return number of the output tuples, each one is checked and its key is counted in key_cnt
+ */
+size_t_ run_join(HashJoinExecutor *join, const Schema *out_schema, std::map<integer_t, size_t_> *key_cnt) {
+    Tuple tuple;
+    size_t_ cnt = 0;
+    join->open();
+    while (join->get_next(&tuple)) {
+        integer_t left_key = tuple.get_value(*out_schema, 0).get_value<integer_t>();
+        integer_t right_key = tuple.get_value(*out_schema, 3).get_value<integer_t>();
+        EXPECT_EQ(left_key, right_key);
+        EXPECT_EQ(Value(right_key * 2), tuple.get_value(*out_schema, 4));
+        EXPECT_EQ(Value("str" + std::to_string(left_key)), tuple.get_value(*out_schema, 2));
+        (*key_cnt)[left_key]++;
+        cnt++;
+    }
+    return cnt;
+}
+
+/**
+ * Test List:
+ *   1. the build side fits in the memory, no partition is created
+ *   2. the build side exceeds the memory, both sides are partitioned
+ *   3. most build tuples have the same key, the partition is loaded chunk by chunk
+ *   4. join on the char columns of different widths
+ */
+TEST_F(HashJoinTest, BasicTest) {
+    PRINT("start the hash join tests...");
+    Schema *left_schema = create_table_schema(
+        std::vector<TypeId>{TypeId::kInteger, TypeId::kChar, TypeId::kVarchar},
+        std::vector<string_t>{"l_col1", "l_col2", "l_col3"}, std::vector<size_t_>{100, 100});
+    Schema *right_schema = create_table_schema(std::vector<TypeId>{TypeId::kInteger, TypeId::kInteger},
+        std::vector<string_t>{"r_col1", "r_col2"}, std::vector<size_t_>{});
+
+    db_manager.reset(new DBManager(meta, true));
+    ASSERT_TRUE(db_manager->get_status());
+    ExecutorContext exec_ctx(db_manager->get_buffer_pool_manager());
+
+    char str[101];
+    auto left_tuple = [&](integer_t key) {
+        fill_char_array("char" + std::to_string(key), str);
+        std::vector<Value> values{Value(key), Value(str), Value("str" + std::to_string(key))};
+        return Tuple(&values, *left_schema);
+    };
+    auto right_tuple = [&](integer_t key) {
+        std::vector<Value> values{Value(key), Value(key * 2)};
+        return Tuple(&values, *right_schema);
+    };
+
+    // ********************* test 1 ********************* //
+    {
+        std::vector<Tuple> lefts, rights;
+        for (integer_t i = 0; i < 100; i++)
+            lefts.push_back(left_tuple(i));
+        for (integer_t i = 0; i < 1000; i++)
+            rights.push_back(right_tuple(i % 200));
+
+        TupleListExecutor left(&exec_ctx, &lefts), right(&exec_ctx, &rights);
+        HashJoinExecutor join(&exec_ctx, &left, &right, left_schema, right_schema,
+            std::vector<offset_t>{0}, std::vector<offset_t>{0});
+        std::map<integer_t, size_t_> key_cnt;
+        ASSERT_EQ(500, run_join(&join, join.get_output_schema(), &key_cnt));
+        ASSERT_EQ(0, join.get_partition_num());
+        join.close();
+        ASSERT_EQ(100, key_cnt.size());
+        for (auto &kc : key_cnt)
+            ASSERT_EQ(5, kc.second);
+    }
+    PRINT("***test 1 pass***");
+
+    // ********************* test 2 ********************* //
+    {
+        integer_t left_num = 5000;
+        std::vector<Tuple> lefts, rights;
+        for (integer_t i = 0; i < left_num; i++)
+            lefts.push_back(left_tuple(i));
+        for (integer_t i = 0; i < left_num * 2; i += 3)
+            rights.push_back(right_tuple(i));
+
+        TupleListExecutor left(&exec_ctx, &lefts), right(&exec_ctx, &rights);
+        HashJoinExecutor join(&exec_ctx, &left, &right, left_schema, right_schema,
+            std::vector<offset_t>{0}, std::vector<offset_t>{0});
+
+        // it could be opened again after being closed
+        for (int round = 0; round < 2; round++) {
+            std::map<integer_t, size_t_> key_cnt;
+            ASSERT_EQ((left_num + 2) / 3, run_join(&join, join.get_output_schema(), &key_cnt));
+            ASSERT_LT(0, join.get_partition_num());
+            join.close();
+            for (auto &kc : key_cnt) {
+                ASSERT_EQ(0, kc.first % 3);
+                ASSERT_EQ(1, kc.second);
+            }
+        }
+    }
+    PRINT("***test 2 pass***");
+
+    // ********************* test 3 ********************* //
+    {
+        std::vector<Tuple> lefts, rights;
+        for (integer_t i = 0; i < 3000; i++)
+            lefts.push_back(left_tuple(i % 50 == 0 ? i : 7));
+        for (integer_t i = 0; i < 3000; i += 10)
+            rights.push_back(right_tuple(i < 50 ? 7 : i));
+
+        TupleListExecutor left(&exec_ctx, &lefts), right(&exec_ctx, &rights);
+        HashJoinExecutor join(&exec_ctx, &left, &right, left_schema, right_schema,
+            std::vector<offset_t>{0}, std::vector<offset_t>{0});
+        std::map<integer_t, size_t_> key_cnt;
+        size_t_ cnt = run_join(&join, join.get_output_schema(), &key_cnt);
+        ASSERT_LT(0, join.get_partition_num());
+        join.close();
+
+        // 2940 tuples of key 7 match 5 tuples, and keys 50, 100 ... match one tuple each
+        ASSERT_EQ(2940 * 5, key_cnt[7]);
+        ASSERT_EQ(2940 * 5 + 59, cnt);
+    }
+    PRINT("***test 3 pass***");
+
+    // ********************* test 4 ********************* //
+    Schema *narrow_schema = create_table_schema(std::vector<TypeId>{TypeId::kChar, TypeId::kInteger},
+        std::vector<string_t>{"n_col1", "n_col2"}, std::vector<size_t_>{20});
+    {
+        std::vector<Tuple> lefts, rights;
+        for (integer_t i = 0; i < 100; i++)
+            lefts.push_back(left_tuple(i));
+        for (integer_t i = 0; i < 200; i += 2) {
+            std::vector<Value> values{Value("char" + std::to_string(i)), Value(i)};
+            rights.push_back(Tuple(&values, *narrow_schema));
+        }
+
+        TupleListExecutor left(&exec_ctx, &lefts), right(&exec_ctx, &rights);
+        HashJoinExecutor join(&exec_ctx, &left, &right, left_schema, narrow_schema,
+            std::vector<offset_t>{1}, std::vector<offset_t>{0});
+        const Schema *out_schema = join.get_output_schema();
+        Tuple tuple;
+        size_t_ cnt = 0;
+        join.open();
+        while (join.get_next(&tuple)) {
+            integer_t key = tuple.get_value(*out_schema, 0).get_value<integer_t>();
+            ASSERT_EQ(0, key % 2);
+            ASSERT_EQ(Value(key), tuple.get_value(*out_schema, 4));
+            cnt++;
+        }
+        join.close();
+        ASSERT_EQ(50, cnt);
+    }
+    PRINT("***test 4 pass***");
+
+    db_manager.reset(nullptr);
+    delete left_schema;
+    delete right_schema;
+    delete narrow_schema;
+}
+
+} // namespace dawn
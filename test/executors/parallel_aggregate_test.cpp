@@ -0,0 +1,158 @@
+#include <memory>
+
+#include "gtest/gtest.h"
+#include "test_util.h"
+#include "table/schema.h"
+#include "manager/db_manager.h"
+#include "executors/aggregate_executor.h"
+#include "executors/gather_executor.h"
+
+namespace dawn {
+
+extern std::unique_ptr<DBManager> db_manager;
+
+const char *meta = "test";
+const char *mtdf = "test.mtd";
+const char *dbf = "test.db";
+const char *logf = "test.log";
+
+class ParallelAggregateTest : public testing::Test {
+public:
+    void SetUp() {
+        DBManager::set_default_pool_size(50);
+        remove(mtdf);
+        remove(dbf);
+        remove(logf);
+    }
+
+    void TearDown() {
+        remove(mtdf);
+        remove(dbf);
+        remove(logf);
+    }
+};
+
+/**
+ * input column types:
+ * -----------------------------------------
+ * | integer (key) | decimal | char (20) |
+ * -----------------------------------------
+ * output column types:
+ * -----------------------------------------------------------------------------
+ * | COUNT(key) integer | SUM(key) integer | MIN(dec) | MAX(dec) | SUM(dec) |
+ * -----------------------------------------------------------------------------
+ *
+ * Test List:
+ *   1. aggregate in a single executor
+ *   2. the workers aggregate their own tuples, and their states are combined, some workers are empty
+ *   3. all the workers are empty
+ */
+TEST_F(ParallelAggregateTest, BasicTest) {
+    PRINT("start the parallel aggregate tests...");
+    Schema *schema = create_table_schema(std::vector<TypeId>{TypeId::kInteger, TypeId::kDecimal, TypeId::kChar},
+        std::vector<string_t>{"col1", "col2", "col3"}, std::vector<size_t_>{20});
+    Schema *out_schema = create_table_schema(std::vector<TypeId>{TypeId::kInteger, TypeId::kInteger,
+        TypeId::kDecimal, TypeId::kDecimal, TypeId::kDecimal},
+        std::vector<string_t>{"cnt", "sum", "min", "max", "dec_sum"});
+
+    db_manager.reset(new DBManager(meta, true));
+    ASSERT_TRUE(db_manager->get_status());
+    ExecutorContext exec_ctx(db_manager->get_buffer_pool_manager(), 2);
+
+    AggregateExpression cnt(AggregationType::kCountAggregate, 0), sum(AggregationType::kSumAggregate, 0),
+        min(AggregationType::kMinAggregate, 1), max(AggregationType::kMaxAggregate, 1),
+        dec_sum(AggregationType::kSumAggregate, 1);
+    std::vector<AggregateExpression*> aggs{&cnt, &sum, &min, &max, &dec_sum};
+
+    // the last worker has no tuples
+    const int worker_num = 5;
+    const integer_t tuple_num = 10000;
+    std::vector<Tuple> all_tuples;
+    std::vector<std::vector<Tuple>> tuples(worker_num);
+    integer_t expected_sum = 0;
+    decimal_t expected_min = 0, expected_max = 0, expected_dec_sum = 0;
+    char str[21];
+    for (integer_t i = 0; i < tuple_num; i++) {
+        decimal_t dec = static_cast<decimal_t>((i * 7919) % 1000) / 4 - 100;
+        fill_char_array("str" + std::to_string(i), str);
+        std::vector<Value> values{Value(i), Value(dec), Value(str)};
+        all_tuples.push_back(Tuple(&values, *schema));
+        tuples[i % (worker_num - 1)].push_back(all_tuples.back());
+
+        expected_sum += i;
+        expected_min = i == 0 ? dec : std::min(expected_min, dec);
+        expected_max = i == 0 ? dec : std::max(expected_max, dec);
+        expected_dec_sum += dec;
+    }
+
+    auto check_result = [&](ExecutorAbstract *agg, integer_t num) {
+        Tuple tuple;
+        agg->open();
+        ASSERT_TRUE(agg->get_next(&tuple));
+        ASSERT_EQ(Value(num), tuple.get_value(*out_schema, 0));
+        ASSERT_EQ(Value(num == 0 ? 0 : expected_sum), tuple.get_value(*out_schema, 1));
+        ASSERT_EQ(Value(num == 0 ? 0 : expected_min), tuple.get_value(*out_schema, 2));
+        ASSERT_EQ(Value(num == 0 ? 0 : expected_max), tuple.get_value(*out_schema, 3));
+        ASSERT_DOUBLE_EQ(num == 0 ? 0 : expected_dec_sum, tuple.get_value(*out_schema, 4).get_value<decimal_t>());
+        ASSERT_FALSE(agg->get_next(&tuple));
+        agg->close();
+    };
+
+    // ********************* test 1 ********************* //
+    {
+        TupleListExecutor child(&exec_ctx, &all_tuples);
+        AggregateExecutor agg(&exec_ctx, &child, aggs, AggregationPhase::kComplete, schema, out_schema);
+        check_result(&agg, tuple_num);
+    }
+    PRINT("***test 1 pass***");
+
+    // ********************* test 2 ********************* //
+    {
+        std::vector<std::unique_ptr<TupleListExecutor>> lists;
+        std::vector<std::unique_ptr<AggregateExecutor>> partials;
+        std::vector<ExecutorAbstract*> workers;
+        for (int i = 0; i < worker_num; i++) {
+            lists.emplace_back(new TupleListExecutor(&exec_ctx, &tuples[i]));
+            partials.emplace_back(new AggregateExecutor(&exec_ctx, lists.back().get(), aggs,
+                AggregationPhase::kPartial, schema, out_schema));
+            workers.push_back(partials.back().get());
+        }
+
+        // the empty worker outputs nothing
+        Tuple tuple;
+        partials.back()->open();
+        ASSERT_FALSE(partials.back()->get_next(&tuple));
+        partials.back()->close();
+
+        GatherExecutor gather(&exec_ctx, workers);
+        AggregateExecutor final_agg(&exec_ctx, &gather, aggs, AggregationPhase::kFinal, out_schema, out_schema);
+        check_result(&final_agg, tuple_num);
+        // run it again
+        check_result(&final_agg, tuple_num);
+    }
+    PRINT("***test 2 pass***");
+
+    // ********************* test 3 ********************* //
+    {
+        std::vector<Tuple> empty;
+        std::vector<std::unique_ptr<TupleListExecutor>> lists;
+        std::vector<std::unique_ptr<AggregateExecutor>> partials;
+        std::vector<ExecutorAbstract*> workers;
+        for (int i = 0; i < 3; i++) {
+            lists.emplace_back(new TupleListExecutor(&exec_ctx, &empty));
+            partials.emplace_back(new AggregateExecutor(&exec_ctx, lists.back().get(), aggs,
+                AggregationPhase::kPartial, schema, out_schema));
+            workers.push_back(partials.back().get());
+        }
+        GatherExecutor gather(&exec_ctx, workers);
+        AggregateExecutor final_agg(&exec_ctx, &gather, aggs, AggregationPhase::kFinal, out_schema, out_schema);
+        check_result(&final_agg, 0);
+    }
+    PRINT("***test 3 pass***");
+
+    db_manager.reset(nullptr);
+    delete schema;
+    delete out_schema;
+}
+
+} // namespace dawn
@@ -0,0 +1,164 @@
+#include <memory>
+
+#include "gtest/gtest.h"
+#include "table/schema.h"
+#include "manager/db_manager.h"
+#include "table/table.h"
+#include "table/morsel_queue.h"
+#include "executors/seq_scan_executor.h"
+#include "executors/selection_executor.h"
+#include "executors/proj_executor.h"
+#include "executors/gather_executor.h"
+#include "sql/expressions/col_value_expr.h"
+#include "sql/expressions/constant_expr.h"
+#include "sql/expressions/comparison_expr.h"
+
+namespace dawn {
+
+extern std::unique_ptr<DBManager> db_manager;
+
+/**
+ * table name: table
+ * column types:
+ * ---------------------------------------
+ * | integer (key) | integer | char (10) |
+ * ---------------------------------------
+ */
+string_t table_name("table");
+const char *meta = "test";
+const char *mtdf = "test.mtd";
+const char *dbf = "test.db";
+const char *logf = "test.log";
+
+class ParallelScanTest : public testing::Test {
+public:
+    void SetUp() {
+        DBManager::set_default_pool_size(50);
+        remove(mtdf);
+        remove(dbf);
+        remove(logf);
+    }
+
+    void TearDown() {
+        remove(mtdf);
+        remove(dbf);
+        remove(logf);
+    }
+};
+
+/** SELECT col1 FROM table WHERE col2 < 3, each worker has its own executors and expressions */
+struct WorkerPipeline {
+    WorkerPipeline(ExecutorContext *exec_ctx, Table *table, MorselQueue *morsels, Schema *tb_schema, Schema *out_schema)
+        : col1(0), col2(1), three(Value(3)), less(std::vector<ExpressionAbstract*>{&col2, &three}, ComparisonType::kLessThan),
+        scan(exec_ctx, table, morsels), selection(exec_ctx, &less, &scan, tb_schema),
+        projection(exec_ctx, &selection, std::vector<ExpressionAbstract*>{&col1}, tb_schema, out_schema) {}
+
+    ColumnValueExpression col1, col2;
+    ConstantExpression three;
+    ComparisonExpression less;
+    SeqScanExecutor scan;
+    SelectionExecutor selection;
+    ProjectionExecutor projection;
+};
+
+/**
+ * Test List:
+ *   1. the scans sharing the morsel queue output each tuple once, the queue starts over when it's reopened
+ *   2. the workers' pipelines are merged by the gather, opened again and closed before they finish
+ */
+TEST_F(ParallelScanTest, BasicTest) {
+    PRINT("start the parallel scan tests...");
+    Schema *tb_schema = create_table_schema(std::vector<TypeId>{TypeId::kInteger, TypeId::kInteger, TypeId::kChar},
+        std::vector<string_t>{"tb_col1", "tb_col2", "tb_col3"}, std::vector<size_t_>{10});
+    Schema *out_schema = create_table_schema(std::vector<TypeId>{TypeId::kInteger},
+        std::vector<string_t>{"col1"});
+    integer_t insert_num = 20000;
+
+    db_manager.reset(new DBManager(meta, true));
+    ASSERT_TRUE(db_manager->get_status());
+    BufferPoolManager *bpm = db_manager->get_buffer_pool_manager();
+
+    CatalogTable *catalog_table = db_manager->get_catalog()->get_catalog_table();
+    ASSERT_TRUE(catalog_table->create_table(table_name, *tb_schema));
+    TableMetaData *table_md = catalog_table->get_table_meta_data(table_name);
+    ASSERT_NE(nullptr, table_md);
+    Table *table = table_md->get_table();
+
+    char str[11];
+    for (integer_t i = 0; i < insert_num; i++) {
+        fill_char_array("str" + std::to_string(i % 10), str);
+        std::vector<Value> values{Value(i), Value(i % 10), Value(str)};
+        Tuple tuple(&values, *tb_schema);
+        ASSERT_TRUE(table->insert_tuple(&tuple, *tb_schema));
+    }
+
+    ExecutorContext exec_ctx(bpm);
+    MorselQueue morsels;
+
+    // ********************* test 1 ********************* //
+    {
+        SeqScanExecutor scan1(&exec_ctx, table, &morsels), scan2(&exec_ctx, table, &morsels);
+        for (int round = 0; round < 2; round++) {
+            std::vector<int> seen(insert_num, 0);
+            Tuple tuple;
+            scan1.open();
+            scan2.open();
+            // the scans take the morsels in turn
+            bool more1 = true, more2 = true;
+            while (more1 || more2) {
+                if (more1 && (more1 = scan1.get_next(&tuple)))
+                    seen[tuple.get_value(*tb_schema, 0).get_value<integer_t>()]++;
+                if (more2 && (more2 = scan2.get_next(&tuple)))
+                    seen[tuple.get_value(*tb_schema, 0).get_value<integer_t>()]++;
+            }
+            scan1.close();
+            scan2.close();
+            for (integer_t i = 0; i < insert_num; i++)
+                ASSERT_EQ(1, seen[i]);
+        }
+    }
+    PRINT("***test 1 pass***");
+
+    // ********************* test 2 ********************* //
+    {
+        std::vector<std::unique_ptr<WorkerPipeline>> pipelines;
+        std::vector<ExecutorAbstract*> workers;
+        for (int i = 0; i < 4; i++) {
+            pipelines.emplace_back(new WorkerPipeline(&exec_ctx, table, &morsels, tb_schema, out_schema));
+            workers.push_back(&pipelines.back()->projection);
+        }
+        GatherExecutor gather(&exec_ctx, workers);
+        ASSERT_EQ(4, gather.get_worker_num());
+
+        for (int round = 0; round < 2; round++) {
+            std::vector<int> seen(insert_num, 0);
+            Tuple tuple;
+            integer_t cnt = 0;
+            gather.open();
+            while (gather.get_next(&tuple)) {
+                integer_t key = tuple.get_value(*out_schema, 0).get_value<integer_t>();
+                ASSERT_LT(key % 10, 3);
+                seen[key]++;
+                cnt++;
+            }
+            gather.close();
+            ASSERT_EQ(insert_num / 10 * 3, cnt);
+            for (integer_t i = 0; i < insert_num; i++)
+                ASSERT_EQ(i % 10 < 3 ? 1 : 0, seen[i]);
+        }
+
+        // stop the workers before they finish
+        Tuple tuple;
+        gather.open();
+        for (int i = 0; i < 10; i++)
+            ASSERT_TRUE(gather.get_next(&tuple));
+        gather.close();
+    }
+    PRINT("***test 2 pass***");
+
+    db_manager.reset(nullptr);
+    delete tb_schema;
+    delete out_schema;
+}
+
+} // namespace dawn
@@ -0,0 +1,215 @@
+#include <map>
+
+#include "gtest/gtest.h"
+#include "test_util.h"
+#include "table/schema.h"
+#include "manager/db_manager.h"
+#include "executors/external_sort_executor.h"
+#include "executors/sort_merge_join_executor.h"
+
+namespace dawn {
+
+extern std::unique_ptr<DBManager> db_manager;
+
+const char *meta = "test";
+const char *mtdf = "test.mtd";
+const char *dbf = "test.db";
+const char *logf = "test.log";
+
+class SortMergeJoinTest : public testing::Test {
+public:
+    void SetUp() {
+        DBManager::set_default_pool_size(50);
+        remove(mtdf);
+        remove(dbf);
+        remove(logf);
+    }
+
+    void TearDown() {
+        remove(mtdf);
+        remove(dbf);
+        remove(logf);
+    }
+};
+
+/**
+ * column types:
+ * ------------------------------------------
+ * | integer (key) | integer (seq) | char (100) |
+ * ------------------------------------------
+ * the tuples are sorted by the key, seq is the position in the input
+ *
+ * @return number of the tuples, the order and the stability are checked
+ */
+size_t_ check_sorted(ExternalSortExecutor *sort, const Schema &schema, bool desc) {
+    Tuple tuple;
+    size_t_ cnt = 0;
+    integer_t last_key = 0;
+    integer_t last_seq = -1;
+    sort->open();
+    while (sort->get_next(&tuple)) {
+        integer_t key = tuple.get_value(schema, 0).get_value<integer_t>();
+        integer_t seq = tuple.get_value(schema, 1).get_value<integer_t>();
+        EXPECT_EQ(Value("str" + std::to_string(seq)), tuple.get_value(schema, 2));
+        if (cnt > 0) {
+            EXPECT_TRUE(desc ? key <= last_key : key >= last_key);
+            if (key == last_key) {
+                EXPECT_LT(last_seq, seq);
+            }
+        }
+        last_key = key;
+        last_seq = seq;
+        cnt++;
+    }
+    return cnt;
+}
+
+/**
+ * Test List:
+ *   1. sort in the memory, ascending and descending
+ *   2. sort with the runs written to the temporary pages
+ *   3. more runs than the threshold pages, they're merged twice
+ *   4. join with the duplicated keys on both sides, the children are sorted or not
+ */
+TEST_F(SortMergeJoinTest, BasicTest) {
+    PRINT("start the sort merge join tests...");
+    Schema *schema = create_table_schema(std::vector<TypeId>{TypeId::kInteger, TypeId::kInteger, TypeId::kChar},
+        std::vector<string_t>{"col1", "col2", "col3"}, std::vector<size_t_>{100});
+
+    db_manager.reset(new DBManager(meta, true));
+    ASSERT_TRUE(db_manager->get_status());
+    ExecutorContext exec_ctx(db_manager->get_buffer_pool_manager());
+
+    char str[101];
+    auto make_tuples = [&](integer_t num, integer_t mod, std::vector<Tuple> *tuples) {
+        tuples->clear();
+        for (integer_t i = 0; i < num; i++) {
+            // the keys are scattered
+            integer_t key = (i * 7919) % mod;
+            fill_char_array("str" + std::to_string(i), str);
+            std::vector<Value> values{Value(key), Value(i), Value(str)};
+            tuples->push_back(Tuple(&values, *schema));
+        }
+    };
+
+    // ********************* test 1 ********************* //
+    {
+        std::vector<Tuple> tuples;
+        make_tuples(300, 50, &tuples);
+        TupleListExecutor child(&exec_ctx, &tuples);
+        ExternalSortExecutor asc(&exec_ctx, &child, schema, std::vector<offset_t>{0});
+        ASSERT_EQ(300, check_sorted(&asc, *schema, false));
+        ASSERT_EQ(0, asc.get_run_num());
+        asc.close();
+
+        ExternalSortExecutor desc(&exec_ctx, &child, schema, std::vector<offset_t>{0}, std::vector<bool>{true});
+        ASSERT_EQ(300, check_sorted(&desc, *schema, true));
+        desc.close();
+    }
+    PRINT("***test 1 pass***");
+
+    // ********************* test 2 ********************* //
+    {
+        std::vector<Tuple> tuples;
+        make_tuples(5000, 1000, &tuples);
+        TupleListExecutor child(&exec_ctx, &tuples);
+        ExternalSortExecutor sort(&exec_ctx, &child, schema, std::vector<offset_t>{0});
+        ASSERT_EQ(5000, check_sorted(&sort, *schema, false));
+        ASSERT_LT(1, sort.get_run_num());
+        sort.close();
+    }
+    PRINT("***test 2 pass***");
+
+    // ********************* test 3 ********************* //
+    {
+        std::vector<Tuple> tuples;
+        make_tuples(20000, 3000, &tuples);
+        TupleListExecutor child(&exec_ctx, &tuples);
+        ExternalSortExecutor sort(&exec_ctx, &child, schema, std::vector<offset_t>{0});
+        ASSERT_EQ(20000, check_sorted(&sort, *schema, false));
+        ASSERT_LT(20, sort.get_run_num());
+        sort.close();
+    }
+    PRINT("***test 3 pass***");
+
+    // ********************* test 4 ********************* //
+    {
+        std::vector<Tuple> lefts, rights;
+        make_tuples(3000, 500, &lefts);
+        make_tuples(2000, 800, &rights);
+        std::map<integer_t, size_t_> left_cnt, right_cnt;
+        for (auto &tuple : lefts)
+            left_cnt[tuple.get_value(*schema, 0).get_value<integer_t>()]++;
+        for (auto &tuple : rights)
+            right_cnt[tuple.get_value(*schema, 0).get_value<integer_t>()]++;
+        size_t_ expected = 0;
+        for (auto &kc : left_cnt)
+            expected += kc.second * right_cnt[kc.first];
+
+        TupleListExecutor left(&exec_ctx, &lefts), right(&exec_ctx, &rights);
+        SortMergeJoinExecutor join(&exec_ctx, &left, &right, schema, schema,
+            std::vector<offset_t>{0}, std::vector<offset_t>{0});
+        const Schema *out_schema = join.get_output_schema();
+        Tuple tuple;
+        size_t_ cnt = 0;
+        join.open();
+        while (join.get_next(&tuple)) {
+            ASSERT_EQ(tuple.get_value(*out_schema, 0), tuple.get_value(*out_schema, 3));
+            cnt++;
+        }
+        join.close();
+        ASSERT_EQ(expected, cnt);
+
+        // the left child is sorted by another sort executor
+        ExternalSortExecutor left_sort(&exec_ctx, &left, schema, std::vector<offset_t>{0});
+        SortMergeJoinExecutor sorted_join(&exec_ctx, &left_sort, &right, schema, schema,
+            std::vector<offset_t>{0}, std::vector<offset_t>{0}, true, false);
+        cnt = 0;
+        sorted_join.open();
+        while (sorted_join.get_next(&tuple))
+            cnt++;
+        sorted_join.close();
+        ASSERT_EQ(expected, cnt);
+    }
+    PRINT("***test 4 pass***");
+
+    db_manager.reset(nullptr);
+    delete schema;
+}
+
+/**
+ * Test List:
+ *   1. with a small pool, the runs are merged in several passes, each pass merges all the runs
+ */
+TEST_F(SortMergeJoinTest, MultiPassTest) {
+    PRINT("start the multi-pass merge tests...");
+    Schema *schema = create_table_schema(std::vector<TypeId>{TypeId::kInteger, TypeId::kInteger, TypeId::kChar},
+        std::vector<string_t>{"col1", "col2", "col3"}, std::vector<size_t_>{100});
+    integer_t tuple_num = 20000;
+
+    // only a few threshold pages, so that there are much more runs than them
+    DBManager::set_default_pool_size(15);
+    db_manager.reset(new DBManager(meta, true));
+    ASSERT_TRUE(db_manager->get_status());
+    ExecutorContext exec_ctx(db_manager->get_buffer_pool_manager());
+
+    // ********************* test 1 ********************* //
+    char str[101];
+    std::vector<Tuple> tuples;
+    for (integer_t i = 0; i < tuple_num; i++) {
+        fill_char_array("str" + std::to_string(i), str);
+        std::vector<Value> values{Value((i * 7919) % 3000), Value(i), Value(str)};
+        tuples.push_back(Tuple(&values, *schema));
+    }
+    TupleListExecutor child(&exec_ctx, &tuples);
+    ExternalSortExecutor sort(&exec_ctx, &child, schema, std::vector<offset_t>{0});
+    ASSERT_EQ(tuple_num, check_sorted(&sort, *schema, false));
+    ASSERT_LT(1, sort.get_merge_pass_num());
+    sort.close();
+    PRINT("***test 1 pass***");
+
+    db_manager.reset(nullptr);
+    delete schema;
+}
+
+} // namespace dawn
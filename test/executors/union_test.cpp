@@ -0,0 +1,109 @@
+#include <set>
+
+#include "gtest/gtest.h"
+#include "test_util.h"
+#include "table/schema.h"
+#include "manager/db_manager.h"
+#include "executors/union_executor.h"
+
+namespace dawn {
+
+extern std::unique_ptr<DBManager> db_manager;
+
+const char *meta = "test";
+const char *mtdf = "test.mtd";
+const char *dbf = "test.db";
+const char *logf = "test.log";
+
+class UnionTest : public testing::Test {
+public:
+    void SetUp() {
+        DBManager::set_default_pool_size(50);
+        remove(mtdf);
+        remove(dbf);
+        remove(logf);
+    }
+
+    void TearDown() {
+        remove(mtdf);
+        remove(dbf);
+        remove(logf);
+    }
+};
+
+/**
+ * left column types:
+ * ---------------------------
+ * | integer | char (100)    |
+ * ---------------------------
+ * right column types:
+ * ---------------------------
+ * | integer | varchar       |
+ * ---------------------------
+ *
+ * Test List:
+ *   1. the left child's tuples fit in the memory, execute the same query for several times
+ *   2. too many left tuples, they're spilled and loaded batch by batch, execute the same query for several times
+ */
+TEST_F(UnionTest, BasicTest) {
+    PRINT("start the union tests...");
+    Schema *left_schema = create_table_schema(std::vector<TypeId>{TypeId::kInteger, TypeId::kChar},
+        std::vector<string_t>{"l_col1", "l_col2"}, std::vector<size_t_>{100});
+    Schema *right_schema = create_table_schema(std::vector<TypeId>{TypeId::kInteger, TypeId::kVarchar},
+        std::vector<string_t>{"r_col1", "r_col2"}, std::vector<size_t_>{100});
+
+    db_manager.reset(new DBManager(meta, true));
+    ASSERT_TRUE(db_manager->get_status());
+    ExecutorContext exec_ctx(db_manager->get_buffer_pool_manager());
+
+    char str[101];
+    std::vector<Tuple> rights;
+    for (integer_t i = 0; i < 30; i++) {
+        std::vector<Value> values{Value(i), Value("str" + std::to_string(i))};
+        rights.push_back(Tuple(&values, *right_schema));
+    }
+
+    auto run_union = [&](integer_t left_num, bool spilled) {
+        std::vector<Tuple> lefts;
+        for (integer_t i = 0; i < left_num; i++) {
+            fill_char_array("char" + std::to_string(i), str);
+            std::vector<Value> values{Value(i), Value(str)};
+            lefts.push_back(Tuple(&values, *left_schema));
+        }
+
+        TupleListExecutor left(&exec_ctx, &lefts), right(&exec_ctx, &rights);
+        UnionExecutor union_exec(&exec_ctx, std::vector<ExecutorAbstract*>{&left, &right},
+            std::vector<Schema*>{left_schema, right_schema});
+        const Schema *out_schema = union_exec.get_output_schema();
+        for (int round = 0; round < 2; round++) {
+            std::set<std::pair<integer_t, integer_t>> pairs;
+            Tuple tuple;
+            union_exec.open();
+            ASSERT_EQ(spilled, union_exec.get_batch_num() > 1);
+            while (union_exec.get_next(&tuple)) {
+                integer_t l = tuple.get_value(*out_schema, 0).get_value<integer_t>();
+                integer_t r = tuple.get_value(*out_schema, 2).get_value<integer_t>();
+                fill_char_array("char" + std::to_string(l), str);
+                ASSERT_EQ(Value(str), tuple.get_value(*out_schema, 1));
+                ASSERT_EQ(Value("str" + std::to_string(r)), tuple.get_value(*out_schema, 3));
+                pairs.insert(std::make_pair(l, r));
+            }
+            union_exec.close();
+            ASSERT_EQ(static_cast<size_t>(left_num * rights.size()), pairs.size());
+        }
+    };
+
+    // ********************* test 1 ********************* //
+    run_union(100, false);
+    PRINT("***test 1 pass***");
+
+    // ********************* test 2 ********************* //
+    run_union(3000, true);
+    PRINT("***test 2 pass***");
+
+    db_manager.reset(nullptr);
+    delete left_schema;
+    delete right_schema;
+}
+
+} // namespace dawn
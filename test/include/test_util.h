@@ -8,6 +8,7 @@
 #include <thread>
 
 #include "util/util.h"
+#include "executors/executor_abstr.h"
 
 class TestParam {
 public:
@@ -106,3 +107,25 @@ private:
     int sock_fd_;
     std::string resp_;
 };
+
+namespace dawn {
+
+/** produce the tuples in the vector one by one, it only implements get_next() like the legacy executors */
+class TupleListExecutor : public ExecutorAbstract {
+public:
+    TupleListExecutor(ExecutorContext *exec_ctx, std::vector<Tuple> *tuples)
+        : ExecutorAbstract(exec_ctx), tuples_(tuples) {}
+    void open() override { idx_ = 0; }
+    bool get_next(Tuple *tuple) override {
+        if (idx_ == tuples_->size())
+            return false;
+        *tuple = (*tuples_)[idx_++];
+        return true;
+    }
+    void close() override {}
+private:
+    std::vector<Tuple> *tuples_;
+    size_t idx_ = 0;
+};
+
+} // namespace dawn
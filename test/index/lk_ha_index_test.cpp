@@ -3,6 +3,14 @@
 #include "manager/db_manager.h"
 #include "table/table.h"
 #include "table/lk_ha_tb_iter.h"
+#include "meta/table_meta_data.h"
+#include "storage/page/link_hash_page.h"
+#include "executors/seq_scan_executor.h"
+#include "executors/proj_executor.h"
+
+#include <chrono>
+#include <cmath>
+#include <thread>
 
 namespace dawn {
 
@@ -640,4 +648,1010 @@ TEST_F(LinkHashBasicTest, BasicIterTest) {
     delete tb_schema;
 }
 
+/**
+ * Test List:
+ *   1. every tuple's key should pass the key filter of the TablePage it stays on
+ *   2. searching nonexistent keys should fail
+ */
+TEST_F(LinkHashBasicTest, KeyFilterTest) {
+    PRINT("start the link hash key filter tests...");
+    Schema *tb_schema = create_table_schema(tb_col_types, tb_col_names, tb_char_size);
+    offset_t key_idx = tb_schema->get_key_idx();
+    size_t_ insert_num = 12345;
+
+    db_manager.reset(new DBManager(meta, true));
+    ASSERT_TRUE(db_manager->get_status());
+
+    Catalog *catalog = db_manager->get_catalog();
+    CatalogTable *catalog_table = catalog->get_catalog_table();
+    ASSERT_TRUE(catalog_table->create_table(table_name, *tb_schema));
+
+    TableMetaData *table_md = catalog_table->get_table_meta_data(table_name);
+    ASSERT_NE(nullptr, table_md);
+
+    Table *table = table_md->get_table();
+    ASSERT_NE(nullptr, table);
+
+    fill_char_array("apple", v1);
+    fill_char_array("monkey_key", v3);
+
+    values.clear();
+    values.push_back(Value(static_cast<integer_t>(0)));
+    values.push_back(Value(v1));
+    values.push_back(Value(true));
+    values.push_back(Value(v3));
+    values.push_back(Value(3.1415926));
+
+    bool ok = true;
+    for (size_t_ i = 0; i < insert_num; i++) {
+        values[key_idx] = Value(static_cast<integer_t>(i));
+        Tuple tuple(&values, *tb_schema);
+        if (!table->insert_tuple(&tuple, *tb_schema)) {
+            ok = false;
+            break;
+        }
+    }
+    ASSERT_TRUE(ok);
+
+    // ********************* test 1 ********************* //
+    BufferPoolManager *bpm = db_manager->get_buffer_pool_manager();
+    size_t_ cnt = 0;
+    {
+        LinkHashTableIter tb_iter(table->get_first_table_page_id(), bpm);
+        while (tb_iter->get_rid().get_page_id() != INVALID_PAGE_ID) {
+            page_id_t page_id = tb_iter->get_rid().get_page_id();
+            TablePage *tb_page = reinterpret_cast<TablePage*>(bpm->get_page(page_id));
+            tb_page->r_lock();
+            bool pass = tb_page->may_contain_key(IndexKey(tb_iter->get_data(), get_key_columns(*tb_schema)).get_hash_value());
+            tb_page->r_unlock();
+            bpm->unpin_page(page_id, false);
+            if (!pass) {
+                ok = false;
+                break;
+            }
+            ++cnt;
+            ++tb_iter;
+        }
+    }
+    ASSERT_TRUE(ok);
+    ASSERT_EQ(insert_num, cnt);
+    PRINT("***test 1 pass***");
+
+    // ********************* test 2 ********************* //
+    Tuple container;
+    for (size_t_ i = insert_num; i < 2 * insert_num; i++) {
+        if (table->get_tuple(Value(static_cast<integer_t>(i)), &container, *tb_schema)) {
+            ok = false;
+            break;
+        }
+    }
+    ASSERT_TRUE(ok);
+    PRINT("***test 2 pass***");
+
+    delete tb_schema;
+}
+
+/**
+ * Test List:
+ *   1. search existent and nonexistent keys in a batch, and check the result with get_tuple()
+ *   2. delete some tuples and search again
+ */
+TEST_F(LinkHashBasicTest, BatchSearchTest) {
+    PRINT("start the link hash batch search tests...");
+    Schema *tb_schema = create_table_schema(tb_col_types, tb_col_names, tb_char_size);
+    offset_t key_idx = tb_schema->get_key_idx();
+    size_t_ insert_num = 12345;
+
+    db_manager.reset(new DBManager(meta, true));
+    ASSERT_TRUE(db_manager->get_status());
+
+    Catalog *catalog = db_manager->get_catalog();
+    CatalogTable *catalog_table = catalog->get_catalog_table();
+    ASSERT_TRUE(catalog_table->create_table(table_name, *tb_schema));
+
+    TableMetaData *table_md = catalog_table->get_table_meta_data(table_name);
+    ASSERT_NE(nullptr, table_md);
+
+    Table *table = table_md->get_table();
+    ASSERT_NE(nullptr, table);
+
+    fill_char_array("apple", v1);
+    fill_char_array("monkey_key", v3);
+
+    values.clear();
+    values.push_back(Value(static_cast<integer_t>(0)));
+    values.push_back(Value(v1));
+    values.push_back(Value(true));
+    values.push_back(Value(v3));
+    values.push_back(Value(3.1415926));
+
+    bool ok = true;
+    for (size_t_ i = 0; i < insert_num; i++) {
+        values[key_idx] = Value(static_cast<integer_t>(i));
+        Tuple tuple(&values, *tb_schema);
+        if (!table->insert_tuple(&tuple, *tb_schema)) {
+            ok = false;
+            break;
+        }
+    }
+    ASSERT_TRUE(ok);
+
+    // keys in [0, 2 * insert_num) with step 3, half of them don't exist
+    std::vector<Value> key_values;
+    for (size_t_ i = 2 * insert_num - 1; i >= 0; i -= 3) {
+        key_values.push_back(Value(static_cast<integer_t>(i)));
+    }
+
+    // ********************* test 1 ********************* //
+    std::vector<Tuple> tuples;
+    size_t_ found_num = table->get_tuples(key_values, &tuples, *tb_schema);
+    ASSERT_EQ(key_values.size(), tuples.size());
+
+    size_t_ expect_num = 0;
+    Tuple container;
+    for (size_t i = 0; i < key_values.size(); i++) {
+        if (table->get_tuple(key_values[i], &container, *tb_schema)) {
+            expect_num++;
+            ok = ok && (container.is_equal(tuples[i]));
+        } else {
+            ok = ok && (tuples[i].get_rid().get_page_id() == INVALID_PAGE_ID);
+        }
+    }
+    ASSERT_TRUE(ok);
+    ASSERT_EQ(expect_num, found_num);
+    PRINT("***test 1 pass***");
+
+    // ********************* test 2 ********************* //
+    for (size_t_ i = 0; i < insert_num; i += 2) {
+        Value key_value(static_cast<integer_t>(i));
+        ASSERT_TRUE(table->mark_delete(key_value, *tb_schema));
+        table->apply_delete(key_value, *tb_schema);
+    }
+
+    found_num = table->get_tuples(key_values, &tuples, *tb_schema);
+    expect_num = 0;
+    for (size_t i = 0; i < key_values.size(); i++) {
+        integer_t key = key_values[i].get_value<integer_t>();
+        if (key < insert_num && key % 2 == 1) {
+            expect_num++;
+            ok = ok && (tuples[i].get_value(*tb_schema, key_idx) == key_values[i]);
+        } else {
+            ok = ok && (tuples[i].get_rid().get_page_id() == INVALID_PAGE_ID);
+        }
+    }
+    ASSERT_TRUE(ok);
+    ASSERT_EQ(expect_num, found_num);
+    PRINT("***test 2 pass***");
+
+    delete tb_schema;
+}
+
+/**
+ * Test List:
+ *   1. insert tuples that fill most of the second level pages, check all the tuples can be found
+ *   2. restart the db to ensure the directory is loaded from the disk
+ */
+TEST_F(LinkHashBasicTest, DirectoryTest) {
+    PRINT("start the link hash directory tests...");
+    Schema *tb_schema = create_table_schema(tb_col_types, tb_col_names, tb_char_size);
+    offset_t key_idx = tb_schema->get_key_idx();
+    size_t_ insert_num = 12000;
+    table_id_t table_id;
+
+    fill_char_array("apple", v1);
+    fill_char_array("monkey_key", v3);
+
+    {
+        db_manager.reset(new DBManager(meta, true));
+        ASSERT_TRUE(db_manager->get_status());
+
+        CatalogTable *catalog_table = db_manager->get_catalog()->get_catalog_table();
+        ASSERT_TRUE(catalog_table->create_table(table_name, *tb_schema));
+        TableMetaData *table_md = catalog_table->get_table_meta_data(table_name);
+        ASSERT_NE(nullptr, table_md);
+        table_id = table_md->get_table_id();
+        Table *table = table_md->get_table();
+
+        // ********************* test 1 ********************* //
+        values.clear();
+        values.push_back(Value(static_cast<integer_t>(0)));
+        values.push_back(Value(v1));
+        values.push_back(Value(true));
+        values.push_back(Value(v3));
+        values.push_back(Value(3.1415926));
+        for (size_t_ i = 0; i < insert_num; i++) {
+            values[key_idx] = Value(static_cast<integer_t>(i));
+            Tuple tuple(&values, *tb_schema);
+            ASSERT_TRUE(table->insert_tuple(&tuple, *tb_schema));
+        }
+
+        Tuple tuple;
+        for (size_t_ i = 0; i < insert_num; i++) {
+            Value key_value(static_cast<integer_t>(i));
+            ASSERT_TRUE(table->get_tuple(key_value, &tuple, *tb_schema));
+            ASSERT_EQ(key_value, tuple.get_value(*tb_schema, key_idx));
+        }
+        PRINT("***test 1 pass***");
+    }
+
+    {
+        // ********************* test 2 ********************* //
+        db_manager.reset(new DBManager(meta, false));
+        ASSERT_TRUE(db_manager->get_status());
+
+        CatalogTable *catalog_table = db_manager->get_catalog()->get_catalog_table();
+        TableMetaData *table_md = catalog_table->get_table_meta_data(table_id);
+        ASSERT_NE(nullptr, table_md);
+        Table *table = table_md->get_table();
+
+        Tuple tuple;
+        for (size_t_ i = 0; i < insert_num; i++) {
+            Value key_value(static_cast<integer_t>(i));
+            ASSERT_TRUE(table->get_tuple(key_value, &tuple, *tb_schema));
+        }
+
+        // the directory should be the same after restarting, so no duplicate key is accepted
+        values.clear();
+        values.push_back(Value(static_cast<integer_t>(7)));
+        values.push_back(Value(v1));
+        values.push_back(Value(true));
+        values.push_back(Value(v3));
+        values.push_back(Value(3.1415926));
+        Tuple dup_tuple(&values, *tb_schema);
+        ASSERT_FALSE(table->insert_tuple(&dup_tuple, *tb_schema));
+        PRINT("***test 2 pass***");
+    }
+
+    db_manager.reset(nullptr);
+    delete tb_schema;
+}
+
+/**
+ * Test List:
+ *   1. the encoded keys keep the order of the values, -0.0 and 0.0 have the same key,
+ *      and the keys are compared with the tuples correctly
+ *   2. insert tuples with the composite key (tb_col1, tb_col4), the first column is not unique
+ *   3. restart the db to ensure the key columns are persisted
+ */
+TEST_F(LinkHashBasicTest, CompositeKeyTest) {
+    PRINT("start the composite key tests...");
+
+    // ********************* test 1 ********************* //
+    Column int_col(TypeId::kInteger, "int", 0);
+    Column dec_col(TypeId::kDecimal, "dec", 0);
+    Column char_col("char", 0, 5);
+    std::vector<integer_t> ints{-100000, -5, -1, 0, 3, 256, 100000};
+    std::vector<decimal_t> decs{-1e10, -2.5, -0.1, 0.0, 1.5, 3.0, 1e10};
+    std::vector<string_t> strs{"", "ab", "abc", "abd", "b", "bbbbb"};
+    for (size_t i = 1; i < ints.size(); i++)
+        ASSERT_TRUE(IndexKey(Value(ints[i - 1]), int_col) < IndexKey(Value(ints[i]), int_col));
+    for (size_t i = 1; i < decs.size(); i++)
+        ASSERT_TRUE(IndexKey(Value(decs[i - 1]), dec_col) < IndexKey(Value(decs[i]), dec_col));
+    // the values equal to each other have the same key
+    ASSERT_EQ(IndexKey(Value(-0.0), dec_col), IndexKey(Value(0.0), dec_col));
+    ASSERT_EQ(IndexKey(Value(std::nan("1")), dec_col), IndexKey(Value(-std::nan("2")), dec_col));
+    for (size_t i = 1; i < strs.size(); i++)
+        ASSERT_TRUE(IndexKey(Value(strs[i - 1]), char_col) < IndexKey(Value(strs[i]), char_col));
+    ASSERT_TRUE(IndexKey(std::vector<Value>{Value(1), Value("b")}, std::vector<Column>{int_col, char_col}) <
+                IndexKey(std::vector<Value>{Value(2), Value("a")}, std::vector<Column>{int_col, char_col}));
+    // the key is compared with the tuple in place, garbage after '\0' is ignored
+    std::vector<Column> raw_cols{int_col, Column("char", INTEGER_T_SIZE, 5)};
+    char raw[INTEGER_T_SIZE + 5];
+    integer_t raw_int = 3;
+    memcpy(raw, &raw_int, INTEGER_T_SIZE);
+    memcpy(raw + INTEGER_T_SIZE, "ab\0xy", 5);
+    IndexKey raw_key(std::vector<Value>{Value(3), Value("ab")}, raw_cols);
+    ASSERT_EQ(raw_key, IndexKey(raw, raw_cols));
+    ASSERT_TRUE(raw_key.is_equal_to_tuple(raw, raw_cols));
+    ASSERT_FALSE(IndexKey(std::vector<Value>{Value(3), Value("abx")}, raw_cols).is_equal_to_tuple(raw, raw_cols));
+    ASSERT_FALSE(IndexKey(std::vector<Value>{Value(3), Value("a")}, raw_cols).is_equal_to_tuple(raw, raw_cols));
+    ASSERT_FALSE(IndexKey(std::vector<Value>{Value(4), Value("ab")}, raw_cols).is_equal_to_tuple(raw, raw_cols));
+    PRINT("***test 1 pass***");
+
+    Schema *tb_schema = create_table_schema(tb_col_types, tb_col_names, tb_char_size);
+    tb_schema->set_key_idxs(std::vector<offset_t>{0, 3});
+    std::vector<Column> key_cols = get_key_columns(*tb_schema);
+    integer_t tenant_num = 7;
+    integer_t insert_num = 7000;
+    table_id_t table_id;
+
+    auto make_key = [&](integer_t i) {
+        fill_char_array("obj" + std::to_string(i / tenant_num), v3);
+        return IndexKey(std::vector<Value>{Value(i % tenant_num), Value(v3)}, key_cols);
+    };
+
+    {
+        // ********************* test 2 ********************* //
+        db_manager.reset(new DBManager(meta, true));
+        ASSERT_TRUE(db_manager->get_status());
+
+        CatalogTable *catalog_table = db_manager->get_catalog()->get_catalog_table();
+        ASSERT_TRUE(catalog_table->create_table(table_name, *tb_schema));
+        TableMetaData *table_md = catalog_table->get_table_meta_data(table_name);
+        ASSERT_NE(nullptr, table_md);
+        table_id = table_md->get_table_id();
+        Table *table = table_md->get_table();
+
+        fill_char_array("apple", v1);
+        for (integer_t i = 0; i < insert_num; i++) {
+            fill_char_array("obj" + std::to_string(i / tenant_num), v3);
+            values.clear();
+            values.push_back(Value(i % tenant_num));
+            values.push_back(Value(v1));
+            values.push_back(Value(true));
+            values.push_back(Value(v3));
+            values.push_back(Value(static_cast<decimal_t>(i)));
+            Tuple tuple(&values, *tb_schema);
+            ASSERT_TRUE(table->insert_tuple(&tuple, *tb_schema));
+            ASSERT_FALSE(table->insert_tuple(&tuple, *tb_schema));
+        }
+
+        Tuple tuple;
+        for (integer_t i = 0; i < insert_num; i++) {
+            ASSERT_TRUE(table->get_tuple(make_key(i), &tuple, *tb_schema));
+            ASSERT_EQ(Value(static_cast<decimal_t>(i)), tuple.get_value(*tb_schema, 4));
+        }
+        ASSERT_FALSE(table->get_tuple(make_key(insert_num), &tuple, *tb_schema));
+        PRINT("***test 2 pass***");
+    }
+
+    {
+        // ********************* test 3 ********************* //
+        db_manager.reset(new DBManager(meta, false));
+        ASSERT_TRUE(db_manager->get_status());
+
+        CatalogTable *catalog_table = db_manager->get_catalog()->get_catalog_table();
+        TableMetaData *table_md = catalog_table->get_table_meta_data(table_id);
+        ASSERT_NE(nullptr, table_md);
+        ASSERT_EQ(tb_schema->get_key_idxs(), table_md->get_table_schema()->get_key_idxs());
+        Table *table = table_md->get_table();
+
+        std::vector<IndexKey> keys;
+        for (integer_t i = 0; i < insert_num; i += 3)
+            keys.push_back(make_key(i));
+        std::vector<Tuple> tuples;
+        ASSERT_EQ(keys.size(), table->get_tuples(keys, &tuples, *tb_schema));
+
+        for (integer_t i = 0; i < insert_num; i += 2) {
+            ASSERT_TRUE(table->mark_delete(make_key(i), *tb_schema));
+            table->apply_delete(make_key(i), *tb_schema);
+        }
+        Tuple tuple;
+        for (integer_t i = 0; i < insert_num; i++)
+            ASSERT_EQ(i % 2 == 1, table->get_tuple(make_key(i), &tuple, *tb_schema));
+        PRINT("***test 3 pass***");
+    }
+
+    db_manager.reset(nullptr);
+    delete tb_schema;
+}
+
+/** @return page ids of the TablePage list that the key's hash value refers to */
+std::vector<page_id_t> get_link_list(Table *table, hash_t hash_val, BufferPoolManager *bpm) {
+    offset_t sec_pg_slot_num;
+    offset_t tb_pg_slot_num;
+    hash_to_slot(hash_val, &sec_pg_slot_num, &tb_pg_slot_num);
+
+    std::vector<page_id_t> pgids;
+    page_id_t first_pgid = table->get_first_table_page_id();
+    LinkHashPage *first_pg = reinterpret_cast<LinkHashPage*>(bpm->get_page(first_pgid));
+    page_id_t sec_pgid = first_pg->get_pgid_in_slot(sec_pg_slot_num);
+    bpm->unpin_page(first_pgid, false);
+    if (sec_pgid == INVALID_PAGE_ID)
+        return pgids;
+
+    LinkHashPage *sec_pg = reinterpret_cast<LinkHashPage*>(bpm->get_page(sec_pgid));
+    page_id_t tb_pgid = sec_pg->get_pgid_in_slot(tb_pg_slot_num);
+    bpm->unpin_page(sec_pgid, false);
+    while (tb_pgid != INVALID_PAGE_ID) {
+        pgids.push_back(tb_pgid);
+        TablePage *tb_page = reinterpret_cast<TablePage*>(bpm->get_page(tb_pgid));
+        page_id_t next_pgid = tb_page->get_next_page_id();
+        bpm->unpin_page(tb_pgid, false);
+        tb_pgid = next_pgid;
+    }
+    return pgids;
+}
+
+/** @return key_num keys that are in the same link list */
+std::vector<integer_t> find_list_keys(const Column &key_col, size_t_ key_num) {
+    std::vector<uint8_t> slot_cnt(Lk_HA_TOTAL_SLOT_NUM, 0);
+    std::vector<integer_t> keys;
+    offset_t target_slot = -1;
+    for (integer_t i = 0; target_slot < 0; i++) {
+        offset_t sec_pg_slot_num;
+        offset_t tb_pg_slot_num;
+        hash_to_slot(IndexKey(Value(i), key_col).get_hash_value(), &sec_pg_slot_num, &tb_pg_slot_num);
+        offset_t slot = sec_pg_slot_num * LK_HA_PG_SLOT_NUM + tb_pg_slot_num;
+        if (++slot_cnt[slot] == key_num)
+            target_slot = slot;
+    }
+    for (integer_t i = 0; static_cast<size_t_>(keys.size()) < key_num; i++) {
+        offset_t sec_pg_slot_num;
+        offset_t tb_pg_slot_num;
+        hash_to_slot(IndexKey(Value(i), key_col).get_hash_value(), &sec_pg_slot_num, &tb_pg_slot_num);
+        if (sec_pg_slot_num * LK_HA_PG_SLOT_NUM + tb_pg_slot_num == target_slot)
+            keys.push_back(i);
+    }
+    return keys;
+}
+
+/**
+ * keys are chosen so that they are in the same link list, and a TablePage
+ * could contain only 5 tuples, so the list is long enough to be compacted.
+ * 
+ * Test List:
+ *   1. delete all the tuples in the middle page, the list should be shortened
+ *   2. delete most tuples in the head page, the remaining tuples should be merged into it
+ *      and the secondary index should refer to the moved tuples
+ *   3. delete all the tuples, the list should be empty
+ *   4. delete all the tuples in the middle page while the pages are pinned by someone else, e.g. the
+ *      scan on the same thread, the pages are kept without waiting for them. They're removed by the
+ *      compaction after being unpinned
+ *   5. delete tuples while a scan stays on the head page, the tuples of the next page shouldn't be
+ *      moved into the free slots the scan has passed, every remaining tuple is still scanned
+ */
+TEST_F(LinkHashBasicTest, CompactionTest) {
+    PRINT("start the link hash compaction tests...");
+    // with large pages, there are too many slots to find enough keys in the same list
+    if (Lk_HA_TOTAL_SLOT_NUM > (1 << 22))
+        GTEST_SKIP();
+
+    std::vector<TypeId> col_types{TypeId::kInteger, TypeId::kChar, TypeId::kInteger};
+    std::vector<string_t> col_names{"key", "pad", "tag"};
+    size_t_ pad_sz = TablePage::get_tp_load_data_space() / 11 * 2;
+    Schema *tb_schema = create_table_schema(col_types, col_names, std::vector<size_t_>{pad_sz});
+    Column key_col = tb_schema->get_column(0);
+    offset_t idx_col = 2;
+    integer_t tag_num = 3;
+    size_t_ key_num = 12;
+
+    std::vector<integer_t> keys = find_list_keys(key_col, key_num);
+    hash_t list_hash = IndexKey(Value(keys[0]), key_col).get_hash_value();
+
+    db_manager.reset(new DBManager(meta, true));
+    ASSERT_TRUE(db_manager->get_status());
+    BufferPoolManager *bpm = db_manager->get_buffer_pool_manager();
+
+    CatalogTable *catalog_table = db_manager->get_catalog()->get_catalog_table();
+    ASSERT_TRUE(catalog_table->create_table(table_name, *tb_schema));
+    TableMetaData *table_md = catalog_table->get_table_meta_data(table_name);
+    ASSERT_NE(nullptr, table_md);
+    Table *table = table_md->get_table();
+    ASSERT_TRUE(table_md->create_index(idx_col));
+    SecondaryIndex *index = table->get_index(idx_col);
+    ASSERT_NE(nullptr, index);
+
+    std::vector<char> pad(pad_sz + 1);
+    fill_char_array("padding", pad.data());
+    for (auto key : keys) {
+        values.clear();
+        values.push_back(Value(key));
+        values.push_back(Value(pad.data()));
+        values.push_back(Value(key % tag_num));
+        Tuple tuple(&values, *tb_schema);
+        ASSERT_TRUE(table->insert_tuple(&tuple, *tb_schema));
+    }
+    std::vector<page_id_t> pgids = get_link_list(table, list_hash, bpm);
+    ASSERT_EQ(3, pgids.size());
+
+    std::set<integer_t> existing(keys.begin(), keys.end());
+    auto delete_key = [&](integer_t key) {
+        ASSERT_TRUE(table->mark_delete(Value(key), *tb_schema));
+        table->apply_delete(Value(key), *tb_schema);
+        existing.erase(key);
+    };
+
+    // check the primary index and the secondary index
+    auto check = [&]() {
+        Tuple tuple;
+        for (auto key : keys)
+            ASSERT_EQ(existing.count(key) == 1, table->get_tuple(Value(key), &tuple, *tb_schema));
+
+        size_t_ cnt = 0;
+        for (integer_t tag = 0; tag < tag_num; tag++) {
+            std::vector<RID> rids;
+            index->scan_key(index->make_key(Value(tag)), &rids);
+            for (auto &rid : rids) {
+                ASSERT_TRUE(table->get_tuple(&tuple, rid));
+                ASSERT_EQ(Value(tag), tuple.get_value(*tb_schema, idx_col));
+                ASSERT_EQ(1, existing.count(tuple.get_value(*tb_schema, 0).get_value<integer_t>()));
+            }
+            cnt += rids.size();
+        }
+        ASSERT_EQ(existing.size(), cnt);
+    };
+
+    // group the keys by the pages they stay on
+    auto keys_on_page = [&](page_id_t page_id) {
+        std::vector<integer_t> page_keys;
+        Tuple tuple;
+        for (auto key : existing) {
+            table->get_tuple(Value(key), &tuple, *tb_schema);
+            if (tuple.get_rid().get_page_id() == page_id)
+                page_keys.push_back(key);
+        }
+        return page_keys;
+    };
+
+    // ********************* test 1 ********************* //
+    for (auto key : keys_on_page(pgids[1]))
+        delete_key(key);
+    pgids = get_link_list(table, list_hash, bpm);
+    ASSERT_EQ(2, pgids.size());
+    check();
+    PRINT("***test 1 pass***");
+
+    // ********************* test 2 ********************* //
+    std::vector<integer_t> head_keys = keys_on_page(pgids[0]);
+    for (size_t i = 1; i < head_keys.size(); i++)
+        delete_key(head_keys[i]);
+    pgids = get_link_list(table, list_hash, bpm);
+    ASSERT_EQ(1, pgids.size());
+    ASSERT_EQ(existing.size(), keys_on_page(pgids[0]).size());
+    check();
+    PRINT("***test 2 pass***");
+
+    // ********************* test 3 ********************* //
+    std::vector<integer_t> remaining(existing.begin(), existing.end());
+    for (auto key : remaining)
+        delete_key(key);
+    ASSERT_EQ(0, get_link_list(table, list_hash, bpm).size());
+    check();
+    PRINT("***test 3 pass***");
+
+    // ********************* test 4 ********************* //
+    for (auto key : keys) {
+        values.clear();
+        values.push_back(Value(key));
+        values.push_back(Value(pad.data()));
+        values.push_back(Value(key % tag_num));
+        Tuple tuple(&values, *tb_schema);
+        ASSERT_TRUE(table->insert_tuple(&tuple, *tb_schema));
+        existing.insert(key);
+    }
+    pgids = get_link_list(table, list_hash, bpm);
+    ASSERT_EQ(3, pgids.size());
+    {
+        LinkHashTableIter iter(table->get_first_table_page_id(), bpm);
+        ASSERT_NE(INVALID_PAGE_ID, iter->get_rid().get_page_id());
+        for (auto pgid : pgids)
+            ASSERT_NE(nullptr, bpm->get_page(pgid));
+        for (auto key : keys_on_page(pgids[1]))
+            delete_key(key);
+        for (auto pgid : pgids)
+            bpm->unpin_page(pgid, false);
+        ASSERT_EQ(3, get_link_list(table, list_hash, bpm).size());
+        check();
+    }
+    remaining.assign(existing.begin(), existing.end());
+    for (auto key : remaining)
+        delete_key(key);
+    ASSERT_EQ(0, get_link_list(table, list_hash, bpm).size());
+    check();
+    PRINT("***test 4 pass***");
+
+    // ********************* test 5 ********************* //
+    for (auto key : keys) {
+        values.clear();
+        values.push_back(Value(key));
+        values.push_back(Value(pad.data()));
+        values.push_back(Value(key % tag_num));
+        Tuple tuple(&values, *tb_schema);
+        ASSERT_TRUE(table->insert_tuple(&tuple, *tb_schema));
+        existing.insert(key);
+    }
+    pgids = get_link_list(table, list_hash, bpm);
+    ASSERT_EQ(3, pgids.size());
+    {
+        // the list is the only one in the table, so the scan stops at the last tuple of the head page
+        std::vector<integer_t> head_keys = keys_on_page(pgids[0]);
+        std::vector<integer_t> next_keys = keys_on_page(pgids[1]);
+        std::set<integer_t> scanned;
+        LinkHashTableIter iter(table->get_first_table_page_id(), bpm);
+        for (size_t i = 0; i < head_keys.size(); i++) {
+            if (i > 0)
+                ++iter;
+            ASSERT_EQ(pgids[0], iter->get_rid().get_page_id());
+            scanned.insert(iter->get_value(*tb_schema, 0).get_value<integer_t>());
+        }
+
+        // free the slots the scan has passed, and make the next page sparse so that it's compacted
+        for (size_t i = 0; i + 2 < head_keys.size(); i++)
+            delete_key(head_keys[i]);
+        for (size_t i = 1; i < next_keys.size(); i++)
+            delete_key(next_keys[i]);
+
+        for (++iter; iter->get_rid().get_page_id() != INVALID_PAGE_ID; ++iter)
+            ASSERT_TRUE(scanned.insert(iter->get_value(*tb_schema, 0).get_value<integer_t>()).second);
+        for (auto key : existing)
+            ASSERT_EQ(1, scanned.count(key));
+    }
+    check();
+    PRINT("***test 5 pass***");
+
+    db_manager.reset(nullptr);
+    delete tb_schema;
+}
+
+/**
+ * keys are in the same link list as CompactionTest, a thread inserts half of them while another one
+ * deletes the other half, which compacts the list. Then they swap the halves.
+ *
+ * Test List:
+ *   1. no inserted tuple is lost when the list is compacted at the same time
+ */
+TEST_F(LinkHashBasicTest, ConcurrentCompactionTest) {
+    PRINT("start the link hash concurrent compaction tests...");
+    if (Lk_HA_TOTAL_SLOT_NUM > (1 << 22))
+        GTEST_SKIP();
+
+    std::vector<TypeId> col_types{TypeId::kInteger, TypeId::kChar};
+    std::vector<string_t> col_names{"key", "pad"};
+    size_t_ pad_sz = TablePage::get_tp_load_data_space() / 11 * 2;
+    Schema *tb_schema = create_table_schema(col_types, col_names, std::vector<size_t_>{pad_sz});
+    std::vector<integer_t> keys = find_list_keys(tb_schema->get_column(0), 12);
+    std::vector<integer_t> halves[2] = {std::vector<integer_t>(keys.begin(), keys.begin() + 6),
+        std::vector<integer_t>(keys.begin() + 6, keys.end())};
+
+    db_manager.reset(new DBManager(meta, true));
+    ASSERT_TRUE(db_manager->get_status());
+    CatalogTable *catalog_table = db_manager->get_catalog()->get_catalog_table();
+    ASSERT_TRUE(catalog_table->create_table(table_name, *tb_schema));
+    Table *table = catalog_table->get_table_meta_data(table_name)->get_table();
+
+    std::vector<char> pad(pad_sz + 1);
+    fill_char_array("padding", pad.data());
+    auto insert_keys = [&](const std::vector<integer_t> &ks) {
+        for (auto key : ks) {
+            std::vector<Value> vals{Value(key), Value(pad.data())};
+            Tuple tuple(&vals, *tb_schema);
+            EXPECT_TRUE(table->insert_tuple(&tuple, *tb_schema));
+        }
+    };
+    auto delete_keys = [&](const std::vector<integer_t> &ks) {
+        for (auto key : ks) {
+            EXPECT_TRUE(table->mark_delete(Value(key), *tb_schema));
+            table->apply_delete(Value(key), *tb_schema);
+        }
+    };
+
+    // ********************* test 1 ********************* //
+    insert_keys(halves[0]);
+    for (int round = 0; round < 200; round++) {
+        const std::vector<integer_t> &present = halves[round % 2];
+        const std::vector<integer_t> &absent = halves[(round + 1) % 2];
+        std::thread deleter(delete_keys, std::cref(present));
+        insert_keys(absent);
+        deleter.join();
+
+        Tuple tuple;
+        for (auto key : absent)
+            ASSERT_TRUE(table->get_tuple(Value(key), &tuple, *tb_schema));
+        for (auto key : present)
+            ASSERT_FALSE(table->get_tuple(Value(key), &tuple, *tb_schema));
+    }
+    PRINT("***test 1 pass***");
+
+    db_manager.reset(nullptr);
+    delete tb_schema;
+}
+
+/**
+ * Test List:
+ *   1. bulk load a batch with duplicated keys, nothing should be loaded
+ *   2. insert some tuples, then bulk load a lot of tuples, part of them are in the slots
+ *      that have had tuples. Check them with get_tuple() and the secondary index
+ *   3. bulk load a batch containing existing keys, the others should be loaded
+ *   4. bulk load a tuple larger than a page, the pages of the failed list should be deleted
+ */
+TEST_F(LinkHashBasicTest, BulkLoadTest) {
+    PRINT("start the link hash bulk load tests...");
+    Schema *tb_schema = create_table_schema(tb_col_types, tb_col_names, tb_char_size);
+    offset_t key_idx = tb_schema->get_key_idx();
+    offset_t idx_col = 2;
+    integer_t insert_num = 1000;
+    integer_t load_num = 10000;
+
+    db_manager.reset(new DBManager(meta, true));
+    ASSERT_TRUE(db_manager->get_status());
+
+    CatalogTable *catalog_table = db_manager->get_catalog()->get_catalog_table();
+    ASSERT_TRUE(catalog_table->create_table(table_name, *tb_schema));
+    TableMetaData *table_md = catalog_table->get_table_meta_data(table_name);
+    ASSERT_NE(nullptr, table_md);
+    Table *table = table_md->get_table();
+    ASSERT_TRUE(table_md->create_index(idx_col));
+    SecondaryIndex *index = table->get_index(idx_col);
+    ASSERT_NE(nullptr, index);
+
+    fill_char_array("apple", v1);
+    fill_char_array("monkey_key", v3);
+    auto make_tuples = [&](integer_t begin, integer_t end, std::vector<Tuple> *tuples) {
+        tuples->clear();
+        for (integer_t i = begin; i < end; i++) {
+            values.clear();
+            values.push_back(Value(i));
+            values.push_back(Value(v1));
+            values.push_back(Value(i % 2 == 0));
+            values.push_back(Value(v3));
+            values.push_back(Value(static_cast<decimal_t>(i)));
+            tuples->push_back(Tuple(&values, *tb_schema));
+        }
+    };
+
+    // ********************* test 1 ********************* //
+    std::vector<Tuple> tuples;
+    make_tuples(0, 100, &tuples);
+    tuples.push_back(tuples[50]);
+    ASSERT_FALSE(table->bulk_load(&tuples, *tb_schema));
+    Tuple tuple;
+    for (integer_t i = 0; i < 100; i++)
+        ASSERT_FALSE(table->get_tuple(Value(i), &tuple, *tb_schema));
+    PRINT("***test 1 pass***");
+
+    // ********************* test 2 ********************* //
+    make_tuples(0, insert_num, &tuples);
+    for (auto &t : tuples)
+        ASSERT_TRUE(table->insert_tuple(&t, *tb_schema));
+
+    make_tuples(insert_num, load_num, &tuples);
+    ASSERT_TRUE(table->bulk_load(&tuples, *tb_schema));
+    for (integer_t i = 0; i < load_num; i++) {
+        ASSERT_TRUE(table->get_tuple(Value(i), &tuple, *tb_schema));
+        ASSERT_EQ(Value(static_cast<decimal_t>(i)), tuple.get_value(*tb_schema, 4));
+    }
+    for (auto &t : tuples) {
+        ASSERT_TRUE(table->get_tuple(&tuple, t.get_rid()));
+        ASSERT_EQ(t.get_value(*tb_schema, key_idx), tuple.get_value(*tb_schema, key_idx));
+    }
+
+    size_t_ cnt = 0;
+    {
+        LinkHashTableIter tb_iter(table->get_first_table_page_id(), db_manager->get_buffer_pool_manager());
+        while (tb_iter->get_rid().get_page_id() != INVALID_PAGE_ID) {
+            ++cnt;
+            ++tb_iter;
+        }
+    }
+    ASSERT_EQ(static_cast<size_t_>(load_num), cnt);
+
+    for (int b = 0; b < 2; b++) {
+        std::vector<RID> rids;
+        index->scan_key(index->make_key(Value(b == 0)), &rids);
+        ASSERT_EQ(static_cast<size_t>(load_num / 2), rids.size());
+    }
+    PRINT("***test 2 pass***");
+
+    // ********************* test 3 ********************* //
+    make_tuples(load_num - 10, load_num + 10, &tuples);
+    ASSERT_FALSE(table->bulk_load(&tuples, *tb_schema));
+    for (integer_t i = load_num; i < load_num + 10; i++)
+        ASSERT_TRUE(table->get_tuple(Value(i), &tuple, *tb_schema));
+    for (size_t i = 0; i < tuples.size(); i++)
+        ASSERT_EQ(i >= 10, tuples[i].get_rid().get_page_id() != INVALID_PAGE_ID);
+    PRINT("***test 3 pass***");
+
+    // ********************* test 4 ********************* //
+    // CHAR isn't toasted, so the tuple can't fit in a page
+    Schema *large_schema = create_table_schema(std::vector<TypeId>{TypeId::kInteger, TypeId::kChar},
+        std::vector<string_t>{"large_col1", "large_col2"}, std::vector<size_t_>{PAGE_SIZE});
+    ASSERT_TRUE(catalog_table->create_table("large_table", *large_schema));
+    Table *large_table = catalog_table->get_table_meta_data("large_table")->get_table();
+    DiskManager *disk_manager = db_manager->get_disk_manager();
+    auto get_alloced_num = [&]() {
+        size_t_ num = 0;
+        for (page_id_t pgid = 0; pgid <= disk_manager->get_max_alloced_pgid(); pgid++)
+            num += disk_manager->is_allocated(pgid) ? 1 : 0;
+        return num;
+    };
+
+    values.clear();
+    values.push_back(Value(0));
+    values.push_back(Value(string_t(PAGE_SIZE / 2, 'x')));
+    std::vector<Tuple> large_tuples{Tuple(&values, *large_schema)};
+    // the first one may create the second level page
+    ASSERT_FALSE(large_table->bulk_load(&large_tuples, *large_schema));
+    size_t_ alloced_num = get_alloced_num();
+    ASSERT_FALSE(large_table->bulk_load(&large_tuples, *large_schema));
+    ASSERT_EQ(alloced_num, get_alloced_num());
+    ASSERT_FALSE(large_table->get_tuple(Value(0), &tuple, *large_schema));
+    PRINT("***test 4 pass***");
+
+    db_manager.reset(nullptr);
+    delete large_schema;
+    delete tb_schema;
+}
+
+/**
+ * Test List:
+ *   1. insert, update and delete tuples of a wide PAX table and check
+ *   2. restart the db, the table should still be PAX and the tuples are persisted
+ *   3. scan and project a few columns, only these columns are read from the pages
+ */
+TEST_F(LinkHashBasicTest, PaxTest) {
+    PRINT("start the link hash PAX tests...");
+    int col_num = 40;
+    std::vector<TypeId> col_types{TypeId::kInteger};
+    std::vector<string_t> col_names{"pax_col0"};
+    for (int i = 1; i < col_num; i++) {
+        col_types.push_back(i % 2 == 0 ? TypeId::kInteger : TypeId::kDecimal);
+        col_names.push_back("pax_col" + std::to_string(i));
+    }
+    Schema *tb_schema = create_table_schema(col_types, col_names);
+    ASSERT_TRUE(tb_schema->set_layout(PAX_LAYOUT));
+    integer_t insert_num = 3000;
+    table_id_t table_id;
+
+    auto make_tuple = [&](integer_t key, integer_t version) {
+        values.clear();
+        values.push_back(Value(key));
+        for (int i = 1; i < col_num; i++) {
+            if (i % 2 == 0)
+                values.push_back(Value(key * i + version));
+            else
+                values.push_back(Value(static_cast<decimal_t>(key) / i + version));
+        }
+        return Tuple(&values, *tb_schema);
+    };
+    auto version_of = [&](integer_t key) { return key % 7 == 0 ? 1 : 0; };
+    auto deleted = [&](integer_t key) { return key % 11 == 0; };
+
+    {
+        db_manager.reset(new DBManager(meta, true));
+        ASSERT_TRUE(db_manager->get_status());
+
+        CatalogTable *catalog_table = db_manager->get_catalog()->get_catalog_table();
+        ASSERT_TRUE(catalog_table->create_table(table_name, *tb_schema));
+        TableMetaData *table_md = catalog_table->get_table_meta_data(table_name);
+        ASSERT_NE(nullptr, table_md);
+        table_id = table_md->get_table_id();
+        Table *table = table_md->get_table();
+
+        // ********************* test 1 ********************* //
+        for (integer_t i = 0; i < insert_num; i++) {
+            Tuple tuple = make_tuple(i, 0);
+            ASSERT_TRUE(table->insert_tuple(&tuple, *tb_schema));
+        }
+        Tuple tuple;
+        for (integer_t i = 0; i < insert_num; i++) {
+            ASSERT_TRUE(table->get_tuple(Value(i), &tuple, *tb_schema));
+            ASSERT_EQ(make_tuple(i, 0), tuple);
+        }
+
+        for (integer_t i = 0; i < insert_num; i++) {
+            if (version_of(i) == 0)
+                continue;
+            ASSERT_TRUE(table->get_tuple(Value(i), &tuple, *tb_schema));
+            Tuple new_tuple = make_tuple(i, version_of(i));
+            ASSERT_TRUE(table->update_tuple(&new_tuple, tuple.get_rid(), *tb_schema));
+        }
+        for (integer_t i = 0; i < insert_num; i++) {
+            if (!deleted(i))
+                continue;
+            ASSERT_TRUE(table->mark_delete(Value(i), *tb_schema));
+            table->apply_delete(Value(i), *tb_schema);
+        }
+        PRINT("***test 1 pass***");
+    }
+
+    {
+        db_manager.reset(new DBManager(meta, false));
+        ASSERT_TRUE(db_manager->get_status());
+
+        // ********************* test 2 ********************* //
+        CatalogTable *catalog_table = db_manager->get_catalog()->get_catalog_table();
+        TableMetaData *table_md = catalog_table->get_table_meta_data(table_id);
+        ASSERT_NE(nullptr, table_md);
+        ASSERT_EQ(PAX_LAYOUT, table_md->get_table_schema()->get_layout());
+        Table *table = table_md->get_table();
+        Tuple tuple;
+        for (integer_t i = 0; i < insert_num; i++) {
+            if (deleted(i)) {
+                ASSERT_FALSE(table->get_tuple(Value(i), &tuple, *tb_schema));
+                continue;
+            }
+            ASSERT_TRUE(table->get_tuple(Value(i), &tuple, *tb_schema));
+            ASSERT_EQ(make_tuple(i, version_of(i)), tuple);
+        }
+        PRINT("***test 2 pass***");
+
+        // ********************* test 3 ********************* //
+        ExecutorContext exec_ctx(db_manager->get_buffer_pool_manager());
+        Schema *output_schema = create_table_schema(
+            std::vector<TypeId>{TypeId::kInteger, col_types[col_num - 2], col_types[col_num - 1]},
+            std::vector<string_t>{"key", "int", "dec"});
+        SeqScanExecutor *child = new SeqScanExecutor(&exec_ctx, table);
+        ColumnValueExpression key_expr(0);
+        ColumnValueExpression int_expr(col_num - 2);
+        ColumnValueExpression dec_expr(col_num - 1);
+        ProjectionExecutor proj(&exec_ctx, child, std::vector<ExpressionAbstract*>{&key_expr, &int_expr, &dec_expr},
+            tb_schema, output_schema);
+        proj.open();
+        integer_t cnt = 0;
+        while (proj.get_next(&tuple)) {
+            integer_t key = tuple.get_value(*output_schema, 0).get_value<integer_t>();
+            Tuple expected = make_tuple(key, version_of(key));
+            ASSERT_FALSE(deleted(key));
+            ASSERT_EQ(expected.get_value(*tb_schema, col_num - 2), tuple.get_value(*output_schema, 1));
+            ASSERT_EQ(expected.get_value(*tb_schema, col_num - 1), tuple.get_value(*output_schema, 2));
+            cnt++;
+        }
+        proj.close();
+        ASSERT_EQ(insert_num - (insert_num + 10) / 11, cnt);
+        PRINT("***test 3 pass***");
+
+        delete child;
+        delete output_schema;
+    }
+
+    db_manager.reset(nullptr);
+    delete tb_schema;
+}
+
+/**
+ * scan a table whose pages are far more than the buffer pool could contain,
+ * build with different DAWN_PAGE_SIZE to compare the throughput of the page sizes
+ */
+TEST_F(LinkHashBasicTest, ScanBenchmark) {
+    PRINT("start the link hash scan benchmark...");
+    Schema *tb_schema = create_table_schema(tb_col_types, tb_col_names, tb_char_size);
+    integer_t load_num = 100000;
+    table_id_t table_id;
+
+    {
+        db_manager.reset(new DBManager(meta, true));
+        ASSERT_TRUE(db_manager->get_status());
+
+        CatalogTable *catalog_table = db_manager->get_catalog()->get_catalog_table();
+        ASSERT_TRUE(catalog_table->create_table(table_name, *tb_schema));
+        TableMetaData *table_md = catalog_table->get_table_meta_data(table_name);
+        ASSERT_NE(nullptr, table_md);
+        table_id = table_md->get_table_id();
+
+        fill_char_array("apple", v1);
+        fill_char_array("monkey_key", v3);
+        std::vector<Tuple> tuples;
+        for (integer_t i = 0; i < load_num; i++) {
+            values.clear();
+            values.push_back(Value(i));
+            values.push_back(Value(v1));
+            values.push_back(Value(i % 2 == 0));
+            values.push_back(Value(v3));
+            values.push_back(Value(static_cast<decimal_t>(i)));
+            tuples.push_back(Tuple(&values, *tb_schema));
+        }
+        ASSERT_TRUE(table_md->get_table()->bulk_load(&tuples, *tb_schema));
+    }
+
+    // restart the db, so that the pages are read from the disk
+    db_manager.reset(new DBManager(meta, false));
+    ASSERT_TRUE(db_manager->get_status());
+    TableMetaData *table_md = db_manager->get_catalog()->get_catalog_table()->get_table_meta_data(table_id);
+    ASSERT_NE(nullptr, table_md);
+
+    size_t_ cnt = 0;
+    decimal_t sum = 0;
+    auto start = std::chrono::steady_clock::now();
+    {
+        LinkHashTableIter tb_iter(table_md->get_table()->get_first_table_page_id(),
+            db_manager->get_buffer_pool_manager());
+        while (tb_iter->get_rid().get_page_id() != INVALID_PAGE_ID) {
+            sum += tb_iter->get_value(*tb_schema, 4).get_value<decimal_t>();
+            ++cnt;
+            ++tb_iter;
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+    ASSERT_EQ(static_cast<size_t_>(load_num), cnt);
+    ASSERT_EQ(static_cast<decimal_t>(load_num) * (load_num - 1) / 2, sum);
+
+    auto us = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+    PRINT("page size:", PAGE_SIZE, "tuples:", cnt, "pages:", db_manager->get_disk_manager()->get_max_alloced_pgid() + 1,
+        "time(us):", us, "tuples/ms:", us == 0 ? 0 : cnt * 1000 / us);
+
+    db_manager.reset(nullptr);
+    delete tb_schema;
+}
+
 } // namespace dawn
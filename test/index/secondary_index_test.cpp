@@ -0,0 +1,476 @@
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <functional>
+#include <thread>
+#include "table/schema.h"
+#include "manager/db_manager.h"
+#include "table/table.h"
+#include "index/secondary_index.h"
+#include "executors/index_scan_executor.h"
+
+namespace dawn {
+
+extern std::unique_ptr<DBManager> db_manager;
+
+/**
+ * table name: table
+ * column types:
+ * ----------------------------------------------------
+ * | integer | char (5) | bool | char (10) | decimal |
+ * ----------------------------------------------------
+ * the secondary index is created on the second column, and it has only 10 distinct values
+ */
+string_t table_name("table");
+std::vector<TypeId> tb_col_types{TypeId::kInteger, TypeId::kChar, TypeId::kBoolean, TypeId::kChar, TypeId::kDecimal};
+std::vector<string_t> tb_col_names{"tb_col1", "tb_col2", "tb_col3", "tb_col4", "tb_col5"};
+std::vector<size_t_> tb_char_size{5, 10};
+offset_t idx_col = 1;
+int distinct_num = 10;
+
+const char *meta = "test";
+const char *mtdf = "test.mtd";
+const char *dbf = "test.db";
+const char *logf = "test.log";
+
+/** the value of the indexed column is decided by the key */
+void make_values(integer_t key, std::vector<Value> *values) {
+    char v1[6];
+    char v3[11];
+    fill_char_array("v" + std::to_string(key % distinct_num), v1);
+    fill_char_array("monkey_key", v3);
+    values->clear();
+    values->push_back(Value(key));
+    values->push_back(Value(v1));
+    values->push_back(Value(true));
+    values->push_back(Value(v3));
+    values->push_back(Value(3.1415926));
+}
+
+Value make_idx_key(int i) {
+    char v1[6];
+    fill_char_array("v" + std::to_string(i), v1);
+    return Value(v1);
+}
+
+class SecondaryIndexTest : public testing::Test {
+public:
+    void SetUp() {
+        DBManager::set_default_pool_size(50);
+        remove(mtdf);
+        remove(dbf);
+        remove(logf);
+    }
+
+    void TearDown() {
+        remove(mtdf);
+        remove(dbf);
+        remove(logf);
+    }
+};
+
+/**
+ * Test List:
+ *   1. create index after inserting some tuples, then insert more tuples,
+ *      check the index with all the distinct values
+ *   2. update and delete some tuples and check
+ *   3. restart the db to ensure the index is loaded from the disk
+ *   4. get tuples with IndexScanExecutor
+ */
+TEST_F(SecondaryIndexTest, BasicTest) {
+    PRINT("start the secondary index tests...");
+    Schema *tb_schema = create_table_schema(tb_col_types, tb_col_names, tb_char_size);
+    integer_t insert_num = 5000;
+    table_id_t table_id;
+    std::vector<Value> values;
+
+    // count of each distinct value
+    std::vector<size_t> expect_cnt(distinct_num, 0);
+
+    {
+        db_manager.reset(new DBManager(meta, true));
+        ASSERT_TRUE(db_manager->get_status());
+
+        CatalogTable *catalog_table = db_manager->get_catalog()->get_catalog_table();
+        ASSERT_TRUE(catalog_table->create_table(table_name, *tb_schema));
+        TableMetaData *table_md = catalog_table->get_table_meta_data(table_name);
+        ASSERT_NE(nullptr, table_md);
+        table_id = table_md->get_table_id();
+        Table *table = table_md->get_table();
+
+        // ********************* test 1 ********************* //
+        for (integer_t i = 0; i < insert_num; i++) {
+            if (i == insert_num / 2) {
+                ASSERT_TRUE(table_md->create_index(idx_col));
+                ASSERT_FALSE(table_md->create_index(idx_col));
+                ASSERT_FALSE(table_md->create_index(idx_col + 1, BP_TREE));
+            }
+            make_values(i, &values);
+            Tuple tuple(&values, *tb_schema);
+            ASSERT_TRUE(table->insert_tuple(&tuple, *tb_schema));
+            expect_cnt[i % distinct_num]++;
+        }
+
+        SecondaryIndex *index = table->get_index(idx_col);
+        ASSERT_NE(nullptr, index);
+        for (int i = 0; i < distinct_num; i++) {
+            std::vector<RID> rids;
+            index->scan_key(index->make_key(make_idx_key(i)), &rids);
+            ASSERT_EQ(expect_cnt[i], rids.size());
+
+            Tuple tuple;
+            for (auto &rid : rids) {
+                ASSERT_TRUE(table->get_tuple(&tuple, rid));
+                ASSERT_EQ(make_idx_key(i), tuple.get_value(*tb_schema, idx_col));
+            }
+        }
+        PRINT("***test 1 pass***");
+
+        // ********************* test 2 ********************* //
+        // move the tuples with "v0" to "v1" without changing the key
+        for (integer_t i = 0; i < insert_num; i += distinct_num) {
+            Tuple old_tuple;
+            ASSERT_TRUE(table->get_tuple(Value(i), &old_tuple, *tb_schema));
+            make_values(i + 1, &values);
+            values[0] = Value(i);
+            Tuple new_tuple(&values, *tb_schema);
+            ASSERT_TRUE(table->update_tuple(&new_tuple, old_tuple.get_rid(), *tb_schema));
+            expect_cnt[0]--;
+            expect_cnt[1]++;
+        }
+
+        // delete the tuples with "v2"
+        for (integer_t i = 2; i < insert_num; i += distinct_num) {
+            ASSERT_TRUE(table->mark_delete(Value(i), *tb_schema));
+            table->apply_delete(Value(i), *tb_schema);
+            expect_cnt[2]--;
+        }
+
+        for (int i = 0; i < distinct_num; i++) {
+            std::vector<RID> rids;
+            index->scan_key(index->make_key(make_idx_key(i)), &rids);
+            ASSERT_EQ(expect_cnt[i], rids.size());
+        }
+        PRINT("***test 2 pass***");
+    }
+
+    {
+        // ********************* test 3 ********************* //
+        db_manager.reset(new DBManager(meta, false));
+        ASSERT_TRUE(db_manager->get_status());
+
+        CatalogTable *catalog_table = db_manager->get_catalog()->get_catalog_table();
+        TableMetaData *table_md = catalog_table->get_table_meta_data(table_id);
+        ASSERT_NE(nullptr, table_md);
+        Table *table = table_md->get_table();
+        SecondaryIndex *index = table->get_index(idx_col);
+        ASSERT_NE(nullptr, index);
+        ASSERT_EQ(nullptr, table->get_index(idx_col + 1));
+
+        for (int i = 0; i < distinct_num; i++) {
+            std::vector<RID> rids;
+            index->scan_key(index->make_key(make_idx_key(i)), &rids);
+            ASSERT_EQ(expect_cnt[i], rids.size());
+        }
+        PRINT("***test 3 pass***");
+
+        // ********************* test 4 ********************* //
+        ExecutorContext exec_ctx(db_manager->get_buffer_pool_manager());
+        for (int i = 0; i < distinct_num; i++) {
+            IndexScanExecutor exec(&exec_ctx, table, index, index->make_key(make_idx_key(i)));
+            exec.open();
+            Tuple tuple;
+            size_t cnt = 0;
+            while (exec.get_next(&tuple)) {
+                ASSERT_EQ(make_idx_key(i), tuple.get_value(*tb_schema, idx_col));
+                cnt++;
+            }
+            exec.close();
+            ASSERT_EQ(expect_cnt[i], cnt);
+        }
+        PRINT("***test 4 pass***");
+    }
+
+    db_manager.reset(nullptr);
+    delete tb_schema;
+}
+
+/**
+ * Test List:
+ *   1. create the index on (tb_col3, tb_col2), and check it with all the keys
+ */
+TEST_F(SecondaryIndexTest, CompositeTest) {
+    PRINT("start the composite secondary index tests...");
+    Schema *tb_schema = create_table_schema(tb_col_types, tb_col_names, tb_char_size);
+    integer_t insert_num = 3000;
+    std::vector<Value> values;
+    std::vector<offset_t> col_idxs{2, idx_col};
+
+    db_manager.reset(new DBManager(meta, true));
+    ASSERT_TRUE(db_manager->get_status());
+
+    CatalogTable *catalog_table = db_manager->get_catalog()->get_catalog_table();
+    ASSERT_TRUE(catalog_table->create_table(table_name, *tb_schema));
+    TableMetaData *table_md = catalog_table->get_table_meta_data(table_name);
+    ASSERT_NE(nullptr, table_md);
+    Table *table = table_md->get_table();
+    ASSERT_TRUE(table_md->create_index(col_idxs));
+    ASSERT_TRUE(table_md->create_index(idx_col));
+
+    // ********************* test 1 ********************* //
+    for (integer_t i = 0; i < insert_num; i++) {
+        make_values(i, &values);
+        values[2] = Value(i % 2 == 0);
+        Tuple tuple(&values, *tb_schema);
+        ASSERT_TRUE(table->insert_tuple(&tuple, *tb_schema));
+    }
+
+    SecondaryIndex *index = table->get_index(col_idxs);
+    ASSERT_NE(nullptr, index);
+    ASSERT_NE(index, table->get_index(idx_col));
+    std::vector<Column> key_cols{tb_schema->get_column(2), tb_schema->get_column(idx_col)};
+    for (int i = 0; i < distinct_num; i++) {
+        for (int b = 0; b < 2; b++) {
+            std::vector<RID> rids;
+            IndexKey key(std::vector<Value>{Value(b == 1), make_idx_key(i)}, key_cols);
+            index->scan_key(key, &rids);
+            size_t expect = ((i % 2 == 0) == (b == 1)) ? insert_num / distinct_num : 0;
+            ASSERT_EQ(expect, rids.size());
+        }
+    }
+    PRINT("***test 1 pass***");
+
+    db_manager.reset(nullptr);
+    delete tb_schema;
+}
+
+/**
+ * Test List:
+ *   1. insert tuples with varchar columns of different lengths, check them with
+ *      the primary index and a secondary index on the varchar column
+ *   2. grow the tuples so that some of them have to move to other pages, and check again
+ *   3. restart the db to ensure the varchar columns are loaded from the disk
+ */
+TEST_F(SecondaryIndexTest, VarcharTest) {
+    PRINT("start the varchar secondary index tests...");
+    Schema *tb_schema = create_table_schema(std::vector<TypeId>{TypeId::kInteger, TypeId::kVarchar, TypeId::kVarchar},
+        std::vector<string_t>{"tb_col1", "tb_col2", "tb_col3"}, std::vector<size_t_>{200, 20});
+    integer_t insert_num = 2000;
+    table_id_t table_id;
+    offset_t var_idx_col = 2;
+
+    auto make_var_values = [&](integer_t key, size_t_ len, std::vector<Value> *values) {
+        values->clear();
+        values->push_back(Value(key));
+        values->push_back(Value(string_t(len, 'x')));
+        values->push_back(Value("v" + std::to_string(key % distinct_num)));
+    };
+    auto check_tuples = [&](Table *table, const std::vector<size_t_> &lens) {
+        SecondaryIndex *index = table->get_index(var_idx_col);
+        ASSERT_NE(nullptr, index);
+        for (int i = 0; i < distinct_num; i++) {
+            std::vector<RID> rids;
+            index->scan_key(index->make_key(Value("v" + std::to_string(i))), &rids);
+            ASSERT_EQ(static_cast<size_t>(insert_num / distinct_num), rids.size());
+        }
+
+        Tuple tuple;
+        for (integer_t i = 0; i < insert_num; i++) {
+            ASSERT_TRUE(table->get_tuple(Value(i), &tuple, *tb_schema));
+            ASSERT_EQ(Value(string_t(lens[i], 'x')), tuple.get_value(*tb_schema, 1));
+            ASSERT_EQ(Value("v" + std::to_string(i % distinct_num)), tuple.get_value(*tb_schema, var_idx_col));
+        }
+    };
+
+    std::vector<size_t_> lens;
+    std::vector<Value> values;
+    {
+        db_manager.reset(new DBManager(meta, true));
+        ASSERT_TRUE(db_manager->get_status());
+
+        CatalogTable *catalog_table = db_manager->get_catalog()->get_catalog_table();
+        ASSERT_TRUE(catalog_table->create_table(table_name, *tb_schema));
+        TableMetaData *table_md = catalog_table->get_table_meta_data(table_name);
+        ASSERT_NE(nullptr, table_md);
+        table_id = table_md->get_table_id();
+        Table *table = table_md->get_table();
+        ASSERT_TRUE(table_md->create_index(var_idx_col));
+
+        // ********************* test 1 ********************* //
+        for (integer_t i = 0; i < insert_num; i++) {
+            lens.push_back(i % 50);
+            make_var_values(i, lens[i], &values);
+            Tuple tuple(&values, *tb_schema);
+            ASSERT_TRUE(table->insert_tuple(&tuple, *tb_schema));
+        }
+        check_tuples(table, lens);
+        PRINT("***test 1 pass***");
+
+        // ********************* test 2 ********************* //
+        for (integer_t i = 0; i < insert_num; i += 3) {
+            Tuple old_tuple;
+            ASSERT_TRUE(table->get_tuple(Value(i), &old_tuple, *tb_schema));
+            lens[i] = 200;
+            make_var_values(i, lens[i], &values);
+            Tuple new_tuple(&values, *tb_schema);
+            ASSERT_TRUE(table->update_tuple(&new_tuple, old_tuple.get_rid(), *tb_schema));
+        }
+        check_tuples(table, lens);
+        PRINT("***test 2 pass***");
+    }
+
+    {
+        // ********************* test 3 ********************* //
+        db_manager.reset(new DBManager(meta, false));
+        ASSERT_TRUE(db_manager->get_status());
+
+        CatalogTable *catalog_table = db_manager->get_catalog()->get_catalog_table();
+        TableMetaData *table_md = catalog_table->get_table_meta_data(table_id);
+        ASSERT_NE(nullptr, table_md);
+        const Schema *schema = table_md->get_table_schema();
+        for (size_t_ i = 0; i < tb_schema->get_column_num(); i++)
+            ASSERT_TRUE(Column::is_columns_equal(tb_schema->get_column(i), schema->get_column(i)));
+        check_tuples(table_md->get_table(), lens);
+        PRINT("***test 3 pass***");
+    }
+
+    db_manager.reset(nullptr);
+    delete tb_schema;
+}
+
+/**
+ * Test List:
+ *   1. create indexes on different column sequences until the index header page is full,
+ *      the next index should be refused
+ *   2. restart the db to ensure all the indexes are loaded from the disk, and check one of them
+ */
+TEST_F(SecondaryIndexTest, MaxIndexTest) {
+    PRINT("start the max index number tests...");
+    Schema *tb_schema = create_table_schema(tb_col_types, tb_col_names, tb_char_size);
+    integer_t insert_num = 100;
+    table_id_t table_id;
+    std::vector<Value> values;
+
+    // the ordered column sequences without repeated columns, shorter ones first
+    std::vector<std::vector<offset_t>> col_seqs;
+    std::vector<offset_t> seq;
+    std::function<void(size_t_)> make_seqs = [&](size_t_ len) {
+        if (seq.size() == len) {
+            col_seqs.push_back(seq);
+            return;
+        }
+        for (offset_t i = 0; i < tb_col_types.size(); i++) {
+            if (std::find(seq.begin(), seq.end(), i) != seq.end())
+                continue;
+            seq.push_back(i);
+            make_seqs(len);
+            seq.pop_back();
+        }
+    };
+    for (size_t_ len = 1; len <= tb_col_types.size() && col_seqs.size() <= TableMetaData::MAX_INDEX_NUM; len++)
+        make_seqs(len);
+    if (col_seqs.size() <= TableMetaData::MAX_INDEX_NUM) {
+        delete tb_schema;
+        GTEST_SKIP() << "not enough column sequences for the page size";
+    }
+    // every index keeps its first level page pinned
+    DBManager::set_default_pool_size(TableMetaData::MAX_INDEX_NUM + 50);
+
+    {
+        db_manager.reset(new DBManager(meta, true));
+        ASSERT_TRUE(db_manager->get_status());
+
+        CatalogTable *catalog_table = db_manager->get_catalog()->get_catalog_table();
+        ASSERT_TRUE(catalog_table->create_table(table_name, *tb_schema));
+        TableMetaData *table_md = catalog_table->get_table_meta_data(table_name);
+        ASSERT_NE(nullptr, table_md);
+        table_id = table_md->get_table_id();
+        Table *table = table_md->get_table();
+        for (integer_t i = 0; i < insert_num; i++) {
+            make_values(i, &values);
+            Tuple tuple(&values, *tb_schema);
+            ASSERT_TRUE(table->insert_tuple(&tuple, *tb_schema));
+        }
+
+        // ********************* test 1 ********************* //
+        for (size_t_ i = 0; i < TableMetaData::MAX_INDEX_NUM; i++)
+            ASSERT_TRUE(table_md->create_index(col_seqs[i]));
+        ASSERT_FALSE(table_md->create_index(col_seqs[TableMetaData::MAX_INDEX_NUM]));
+        ASSERT_EQ(TableMetaData::MAX_INDEX_NUM, table->get_indexes().size());
+        ASSERT_EQ(nullptr, table->get_index(col_seqs[TableMetaData::MAX_INDEX_NUM]));
+        PRINT("***test 1 pass***");
+    }
+
+    {
+        // ********************* test 2 ********************* //
+        db_manager.reset(new DBManager(meta, false));
+        ASSERT_TRUE(db_manager->get_status());
+
+        CatalogTable *catalog_table = db_manager->get_catalog()->get_catalog_table();
+        TableMetaData *table_md = catalog_table->get_table_meta_data(table_id);
+        ASSERT_NE(nullptr, table_md);
+        Table *table = table_md->get_table();
+        ASSERT_EQ(TableMetaData::MAX_INDEX_NUM, table->get_indexes().size());
+        ASSERT_NE(nullptr, table->get_index(col_seqs[TableMetaData::MAX_INDEX_NUM - 1]));
+        SecondaryIndex *index = table->get_index(idx_col);
+        ASSERT_NE(nullptr, index);
+        for (int i = 0; i < distinct_num; i++) {
+            std::vector<RID> rids;
+            index->scan_key(index->make_key(make_idx_key(i)), &rids);
+            ASSERT_EQ(static_cast<size_t>(insert_num / distinct_num), rids.size());
+        }
+        PRINT("***test 2 pass***");
+    }
+
+    db_manager.reset(nullptr);
+    delete tb_schema;
+}
+
+/**
+ * Test List:
+ *   1. create the index when another thread is inserting tuples,
+ *      check that the tuples inserted during the creation are indexed
+ */
+TEST_F(SecondaryIndexTest, ConcurrentCreateTest) {
+    PRINT("start the concurrent index creation tests...");
+    Schema *tb_schema = create_table_schema(tb_col_types, tb_col_names, tb_char_size);
+    integer_t before_num = 2000;
+    integer_t insert_num = 6000;
+
+    db_manager.reset(new DBManager(meta, true));
+    ASSERT_TRUE(db_manager->get_status());
+
+    CatalogTable *catalog_table = db_manager->get_catalog()->get_catalog_table();
+    ASSERT_TRUE(catalog_table->create_table(table_name, *tb_schema));
+    TableMetaData *table_md = catalog_table->get_table_meta_data(table_name);
+    ASSERT_NE(nullptr, table_md);
+    Table *table = table_md->get_table();
+
+    auto insert_tuples = [&](integer_t begin, integer_t end) {
+        std::vector<Value> values;
+        for (integer_t i = begin; i < end; i++) {
+            make_values(i, &values);
+            Tuple tuple(&values, *tb_schema);
+            ASSERT_TRUE(table->insert_tuple(&tuple, *tb_schema));
+        }
+    };
+    insert_tuples(0, before_num);
+
+    // ********************* test 1 ********************* //
+    std::thread writer(insert_tuples, before_num, insert_num);
+    ASSERT_TRUE(table_md->create_index(idx_col));
+    writer.join();
+
+    SecondaryIndex *index = table->get_index(idx_col);
+    ASSERT_NE(nullptr, index);
+    for (int i = 0; i < distinct_num; i++) {
+        std::vector<RID> rids;
+        index->scan_key(index->make_key(make_idx_key(i)), &rids);
+        ASSERT_EQ(static_cast<size_t>(insert_num / distinct_num), rids.size());
+    }
+    PRINT("***test 1 pass***");
+
+    db_manager.reset(nullptr);
+    delete tb_schema;
+}
+
+} // namespace dawn
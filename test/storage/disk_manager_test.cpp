@@ -31,6 +31,8 @@ public:
     offset_t get_log_name_offset() const { return log_name_offset; }
     offset_t get_max_ava_pgid_offset() const { return max_ava_pgid_offset; }
     offset_t get_catalog_pgid_offset() const { return catalog_pgid_offset; }
+    offset_t get_page_size_offset() const { return page_size_offset; }
+    offset_t get_format_version_offset() const { return format_version_offset; }
     offset_t get_reserved_offset() const { return reserved_offset; }
 };
 
@@ -118,8 +120,14 @@ bool create_meta_file(const char *name, page_id_t max_ava_pgid) {
     catalog_pgid_offset = max_ava_pgid_offset + PGID_T_SIZE;
     *reinterpret_cast<page_id_t*>(buf+catalog_pgid_offset) = 123;
 
-    reserved_offset = catalog_pgid_offset + sizeof(page_id_t);
-    memset(buf + reserved_offset, 0, 128);
+    offset_t page_size_offset = catalog_pgid_offset + sizeof(page_id_t);
+    *reinterpret_cast<size_t_*>(buf+page_size_offset) = PAGE_SIZE;
+
+    offset_t format_version_offset = page_size_offset + SIZE_T_SIZE;
+    *reinterpret_cast<int32_t*>(buf+format_version_offset) = DB_FORMAT_VERSION;
+
+    reserved_offset = format_version_offset + sizeof(int32_t);
+    memset(buf + reserved_offset, 0, 120);
 
     // write meta data to the meta file
     meta_io.seekg(0);
@@ -155,7 +163,7 @@ bool read_write_pages_check(DiskManager_T &dmt, int page_num) {
     }
 
     // read
-    char read_buf[4096];
+    char read_buf[PAGE_SIZE];
     bool ok = true;
     for (auto iter = s.begin(); iter != s.end(); iter++) {
         if (!dmt.read_page(*iter, read_buf))
@@ -192,6 +200,9 @@ bool read_write_pages_check(DiskManager_T &dmt, int page_num) {
  *   1. create mode: check files have been created and values have been written into the .mtd
  *   2. read mode: read all files successfully and initialize data correctly
  *   3. read mode: db should collect page id's info correctly when it starts
+ *   4. the database can't be opened with a different page size
+ *   5. the database can't be opened with a different format version, unless it's the first
+ *      version written before the version is recorded
  */
 TEST_F(DiskManagerTest, ConstructorTEST) {
     const char *meta = "test";
@@ -255,6 +266,12 @@ TEST_F(DiskManagerTest, ConstructorTEST) {
         pg = reinterpret_cast<page_id_t*>(buf + dmt.get_catalog_pgid_offset());
         EXPECT_EQ(0, *pg);
 
+        p = reinterpret_cast<int*>(buf + dmt.get_page_size_offset());
+        EXPECT_EQ(PAGE_SIZE, *p);
+
+        p = reinterpret_cast<int*>(buf + dmt.get_format_version_offset());
+        EXPECT_EQ(DB_FORMAT_VERSION, *p);
+
         char rbuf[PAGE_SIZE];
         EXPECT_TRUE(dmt.read_page(0, rbuf));
         EXPECT_EQ(rbuf[0], STATUS_EXIST);
@@ -333,6 +350,79 @@ TEST_F(DiskManagerTest, ConstructorTEST) {
         }
     }
 
+    {
+        // test 4: the database can't be opened with a different page size
+        offset_t page_size_offset;
+        {
+            DiskManager_T dmt(meta);
+            ASSERT_TRUE(dmt.get_status());
+            page_size_offset = dmt.get_page_size_offset();
+        }
+
+        fstream_t f;
+        ASSERT_TRUE(open_file(mtdf, f, ios::in | ios::out));
+        size_t_ page_size = PAGE_SIZE * 2;
+        f.seekp(page_size_offset);
+        f.write(reinterpret_cast<char*>(&page_size), SIZE_T_SIZE);
+        f.close();
+
+        DiskManager dm(meta);
+        EXPECT_FALSE(dm.get_status());
+    }
+
+    {
+        // test 5: the database can't be opened with a different format version
+        offset_t page_size_offset;
+        offset_t format_version_offset;
+        remove(mtdf);
+        remove(dbf);
+        remove(logf);
+        {
+            DiskManager_T dmt(meta, true);
+            ASSERT_TRUE(dmt.get_status());
+            page_size_offset = dmt.get_page_size_offset();
+            format_version_offset = dmt.get_format_version_offset();
+        }
+
+        auto write_format = [&](size_t_ page_size, int32_t format_version) {
+            fstream_t f;
+            ASSERT_TRUE(open_file(mtdf, f, ios::in | ios::out));
+            f.seekp(page_size_offset);
+            f.write(reinterpret_cast<char*>(&page_size), SIZE_T_SIZE);
+            f.seekp(format_version_offset);
+            f.write(reinterpret_cast<char*>(&format_version), sizeof(int32_t));
+            f.close();
+        };
+
+        // written before the page size is recorded, the pages have no key filter
+        write_format(0, 0);
+        {
+            DiskManager dm(meta);
+            EXPECT_FALSE(dm.get_status());
+        }
+
+        write_format(PAGE_SIZE, DB_FORMAT_VERSION + 1);
+        {
+            DiskManager dm(meta);
+            EXPECT_FALSE(dm.get_status());
+        }
+
+        // written after the page size is recorded but before the version is recorded
+        write_format(PAGE_SIZE, 0);
+        {
+            DiskManager_T dmt(meta);
+            EXPECT_TRUE(dmt.get_status());
+        }
+
+        // the version is recorded when the database is shut down
+        fstream_t f;
+        ASSERT_TRUE(open_file(mtdf, f, ios::in));
+        int32_t format_version;
+        f.seekg(format_version_offset);
+        f.read(reinterpret_cast<char*>(&format_version), sizeof(int32_t));
+        EXPECT_EQ(DB_FORMAT_VERSION, format_version);
+    }
+
     remove(mtdf);
     remove(dbf);
     remove(logf);
@@ -0,0 +1,101 @@
+#include "gtest/gtest.h"
+#include "util/config.h"
+#include "util/util.h"
+#include "storage/page/slot_search.h"
+#include "storage/page/table_page.h"
+
+#include <chrono>
+#include <random>
+#include <vector>
+
+namespace dawn {
+
+std::vector<SlotSearchKernel> all_kernels{SlotSearchKernel::kScalar, SlotSearchKernel::kSSE4, SlotSearchKernel::kAVX2};
+std::vector<const char*> kernel_names{"scalar", "sse4", "avx2"};
+
+/** records of a page, the slot is empty when it's offset is 0 */
+void make_records(const std::vector<bool> &live, std::vector<offset_t> *records) {
+    records->assign(live.size() * 2, 0);
+    for (size_t i = 0; i < live.size(); i++) {
+        (*records)[2 * i] = live[i] ? PAGE_SIZE - static_cast<offset_t>(i) : 0;
+        (*records)[2 * i + 1] = live[i] ? 16 : 0;
+    }
+}
+
+/**
+ * Test List:
+ *   1. every kernel gets the same result as a plain loop with random records
+ */
+TEST(SlotSearchTest, KernelTest) {
+    PRINT("start the slot search tests...");
+    std::default_random_engine dre(2021);
+    std::uniform_int_distribution<int> di(0, 99);
+
+    // ********************* test 1 ********************* //
+    for (int round = 0; round < 200; round++) {
+        size_t_ count = di(dre) * 3;
+        int live_rate = di(dre);
+        std::vector<bool> live(count);
+        for (size_t_ i = 0; i < count; i++)
+            live[i] = di(dre) < live_rate;
+        std::vector<offset_t> records;
+        make_records(live, &records);
+        const char *data = reinterpret_cast<const char*>(records.data());
+
+        size_t_ live_cnt = 0;
+        for (size_t_ i = 0; i < count; i++)
+            live_cnt += live[i];
+
+        for (auto kernel : all_kernels) {
+            const SlotSearchFuncs *funcs = get_slot_search_funcs(kernel);
+            if (funcs == nullptr)
+                continue;
+            ASSERT_EQ(live_cnt, funcs->count_live(data, count));
+            for (offset_t begin = 0; begin <= count; begin++) {
+                for (bool empty : {true, false}) {
+                    offset_t expect = begin;
+                    while (expect < count && live[expect] == empty)
+                        expect++;
+                    ASSERT_EQ(expect, funcs->find_slot(data, begin, count, empty));
+                }
+            }
+        }
+    }
+    PRINT("***test 1 pass***");
+}
+
+/**
+ * compare the kernels on a full page of the smallest tuples,
+ * the only empty slot is at the end, so the whole record array is scanned
+ */
+TEST(SlotSearchTest, Benchmark) {
+    PRINT("start the slot search benchmark...");
+    size_t_ count = TablePage::get_tp_num_capacity(INTEGER_T_SIZE);
+    std::vector<bool> live(count, true);
+    live[count - 1] = false;
+    std::vector<offset_t> records;
+    make_records(live, &records);
+    const char *data = reinterpret_cast<const char*>(records.data());
+    int loop = 100000;
+
+    for (size_t k = 0; k < all_kernels.size(); k++) {
+        const SlotSearchFuncs *funcs = get_slot_search_funcs(all_kernels[k]);
+        if (funcs == nullptr) {
+            PRINT(kernel_names[k], "is not supported");
+            continue;
+        }
+
+        size_t_ sum = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < loop; i++) {
+            sum += funcs->find_slot(data, 0, count, true);
+            sum += funcs->count_live(data, count);
+        }
+        auto end = std::chrono::steady_clock::now();
+        ASSERT_EQ(static_cast<size_t_>(loop) * 2 * (count - 1), sum);
+        PRINT(kernel_names[k], "slots:", count, "time(us):",
+            std::chrono::duration_cast<std::chrono::microseconds>(end - start).count());
+    }
+}
+
+} // namespace dawn
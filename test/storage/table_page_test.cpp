@@ -0,0 +1,211 @@
+#include "gtest/gtest.h"
+#include "util/config.h"
+#include "util/util.h"
+#include "storage/page/table_page.h"
+#include "table/schema.h"
+
+#include <vector>
+
+namespace dawn {
+
+/**
+ * Test List:
+ *   1. fill the page, delete every other tuple and fill it again,
+ *      the empty slots should be reused from the lowest one
+ *   2. delete all the tuples, the page should have the same free space as a new one
+ */
+TEST(TablePageTest, FreeSlotTest) {
+    PRINT("start the TablePage free slot tests...");
+    Schema *schema = create_table_schema(std::vector<TypeId>{TypeId::kInteger}, std::vector<string_t>{"col"});
+    Page raw_page(1);
+    TablePage *page = reinterpret_cast<TablePage*>(&raw_page);
+    page->init(INVALID_PAGE_ID, INVALID_PAGE_ID);
+    size_t_ new_page_space = page->get_free_space();
+
+    auto make_tuple = [&](integer_t i) {
+        std::vector<Value> values{Value(i)};
+        return Tuple(&values, *schema);
+    };
+
+    // ********************* test 1 ********************* //
+    std::vector<RID> rids;
+    RID rid;
+    integer_t i = 0;
+    while (page->insert_tuple(make_tuple(i), &rid)) {
+        ASSERT_EQ(i, rid.get_slot_num());
+        rids.push_back(rid);
+        i++;
+    }
+    size_t_ capacity = rids.size();
+    ASSERT_EQ(TablePage::get_tp_num_capacity(INTEGER_T_SIZE), capacity);
+
+    for (size_t_ slot = 0; slot < capacity; slot += 2) {
+        ASSERT_TRUE(page->mark_delete(rids[slot]));
+        page->apply_delete(rids[slot]);
+    }
+    ASSERT_EQ(capacity / 2, page->get_stored_tuple_cnt());
+
+    for (size_t_ slot = 0; slot < capacity; slot += 2) {
+        ASSERT_TRUE(page->insert_tuple(make_tuple(slot), &rid));
+        ASSERT_EQ(slot, rid.get_slot_num());
+    }
+    ASSERT_FALSE(page->insert_tuple(make_tuple(capacity), &rid));
+    ASSERT_EQ(capacity, page->get_stored_tuple_cnt());
+
+    Tuple tuple;
+    for (size_t_ slot = 0; slot < capacity; slot++) {
+        ASSERT_TRUE(page->get_tuple(&tuple, rids[slot]));
+        ASSERT_EQ(Value(slot), tuple.get_value(*schema, 0));
+    }
+    PRINT("***test 1 pass***");
+
+    // ********************* test 2 ********************* //
+    for (size_t_ slot = 0; slot < capacity; slot++) {
+        ASSERT_TRUE(page->mark_delete(rids[slot]));
+        page->apply_delete(rids[slot]);
+    }
+    ASSERT_EQ(0, page->get_stored_tuple_cnt());
+    ASSERT_EQ(new_page_space, page->get_free_space());
+    ASSERT_TRUE(page->insert_tuple(make_tuple(0), &rid));
+    ASSERT_EQ(0, rid.get_slot_num());
+    PRINT("***test 2 pass***");
+
+    delete schema;
+}
+
+/**
+ * Test List:
+ *   1. insert tuples with different sizes, then grow and shrink them in place,
+ *      the other tuples should not be affected
+ *   2. the update fails when the page can't contain the larger tuple
+ */
+TEST(TablePageTest, VarcharTest) {
+    PRINT("start the TablePage varchar tests...");
+    Schema *schema = create_table_schema(std::vector<TypeId>{TypeId::kInteger, TypeId::kVarchar},
+        std::vector<string_t>{"col1", "col2"}, std::vector<size_t_>{PAGE_SIZE});
+    Page raw_page(1);
+    TablePage *page = reinterpret_cast<TablePage*>(&raw_page);
+    page->init(INVALID_PAGE_ID, INVALID_PAGE_ID);
+
+    auto make_tuple = [&](integer_t i, size_t_ len) {
+        std::vector<Value> values{Value(i), Value(string_t(len, 'a' + i % 26))};
+        return Tuple(&values, *schema);
+    };
+
+    // ********************* test 1 ********************* //
+    integer_t tuple_num = 20;
+    std::vector<size_t_> lens;
+    std::vector<RID> rids(tuple_num);
+    for (integer_t i = 0; i < tuple_num; i++) {
+        lens.push_back(i * 7 % 50);
+        Tuple tuple = make_tuple(i, lens[i]);
+        ASSERT_EQ(schema->get_tuple_size() + lens[i], tuple.get_size());
+        ASSERT_TRUE(page->insert_tuple(tuple, &rids[i]));
+    }
+
+    for (integer_t i = 0; i < tuple_num; i++) {
+        lens[i] = i % 2 == 0 ? lens[i] + 30 : lens[i] / 2;
+        ASSERT_TRUE(page->update_tuple(make_tuple(i, lens[i]), rids[i]));
+    }
+
+    Tuple tuple;
+    for (integer_t i = 0; i < tuple_num; i++) {
+        ASSERT_TRUE(page->get_tuple(&tuple, rids[i]));
+        ASSERT_EQ(Value(i), tuple.get_value(*schema, 0));
+        ASSERT_EQ(Value(string_t(lens[i], 'a' + i % 26)), tuple.get_value(*schema, 1));
+    }
+    PRINT("***test 1 pass***");
+
+    // ********************* test 2 ********************* //
+    size_t_ free_space = page->get_free_space();
+    ASSERT_FALSE(page->update_tuple(make_tuple(0, lens[0] + free_space + 1), rids[0]));
+    ASSERT_TRUE(page->update_tuple(make_tuple(0, lens[0] + free_space), rids[0]));
+    ASSERT_EQ(0, page->get_free_space());
+    ASSERT_TRUE(page->get_tuple(&tuple, rids[1]));
+    ASSERT_EQ(Value(string_t(lens[1], 'b')), tuple.get_value(*schema, 1));
+    PRINT("***test 2 pass***");
+
+    delete schema;
+}
+
+/**
+ * Test List:
+ *   1. fill the PAX page, the tuples should be gathered from the mini pages correctly
+ *      and the values of a column should be contiguous
+ *   2. read some columns only, the others are 0
+ *   3. update and delete some tuples, then fill the page again
+ */
+TEST(TablePageTest, PaxTest) {
+    PRINT("start the TablePage PAX tests...");
+    Schema *schema = create_table_schema(std::vector<TypeId>{TypeId::kInteger, TypeId::kChar, TypeId::kDecimal},
+        std::vector<string_t>{"col1", "col2", "col3"}, std::vector<size_t_>{5});
+    ASSERT_TRUE(schema->set_layout(PAX_LAYOUT));
+    Page raw_page(1);
+    TablePage *page = reinterpret_cast<TablePage*>(&raw_page);
+    page->init(INVALID_PAGE_ID, INVALID_PAGE_ID, *schema);
+    ASSERT_TRUE(page->is_pax());
+    ASSERT_EQ(schema->get_tuple_size(), page->get_pax_tuple_size());
+
+    auto make_tuple = [&](integer_t i) {
+        char str[6];
+        fill_char_array("s" + std::to_string(i % 1000), str);
+        std::vector<Value> values{Value(i), Value(str), Value(i * 0.5)};
+        return Tuple(&values, *schema);
+    };
+
+    // ********************* test 1 ********************* //
+    size_t_ capacity = page->get_pax_capacity();
+    std::vector<RID> rids(capacity);
+    for (integer_t i = 0; i < capacity; i++)
+        ASSERT_TRUE(page->insert_tuple(make_tuple(i), &rids[i]));
+    RID rid;
+    ASSERT_FALSE(page->insert_tuple(make_tuple(capacity), &rid));
+    ASSERT_EQ(0, page->get_free_space());
+
+    Tuple tuple;
+    for (integer_t i = 0; i < capacity; i++) {
+        ASSERT_TRUE(page->get_tuple(&tuple, rids[i]));
+        ASSERT_EQ(make_tuple(i), tuple);
+    }
+
+    const integer_t *col1 = reinterpret_cast<const integer_t*>(page->get_pax_column(0));
+    const decimal_t *col3 = reinterpret_cast<const decimal_t*>(page->get_pax_column(2));
+    for (integer_t i = 0; i < capacity; i++) {
+        ASSERT_EQ(i, col1[i]);
+        ASSERT_EQ(i * 0.5, col3[i]);
+    }
+    PRINT("***test 1 pass***");
+
+    // ********************* test 2 ********************* //
+    std::vector<offset_t> col_idxs{2, 0};
+    for (integer_t i = 0; i < capacity; i++) {
+        ASSERT_TRUE(page->get_tuple_columns(&tuple, rids[i], col_idxs));
+        ASSERT_EQ(Value(i), tuple.get_value(*schema, 0));
+        ASSERT_EQ(Value(i * 0.5), tuple.get_value(*schema, 2));
+        ASSERT_EQ(Value(""), tuple.get_value(*schema, 1));
+    }
+    PRINT("***test 2 pass***");
+
+    // ********************* test 3 ********************* //
+    for (integer_t i = 0; i < capacity; i += 2) {
+        ASSERT_TRUE(page->update_tuple(make_tuple(i + 10000), rids[i]));
+        if (i + 1 == capacity)
+            break;
+        ASSERT_TRUE(page->mark_delete(rids[i + 1]));
+        page->apply_delete(rids[i + 1]);
+    }
+    for (integer_t i = 1; i < capacity; i += 2) {
+        ASSERT_TRUE(page->insert_tuple(make_tuple(i + 20000), &rid));
+        ASSERT_EQ(rids[i], rid);
+    }
+    ASSERT_FALSE(page->insert_tuple(make_tuple(capacity), &rid));
+    for (integer_t i = 0; i < capacity; i++) {
+        ASSERT_TRUE(page->get_tuple(&tuple, rids[i]));
+        ASSERT_EQ(make_tuple(i + (i % 2 == 0 ? 10000 : 20000)), tuple);
+    }
+    PRINT("***test 3 pass***");
+
+    delete schema;
+}
+
+} // namespace dawn
@@ -0,0 +1,265 @@
+#include "gtest/gtest.h"
+#include "table/schema.h"
+#include "manager/db_manager.h"
+#include "table/table.h"
+#include "table/toast.h"
+#include "executors/seq_scan_executor.h"
+#include "executors/proj_executor.h"
+
+namespace dawn {
+
+extern std::unique_ptr<DBManager> db_manager;
+
+/**
+ * table name: table
+ * column types:
+ * ---------------------------------------------------
+ * | integer (key) | varchar (20000) | varchar (10) |
+ * ---------------------------------------------------
+ * the second column is large enough to be toasted, and the third one is small
+ */
+string_t table_name("table");
+const char *meta = "test";
+const char *mtdf = "test.mtd";
+const char *dbf = "test.db";
+const char *logf = "test.log";
+
+size_t_ body_len(integer_t key) {
+    switch (key % 3) {
+        case 0: return 10;
+        case 1: return 3000;
+        default: return 10000;
+    }
+}
+
+string_t make_body(integer_t key, size_t_ len) {
+    string_t body(len, 'a' + key % 26);
+    body[0] = 'A' + key % 26;
+    return body;
+}
+
+void make_values(integer_t key, size_t_ len, std::vector<Value> *values) {
+    values->clear();
+    values->push_back(Value(key));
+    values->push_back(Value(make_body(key, len)));
+    values->push_back(Value("t" + std::to_string(key % 10)));
+}
+
+class ToastTest : public testing::Test {
+public:
+    void SetUp() {
+        DBManager::set_default_pool_size(50);
+        remove(mtdf);
+        remove(dbf);
+        remove(logf);
+    }
+
+    void TearDown() {
+        remove(mtdf);
+        remove(dbf);
+        remove(logf);
+    }
+};
+
+/**
+ * Test List:
+ *   1. insert tuples with small and large values, the stored tuples should be small
+ *      and the values could be fetched from the overflow pages
+ *   2. update the large values many times, the old overflow pages should be reused
+ *   3. delete some tuples and restart the db, check the rest of tuples
+ *   4. scan the table, the large values are only fetched when they are projected
+ *   5. bulk load tuples with large values, the caller's tuples are kept as they are. A batch
+ *      with a duplicated key loads nothing, and its overflow pages are deleted
+ *   6. read a value into a buffer smaller than it, only the bytes the buffer contains are copied
+ */
+TEST_F(ToastTest, BasicTest) {
+    PRINT("start the toast tests...");
+    Schema *tb_schema = create_table_schema(std::vector<TypeId>{TypeId::kInteger, TypeId::kVarchar, TypeId::kVarchar},
+        std::vector<string_t>{"tb_col1", "tb_col2", "tb_col3"}, std::vector<size_t_>{20000, 10});
+    integer_t insert_num = 300;
+    table_id_t table_id;
+    std::vector<Value> values;
+    std::vector<size_t_> lens;
+    for (integer_t i = 0; i < insert_num; i++)
+        lens.push_back(body_len(i));
+
+    auto check_tuple = [&](Table *table, integer_t key, BufferPoolManager *bpm) {
+        Tuple tuple;
+        ASSERT_TRUE(table->get_tuple(Value(key), &tuple, *tb_schema));
+        ASSERT_LE(tuple.get_size(), TOAST_TUPLE_THRESHOLD);
+        ASSERT_EQ(lens[key] > TOAST_TUPLE_THRESHOLD, tuple.is_toasted(*tb_schema, 1));
+        ASSERT_FALSE(tuple.is_toasted(*tb_schema, 2));
+        ASSERT_EQ(Value(make_body(key, lens[key])), toast_fetch_value(tuple, *tb_schema, 1, bpm));
+        ASSERT_EQ(Value("t" + std::to_string(key % 10)), tuple.get_value(*tb_schema, 2));
+
+        toast_fetch(&tuple, *tb_schema, bpm);
+        ASSERT_FALSE(tuple.is_toasted(*tb_schema, 1));
+        ASSERT_EQ(Value(make_body(key, lens[key])), tuple.get_value(*tb_schema, 1));
+    };
+
+    {
+        db_manager.reset(new DBManager(meta, true));
+        ASSERT_TRUE(db_manager->get_status());
+        BufferPoolManager *bpm = db_manager->get_buffer_pool_manager();
+
+        CatalogTable *catalog_table = db_manager->get_catalog()->get_catalog_table();
+        ASSERT_TRUE(catalog_table->create_table(table_name, *tb_schema));
+        TableMetaData *table_md = catalog_table->get_table_meta_data(table_name);
+        ASSERT_NE(nullptr, table_md);
+        table_id = table_md->get_table_id();
+        Table *table = table_md->get_table();
+
+        // ********************* test 1 ********************* //
+        for (integer_t i = 0; i < insert_num; i++) {
+            make_values(i, lens[i], &values);
+            Tuple tuple(&values, *tb_schema);
+            ASSERT_TRUE(table->insert_tuple(&tuple, *tb_schema));
+
+            // the caller's tuple is not changed
+            ASSERT_FALSE(tuple.is_toasted(*tb_schema, 1));
+        }
+        for (integer_t i = 0; i < insert_num; i++)
+            check_tuple(table, i, bpm);
+        PRINT("***test 1 pass***");
+
+        // ********************* test 2 ********************* //
+        integer_t key = 2;
+        DiskManager *disk_manager = db_manager->get_disk_manager();
+        page_id_t max_pgid = disk_manager->get_max_alloced_pgid();
+        for (int round = 0; round < 50; round++) {
+            Tuple old_tuple;
+            ASSERT_TRUE(table->get_tuple(Value(key), &old_tuple, *tb_schema));
+            lens[key] = 5000 + round;
+            make_values(key, lens[key], &values);
+            Tuple new_tuple(&values, *tb_schema);
+            ASSERT_TRUE(table->update_tuple(&new_tuple, old_tuple.get_rid(), *tb_schema));
+        }
+        check_tuple(table, key, bpm);
+        ASSERT_LE(disk_manager->get_max_alloced_pgid(), max_pgid + 2);
+
+        // update the small column only, the new tuple refers to the same overflow pages
+        Tuple old_tuple;
+        ASSERT_TRUE(table->get_tuple(Value(key), &old_tuple, *tb_schema));
+        Tuple new_tuple(old_tuple);
+        Value tag("t" + std::to_string(key % 10));
+        new_tuple.set_value(*tb_schema, &tag, 2);
+        ASSERT_TRUE(table->update_tuple(&new_tuple, old_tuple.get_rid(), *tb_schema));
+        check_tuple(table, key, bpm);
+
+        // the large value becomes small, and the small one becomes large
+        lens[key] = 10;
+        lens[key + 1] = 8000;
+        for (integer_t k : {key, key + 1}) {
+            ASSERT_TRUE(table->get_tuple(Value(k), &old_tuple, *tb_schema));
+            make_values(k, lens[k], &values);
+            Tuple tuple(&values, *tb_schema);
+            ASSERT_TRUE(table->update_tuple(&tuple, old_tuple.get_rid(), *tb_schema));
+            check_tuple(table, k, bpm);
+        }
+        PRINT("***test 2 pass***");
+
+        // ********************* test 3 ********************* //
+        for (integer_t i = 0; i < insert_num; i += 5) {
+            ASSERT_TRUE(table->mark_delete(Value(i), *tb_schema));
+            table->apply_delete(Value(i), *tb_schema);
+        }
+    }
+
+    {
+        db_manager.reset(new DBManager(meta, false));
+        ASSERT_TRUE(db_manager->get_status());
+        BufferPoolManager *bpm = db_manager->get_buffer_pool_manager();
+
+        CatalogTable *catalog_table = db_manager->get_catalog()->get_catalog_table();
+        TableMetaData *table_md = catalog_table->get_table_meta_data(table_id);
+        ASSERT_NE(nullptr, table_md);
+        Table *table = table_md->get_table();
+        Tuple tuple;
+        for (integer_t i = 0; i < insert_num; i++) {
+            if (i % 5 == 0) {
+                ASSERT_FALSE(table->get_tuple(Value(i), &tuple, *tb_schema));
+                continue;
+            }
+            check_tuple(table, i, bpm);
+        }
+        PRINT("***test 3 pass***");
+
+        // ********************* test 4 ********************* //
+        ExecutorContext exec_ctx(bpm);
+        SeqScanExecutor scan(&exec_ctx, table);
+        scan.open();
+        integer_t cnt = 0;
+        while (scan.get_next(&tuple)) {
+            integer_t key = tuple.get_value(*tb_schema, 0).get_value<integer_t>();
+            ASSERT_EQ(lens[key] > TOAST_TUPLE_THRESHOLD, tuple.is_toasted(*tb_schema, 1));
+            cnt++;
+        }
+        scan.close();
+        ASSERT_EQ(insert_num - insert_num / 5, cnt);
+
+        Schema *output_schema = new Schema(std::vector<Column>{tb_schema->get_column(0), tb_schema->get_column(1)});
+        SeqScanExecutor *child = new SeqScanExecutor(&exec_ctx, table);
+        ColumnValueExpression key_expr(0);
+        ColumnValueExpression body_expr(1);
+        ProjectionExecutor proj(&exec_ctx, child, std::vector<ExpressionAbstract*>{&key_expr, &body_expr},
+            tb_schema, output_schema);
+        proj.open();
+        cnt = 0;
+        while (proj.get_next(&tuple)) {
+            integer_t key = tuple.get_value(*output_schema, 0).get_value<integer_t>();
+            ASSERT_EQ(Value(make_body(key, lens[key])), tuple.get_value(*output_schema, 1));
+            cnt++;
+        }
+        proj.close();
+        ASSERT_EQ(insert_num - insert_num / 5, cnt);
+        PRINT("***test 4 pass***");
+
+        delete child;
+        delete output_schema;
+
+        // ********************* test 5 ********************* //
+        integer_t load_num = 30;
+        std::vector<Tuple> tuples;
+        for (integer_t i = insert_num; i < insert_num + load_num; i++) {
+            lens.push_back(body_len(i));
+            make_values(i, lens[i], &values);
+            tuples.push_back(Tuple(&values, *tb_schema));
+        }
+        std::vector<Tuple> dup_tuples(tuples);
+        dup_tuples.push_back(tuples[0]);
+        DiskManager *disk_manager = db_manager->get_disk_manager();
+        page_id_t max_pgid = disk_manager->get_max_alloced_pgid();
+        ASSERT_FALSE(table->bulk_load(&dup_tuples, *tb_schema));
+        for (auto &dup_tuple : dup_tuples) {
+            ASSERT_FALSE(dup_tuple.is_toasted(*tb_schema, 1));
+            ASSERT_EQ(INVALID_PAGE_ID, dup_tuple.get_rid().get_page_id());
+        }
+        for (page_id_t pgid = max_pgid + 1; pgid <= disk_manager->get_max_alloced_pgid(); pgid++)
+            ASSERT_FALSE(disk_manager->is_allocated(pgid));
+
+        ASSERT_TRUE(table->bulk_load(&tuples, *tb_schema));
+        for (integer_t i = 0; i < load_num; i++) {
+            ASSERT_FALSE(tuples[i].is_toasted(*tb_schema, 1));
+            ASSERT_EQ(Value(make_body(insert_num + i, lens[insert_num + i])), tuples[i].get_value(*tb_schema, 1));
+            check_tuple(table, insert_num + i, bpm);
+        }
+        PRINT("***test 5 pass***");
+
+        // ********************* test 6 ********************* //
+        string_t body = make_body(0, 10000);
+        page_id_t first_pgid = toast_write_value(body.data(), body.size(), bpm);
+        ASSERT_NE(INVALID_PAGE_ID, first_pgid);
+        std::vector<char> dst(100);
+        ASSERT_TRUE(toast_read_value(first_pgid, dst.size(), dst.data(), bpm));
+        ASSERT_EQ(body.substr(0, dst.size()), string_t(dst.data(), dst.size()));
+        dst.resize(body.size() + 1);
+        ASSERT_FALSE(toast_read_value(first_pgid, dst.size(), dst.data(), bpm));
+        toast_delete_value(first_pgid, bpm);
+        PRINT("***test 6 pass***");
+    }
+
+    db_manager.reset(nullptr);
+    delete tb_schema;
+}
+
+} // namespace dawn
@@ -0,0 +1,236 @@
+#include "gtest/gtest.h"
+#include "test_util.h"
+#include "table/schema.h"
+#include "table/tuple_batch.h"
+#include "manager/db_manager.h"
+#include "table/table.h"
+#include "executors/seq_scan_executor.h"
+#include "executors/selection_executor.h"
+#include "executors/proj_executor.h"
+#include "sql/expressions/col_value_expr.h"
+#include "sql/expressions/constant_expr.h"
+#include "sql/expressions/comparison_expr.h"
+
+namespace dawn {
+
+extern std::unique_ptr<DBManager> db_manager;
+
+/**
+ * table name: table
+ * column types:
+ * -----------------------------------------------------------
+ * | integer (key) | integer | decimal | char (10) | varchar |
+ * -----------------------------------------------------------
+ */
+string_t table_name("table");
+const char *meta = "test";
+const char *mtdf = "test.mtd";
+const char *dbf = "test.db";
+const char *logf = "test.log";
+
+class TupleBatchTest : public testing::Test {
+public:
+    void SetUp() {
+        DBManager::set_default_pool_size(50);
+        remove(mtdf);
+        remove(dbf);
+        remove(logf);
+    }
+
+    void TearDown() {
+        remove(mtdf);
+        remove(dbf);
+        remove(logf);
+    }
+};
+
+/**
+ * Test List:
+ *   1. scan the table batch by batch, the values are the same as the tuples' and the toasted ones are fetched
+ *   2. select the rows with the kernel (integer vs constant) and row by row (char vs char)
+ *   3. project the selected rows, they are compacted in the output batch
+ *   4. the legacy executor fills the batch with the tuples
+ */
+TEST_F(TupleBatchTest, BasicTest) {
+    PRINT("start the tuple batch tests...");
+    Schema *tb_schema = create_table_schema(
+        std::vector<TypeId>{TypeId::kInteger, TypeId::kInteger, TypeId::kDecimal, TypeId::kChar, TypeId::kVarchar},
+        std::vector<string_t>{"tb_col1", "tb_col2", "tb_col3", "tb_col4", "tb_col5"}, std::vector<size_t_>{10, 2000});
+    integer_t insert_num = 3000;
+
+    db_manager.reset(new DBManager(meta, true));
+    ASSERT_TRUE(db_manager->get_status());
+    BufferPoolManager *bpm = db_manager->get_buffer_pool_manager();
+
+    CatalogTable *catalog_table = db_manager->get_catalog()->get_catalog_table();
+    ASSERT_TRUE(catalog_table->create_table(table_name, *tb_schema));
+    TableMetaData *table_md = catalog_table->get_table_meta_data(table_name);
+    ASSERT_NE(nullptr, table_md);
+    Table *table = table_md->get_table();
+
+    char str[11];
+    auto varchar_of = [](integer_t i) {
+        // every 100th string is toasted
+        return i % 100 == 0 ? string_t(1500, 'a' + i % 26) : "str" + std::to_string(i);
+    };
+    for (integer_t i = 0; i < insert_num; i++) {
+        fill_char_array("str" + std::to_string(i % 10), str);
+        std::vector<Value> values{Value(i), Value(i % 10), Value(static_cast<decimal_t>(i) / 2),
+            Value(str), Value(varchar_of(i))};
+        Tuple tuple(&values, *tb_schema);
+        ASSERT_TRUE(table->insert_tuple(&tuple, *tb_schema));
+    }
+
+    ExecutorContext exec_ctx(bpm);
+
+    // ********************* test 1 ********************* //
+    {
+        SeqScanExecutor scan(&exec_ctx, table);
+        TupleBatch batch;
+        batch.init(tb_schema);
+        scan.open();
+        integer_t cnt = 0;
+        Tuple tuple;
+        while (scan.get_next_batch(&batch)) {
+            ASSERT_LE(batch.get_size(), TUPLE_BATCH_SZ);
+            ASSERT_EQ(nullptr, batch.get_selection());
+            const integer_t *keys = batch.get_column(0)->get_data<integer_t>();
+            const decimal_t *decs = batch.get_column(2)->get_data<decimal_t>();
+            for (int i = 0; i < batch.get_size(); i++) {
+                integer_t key = keys[i];
+                ASSERT_EQ(static_cast<decimal_t>(key) / 2, decs[i]);
+                ASSERT_EQ(Value(key % 10), batch.get_column(1)->get_value(i));
+                ASSERT_EQ(Value(varchar_of(key)), batch.get_column(4)->get_value(i));
+
+                ASSERT_TRUE(table->get_tuple(Value(key), &tuple, *tb_schema));
+                ASSERT_EQ(tuple.get_value(*tb_schema, 3), batch.get_column(3)->get_value(i));
+                ASSERT_EQ(tuple.get_rid(), batch.get_rid(i));
+            }
+            cnt += batch.get_size();
+        }
+        scan.close();
+        ASSERT_EQ(insert_num, cnt);
+    }
+    PRINT("***test 1 pass***");
+
+    // ********************* test 2 ********************* //
+    ColumnValueExpression col2(1), col4(3);
+    ConstantExpression three(Value(3));
+    ComparisonExpression less(std::vector<ExpressionAbstract*>{&col2, &three}, ComparisonType::kLessThan);
+    ComparisonExpression str_eq(std::vector<ExpressionAbstract*>{&col4, &col4}, ComparisonType::kEqual);
+    {
+        // col2 < 3
+        SeqScanExecutor *child = new SeqScanExecutor(&exec_ctx, table);
+        SelectionExecutor selection(&exec_ctx, &less, child, tb_schema);
+        TupleBatch batch;
+        batch.init(tb_schema, std::vector<offset_t>{0});
+        selection.open();
+        integer_t cnt = 0;
+        while (selection.get_next_batch(&batch)) {
+            ASSERT_TRUE(batch.is_loaded(1));
+            ASSERT_FALSE(batch.is_loaded(2));
+            ASSERT_NE(nullptr, batch.get_selection());
+            for (int i = 0; i < batch.get_count(); i++) {
+                int row = batch.get_row(i);
+                integer_t key = batch.get_column(0)->get_data<integer_t>()[row];
+                ASSERT_LT(key % 10, 3);
+                if (i > 0) {
+                    ASSERT_LT(batch.get_row(i - 1), row);
+                }
+            }
+            cnt += batch.get_count();
+        }
+        selection.close();
+        ASSERT_EQ(insert_num / 10 * 3, cnt);
+
+        // the char column is compared row by row
+        SelectionExecutor str_selection(&exec_ctx, &str_eq, child, tb_schema);
+        batch.init(tb_schema, std::vector<offset_t>{0});
+        str_selection.open();
+        cnt = 0;
+        while (str_selection.get_next_batch(&batch))
+            cnt += batch.get_count();
+        str_selection.close();
+        ASSERT_EQ(insert_num, cnt);
+        delete child;
+    }
+    PRINT("***test 2 pass***");
+
+    // ********************* test 3 ********************* //
+    {
+        Schema *out_schema = create_table_schema(std::vector<TypeId>{TypeId::kInteger, TypeId::kChar, TypeId::kVarchar},
+            std::vector<string_t>{"out_col1", "out_col2", "out_col3"}, std::vector<size_t_>{10, 2000});
+        ColumnValueExpression col1(0), col5(4);
+        SeqScanExecutor *scan = new SeqScanExecutor(&exec_ctx, table);
+        SelectionExecutor *selection = new SelectionExecutor(&exec_ctx, &less, scan, tb_schema);
+        ProjectionExecutor proj(&exec_ctx, selection, std::vector<ExpressionAbstract*>{&col1, &col4, &col5},
+            tb_schema, out_schema);
+
+        std::vector<Tuple> expected;
+        Tuple tuple;
+        proj.open();
+        while (proj.get_next(&tuple))
+            expected.push_back(tuple);
+        proj.close();
+
+        TupleBatch batch;
+        batch.init(out_schema);
+        proj.open();
+        size_t idx = 0;
+        while (proj.get_next_batch(&batch)) {
+            ASSERT_EQ(nullptr, batch.get_selection());
+            for (int i = 0; i < batch.get_size(); i++) {
+                batch.get_tuple(i, &tuple);
+                ASSERT_LT(idx, expected.size());
+                for (int j = 0; j < 3; j++)
+                    ASSERT_EQ(expected[idx].get_value(*out_schema, j), tuple.get_value(*out_schema, j));
+                idx++;
+            }
+        }
+        proj.close();
+        ASSERT_EQ(expected.size(), idx);
+        ASSERT_EQ(static_cast<size_t>(insert_num / 10 * 3), idx);
+        delete selection;
+        delete scan;
+        delete out_schema;
+    }
+    PRINT("***test 3 pass***");
+
+    // ********************* test 4 ********************* //
+    {
+        std::vector<Tuple> tuples;
+        for (integer_t i = 0; i < 1500; i++) {
+            fill_char_array("str" + std::to_string(i % 10), str);
+            std::vector<Value> values{Value(i), Value(i % 10), Value(static_cast<decimal_t>(i)),
+                Value(str), Value(varchar_of(i))};
+            tuples.push_back(Tuple(&values, *tb_schema));
+        }
+        TupleListExecutor *child = new TupleListExecutor(&exec_ctx, &tuples);
+        SelectionExecutor selection(&exec_ctx, &less, child, tb_schema);
+        TupleBatch batch;
+        batch.init(tb_schema);
+        selection.open();
+        std::vector<int> batch_counts;
+        while (selection.get_next_batch(&batch)) {
+            batch_counts.push_back(batch.get_count());
+            for (int i = 0; i < batch.get_count(); i++) {
+                int row = batch.get_row(i);
+                Tuple tuple;
+                batch.get_tuple(row, &tuple);
+                integer_t key = tuple.get_value(*tb_schema, 0).get_value<integer_t>();
+                for (int j = 0; j < tb_schema->get_column_num(); j++)
+                    ASSERT_EQ(tuples[key].get_value(*tb_schema, j), tuple.get_value(*tb_schema, j));
+            }
+        }
+        selection.close();
+        ASSERT_EQ(2, batch_counts.size());
+        ASSERT_EQ(450, batch_counts[0] + batch_counts[1]);
+        delete child;
+    }
+    PRINT("***test 4 pass***");
+
+    db_manager.reset(nullptr);
+    delete tb_schema;
+}
+
+} // namespace dawn
@@ -0,0 +1,222 @@
+#include <atomic>
+#include <thread>
+
+#include "gtest/gtest.h"
+#include "table/schema.h"
+#include "table/tuple_view.h"
+#include "manager/db_manager.h"
+#include "table/table.h"
+#include "executors/seq_scan_executor.h"
+#include "executors/selection_executor.h"
+#include "sql/expressions/col_value_expr.h"
+#include "sql/expressions/comparison_expr.h"
+
+namespace dawn {
+
+extern std::unique_ptr<DBManager> db_manager;
+
+/**
+ * table name: table
+ * column types:
+ * ---------------------------------------
+ * | integer (key) | integer | char (10) |
+ * ---------------------------------------
+ */
+string_t table_name("table");
+const char *meta = "test";
+const char *mtdf = "test.mtd";
+const char *dbf = "test.db";
+const char *logf = "test.log";
+
+class TupleViewTest : public testing::Test {
+public:
+    void SetUp() {
+        DBManager::set_default_pool_size(50);
+        remove(mtdf);
+        remove(dbf);
+        remove(logf);
+    }
+
+    void TearDown() {
+        remove(mtdf);
+        remove(dbf);
+        remove(logf);
+    }
+};
+
+/**
+ * Test List:
+ *   1. scan the table with views, the tuples refer to the iter's copy and the pages aren't pinned by them
+ *   2. modify the view's tuple, the page should not be changed
+ *   3. the materialized tuple is still valid after the view is released
+ *   4. the selection passes the views through, and only copies the tuples returned by get_next()
+ *   5. scan the table while another thread updates, deletes and reinserts the tuples, no torn
+ *      tuple should be seen
+ */
+TEST_F(TupleViewTest, BasicTest) {
+    PRINT("start the tuple view tests...");
+    Schema *tb_schema = create_table_schema(std::vector<TypeId>{TypeId::kInteger, TypeId::kInteger, TypeId::kChar},
+        std::vector<string_t>{"tb_col1", "tb_col2", "tb_col3"}, std::vector<size_t_>{10});
+    integer_t insert_num = 1000;
+
+    db_manager.reset(new DBManager(meta, true));
+    ASSERT_TRUE(db_manager->get_status());
+    BufferPoolManager *bpm = db_manager->get_buffer_pool_manager();
+
+    CatalogTable *catalog_table = db_manager->get_catalog()->get_catalog_table();
+    ASSERT_TRUE(catalog_table->create_table(table_name, *tb_schema));
+    TableMetaData *table_md = catalog_table->get_table_meta_data(table_name);
+    ASSERT_NE(nullptr, table_md);
+    Table *table = table_md->get_table();
+
+    char str[11];
+    for (integer_t i = 0; i < insert_num; i++) {
+        fill_char_array("str" + std::to_string(i % 10), str);
+        std::vector<Value> values{Value(i), Value(i % 10), Value(str)};
+        Tuple tuple(&values, *tb_schema);
+        ASSERT_TRUE(table->insert_tuple(&tuple, *tb_schema));
+    }
+
+    ExecutorContext exec_ctx(bpm);
+
+    // ********************* test 1 ********************* //
+    {
+        SeqScanExecutor scan(&exec_ctx, table);
+        TupleView view;
+        scan.open();
+        integer_t cnt = 0;
+        while (scan.get_next_view(&view)) {
+            ASSERT_TRUE(view->is_attached());
+
+            // pinned by the iter and here, the view doesn't pin it
+            Page *page = bpm->get_page(view->get_rid().get_page_id());
+            ASSERT_EQ(2, page->get_pin_count());
+            bpm->unpin_page(view->get_rid().get_page_id(), false);
+
+            integer_t key = view->get_value(*tb_schema, 0).get_value<integer_t>();
+            ASSERT_EQ(Value(key % 10), view->get_value(*tb_schema, 1));
+            cnt++;
+        }
+        scan.close();
+        ASSERT_EQ(insert_num, cnt);
+    }
+    PRINT("***test 1 pass***");
+
+    // ********************* test 2 ********************* //
+    Tuple materialized;
+    {
+        SeqScanExecutor scan(&exec_ctx, table);
+        TupleView view;
+        scan.open();
+        ASSERT_TRUE(scan.get_next_view(&view));
+        integer_t key = view->get_value(*tb_schema, 0).get_value<integer_t>();
+        Value new_value(-1);
+        view.get_tuple()->set_value(*tb_schema, &new_value, 1);
+        ASSERT_FALSE(view->is_attached());
+        ASSERT_EQ(new_value, view->get_value(*tb_schema, 1));
+
+        Tuple stored;
+        ASSERT_TRUE(table->get_tuple(Value(key), &stored, *tb_schema));
+        ASSERT_EQ(Value(key % 10), stored.get_value(*tb_schema, 1));
+        PRINT("***test 2 pass***");
+
+        // ********************* test 3 ********************* //
+        ASSERT_TRUE(scan.get_next_view(&view));
+        ASSERT_TRUE(view->is_attached());
+        view.materialize(&materialized);
+        ASSERT_TRUE(materialized.is_allocated());
+        ASSERT_EQ(*view, materialized);
+        scan.close();
+    }
+    integer_t key = materialized.get_value(*tb_schema, 0).get_value<integer_t>();
+    ASSERT_EQ(Value(key % 10), materialized.get_value(*tb_schema, 1));
+    PRINT("***test 3 pass***");
+
+    // ********************* test 4 ********************* //
+    {
+        SeqScanExecutor *child = new SeqScanExecutor(&exec_ctx, table);
+        ColumnValueExpression col_expr(1);
+        std::vector<ExpressionAbstract*> children{&col_expr, &col_expr};
+        ComparisonExpression pred(children, ComparisonType::kEqual);
+        SelectionExecutor selection(&exec_ctx, &pred, child, tb_schema);
+        TupleView view;
+        selection.open();
+        integer_t cnt = 0;
+        while (selection.get_next_view(&view)) {
+            ASSERT_TRUE(view->is_attached());
+            cnt++;
+        }
+        selection.close();
+        ASSERT_EQ(insert_num, cnt);
+
+        Tuple tuple;
+        selection.open();
+        cnt = 0;
+        while (selection.get_next(&tuple)) {
+            ASSERT_TRUE(tuple.is_allocated());
+            cnt++;
+        }
+        selection.close();
+        ASSERT_EQ(insert_num, cnt);
+        delete child;
+    }
+    PRINT("***test 4 pass***");
+
+    // ********************* test 5 ********************* //
+    {
+        // col3 is always "str" + col2, the tuples of the odd keys are deleted and reinserted
+        std::atomic<bool> done{false};
+        std::thread writer([&] {
+            // done is set even if an assertion fails, or the scan never stops
+            [&] {
+                char buf[11];
+                Tuple tuple;
+                for (integer_t round = 1; round <= 20; round++) {
+                    for (integer_t i = 0; i < insert_num; i++) {
+                        integer_t tag = (i + round) % 10;
+                        fill_char_array("str" + std::to_string(tag), buf);
+                        std::vector<Value> values{Value(i), Value(tag), Value(buf)};
+                        Tuple new_tuple(&values, *tb_schema);
+                        if (i % 2 == 0) {
+                            ASSERT_TRUE(table->get_tuple(Value(i), &tuple, *tb_schema));
+                            ASSERT_TRUE(table->update_tuple(&new_tuple, tuple.get_rid(), *tb_schema));
+                        } else {
+                            ASSERT_TRUE(table->mark_delete(Value(i), *tb_schema));
+                            table->apply_delete(Value(i), *tb_schema);
+                            ASSERT_TRUE(table->insert_tuple(&new_tuple, *tb_schema));
+                        }
+                    }
+                }
+            }();
+            done = true;
+        });
+
+        integer_t scan_num = 0;
+        while (!done || scan_num == 0) {
+            SeqScanExecutor scan(&exec_ctx, table);
+            TupleView view;
+            scan.open();
+            while (scan.get_next_view(&view)) {
+                integer_t key = view->get_value(*tb_schema, 0).get_value<integer_t>();
+                ASSERT_LE(0, key);
+                ASSERT_GT(insert_num, key);
+                integer_t tag = view->get_value(*tb_schema, 1).get_value<integer_t>();
+                ASSERT_EQ(Value("str" + std::to_string(tag)), view->get_value(*tb_schema, 2));
+            }
+            scan.close();
+            scan_num++;
+        }
+        writer.join();
+
+        // no tuple is lost after all
+        Tuple tuple;
+        for (integer_t i = 0; i < insert_num; i++)
+            ASSERT_TRUE(table->get_tuple(Value(i), &tuple, *tb_schema));
+    }
+    PRINT("***test 5 pass***");
+
+    db_manager.reset(nullptr);
+    delete tb_schema;
+}
+
+} // namespace dawn